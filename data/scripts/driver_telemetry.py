@@ -0,0 +1,25 @@
+"""Stage timings shared by the Schrödinger's Sandbox drivers.
+
+Drivers import this module before any third-party package, so STARTED_AT separates interpreter
+start-up from import time in the backend telemetry.
+"""
+
+import time
+
+STARTED_AT = time.time()
+
+
+class StageClock:
+    """Wall time per driver stage, reported as result.json "timings" for the backend telemetry."""
+
+    def __init__(self):
+        self.stages = {}
+        self._mark = STARTED_AT
+
+    def lap(self, stage):
+        now = time.time()
+        self.stages[stage] = self.stages.get(stage, 0.0) + (now - self._mark)
+        self._mark = now
+
+    def to_json(self):
+        return {"started_at": STARTED_AT, "stages": [[name, seconds] for name, seconds in self.stages.items()]}
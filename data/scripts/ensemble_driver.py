@@ -0,0 +1,290 @@
+#!/usr/bin/env python3
+"""Ensemble single-point driver for Schrödinger's Sandbox.
+
+Scores many geometries that share method, basis, charge and multiplicity in one process. The
+calculator is set up once per atom composition and moved from geometry to geometry, so basis
+objects and SCF machinery are built once and every SCF starts from the previous member's solution.
+"""
+
+import json
+import os
+import sys
+import time
+import traceback
+
+# Imported before the third-party packages so its start time excludes their import time.
+from driver_telemetry import StageClock
+
+import numpy as np  # noqa: E402
+
+XTB_METHODS = ("gfn2-xtb", "gfn1-xtb", "gfn-ff")
+
+
+def _requested_properties(job):
+    """Per-member properties the job asked for ("dipole", "mulliken"); energies are always returned."""
+    return set(job.get("properties", []))
+
+
+def _split_geometry(geometry):
+    numbers = tuple(int(z) for z, _ in geometry)
+    positions = np.array([[float(v) for v in coords] for _, coords in geometry], dtype=np.float64)
+    return numbers, positions
+
+
+class TbliteEnsemble:
+    """One tblite calculator per composition; each singlepoint restarts from the previous result."""
+
+    def __init__(self, job):
+        from tblite.interface import Calculator
+
+        from xtb_driver import _method_name
+
+        self.job = job
+        self.properties = _requested_properties(job)
+        self.calculator_type = Calculator
+        self.method_name = _method_name(job["method"].lower())
+        self.calculators = {}
+
+    def _calculator(self, numbers, positions):
+        entry = self.calculators.get(numbers)
+        if entry is None:
+            calc = self.calculator_type(self.method_name, np.array(numbers, dtype=np.int32), positions)
+            calc.set("verbosity", 0)
+            if self.job.get("charge", 0) != 0:
+                calc.set("charge", float(self.job["charge"]))
+            if self.job.get("multiplicity", 1) != 1:
+                calc.set("spin", int(self.job["multiplicity"]) - 1)
+            if self.job.get("solvent", ""):
+                calc.set("solvent", str(self.job["solvent"]))
+            entry = {"calc": calc, "previous": None}
+            self.calculators[numbers] = entry
+        else:
+            entry["calc"].update(positions)
+        return entry
+
+    def evaluate(self, geometry, member):
+        numbers, positions = _split_geometry(geometry)
+        entry = self._calculator(numbers, positions)
+        try:
+            res = entry["calc"].singlepoint(entry["previous"])
+        except Exception:
+            entry["previous"] = None
+            raise
+        entry["previous"] = res
+        member["energy"] = float(res.get("energy"))
+        charges = res.get("charges") if "mulliken" in self.properties else None
+        if charges is not None:
+            member["mulliken_charges"] = [float(x) for x in charges]
+        dipole = res.get("dipole") if "dipole" in self.properties else None
+        if dipole is not None:
+            member["dipole_moment"] = [float(x) for x in dipole]
+
+
+class XtbCliEnsemble:
+    """Fallback when tblite is not importable: one xtb run per geometry in a shared scratch directory."""
+
+    def __init__(self, job, output_dir):
+        from xtb_driver import _find_xtb
+
+        if not _find_xtb():
+            raise RuntimeError(
+                "Neither tblite Python package nor xtb command-line tool found. "
+                "Install tblite or xtb."
+            )
+        self.properties = _requested_properties(job)
+        # The xtb run itself writes no molden file; charges and dipole come from its output.
+        self.job = dict(job, properties=[], optimize=False)
+        self.scratch = os.path.join(output_dir, "ensemble_xtb")
+        os.makedirs(self.scratch, exist_ok=True)
+
+    def evaluate(self, geometry, member):
+        from xtb_driver import _run_xtb_cli, _write_xyz
+
+        xyz_path = os.path.join(self.scratch, "input.xyz")
+        _write_xyz(xyz_path, geometry)
+        single = {}
+        _run_xtb_cli(self.job, self.scratch, xyz_path, single)
+        member["energy"] = float(single["total_energy"])
+        if "mulliken" in self.properties and "mulliken_charges" in single:
+            member["mulliken_charges"] = single["mulliken_charges"]
+        if "dipole" in self.properties and "dipole_moment" in single:
+            member["dipole_moment"] = single["dipole_moment"]
+
+
+class PySCFEnsemble:
+    """One Mole and mean-field object per composition, moved to each geometry in turn.
+
+    The basis is parsed once, the SCF object is reset rather than rebuilt, and the previous
+    member's density matrix is the initial guess for the next one.
+    """
+
+    def __init__(self, job, output_dir):
+        from pyscf import gto
+
+        self.job = job
+        self.properties = _requested_properties(job)
+        self.method = job["method"].lower()
+        self.mole_type = gto.Mole
+        self.log_path = os.path.join(output_dir, "pyscf.log")
+        self.setups = {}
+
+    def _setup(self, numbers, positions):
+        from pyscf_driver import _build_mean_field, _element_symbol
+
+        entry = self.setups.get(numbers)
+        if entry is not None:
+            entry["mol"].set_geom_(positions, unit="Bohr")
+            entry["mf"].reset(entry["mol"])
+            return entry
+
+        mol = self.mole_type()
+        mol.atom = [[_element_symbol(z), tuple(float(v) for v in pos)] for z, pos in zip(numbers, positions)]
+        mol.basis = self.job["basis"]
+        mol.charge = int(self.job.get("charge", 0))
+        mol.spin = int(self.job.get("multiplicity", 1)) - 1
+        mol.unit = "Bohr"
+        mol.verbose = 0
+        mol.output = self.log_path
+        mol.build()
+        mf = _build_mean_field(
+            mol,
+            self.method,
+            int(self.job.get("multiplicity", 1)),
+            int(self.job.get("max_scf_cycles", 200)),
+            float(self.job.get("scf_convergence", 1.0e-8)),
+            self.job.get("solvent", ""),
+        )
+        entry = {"mol": mol, "mf": mf, "dm": None}
+        self.setups[numbers] = entry
+        return entry
+
+    def evaluate(self, geometry, member):
+        from pyscf import cc, mp
+
+        from pyscf_driver import _mulliken_charges
+
+        numbers, positions = _split_geometry(geometry)
+        entry = self._setup(numbers, positions)
+        mol, mf = entry["mol"], entry["mf"]
+        try:
+            energy = float(mf.kernel(dm0=entry["dm"]))
+        except Exception:
+            entry["dm"] = None
+            raise
+        if not getattr(mf, "converged", False):
+            entry["dm"] = None
+            raise RuntimeError("SCF did not converge")
+        dm = mf.make_rdm1()
+        entry["dm"] = dm
+
+        if self.method == "mp2":
+            is_open_shell = int(self.job.get("multiplicity", 1)) > 1
+            post_hf = mp.UMP2(mf) if is_open_shell else mp.MP2(mf)
+            energy = float(mf.e_tot + post_hf.kernel()[0])
+        elif self.method == "ccsd":
+            energy = float(mf.e_tot + cc.CCSD(mf).kernel()[0])
+
+        member["energy"] = energy
+        if "dipole" in self.properties:
+            member["dipole_moment"] = [float(x) for x in mf.dip_moment(verbose=0)]
+        if "mulliken" in self.properties:
+            member["mulliken_charges"] = _mulliken_charges(mol, dm, mf.get_ovlp())
+
+
+def _make_runner(job, output_dir):
+    if job["method"].lower() not in XTB_METHODS:
+        return PySCFEnsemble(job, output_dir)
+    try:
+        return TbliteEnsemble(job)
+    except ImportError:
+        return XtbCliEnsemble(job, output_dir)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: python3 ensemble_driver.py job.json", file=sys.stderr)
+        sys.exit(1)
+
+    with open(sys.argv[1], "r", encoding="utf-8") as f:
+        job = json.load(f)
+
+    output_dir = job["output_dir"]
+    os.makedirs(output_dir, exist_ok=True)
+
+    progress_path = os.path.join(output_dir, "progress.json")
+    stream_path = os.path.join(output_dir, "ensemble.jsonl")
+
+    def write_progress(stage, step=0, message="", **extra):
+        with open(progress_path, "w", encoding="utf-8") as pf:
+            json.dump(
+                {"stage": stage, "step": step, "message": message, "timestamp": time.time(), **extra},
+                pf,
+            )
+
+    result = {
+        "success": False,
+        "error": "",
+        "total_energy": 0.0,
+        "ensemble": [],
+        "wall_time": 0.0,
+    }
+
+    start_time = time.time()
+    clock = StageClock()
+
+    try:
+        geometries = job.get("ensemble", [])
+        if not geometries:
+            raise ValueError("Ensemble job has no geometries")
+        total = len(geometries)
+
+        runner = _make_runner(job, output_dir)
+        clock.lap("import")
+        write_progress("ensemble", 0, f"Scoring {total} geometries", total=total)
+
+        # Each member is appended as one line the moment it finishes, so the app can plot the
+        # ensemble while it is still running.
+        with open(stream_path, "w", encoding="utf-8") as stream:
+            for index, geometry in enumerate(geometries):
+                member_start = time.time()
+                member = {"index": index, "success": False, "energy": 0.0, "error": ""}
+                try:
+                    runner.evaluate(geometry, member)
+                    member["success"] = True
+                except Exception as exc:
+                    member["error"] = f"{type(exc).__name__}: {exc}"
+                member["wall_time"] = time.time() - member_start
+                result["ensemble"].append(member)
+                stream.write(json.dumps(member) + "\n")
+                stream.flush()
+                write_progress(
+                    "ensemble",
+                    index + 1,
+                    f"Geometry {index + 1}/{total}",
+                    total=total,
+                    energy=member["energy"],
+                )
+        clock.lap("ensemble")
+
+        energies = [member["energy"] for member in result["ensemble"] if member["success"]]
+        if not energies:
+            raise RuntimeError(f"No geometry succeeded; first error: {result['ensemble'][0]['error']}")
+        result["total_energy"] = float(min(energies))
+        failed = total - len(energies)
+        if failed:
+            result["error"] = f"{failed} of {total} geometries failed"
+        result["success"] = True
+    except Exception as exc:
+        result["success"] = False
+        result["error"] = f"{type(exc).__name__}: {exc}\n{traceback.format_exc()}"
+
+    result["wall_time"] = time.time() - start_time
+    result["timings"] = clock.to_json()
+    write_progress("done")
+
+    with open(os.path.join(output_dir, "result.json"), "w", encoding="utf-8") as f:
+        json.dump(result, f, indent=2, default=str)
+
+
+if __name__ == "__main__":
+    main()
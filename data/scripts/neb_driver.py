@@ -3,11 +3,146 @@
 
 import json
 import os
+import queue
 import sys
 import time
 import traceback
 
-import numpy as np
+# Imported before the third-party packages so its start time excludes their import time.
+from driver_telemetry import StageClock
+
+import numpy as np  # noqa: E402
+
+HARTREE_TO_EV = 27.2114
+BOHR_TO_ANG = 0.529177
+NEB_FMAX = 0.05
+
+
+def _build_mf(mol, method):
+    from pyscf import dft, scf
+
+    method = str(method).lower()
+    if method in ("hf", "rhf"):
+        mf = scf.RHF(mol)
+    elif method in ("b3lyp", "pbe", "pbe0"):
+        mf = dft.RKS(mol)
+        mf.xc = method
+    else:
+        mf = scf.RHF(mol)
+    mf.verbose = 0
+    return mf
+
+
+def _evaluate_image(job, symbols, positions_ang, dm_guess, want_forces):
+    """SCF (and optionally gradient) for one image; returns energy in Hartree, forces in eV/Angstrom."""
+    from pyscf import gto
+
+    mol = gto.Mole()
+    mol.atom = [[symbol, tuple(float(v) for v in pos)] for symbol, pos in zip(symbols, positions_ang)]
+    mol.basis = job["basis"]
+    mol.charge = int(job.get("charge", 0))
+    mol.spin = int(job.get("multiplicity", 1)) - 1
+    mol.unit = "Angstrom"
+    mol.verbose = 0
+    mol.build()
+
+    mf = _build_mf(mol, job["method"])
+    mf.kernel(dm0=dm_guess)
+    forces = None
+    if want_forces:
+        grad = mf.nuc_grad_method().kernel()
+        forces = -np.asarray(grad) * HARTREE_TO_EV / BOHR_TO_ANG
+    return float(mf.e_tot), forces, bool(getattr(mf, "converged", False)), mf.make_rdm1()
+
+
+def _image_worker(job, symbols, threads, tasks, results):
+    from pyscf import lib
+
+    lib.num_threads(threads)
+    densities = {}
+    while True:
+        task = tasks.get()
+        if task is None:
+            break
+        index, positions, want_forces = task
+        try:
+            energy, forces, converged, dm = _evaluate_image(job, symbols, positions, densities.get(index), want_forces)
+            densities[index] = dm
+            results.put(("ok", index, energy, forces, converged))
+        except Exception as exc:
+            results.put(("error", index, f"{type(exc).__name__}: {exc}\n{traceback.format_exc()}"))
+
+
+class ImagePool:
+    """Evaluates NEB images concurrently in forked worker processes.
+
+    Image i is always sent to the same worker, which keeps that image's last converged
+    density and uses it as the SCF guess when the image moves in the next iteration.
+    """
+
+    def __init__(self, job, symbols, workers):
+        self.job = job
+        self.symbols = symbols
+        self.workers = max(1, int(workers))
+        self.densities = {}
+        self.processes = []
+        self.tasks = []
+        if self.workers == 1:
+            return
+
+        import multiprocessing
+
+        context = multiprocessing.get_context("fork")
+        self.results = context.Queue()
+        threads = max(1, (os.cpu_count() or 1) // self.workers)
+        for _ in range(self.workers):
+            tasks = context.Queue()
+            process = context.Process(
+                target=_image_worker,
+                args=(job, symbols, threads, tasks, self.results),
+                daemon=True,
+            )
+            process.start()
+            self.tasks.append(tasks)
+            self.processes.append(process)
+
+    def evaluate(self, requests):
+        """requests: [(index, positions_ang, want_forces)] -> {index: (energy, forces, scf_converged)}"""
+        evaluations = {}
+        if not self.processes:
+            for index, positions, want_forces in requests:
+                energy, forces, converged, dm = _evaluate_image(
+                    self.job, self.symbols, positions, self.densities.get(index), want_forces
+                )
+                self.densities[index] = dm
+                evaluations[index] = (energy, forces, converged)
+            return evaluations
+
+        for index, positions, want_forces in requests:
+            self.tasks[index % self.workers].put((index, np.asarray(positions, dtype=float), want_forces))
+        while len(evaluations) < len(requests):
+            try:
+                message = self.results.get(timeout=1.0)
+            except queue.Empty:
+                if not all(process.is_alive() for process in self.processes):
+                    raise RuntimeError("NEB image worker exited unexpectedly")
+                continue
+            if message[0] == "error":
+                raise RuntimeError(f"Image {message[1]} failed: {message[2]}")
+            _, index, energy, forces, converged = message
+            evaluations[index] = (energy, forces, converged)
+        return evaluations
+
+    def close(self):
+        for tasks in self.tasks:
+            tasks.put(None)
+        for process in self.processes:
+            process.join(timeout=5.0)
+            if process.is_alive():
+                process.terminate()
+                process.join()
+        self.processes = []
+        self.tasks = []
 
 
 def main():
@@ -23,10 +158,10 @@ def main():
 
     progress_path = os.path.join(output_dir, "progress.json")
 
-    def write_progress(stage, step=0, message=""):
+    def write_progress(stage, step=0, message="", **extra):
         with open(progress_path, "w", encoding="utf-8") as pf:
             json.dump(
-                {"stage": stage, "step": step, "message": message, "timestamp": time.time()},
+                {"stage": stage, "step": step, "message": message, "timestamp": time.time(), **extra},
                 pf,
             )
 
@@ -40,28 +175,21 @@ def main():
         "forward_barrier": 0.0,
         "reverse_barrier": 0.0,
         "converged": False,
+        "workers": 1,
         "wall_time": 0.0,
     }
 
     start_time = time.time()
+    clock = StageClock()
+    pool = None
 
     try:
-        from pyscf import dft, gto, scf
         from pyscf.data import elements
 
-        bohr_to_ang = 0.529177
-
-        def geom_to_pyscf(geom):
-            atom_list = []
-            for atomic_number, coords in geom:
-                symbol = elements.ELEMENTS[atomic_number]
-                x, y, z = [float(c) * bohr_to_ang for c in coords]
-                atom_list.append([symbol, (x, y, z)])
-            return atom_list
-
-        reactant_atoms = geom_to_pyscf(job["reactant"])
-        product_atoms = geom_to_pyscf(job["product"])
+        clock.lap("import")
         num_images = int(job.get("num_images", 9))
+        atomic_numbers = [int(atomic_number) for atomic_number, _ in job["reactant"]]
+        symbols = [elements.ELEMENTS[z] for z in atomic_numbers]
 
         write_progress("interpolating", message="Generating initial path")
 
@@ -73,74 +201,106 @@ def main():
             t = i / max(1, num_images - 1)
             images_coords.append(reactant_coords * (1.0 - t) + product_coords * t)
 
+        workers = max(1, min(int(job.get("neb_workers", 1)), max(1, num_images - 2)))
+        pool = ImagePool(job, symbols, workers)
+        result["workers"] = workers
+        clock.lap("setup")
+
         try:
             from ase import Atoms
             from ase.calculators.calculator import Calculator, all_changes
             from ase.mep import NEB
             from ase.optimize import BFGS
 
-            class PySCFCalculator(Calculator):
+            class PooledPySCFCalculator(Calculator):
                 implemented_properties = ["energy", "forces"]
 
-                def __init__(self, method, basis, charge, spin, **kwargs):
+                def __init__(self, image_pool, index, **kwargs):
                     super().__init__(**kwargs)
-                    self.method = method
-                    self.basis = basis
-                    self.charge = charge
-                    self.spin = spin
+                    self.image_pool = image_pool
+                    self.index = index
+                    self.scf_converged = False
+
+                def store(self, atoms, evaluation):
+                    energy, forces, converged = evaluation
+                    self.atoms = atoms.copy()
+                    self.results = {"energy": energy * HARTREE_TO_EV}
+                    if forces is not None:
+                        self.results["forces"] = forces
+                    self.scf_converged = converged
 
                 def calculate(self, atoms=None, properties=None, system_changes=all_changes):
-                    super().calculate(atoms, properties or ["energy"], system_changes)
-
-                    mol = gto.Mole()
-                    atom_list = []
-                    for symbol, pos in zip(atoms.get_chemical_symbols(), atoms.get_positions()):
-                        atom_list.append([symbol, tuple(pos)])
-                    mol.atom = atom_list
-                    mol.basis = self.basis
-                    mol.charge = self.charge
-                    mol.spin = self.spin
-                    mol.unit = "Angstrom"
-                    mol.verbose = 0
-                    mol.build()
-
-                    method = str(self.method).lower()
-                    if method in ("hf", "rhf"):
-                        mf = scf.RHF(mol)
-                    elif method in ("b3lyp", "pbe", "pbe0"):
-                        mf = dft.RKS(mol)
-                        mf.xc = method
-                    else:
-                        mf = scf.RHF(mol)
-
-                    mf.verbose = 0
-                    mf.kernel()
-                    self.results["energy"] = float(mf.e_tot) * 27.2114
-                    grad = mf.nuc_grad_method().kernel()
-                    self.results["forces"] = -grad * 27.2114 / 0.529177
-
-            atomic_numbers = [atomic_number for atomic_number, _ in job["reactant"]]
+                    properties = properties or ["energy"]
+                    super().calculate(atoms, properties, system_changes)
+                    request = (self.index, self.atoms.get_positions(), "forces" in properties)
+                    self.store(self.atoms, self.image_pool.evaluate([request])[self.index])
+
+            class ParallelNEB(NEB):
+                """Evaluates every stale image in one concurrent batch before ASE asks for them serially."""
+
+                iteration = 0
+
+                def prefetch(self, indices, want_forces):
+                    requests = []
+                    for index in indices:
+                        atoms = self.images[index]
+                        calc = atoms.calc
+                        have = "forces" in calc.results if want_forces else "energy" in calc.results
+                        if calc.check_state(atoms) or not have:
+                            requests.append((index, atoms.get_positions(), want_forces))
+                    if requests:
+                        for index, evaluation in pool.evaluate(requests).items():
+                            self.images[index].calc.store(self.images[index], evaluation)
+
+                def get_forces(self):
+                    self.prefetch(range(1, len(self.images) - 1), True)
+                    forces = super().get_forces()
+                    self.iteration += 1
+                    self.report(forces)
+                    return forces
+
+                def report(self, forces):
+                    interior = self.images[1:-1]
+                    per_image = np.asarray(forces).reshape(len(interior), -1, 3)
+                    images = []
+                    for offset, atoms in enumerate(interior):
+                        max_force = float(np.sqrt((per_image[offset] ** 2).sum(axis=1)).max())
+                        images.append(
+                            {
+                                "index": offset + 1,
+                                "energy": float(atoms.calc.results["energy"]) / HARTREE_TO_EV,
+                                "max_force": max_force,
+                                "scf_converged": bool(atoms.calc.scf_converged),
+                                "converged": max_force < NEB_FMAX,
+                            }
+                        )
+                    converged = sum(1 for image in images if image["converged"])
+                    write_progress(
+                        "neb",
+                        converged,
+                        f"Iteration {self.iteration}: max force {max(i['max_force'] for i in images):.4f} eV/A",
+                        iteration=self.iteration,
+                        total=len(images),
+                        energy=max(i["energy"] for i in images),
+                        images=images,
+                    )
+
             ase_images = []
             for i in range(num_images):
-                coords_ang = images_coords[i] * bohr_to_ang
-                atoms = Atoms(numbers=atomic_numbers, positions=coords_ang)
-                atoms.calc = PySCFCalculator(
-                    method=job["method"],
-                    basis=job["basis"],
-                    charge=int(job.get("charge", 0)),
-                    spin=int(job.get("multiplicity", 1)) - 1,
-                )
+                atoms = Atoms(numbers=atomic_numbers, positions=images_coords[i] * BOHR_TO_ANG)
+                atoms.calc = PooledPySCFCalculator(pool, i)
                 ase_images.append(atoms)
 
-            write_progress("neb", message="Running NEB optimization")
-            neb = NEB(ase_images, climb=True)
+            write_progress("neb", message=f"Running NEB optimization ({workers} workers)")
+            neb = ParallelNEB(ase_images, climb=True)
             optimizer = BFGS(neb, trajectory=os.path.join(output_dir, "neb.traj"))
-            optimizer.run(fmax=0.05, steps=int(job.get("max_neb_steps", 50)))
+            optimizer.run(fmax=NEB_FMAX, steps=int(job.get("max_neb_steps", 50)))
+            neb.prefetch([0, num_images - 1], False)
 
             for atoms in ase_images:
-                energy_hartree = atoms.get_potential_energy() / 27.2114
+                energy_hartree = atoms.get_potential_energy() / HARTREE_TO_EV
                 result["path_energies"].append(float(energy_hartree))
-                coords_bohr = (atoms.get_positions() / bohr_to_ang).tolist()
+                coords_bohr = (atoms.get_positions() / BOHR_TO_ANG).tolist()
                 geom = [[int(z), [float(v) for v in coords]] for z, coords in zip(atomic_numbers, coords_bohr)]
                 result["path_geometries"].append(geom)
 
@@ -148,38 +308,13 @@ def main():
         except ImportError:
             write_progress("single_points", message="ASE not available, computing single-point energies along linear path")
 
+            requests = [(i, images_coords[i] * BOHR_TO_ANG, False) for i in range(num_images)]
+            evaluations = pool.evaluate(requests)
             for i in range(num_images):
-                write_progress("single_points", i, message=f"Image {i + 1}/{num_images}")
-
-                mol = gto.Mole()
-                coords_ang = images_coords[i] * bohr_to_ang
-                atom_list = []
-                for atom_index, (atomic_number, _) in enumerate(job["reactant"]):
-                    symbol = elements.ELEMENTS[atomic_number]
-                    atom_list.append([symbol, tuple(coords_ang[atom_index])])
-                mol.atom = atom_list
-                mol.basis = job["basis"]
-                mol.charge = int(job.get("charge", 0))
-                mol.spin = int(job.get("multiplicity", 1)) - 1
-                mol.unit = "Angstrom"
-                mol.verbose = 0
-                mol.build()
-
-                method = str(job["method"]).lower()
-                if method in ("hf", "rhf"):
-                    mf = scf.RHF(mol)
-                elif method in ("b3lyp", "pbe", "pbe0"):
-                    mf = dft.RKS(mol)
-                    mf.xc = method
-                else:
-                    mf = scf.RHF(mol)
-                mf.verbose = 0
-                mf.kernel()
-
-                result["path_energies"].append(float(mf.e_tot))
+                result["path_energies"].append(float(evaluations[i][0]))
                 result["path_geometries"].append(
-                    [[int(atomic_number), [float(v) for v in images_coords[i][atom_index]]]
-                     for atom_index, (atomic_number, _) in enumerate(job["reactant"])]
+                    [[atomic_number, [float(v) for v in images_coords[i][atom_index]]]
+                     for atom_index, atomic_number in enumerate(atomic_numbers)]
                 )
 
             result["converged"] = False
@@ -193,12 +328,17 @@ def main():
             result["forward_barrier"] = float(energies[ts_idx] - energies[0])
             result["reverse_barrier"] = float(energies[ts_idx] - energies[-1])
 
+        clock.lap("neb")
         result["success"] = True
     except Exception as exc:
         result["success"] = False
         result["error"] = f"{type(exc).__name__}: {exc}\n{traceback.format_exc()}"
+    finally:
+        if pool is not None:
+            pool.close()
 
     result["wall_time"] = time.time() - start_time
+    result["timings"] = clock.to_json()
     write_progress("done")
 
     with open(os.path.join(output_dir, "result.json"), "w", encoding="utf-8") as f:
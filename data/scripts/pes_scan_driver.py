@@ -4,11 +4,15 @@
 import copy
 import json
 import os
+import queue
 import sys
 import time
 import traceback
 
-import numpy as np
+# Imported before the third-party packages so its start time excludes their import time.
+from driver_telemetry import StageClock
+
+import numpy as np  # noqa: E402
 
 
 def _write_progress(progress_path, stage, step=0, total=0, energy=0.0, message=""):
@@ -60,6 +64,37 @@ def _build_method(mol, job):
     return mf
 
 
+def _warm_start(mf, reference):
+    """Seed mf with the converged orbitals of the neighbouring scan point and return its density."""
+    if reference is None or getattr(reference, "mo_coeff", None) is None:
+        return None
+    mf.mo_coeff = reference.mo_coeff
+    mf.mo_occ = reference.mo_occ
+    return reference.make_rdm1()
+
+
+def _checkpoint_start(mf, job):
+    """Seed mf from the previous job's checkpoint, without an SCF, and return its (projected) density.
+
+    The checkpoint orbitals are only loaded into mf when the basis and spin treatment match.
+    """
+    from pyscf import scf
+    from pyscf_driver import _initial_guess_dm
+
+    dm = _initial_guess_dm(mf, job)
+    if dm is None:
+        return None
+    try:
+        saved = scf.chkfile.load(job["initial_guess"]["chkfile"], "scf")
+    except Exception:
+        return dm
+    mo_coeff = (saved or {}).get("mo_coeff")
+    if mo_coeff is not None and np.ndim(mo_coeff) == np.ndim(dm) and np.shape(mo_coeff)[-2] == mf.mol.nao_nr():
+        mf.mo_coeff = mo_coeff
+        mf.mo_occ = saved["mo_occ"]
+    return dm
+
+
 def _constraint_line(coord, value):
     coord_type = coord["type"]
     atoms = coord["atoms"]
@@ -83,6 +118,108 @@ def _geometry_to_result(mol):
     return geometry
 
 
+def _scan_order(n1, n2):
+    """Grid indices (value_2-major) in serpentine order so consecutive points are neighbours."""
+    order = []
+    for j in range(n2):
+        row = range(n1) if j % 2 == 0 else reversed(range(n1))
+        order.extend(j * n1 + i for i in row)
+    return order
+
+
+def _split_chunks(order, workers):
+    """Contiguous, near-equal slices of the walk; each chunk warm-starts point to point."""
+    workers = max(1, min(int(workers), len(order)))
+    base, extra = divmod(len(order), workers)
+    chunks = []
+    start = 0
+    for w in range(workers):
+        size = base + (1 if w < extra else 0)
+        chunks.append(order[start:start + size])
+        start += size
+    return chunks
+
+
+def _run_chunk(job, chunk, values_1, values_2, atom_list, output_dir, emit):
+    """Relaxed scan over one chunk of grid indices, reporting each finished point through emit."""
+    from pyscf import gto
+    from pyscf.geomopt.geometric_solver import optimize as geom_optimize
+
+    scan = job["scan"]
+    coord1 = scan["coordinate_1"]
+    coord2 = scan.get("coordinate_2")
+    n1 = len(values_1)
+    bohr_to_ang = 0.529177
+
+    prev_geometry = copy.deepcopy(atom_list)
+    prev_mf = None
+
+    for grid_idx in chunk:
+        value_1 = values_1[grid_idx % n1]
+        value_2 = values_2[grid_idx // n1]
+
+        mol = gto.Mole()
+        mol.atom = copy.deepcopy(prev_geometry)
+        mol.basis = job["basis"]
+        mol.charge = int(job.get("charge", 0))
+        mol.spin = int(job.get("multiplicity", 1)) - 1
+        mol.unit = "Angstrom"
+        mol.verbose = 0
+        mol.build()
+
+        constraints_lines = [_constraint_line(coord1, value_1)]
+        if coord2 is not None and value_2 is not None:
+            constraints_lines.append(_constraint_line(coord2, value_2))
+
+        constraints_path = os.path.join(output_dir, f"constraints_{grid_idx + 1}.txt")
+        with open(constraints_path, "w", encoding="utf-8") as f:
+            f.write("\n".join(constraints_lines) + "\n")
+
+        mf = _build_method(mol, job)
+        if prev_mf is not None:
+            dm_guess = _warm_start(mf, prev_mf)
+        else:
+            dm_guess = _checkpoint_start(mf, job)
+
+        try:
+            mol_opt = geom_optimize(
+                mf,
+                maxsteps=int(job.get("max_opt_steps", 50)),
+                constraints=constraints_path,
+            )
+            optimized_mf = _build_method(mol_opt, job)
+            optimized_mf.kernel(dm0=dm_guess)
+            if not getattr(optimized_mf, "converged", False):
+                raise RuntimeError("SCF on optimized scan geometry did not converge")
+            energy = float(optimized_mf.e_tot)
+            final_mol = mol_opt
+            prev_mf = optimized_mf
+
+            opt_coords = np.asarray(final_mol.atom_coords(unit="Bohr"), dtype=float)
+            prev_geometry = []
+            for atom_idx in range(final_mol.natm):
+                x, y, z = opt_coords[atom_idx] * bohr_to_ang
+                prev_geometry.append([final_mol.atom_symbol(atom_idx), (float(x), float(y), float(z))])
+        except Exception:
+            mf.kernel(dm0=dm_guess)
+            energy = float(mf.e_tot)
+            final_mol = mol
+            prev_mf = mf if getattr(mf, "converged", False) else prev_mf
+
+        emit(("point", grid_idx, energy, _geometry_to_result(final_mol)))
+
+
+def _chunk_worker(job, chunk, values_1, values_2, atom_list, output_dir, threads, messages):
+    try:
+        from pyscf import lib
+
+        lib.num_threads(threads)
+        _run_chunk(job, chunk, values_1, values_2, atom_list, output_dir, messages.put)
+        messages.put(("done",))
+    except Exception as exc:
+        messages.put(("error", f"{type(exc).__name__}: {exc}\n{traceback.format_exc()}"))
+
+
 def main():
     if len(sys.argv) < 2:
         print("Usage: python3 pes_scan_driver.py job.json", file=sys.stderr)
@@ -103,35 +240,50 @@ def main():
         "geometries": [],
         "coordinate_values_1": [],
         "coordinate_values_2": [],
+        "point_indices": [],
+        "workers": 1,
         "wall_time": 0.0,
     }
 
     start_time = time.time()
+    clock = StageClock()
+    finished = {}
 
     def write_result_snapshot():
+        # Points finish out of order across workers; the snapshot always lists them in grid order.
+        result["energies"] = []
+        result["geometries"] = []
+        result["coordinate_values_1"] = []
+        result["coordinate_values_2"] = []
+        result["point_indices"] = sorted(finished)
+        for grid_idx in result["point_indices"]:
+            value_1, value_2, energy, geometry = finished[grid_idx]
+            result["energies"].append(energy)
+            result["geometries"].append(geometry)
+            result["coordinate_values_1"].append(float(value_1))
+            if value_2 is not None:
+                result["coordinate_values_2"].append(float(value_2))
         with open(os.path.join(output_dir, "result.json"), "w", encoding="utf-8") as f:
             json.dump(result, f, indent=2, default=str)
 
     try:
-        from pyscf import gto
-        from pyscf.geomopt.geometric_solver import optimize as geom_optimize
+        import pyscf  # noqa: F401  (loaded once here; forked workers inherit it)
 
+        clock.lap("import")
         scan = job["scan"]
         scan_type = str(scan["type"]).lower()
         result["scan_type"] = scan_type
 
         coord1 = scan["coordinate_1"]
-        values_1 = np.linspace(float(coord1["start"]), float(coord1["end"]), int(coord1["steps"]))
+        values_1 = [float(v) for v in np.linspace(float(coord1["start"]), float(coord1["end"]), int(coord1["steps"]))]
 
         if scan_type == "2d":
             coord2 = scan["coordinate_2"]
-            values_2 = np.linspace(float(coord2["start"]), float(coord2["end"]), int(coord2["steps"]))
+            values_2 = [float(v) for v in np.linspace(float(coord2["start"]), float(coord2["end"]), int(coord2["steps"]))]
         else:
-            coord2 = None
             values_2 = [None]
 
         total_points = len(values_1) * len(values_2)
-        point_idx = 0
 
         bohr_to_ang = 0.529177
         atom_list = []
@@ -140,78 +292,75 @@ def main():
             x_ang, y_ang, z_ang = [float(c) * bohr_to_ang for c in coords]
             atom_list.append([symbol, (x_ang, y_ang, z_ang)])
 
-        prev_geometry = copy.deepcopy(atom_list)
-
-        for value_2 in values_2:
-            for value_1 in values_1:
-                point_idx += 1
-                _write_progress(
-                    progress_path,
-                    "scanning",
-                    point_idx,
-                    total_points,
-                    message=f"Point {point_idx}/{total_points}",
+        chunks = _split_chunks(_scan_order(len(values_1), len(values_2)), scan.get("workers", 1))
+        result["workers"] = len(chunks)
+
+        def record(message):
+            _, grid_idx, energy, geometry = message
+            finished[grid_idx] = (values_1[grid_idx % len(values_1)], values_2[grid_idx // len(values_1)], energy, geometry)
+            _write_progress(
+                progress_path,
+                "scanning",
+                len(finished),
+                total_points,
+                energy=energy,
+                message=f"Point {len(finished)}/{total_points} ({len(chunks)} workers)",
+            )
+            write_result_snapshot()
+
+        _write_progress(progress_path, "scanning", 0, total_points, message=f"Point 0/{total_points}")
+        clock.lap("setup")
+        if len(chunks) == 1:
+            _run_chunk(job, chunks[0], values_1, values_2, atom_list, output_dir, record)
+        else:
+            import multiprocessing
+
+            context = multiprocessing.get_context("fork")
+            messages = context.Queue()
+            threads = max(1, (os.cpu_count() or 1) // len(chunks))
+            workers = [
+                context.Process(
+                    target=_chunk_worker,
+                    args=(job, chunk, values_1, values_2, atom_list, output_dir, threads, messages),
+                    daemon=True,
                 )
-
-                mol = gto.Mole()
-                mol.atom = copy.deepcopy(prev_geometry)
-                mol.basis = job["basis"]
-                mol.charge = int(job.get("charge", 0))
-                mol.spin = int(job.get("multiplicity", 1)) - 1
-                mol.unit = "Angstrom"
-                mol.verbose = 0
-                mol.build()
-
-                constraints_lines = [_constraint_line(coord1, value_1)]
-                if coord2 is not None and value_2 is not None:
-                    constraints_lines.append(_constraint_line(coord2, value_2))
-
-                constraints_path = os.path.join(output_dir, f"constraints_{point_idx}.txt")
-                with open(constraints_path, "w", encoding="utf-8") as f:
-                    f.write("\n".join(constraints_lines) + "\n")
-
-                mf = _build_method(mol, job)
-
-                try:
-                    mol_opt = geom_optimize(
-                        mf,
-                        maxsteps=int(job.get("max_opt_steps", 50)),
-                        constraints=constraints_path,
-                    )
-                    optimized_mf = _build_method(mol_opt, job)
-                    optimized_mf.kernel()
-                    if not getattr(optimized_mf, "converged", False):
-                        raise RuntimeError("SCF on optimized scan geometry did not converge")
-                    energy = float(optimized_mf.e_tot)
-                    final_mol = mol_opt
-
-                    opt_coords = np.asarray(final_mol.atom_coords(unit="Bohr"), dtype=float)
-                    prev_geometry = []
-                    for atom_idx in range(final_mol.natm):
-                        x, y, z = opt_coords[atom_idx] * bohr_to_ang
-                        prev_geometry.append([final_mol.atom_symbol(atom_idx), (float(x), float(y), float(z))])
-                except Exception:
-                    mf.kernel()
-                    energy = float(mf.e_tot)
-                    final_mol = mol
-
-                result["energies"].append(energy)
-                result["coordinate_values_1"].append(float(value_1))
-                if value_2 is not None:
-                    result["coordinate_values_2"].append(float(value_2))
-                result["geometries"].append(_geometry_to_result(final_mol))
-                write_result_snapshot()
-
+                for chunk in chunks
+            ]
+            for worker in workers:
+                worker.start()
+            try:
+                running = len(workers)
+                while running > 0:
+                    try:
+                        message = messages.get(timeout=1.0)
+                    except queue.Empty:
+                        if not any(worker.is_alive() for worker in workers):
+                            raise RuntimeError("PES scan worker exited without reporting its points")
+                        continue
+                    if message[0] == "point":
+                        record(message)
+                    elif message[0] == "done":
+                        running -= 1
+                    else:
+                        raise RuntimeError(message[1])
+            finally:
+                for worker in workers:
+                    if worker.is_alive():
+                        worker.terminate()
+                    worker.join()
+
+        clock.lap("scan")
         result["success"] = True
     except Exception as exc:
         result["success"] = False
         result["error"] = f"{type(exc).__name__}: {exc}\n{traceback.format_exc()}"
 
     result["wall_time"] = time.time() - start_time
+    result["timings"] = clock.to_json()
     _write_progress(
         progress_path,
         "done",
-        total=len(result["energies"]),
+        total=len(finished),
         energy=result["energies"][-1] if result["energies"] else 0.0,
         message=result["error"],
     )
@@ -9,7 +9,10 @@ import time
 import traceback
 import importlib
 
-import numpy as np
+# Imported before the third-party packages so its start time excludes their import time.
+from driver_telemetry import StageClock
+
+import numpy as np  # noqa: E402
 
 
 def _solvent_dielectric(name):
@@ -118,6 +121,104 @@ def _write_progress(progress_path, stage, iteration=0, energy=0.0, message=""):
         )
 
 
+def _binary_results(job):
+    return job.get("result_format", "json") == "npy"
+
+
+def _save_array(output_dir, manifest, name, array, dtype="<f8", fortran=False, **metadata):
+    """Write a little-endian .npy side-channel array and register it in the result manifest."""
+    filename = f"{name}.npy"
+    data = np.asarray(array, dtype=dtype)
+    if fortran:
+        data = np.asfortranarray(data)
+    np.save(os.path.join(output_dir, filename), data)
+    entry = {"file": filename}
+    entry.update(metadata)
+    manifest[name] = entry
+
+
+def _write_binary_orbitals(output_dir, mol, mf, manifest, molden_tools):
+    """Write a basis-only molden plus MO arrays in molden AO order, so the app skips the text [MO] block."""
+    from pyscf import gto
+
+    if mol.nbas > 0 and int(np.max(mol._bas[:, gto.ANG_OF])) > 4:
+        return False
+
+    with open(os.path.join(output_dir, "basis.molden"), "w", encoding="utf-8") as f:
+        molden_tools.header(mol, f)
+        f.write("[MO]\n")
+
+    mo_coeff = np.asarray(mf.mo_coeff)
+    if mo_coeff.ndim == 3:
+        mo_coeff = np.hstack([mo_coeff[0], mo_coeff[1]])
+    if mol.cart:
+        norm = mol.intor("int1e_ovlp").diagonal() ** 0.5
+        mo_coeff = norm[:, None] * mo_coeff
+    mo_coeff = mo_coeff[molden_tools.order_ao_index(mol)]
+
+    _save_array(output_dir, manifest, "mo_coefficients", mo_coeff, fortran=True)
+    _save_array(output_dir, manifest, "mo_energies", np.asarray(mf.mo_energy).reshape(-1))
+    _save_array(output_dir, manifest, "mo_occupations", np.asarray(mf.mo_occ).reshape(-1))
+    return True
+
+
+def _evaluate_cube_field(mol, kind, payload, nx, ny, nz):
+    """Evaluate a density, orbital or ESP volume on the same grid cubegen would use, without writing text."""
+    from pyscf import df, gto, lib
+    from pyscf.dft import numint
+    from pyscf.tools import cubegen
+
+    cube = cubegen.Cube(mol, nx=nx, ny=ny, nz=nz)
+    coords = cube.get_coords()
+    ngrids = cube.get_ngrids()
+    field = np.empty(ngrids)
+
+    if kind in ("density", "esp"):
+        payload = np.asarray(payload)
+        if payload.ndim == 3:
+            payload = payload[0] + payload[1]
+
+    if kind == "esp":
+        vnuc = np.zeros(ngrids)
+        for i in range(mol.natm):
+            rp = mol.atom_coord(i) - coords
+            vnuc += mol.atom_charge(i) / np.sqrt(np.einsum("xi,xi->x", rp, rp))
+        for p0, p1 in lib.prange(0, ngrids, 600):
+            fakemol = gto.fakemol_for_charges(coords[p0:p1])
+            ints = df.incore.aux_e2(mol, fakemol)
+            field[p0:p1] = vnuc[p0:p1] - np.einsum("ijp,ij->p", ints, payload)
+    else:
+        gto_val = "GTOval_cart" if mol.cart else "GTOval"
+        for p0, p1 in lib.prange(0, ngrids, 8000):
+            ao = mol.eval_gto(gto_val, coords[p0:p1])
+            if kind == "density":
+                field[p0:p1] = numint.eval_rho(mol, ao, payload)
+            else:
+                field[p0:p1] = ao @ payload
+
+    def step(axis_points):
+        return float(axis_points[1] - axis_points[0]) if len(axis_points) > 1 else 0.0
+
+    grid = {
+        "origin": [float(v) for v in cube.boxorig],
+        "step_x": [step(cube.xs), 0.0, 0.0],
+        "step_y": [0.0, step(cube.ys), 0.0],
+        "step_z": [0.0, 0.0, step(cube.zs)],
+    }
+    return field.reshape(cube.nx, cube.ny, cube.nz), grid
+
+
+def _initial_guess_dm(mf, job):
+    """Density from a previous job's checkpoint, projected when the basis differs; None if unusable."""
+    chkfile = (job.get("initial_guess") or {}).get("chkfile", "")
+    if not chkfile or not os.path.exists(chkfile):
+        return None
+    try:
+        return mf.from_chk(chkfile)
+    except Exception:
+        return None
+
+
 def _is_dft_method(method):
     return method in ("b3lyp", "pbe", "pbe0", "tpss", "m06-2x", "m062x")
 
@@ -288,6 +389,14 @@ def _run_optimization(mf, mol, job, output_dir, progress_path, result, propertie
     }
     if constraints_path:
         kwargs["constraints"] = constraints_path
+    initial_hessian = job.get("initial_hessian", "")
+    if initial_hessian and os.path.exists(initial_hessian):
+        hessian_cart = np.load(initial_hessian)
+        if hessian_cart.shape == (3 * mol.natm, 3 * mol.natm):
+            # geomeTRIC reads a starting Hessian (Hartree/Bohr^2, Cartesian) from a text matrix.
+            hessian_txt = os.path.join(output_dir, "initial_hessian.txt")
+            np.savetxt(hessian_txt, hessian_cart)
+            kwargs["hessian"] = f"file:{hessian_txt}"
 
     history_path = os.path.join(output_dir, "optimization_history.json")
     optimized_mol = None
@@ -310,7 +419,8 @@ def _run_optimization(mf, mol, job, output_dir, progress_path, result, propertie
             float(job.get("scf_convergence", 1.0e-8)),
             solvent,
         )
-        final_mf.kernel()
+        final_mf.chkfile = os.path.join(output_dir, "scf.chk")
+        final_mf.kernel(dm0=mf.make_rdm1())
         if not getattr(final_mf, "converged", False):
             raise RuntimeError("SCF on optimized geometry did not converge")
         result["total_energy"] = float(final_mf.e_tot)
@@ -318,6 +428,8 @@ def _run_optimization(mf, mol, job, output_dir, progress_path, result, propertie
         if "molden" in properties:
             molden_path = os.path.join(output_dir, "result.molden")
             molden_tools.from_scf(final_mf, molden_path)
+            if _binary_results(job):
+                _write_binary_orbitals(output_dir, optimized_mol, final_mf, result["arrays"], molden_tools)
     except Exception as exc:
         result["optimization_converged"] = False
         result["error"] = f"Optimization failed: {exc}"
@@ -400,12 +512,16 @@ def _extract_ir_intensities(mf):
     return None
 
 
-def _run_frequency_analysis(mol, mf, method, progress_path, energy):
+def _run_frequency_analysis(mol, mf, method, progress_path, energy, output_dir=None, manifest=None):
     if method not in ("hf", "rhf") and not _is_dft_method(method):
         raise ValueError("Frequency calculations are currently supported for HF and DFT methods only")
 
     _write_progress(progress_path, "hessian", energy=energy, message="Computing Hessian")
     hessian_matrix = mf.Hessian().kernel()
+    if manifest is not None:
+        natom = mol.natm
+        hessian_cart = np.asarray(hessian_matrix, dtype=float).transpose(0, 2, 1, 3).reshape(3 * natom, 3 * natom)
+        _save_array(output_dir, manifest, "hessian", hessian_cart)
 
     frequencies_cm1 = None
     normal_modes = None
@@ -473,16 +589,20 @@ def main():
         "ir_intensities": [],
         "normal_modes": [],
         "scf_history": [],
+        "arrays": {},
         "wall_time": 0.0,
     }
 
     start_time = time.time()
+    clock = StageClock()
+    binary = _binary_results(job)
 
     try:
         from pyscf import cc, gto, mp
         from pyscf.tools import cubegen
         from pyscf.tools import molden as molden_tools
 
+        clock.lap("import")
         _write_progress(progress_path, "building_molecule")
 
         atom_list = []
@@ -535,8 +655,13 @@ def main():
             )
 
         mf.callback = scf_callback
-        scf_energy = mf.kernel()
+        mf.chkfile = os.path.join(output_dir, "scf.chk")
+        dm_guess = _initial_guess_dm(mf, job)
+        result["initial_guess"] = "chkfile" if dm_guess is not None else "default"
+        clock.lap("setup")
+        scf_energy = mf.kernel(dm0=dm_guess)
         result["total_energy"] = float(scf_energy)
+        clock.lap("scf")
 
         if not getattr(mf, "converged", False):
             result["error"] = "SCF did not converge"
@@ -554,6 +679,8 @@ def main():
             corr_energy = post_hf.kernel()[0]
             post_hf_energy = float(mf.e_tot + corr_energy)
             result["total_energy"] = post_hf_energy
+        if post_hf_energy is not None:
+            clock.lap("post_hf")
 
         _write_progress(progress_path, "computing_properties", energy=result["total_energy"])
 
@@ -575,7 +702,11 @@ def main():
                 result["lowdin_charges"] = []
 
         try:
-            result["mayer_bond_orders"] = _mayer_bond_orders(mol, dm, overlap)
+            bond_orders = _mayer_bond_orders(mol, dm, overlap)
+            if binary:
+                _save_array(output_dir, result["arrays"], "mayer_bond_orders", bond_orders)
+            else:
+                result["mayer_bond_orders"] = bond_orders
         except Exception:
             result["mayer_bond_orders"] = []
 
@@ -588,57 +719,44 @@ def main():
             _write_progress(progress_path, "writing_molden", energy=result["total_energy"])
             molden_path = os.path.join(output_dir, "result.molden")
             molden_tools.from_scf(mf, molden_path)
+            if binary:
+                _write_binary_orbitals(output_dir, mol, mf, result["arrays"], molden_tools)
 
         cube_res = int(job.get("cube_resolution", 80))
         nx = ny = nz = cube_res
 
+        def emit_cube(name, kind, payload, label):
+            clock.lap("properties")
+            _write_progress(progress_path, "writing_cube", energy=result["total_energy"], message=label)
+            if binary:
+                field, grid = _evaluate_cube_field(mol, kind, payload, nx, ny, nz)
+                _save_array(output_dir, result["arrays"], f"{name}_cube", field, dtype="<f4", comment=label, **grid)
+            else:
+                cube_path = os.path.join(output_dir, f"{name}.cube")
+                if kind == "density":
+                    cubegen.density(mol, cube_path, payload, nx=nx, ny=ny, nz=nz)
+                elif kind == "esp":
+                    cubegen.mep(mol, cube_path, payload, nx=nx, ny=ny, nz=nz)
+                else:
+                    cubegen.orbital(mol, cube_path, payload, nx=nx, ny=ny, nz=nz)
+            clock.lap("cubes")
+
         if "cube_density" in properties:
-            _write_progress(progress_path, "writing_cube", energy=result["total_energy"], message="Electron density")
-            cubegen.density(
-                mol,
-                os.path.join(output_dir, "density.cube"),
-                dm,
-                nx=nx,
-                ny=ny,
-                nz=nz,
-            )
+            emit_cube("density", "density", dm, "Electron density")
 
         occupied = np.where(mo_occ > 0.5)[0]
         homo_idx = int(occupied[-1]) if occupied.size else -1
 
         if "cube_homo" in properties and homo_idx >= 0:
-            _write_progress(progress_path, "writing_cube", energy=result["total_energy"], message="HOMO")
-            cubegen.orbital(
-                mol,
-                os.path.join(output_dir, "homo.cube"),
-                mf.mo_coeff[:, homo_idx],
-                nx=nx,
-                ny=ny,
-                nz=nz,
-            )
+            emit_cube("homo", "orbital", mf.mo_coeff[:, homo_idx], "HOMO")
 
         lumo_idx = homo_idx + 1 if homo_idx >= 0 else -1
         if "cube_lumo" in properties and 0 <= lumo_idx < mo_energy.size:
-            _write_progress(progress_path, "writing_cube", energy=result["total_energy"], message="LUMO")
-            cubegen.orbital(
-                mol,
-                os.path.join(output_dir, "lumo.cube"),
-                mf.mo_coeff[:, lumo_idx],
-                nx=nx,
-                ny=ny,
-                nz=nz,
-            )
+            emit_cube("lumo", "orbital", mf.mo_coeff[:, lumo_idx], "LUMO")
 
         if "cube_esp" in properties:
-            _write_progress(progress_path, "writing_cube", energy=result["total_energy"], message="Electrostatic potential")
-            cubegen.mep(
-                mol,
-                os.path.join(output_dir, "esp.cube"),
-                dm,
-                nx=nx,
-                ny=ny,
-                nz=nz,
-            )
+            emit_cube("esp", "esp", dm, "Electrostatic potential")
+        clock.lap("properties")
 
         optimized_mol = None
         final_mf = mf
@@ -659,6 +777,7 @@ def main():
                 )
             except ImportError:
                 result["error"] = "geomeTRIC not installed, optimization unavailable"
+            clock.lap("optimization")
 
         if job.get("frequencies", False):
             freq_mol = optimized_mol if optimized_mol is not None else mol
@@ -672,10 +791,19 @@ def main():
                 method,
                 progress_path,
                 result["total_energy"],
+                output_dir,
+                result["arrays"] if binary else None,
             )
-            result["frequencies_cm1"] = [float(v) for v in frequencies_cm1]
-            result["ir_intensities"] = [float(v) for v in ir_intensities]
-            result["normal_modes"] = [[float(v) for v in mode] for mode in normal_modes]
+            if binary:
+                _save_array(output_dir, result["arrays"], "frequencies_cm1", frequencies_cm1)
+                _save_array(output_dir, result["arrays"], "ir_intensities", ir_intensities)
+                if normal_modes:
+                    _save_array(output_dir, result["arrays"], "normal_modes", np.asarray(normal_modes, dtype=float))
+            else:
+                result["frequencies_cm1"] = [float(v) for v in frequencies_cm1]
+                result["ir_intensities"] = [float(v) for v in ir_intensities]
+                result["normal_modes"] = [[float(v) for v in mode] for mode in normal_modes]
+            clock.lap("frequencies")
 
         if result["error"]:
             result["success"] = False
@@ -693,6 +821,7 @@ def main():
         result["error"] = f"{type(exc).__name__}: {exc}\n{traceback.format_exc()}"
 
     result["wall_time"] = time.time() - start_time
+    result["timings"] = clock.to_json()
 
     _write_progress(progress_path, "done", energy=result["total_energy"], message=result["error"])
     result_path = os.path.join(output_dir, "result.json")
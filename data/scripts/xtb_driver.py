@@ -9,7 +9,10 @@ import sys
 import time
 import traceback
 
-import numpy as np
+# Imported before the third-party packages so its start time excludes their import time.
+from driver_telemetry import StageClock
+
+import numpy as np  # noqa: E402
 
 SYMBOLS = [
     "", "H", "He", "Li", "Be", "B", "C", "N", "O", "F", "Ne",
@@ -377,11 +380,14 @@ def main():
     }
 
     start_time = time.time()
+    clock = StageClock()
+    clock.lap("import")
 
     try:
         geometry = job["geometry"]
         xyz_path = os.path.join(output_dir, "input.xyz")
         _write_xyz(xyz_path, geometry)
+        clock.lap("setup")
 
         write_progress(progress_path, "running_xtb", "Preparing xTB calculation")
 
@@ -399,12 +405,14 @@ def main():
 
         if not used_tblite:
             _run_xtb_cli(job, output_dir, xyz_path, result)
+        clock.lap("xtb")
 
     except Exception as exc:
         result["success"] = False
         result["error"] = f"{type(exc).__name__}: {exc}\n{traceback.format_exc()}"
 
     result["wall_time"] = time.time() - start_time
+    result["timings"] = clock.to_json()
     write_progress(progress_path, "done", message=f"Energy: {result['total_energy']:.6f} Hartree")
 
     result_path = os.path.join(output_dir, "result.json")
@@ -1,7 +1,8 @@
 #version 410 core
 
+// Reads MolRenderer's atom instances as vertices: position + radius, color + Z.
 layout(location = 0) in vec3 a_position;
-layout(location = 1) in vec4 a_color_and_size;
+layout(location = 1) in vec4 a_color_and_z;
 
 uniform mat4 u_view;
 uniform mat4 u_proj;
@@ -9,10 +10,27 @@ uniform vec3 u_camera_pos;
 
 out vec4 v_color;
 
+float point_size_for_element(int z) {
+    if (z == 1) {
+        return 6.0;
+    }
+    if (z == 6 || z == 7) {
+        return 9.0;
+    }
+    if (z == 8) {
+        return 8.5;
+    }
+    if (z == 16) {
+        return 10.0;
+    }
+    return 7.5;
+}
+
 void main() {
     vec4 view_pos = u_view * vec4(a_position, 1.0);
     float distance_to_camera = max(length(a_position - u_camera_pos), 1.0);
+    float size = point_size_for_element(int(a_color_and_z.w + 0.5));
     gl_Position = u_proj * view_pos;
-    gl_PointSize = max(2.0, a_color_and_size.w * 180.0 / distance_to_camera);
-    v_color = vec4(a_color_and_size.rgb, 0.85);
+    gl_PointSize = max(2.0, size * 180.0 / distance_to_camera);
+    v_color = vec4(a_color_and_z.rgb, 0.85);
 }
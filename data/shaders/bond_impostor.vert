@@ -21,6 +21,11 @@ out float v_radius;
 out float v_axis_t;
 
 void main() {
+    // Free instance slots have zero radius and length; clip them before normalizing the axis.
+    if (a_radius <= 0.0) {
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+        return;
+    }
     vec3 axis = normalize(a_pos_b - a_pos_a);
     vec3 midpoint = 0.5 * (a_pos_a + a_pos_b);
     float half_length = 0.5 * length(a_pos_b - a_pos_a) + a_radius;
@@ -0,0 +1,64 @@
+#version 330 core
+
+layout(location = 0) in vec2 a_quad;
+layout(location = 1) in uint a_instance;
+
+// Thirteen floats per bond, the same layout as bond_impostor.vert's attributes.
+uniform samplerBuffer u_bond_instances;
+uniform mat4 u_view;
+uniform mat4 u_proj;
+uniform vec3 u_camera_pos;
+uniform int u_wireframe;
+
+out vec3 v_world_pos;
+out vec3 v_pos_a;
+out vec3 v_pos_b;
+out vec3 v_color_a;
+out vec3 v_color_b;
+out float v_radius;
+out float v_axis_t;
+
+vec3 fetch_vec3(int offset) {
+    return vec3(texelFetch(u_bond_instances, offset).r,
+                texelFetch(u_bond_instances, offset + 1).r,
+                texelFetch(u_bond_instances, offset + 2).r);
+}
+
+void main() {
+    int base = int(a_instance) * 13;
+    vec3 pos_a = fetch_vec3(base);
+    vec3 pos_b = fetch_vec3(base + 3);
+    vec3 color_a = fetch_vec3(base + 6);
+    vec3 color_b = fetch_vec3(base + 9);
+    float radius = texelFetch(u_bond_instances, base + 12).r;
+
+    vec3 axis = normalize(pos_b - pos_a);
+    vec3 midpoint = 0.5 * (pos_a + pos_b);
+    float half_length = 0.5 * length(pos_b - pos_a) + radius;
+    vec3 extended_a = pos_a - axis * radius;
+    vec3 extended_b = pos_b + axis * radius;
+
+    vec3 view_dir = normalize(u_camera_pos - midpoint);
+    vec3 side = cross(view_dir, axis);
+    if (length(side) < 1e-5) {
+        side = vec3(u_view[0][0], u_view[1][0], u_view[2][0]);
+    }
+    side = normalize(side);
+
+    float along = a_quad.x;
+    float width = (u_wireframe != 0) ? 0.0 : a_quad.y * radius;
+    v_world_pos = midpoint + axis * (along * half_length) + side * width;
+    if (u_wireframe != 0) {
+        float t = 0.5 * (a_quad.x + 1.0);
+        v_world_pos = mix(extended_a, extended_b, t);
+    }
+
+    v_pos_a = pos_a;
+    v_pos_b = pos_b;
+    v_color_a = color_a;
+    v_color_b = color_b;
+    v_radius = radius;
+    v_axis_t = clamp(0.5 * (along + 1.0), 0.0, 1.0);
+
+    gl_Position = u_proj * u_view * vec4(v_world_pos, 1.0);
+}
@@ -13,13 +13,25 @@ uniform float u_max_density;
 uniform float u_bound_radius;
 uniform int u_volume_steps;
 uniform int u_isosurface_steps;
+// Progressive refinement: sub-pixel ray offset in NDC, and the shift of every sample in steps.
+uniform vec2 u_jitter;
+uniform float u_sample_offset;
 
 uniform sampler3D u_volume;
 uniform vec3 u_grid_origin;
 uniform mat3 u_world_to_grid;
 uniform ivec3 u_grid_dims;
 
+uniform int u_use_bricks;
+uniform sampler3D u_brick_max;
+uniform vec3 u_brick_origin;
+uniform mat3 u_world_to_brick;
+uniform ivec3 u_brick_dims;
+uniform float u_brick_outside_max;
+
 const vec3 kBackground = vec3(0.04, 0.055, 0.09);
+// Volume samples whose mapped density is below this are treated as invisible when skipping bricks.
+const float kNegligibleDensity = 1e-3;
 
 float sample_volume(vec3 world_pos) {
     vec3 grid_pos = u_world_to_grid * (world_pos - u_grid_origin);
@@ -27,7 +39,7 @@ float sample_volume(vec3 world_pos) {
     if (any(lessThan(uvw, vec3(0.0))) || any(greaterThan(uvw, vec3(1.0)))) {
         return 0.0;
     }
-    return texture(u_volume, uvw).r;
+    return texture(u_volume, uvw.zyx).r;
 }
 
 vec3 density_ramp(float t) {
@@ -65,6 +77,30 @@ vec3 isosurface_shading(vec3 base_color, vec3 p, vec3 view_dir) {
     return base_color * (ambient + diffuse) + vec3(1.0) * (specular + rim);
 }
 
+// Largest |psi| anywhere in the brick containing pos.
+float brick_max_abs(vec3 pos) {
+    vec3 b = u_world_to_brick * (pos - u_brick_origin);
+    ivec3 cell = ivec3(floor(b));
+    if (any(lessThan(cell, ivec3(0))) || any(greaterThanEqual(cell, u_brick_dims))) {
+        return u_brick_outside_max;
+    }
+    return texelFetch(u_brick_max, cell, 0).r;
+}
+
+// Ray parameter at which ro + t * rd leaves the brick it is in at t.
+float brick_exit(vec3 ro, vec3 rd, float t) {
+    vec3 b = u_world_to_brick * (ro + rd * t - u_brick_origin);
+    vec3 d = u_world_to_brick * rd;
+    vec3 far_face = floor(b) + step(vec3(0.0), d);
+    float exit_t = 1e30;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (abs(d[axis]) > 1e-8) {
+            exit_t = min(exit_t, (far_face[axis] - b[axis]) / d[axis]);
+        }
+    }
+    return t + max(exit_t, 0.0);
+}
+
 bool find_isosurface(vec3 ro, vec3 rd, float t_start, float t_end, out vec3 hit_point) {
     int steps = clamp(u_isosurface_steps, 1, 512);
     float step_size = (t_end - t_start) / float(steps);
@@ -73,8 +109,19 @@ bool find_isosurface(vec3 ro, vec3 rd, float t_start, float t_end, out vec3 hit_
     float prev_density = prev_psi * prev_psi;
 
     for (int i = 1; i <= steps; ++i) {
-        float t_curr = t_start + float(i) * step_size;
-        float curr_psi = sample_volume(ro + rd * t_curr);
+        float t_curr = min(t_start + (float(i) + u_sample_offset) * step_size, t_end);
+        vec3 p_curr = ro + rd * t_curr;
+        if (u_use_bricks != 0) {
+            float bound = brick_max_abs(p_curr);
+            if (bound * bound < u_iso_value) {
+                // Resume from the last step still inside the brick; everything up to it is below the isovalue.
+                i = max(i, int(min(floor((brick_exit(ro, rd, t_curr) - t_start) / step_size - u_sample_offset), float(steps))));
+                t_prev = t_start + (float(i) + u_sample_offset) * step_size;
+                prev_density = 0.0;
+                continue;
+            }
+        }
+        float curr_psi = sample_volume(p_curr);
         float curr_density = curr_psi * curr_psi;
 
         if (prev_density < u_iso_value && curr_density >= u_iso_value) {
@@ -101,7 +148,7 @@ bool find_isosurface(vec3 ro, vec3 rd, float t_start, float t_end, out vec3 hit_
 }
 
 void main() {
-    vec2 ray_ndc = 2.0 * uv - vec2(1.0);
+    vec2 ray_ndc = 2.0 * uv - vec2(1.0) + u_jitter;
     vec4 near_clip = vec4(ray_ndc, -1.0, 1.0);
     vec4 far_clip = vec4(ray_ndc, 1.0, 1.0);
 
@@ -141,13 +188,23 @@ void main() {
         float step_size = (t_far - t_near) / float(num_steps);
         vec3 accum_color = vec3(0.0);
         float accum_alpha = 0.0;
+        float visible_psi2 = u_max_density * pow(kNegligibleDensity, 1.0 / max(u_gamma, 1e-3));
 
         for (int i = 0; i < 512; ++i) {
             if (i >= num_steps) {
                 break;
             }
-            float t = t_near + (float(i) + 0.5) * step_size;
+            float t = t_near + (float(i) + 0.5 + u_sample_offset) * step_size;
             vec3 pos = ray_origin + t * ray_dir;
+            if (u_use_bricks != 0) {
+                float bound = brick_max_abs(pos);
+                if (bound * bound < visible_psi2) {
+                    // Jump to the first sample past the brick, keeping the same sample positions.
+                    int next = int(min(ceil((brick_exit(ray_origin, ray_dir, t) - t_near) / step_size - 0.5 - u_sample_offset), float(num_steps)));
+                    i = max(i, next - 1);
+                    continue;
+                }
+            }
             float val = sample_volume(pos);
             float dens = val * val;
             float normalized = clamp(dens / u_max_density, 0.0, 1.0);
@@ -25,7 +25,7 @@ float sample_grid(sampler3D tex, vec3 world_pos) {
     if (any(lessThan(uvw, vec3(0.0))) || any(greaterThan(uvw, vec3(1.0)))) {
         return 0.0;
     }
-    return texture(tex, uvw).r;
+    return texture(tex, uvw.zyx).r;
 }
 
 float sample_density(vec3 world_pos) {
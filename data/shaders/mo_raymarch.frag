@@ -18,36 +18,36 @@ uniform int u_num_mo;
 uniform float u_bound_radius;
 uniform int u_volume_steps;
 uniform int u_isosurface_steps;
-
-uniform sampler2D u_shell_desc;
-uniform sampler2D u_shell_meta;
-uniform sampler2D u_primitives;
-uniform sampler2D u_mo_coeffs;
+// Progressive refinement: sub-pixel ray offset in NDC, and the shift of every sample in steps.
+uniform vec2 u_jitter;
+uniform float u_sample_offset;
+
+uniform samplerBuffer u_shell_desc;
+uniform samplerBuffer u_shell_meta;
+uniform samplerBuffer u_primitives;
+// Coefficient column of u_mo_index only, one texel per basis function.
+uniform samplerBuffer u_mo_coeffs;
+
+uniform int u_use_bricks;
+uniform sampler3D u_brick_max;
+uniform vec3 u_brick_origin;
+uniform mat3 u_world_to_brick;
+uniform ivec3 u_brick_dims;
+uniform float u_brick_outside_max;
 
 const vec3 kBackground = vec3(0.04, 0.055, 0.09);
+// Volume samples whose mapped density is below this are treated as invisible when skipping bricks.
+const float kNegligibleDensity = 1e-3;
 
-vec4 fetch_shell_desc(int i) { return texelFetch(u_shell_desc, ivec2(i, 0), 0); }
-vec4 fetch_shell_meta(int i) { return texelFetch(u_shell_meta, ivec2(i, 0), 0); }
-vec4 fetch_primitive(int i) { return texelFetch(u_primitives, ivec2(i, 0), 0); }
-
-float fetch_mo_coeff(int basis_idx, int mo_idx) {
-    int col = mo_idx / 4;
-    int channel = mo_idx - col * 4;
-    vec4 texel = texelFetch(u_mo_coeffs, ivec2(basis_idx, col), 0);
-    if (channel == 0) return texel.r;
-    if (channel == 1) return texel.g;
-    if (channel == 2) return texel.b;
-    return texel.a;
-}
+vec4 fetch_shell_desc(int i) { return texelFetch(u_shell_desc, i); }
+vec4 fetch_shell_meta(int i) { return texelFetch(u_shell_meta, i); }
+vec4 fetch_primitive(int i) { return texelFetch(u_primitives, i); }
+float fetch_mo_coeff(int basis_idx) { return texelFetch(u_mo_coeffs, basis_idx).r; }
 
 float evaluate_mo(vec3 pos) {
     float mo_val = 0.0;
 
-    for (int s = 0; s < 512; ++s) {
-        if (s >= u_num_shells) {
-            break;
-        }
-
+    for (int s = 0; s < u_num_shells; ++s) {
         vec4 desc = fetch_shell_desc(s);
         vec3 center = desc.xyz;
         int L = int(desc.w + 0.5);
@@ -62,21 +62,18 @@ float evaluate_mo(vec3 pos) {
         float r2 = dot(dr, dr);
 
         float radial = 0.0;
-        for (int p = 0; p < 32; ++p) {
-            if (p >= num_prims) {
-                break;
-            }
+        for (int p = 0; p < num_prims; ++p) {
             vec4 prim = fetch_primitive(first_prim + p);
             radial += prim.y * exp(-prim.x * r2);
         }
 
         if (L == 0) {
             float chi = radial;
-            mo_val += fetch_mo_coeff(first_basis, u_mo_index) * chi;
+            mo_val += fetch_mo_coeff(first_basis) * chi;
         } else if (L == 1) {
-            mo_val += fetch_mo_coeff(first_basis + 0, u_mo_index) * (dr.x * radial);
-            mo_val += fetch_mo_coeff(first_basis + 1, u_mo_index) * (dr.y * radial);
-            mo_val += fetch_mo_coeff(first_basis + 2, u_mo_index) * (dr.z * radial);
+            mo_val += fetch_mo_coeff(first_basis + 0) * (dr.x * radial);
+            mo_val += fetch_mo_coeff(first_basis + 1) * (dr.y * radial);
+            mo_val += fetch_mo_coeff(first_basis + 2) * (dr.z * radial);
         } else if (L == 2) {
             float xx = dr.x * dr.x * radial;
             float yy = dr.y * dr.y * radial;
@@ -86,18 +83,18 @@ float evaluate_mo(vec3 pos) {
             float yz = dr.y * dr.z * radial;
 
             if (num_basis_in_shell == 5) {
-                mo_val += fetch_mo_coeff(first_basis + 0, u_mo_index) * (0.5 * (2.0 * zz - xx - yy));
-                mo_val += fetch_mo_coeff(first_basis + 1, u_mo_index) * (sqrt(3.0) * xz);
-                mo_val += fetch_mo_coeff(first_basis + 2, u_mo_index) * (sqrt(3.0) * yz);
-                mo_val += fetch_mo_coeff(first_basis + 3, u_mo_index) * (0.5 * sqrt(3.0) * (xx - yy));
-                mo_val += fetch_mo_coeff(first_basis + 4, u_mo_index) * (sqrt(3.0) * xy);
+                mo_val += fetch_mo_coeff(first_basis + 0) * (0.5 * (2.0 * zz - xx - yy));
+                mo_val += fetch_mo_coeff(first_basis + 1) * (sqrt(3.0) * xz);
+                mo_val += fetch_mo_coeff(first_basis + 2) * (sqrt(3.0) * yz);
+                mo_val += fetch_mo_coeff(first_basis + 3) * (0.5 * sqrt(3.0) * (xx - yy));
+                mo_val += fetch_mo_coeff(first_basis + 4) * (sqrt(3.0) * xy);
             } else {
-                mo_val += fetch_mo_coeff(first_basis + 0, u_mo_index) * xx;
-                mo_val += fetch_mo_coeff(first_basis + 1, u_mo_index) * yy;
-                mo_val += fetch_mo_coeff(first_basis + 2, u_mo_index) * zz;
-                mo_val += fetch_mo_coeff(first_basis + 3, u_mo_index) * xy;
-                mo_val += fetch_mo_coeff(first_basis + 4, u_mo_index) * xz;
-                mo_val += fetch_mo_coeff(first_basis + 5, u_mo_index) * yz;
+                mo_val += fetch_mo_coeff(first_basis + 0) * xx;
+                mo_val += fetch_mo_coeff(first_basis + 1) * yy;
+                mo_val += fetch_mo_coeff(first_basis + 2) * zz;
+                mo_val += fetch_mo_coeff(first_basis + 3) * xy;
+                mo_val += fetch_mo_coeff(first_basis + 4) * xz;
+                mo_val += fetch_mo_coeff(first_basis + 5) * yz;
             }
         } else if (L == 3) {
             float xx = dr.x * dr.x;
@@ -116,24 +113,24 @@ float evaluate_mo(vec3 pos) {
             float xyz = dr.x * dr.y * dr.z * radial;
 
             if (num_basis_in_shell == 7) {
-                mo_val += fetch_mo_coeff(first_basis + 0, u_mo_index) * (0.5 * dr.z * (2.0 * zz - 3.0 * xx - 3.0 * yy) * radial);
-                mo_val += fetch_mo_coeff(first_basis + 1, u_mo_index) * (sqrt(3.0 / 8.0) * dr.x * (4.0 * zz - xx - yy) * radial);
-                mo_val += fetch_mo_coeff(first_basis + 2, u_mo_index) * (sqrt(3.0 / 8.0) * dr.y * (4.0 * zz - xx - yy) * radial);
-                mo_val += fetch_mo_coeff(first_basis + 3, u_mo_index) * (0.5 * sqrt(15.0) * dr.z * (xx - yy) * radial);
-                mo_val += fetch_mo_coeff(first_basis + 4, u_mo_index) * (sqrt(15.0) * xyz);
-                mo_val += fetch_mo_coeff(first_basis + 5, u_mo_index) * (sqrt(5.0 / 8.0) * dr.x * (xx - 3.0 * yy) * radial);
-                mo_val += fetch_mo_coeff(first_basis + 6, u_mo_index) * (sqrt(5.0 / 8.0) * dr.y * (3.0 * xx - yy) * radial);
+                mo_val += fetch_mo_coeff(first_basis + 0) * (0.5 * dr.z * (2.0 * zz - 3.0 * xx - 3.0 * yy) * radial);
+                mo_val += fetch_mo_coeff(first_basis + 1) * (sqrt(3.0 / 8.0) * dr.x * (4.0 * zz - xx - yy) * radial);
+                mo_val += fetch_mo_coeff(first_basis + 2) * (sqrt(3.0 / 8.0) * dr.y * (4.0 * zz - xx - yy) * radial);
+                mo_val += fetch_mo_coeff(first_basis + 3) * (0.5 * sqrt(15.0) * dr.z * (xx - yy) * radial);
+                mo_val += fetch_mo_coeff(first_basis + 4) * (sqrt(15.0) * xyz);
+                mo_val += fetch_mo_coeff(first_basis + 5) * (sqrt(5.0 / 8.0) * dr.x * (xx - 3.0 * yy) * radial);
+                mo_val += fetch_mo_coeff(first_basis + 6) * (sqrt(5.0 / 8.0) * dr.y * (3.0 * xx - yy) * radial);
             } else {
-                mo_val += fetch_mo_coeff(first_basis + 0, u_mo_index) * xxx;
-                mo_val += fetch_mo_coeff(first_basis + 1, u_mo_index) * yyy;
-                mo_val += fetch_mo_coeff(first_basis + 2, u_mo_index) * zzz;
-                mo_val += fetch_mo_coeff(first_basis + 3, u_mo_index) * xyy;
-                mo_val += fetch_mo_coeff(first_basis + 4, u_mo_index) * xxy;
-                mo_val += fetch_mo_coeff(first_basis + 5, u_mo_index) * xxz;
-                mo_val += fetch_mo_coeff(first_basis + 6, u_mo_index) * xzz;
-                mo_val += fetch_mo_coeff(first_basis + 7, u_mo_index) * yzz;
-                mo_val += fetch_mo_coeff(first_basis + 8, u_mo_index) * yyz;
-                mo_val += fetch_mo_coeff(first_basis + 9, u_mo_index) * xyz;
+                mo_val += fetch_mo_coeff(first_basis + 0) * xxx;
+                mo_val += fetch_mo_coeff(first_basis + 1) * yyy;
+                mo_val += fetch_mo_coeff(first_basis + 2) * zzz;
+                mo_val += fetch_mo_coeff(first_basis + 3) * xyy;
+                mo_val += fetch_mo_coeff(first_basis + 4) * xxy;
+                mo_val += fetch_mo_coeff(first_basis + 5) * xxz;
+                mo_val += fetch_mo_coeff(first_basis + 6) * xzz;
+                mo_val += fetch_mo_coeff(first_basis + 7) * yzz;
+                mo_val += fetch_mo_coeff(first_basis + 8) * yyz;
+                mo_val += fetch_mo_coeff(first_basis + 9) * xyz;
             }
         }
     }
@@ -180,6 +177,30 @@ vec3 isosurface_shading(vec3 base_color, vec3 p, vec3 view_dir) {
     return base_color * (ambient + diffuse) + vec3(1.0) * (specular + rim);
 }
 
+// Largest |psi| anywhere in the brick containing pos.
+float brick_max_abs(vec3 pos) {
+    vec3 b = u_world_to_brick * (pos - u_brick_origin);
+    ivec3 cell = ivec3(floor(b));
+    if (any(lessThan(cell, ivec3(0))) || any(greaterThanEqual(cell, u_brick_dims))) {
+        return u_brick_outside_max;
+    }
+    return texelFetch(u_brick_max, cell, 0).r;
+}
+
+// Ray parameter at which ro + t * rd leaves the brick it is in at t.
+float brick_exit(vec3 ro, vec3 rd, float t) {
+    vec3 b = u_world_to_brick * (ro + rd * t - u_brick_origin);
+    vec3 d = u_world_to_brick * rd;
+    vec3 far_face = floor(b) + step(vec3(0.0), d);
+    float exit_t = 1e30;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (abs(d[axis]) > 1e-8) {
+            exit_t = min(exit_t, (far_face[axis] - b[axis]) / d[axis]);
+        }
+    }
+    return t + max(exit_t, 0.0);
+}
+
 bool find_isosurface(vec3 ro, vec3 rd, float t_start, float t_end, out vec3 hit_point) {
     int steps = clamp(u_isosurface_steps, 1, 512);
     float step_size = (t_end - t_start) / float(steps);
@@ -188,8 +209,19 @@ bool find_isosurface(vec3 ro, vec3 rd, float t_start, float t_end, out vec3 hit_
     float prev_density = prev_psi * prev_psi;
 
     for (int i = 1; i <= steps; ++i) {
-        float t_curr = t_start + float(i) * step_size;
-        float curr_psi = evaluate_mo(ro + rd * t_curr);
+        float t_curr = min(t_start + (float(i) + u_sample_offset) * step_size, t_end);
+        vec3 p_curr = ro + rd * t_curr;
+        if (u_use_bricks != 0) {
+            float bound = brick_max_abs(p_curr);
+            if (bound * bound < u_iso_value) {
+                // Resume from the last step still inside the brick; everything up to it is below the isovalue.
+                i = max(i, int(min(floor((brick_exit(ro, rd, t_curr) - t_start) / step_size - u_sample_offset), float(steps))));
+                t_prev = t_start + (float(i) + u_sample_offset) * step_size;
+                prev_density = 0.0;
+                continue;
+            }
+        }
+        float curr_psi = evaluate_mo(p_curr);
         float curr_density = curr_psi * curr_psi;
 
         if (prev_density < u_iso_value && curr_density >= u_iso_value) {
@@ -216,7 +248,7 @@ bool find_isosurface(vec3 ro, vec3 rd, float t_start, float t_end, out vec3 hit_
 }
 
 void main() {
-    vec2 ray_ndc = 2.0 * uv - vec2(1.0);
+    vec2 ray_ndc = 2.0 * uv - vec2(1.0) + u_jitter;
     vec4 near_clip = vec4(ray_ndc, -1.0, 1.0);
     vec4 far_clip = vec4(ray_ndc, 1.0, 1.0);
 
@@ -261,13 +293,23 @@ void main() {
         float step_size = (t_far - t_near) / float(num_steps);
         vec3 accum_color = vec3(0.0);
         float accum_alpha = 0.0;
+        float visible_psi2 = u_max_density * pow(kNegligibleDensity, 1.0 / max(u_gamma, 1e-3));
 
         for (int i = 0; i < 512; ++i) {
             if (i >= num_steps) {
                 break;
             }
-            float t = t_near + (float(i) + 0.5) * step_size;
+            float t = t_near + (float(i) + 0.5 + u_sample_offset) * step_size;
             vec3 pos = ray_origin + t * ray_dir;
+            if (u_use_bricks != 0) {
+                float bound = brick_max_abs(pos);
+                if (bound * bound < visible_psi2) {
+                    // Jump to the first sample past the brick, keeping the same sample positions.
+                    int next = int(min(ceil((brick_exit(ray_origin, ray_dir, t) - t_near) / step_size - 0.5 - u_sample_offset), float(num_steps)));
+                    i = max(i, next - 1);
+                    continue;
+                }
+            }
             float val = evaluate_mo(pos);
             float dens = val * val;
             float normalized = clamp(dens / u_max_density, 0.0, 1.0);
@@ -23,7 +23,7 @@ float sample_grid(sampler3D tex, vec3 world_pos) {
     if (any(lessThan(uvw, vec3(0.0))) || any(greaterThan(uvw, vec3(1.0)))) {
         return 10.0;
     }
-    return texture(tex, uvw).r;
+    return texture(tex, uvw.zyx).r;
 }
 
 float sample_rdg(vec3 world_pos) {
@@ -36,7 +36,7 @@ float sample_sign_rho(vec3 world_pos) {
     if (any(lessThan(uvw, vec3(0.0))) || any(greaterThan(uvw, vec3(1.0)))) {
         return 0.0;
     }
-    return texture(u_sign_rho, uvw).r;
+    return texture(u_sign_rho, uvw.zyx).r;
 }
 
 vec3 nci_color(float sign_rho, float range) {
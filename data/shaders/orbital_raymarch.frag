@@ -17,6 +17,9 @@ uniform vec2 u_resolution;
 uniform float u_max_density;
 uniform int u_volume_steps;
 uniform int u_isosurface_steps;
+// Progressive refinement: sub-pixel ray offset in NDC, and the shift of every sample in steps.
+uniform vec2 u_jitter;
+uniform float u_sample_offset;
 
 const float PI = 3.14159265358979323846;
 const vec3 kBackground = vec3(0.04, 0.055, 0.09);
@@ -277,7 +280,7 @@ bool find_isosurface(vec3 ro, vec3 rd, float t_start, float t_end, out vec3 hit_
     float prev_density = prev_psi * prev_psi;
 
     for (int i = 1; i <= steps; ++i) {
-        float t_curr = t_start + float(i) * step_size;
+        float t_curr = min(t_start + (float(i) + u_sample_offset) * step_size, t_end);
         float curr_psi = psi(ro + rd * t_curr);
         float curr_density = curr_psi * curr_psi;
 
@@ -305,7 +308,7 @@ bool find_isosurface(vec3 ro, vec3 rd, float t_start, float t_end, out vec3 hit_
 }
 
 void main() {
-    vec2 ray_ndc = 2.0 * uv - vec2(1.0);
+    vec2 ray_ndc = 2.0 * uv - vec2(1.0) + u_jitter;
     vec4 near_clip = vec4(ray_ndc, -1.0, 1.0);
     vec4 far_clip = vec4(ray_ndc, 1.0, 1.0);
 
@@ -360,7 +363,7 @@ void main() {
             if (i >= num_steps) {
                 break;
             }
-            float t = t_near + (float(i) + 0.5) * step_size;
+            float t = t_near + (float(i) + 0.5 + u_sample_offset) * step_size;
             vec3 pos = ray_origin + t * ray_dir;
             float val = psi(pos);
             float dens = val * val;
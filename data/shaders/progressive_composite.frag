@@ -0,0 +1,12 @@
+#version 410 core
+
+in vec2 uv;
+out vec4 frag_color;
+
+uniform sampler2D u_history;
+// Fraction of the history texture the last march covered; coarse frames fill only its corner.
+uniform vec2 u_uv_scale;
+
+void main() {
+    frag_color = vec4(texture(u_history, uv * u_uv_scale).rgb, 1.0);
+}
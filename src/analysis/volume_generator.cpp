@@ -0,0 +1,146 @@
+#include "analysis/volume_generator.h"
+
+#include "core/gaussian_eval.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sbox::analysis {
+
+namespace {
+
+// Basis functions below this magnitude are not evaluated at all.
+constexpr double kScreeningThreshold = 1.0e-10;
+
+sbox::io::CubeData make_cube(const sbox::basis::MOData& mo_data, const VolumeGrid& grid, std::string comment) {
+    if (grid.nx <= 0 || grid.ny <= 0 || grid.nz <= 0 || grid.spacing <= 0.0) {
+        throw std::runtime_error("Volume grid is empty");
+    }
+    sbox::io::CubeData cube;
+    cube.comment1 = std::move(comment);
+    cube.comment2 = "Generated from orbital coefficients";
+    cube.atom_Z = mo_data.atomic_numbers;
+    cube.atom_pos = mo_data.atom_positions;
+    cube.origin = grid.origin;
+    cube.step_x = Eigen::Vector3d(grid.spacing, 0.0, 0.0);
+    cube.step_y = Eigen::Vector3d(0.0, grid.spacing, 0.0);
+    cube.step_z = Eigen::Vector3d(0.0, 0.0, grid.spacing);
+    cube.nx = grid.nx;
+    cube.ny = grid.ny;
+    cube.nz = grid.nz;
+    cube.data.resize(static_cast<std::size_t>(grid.nx) * grid.ny * grid.nz);
+    return cube;
+}
+
+// Fills `cube` one x-slab at a time; slabs are handed out to the workers through a shared counter.
+// `point_value` receives the basis values at a grid point and returns the volume value there.
+template <typename PointValue>
+void fill_volume(const sbox::basis::MOData& mo_data, sbox::io::CubeData& cube, int threads, PointValue point_value) {
+    const std::vector<double> radii2 = sbox::basis::shell_screening_radii2(mo_data.basis, kScreeningThreshold);
+    const int worker_count = std::clamp(threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()), 1, cube.nx);
+    std::atomic<int> next_slab{0};
+
+    // Validate the basis on this thread once; the workers must not throw.
+    std::vector<double> probe;
+    sbox::basis::evaluate_basis_screened(mo_data, radii2, cube.origin, probe);
+
+    auto worker = [&]() {
+        std::vector<double> basis_values;
+        auto evaluate = point_value();
+        for (int ix = next_slab++; ix < cube.nx; ix = next_slab++) {
+            float* slab = cube.data.data() + static_cast<std::size_t>(ix) * cube.ny * cube.nz;
+            for (int iy = 0; iy < cube.ny; ++iy) {
+                for (int iz = 0; iz < cube.nz; ++iz) {
+                    const Eigen::Vector3d point = cube.origin + cube.step_x * ix + cube.step_y * iy + cube.step_z * iz;
+                    sbox::basis::evaluate_basis_screened(mo_data, radii2, point, basis_values);
+                    slab[static_cast<std::size_t>(iy) * cube.nz + iz] = static_cast<float>(evaluate(basis_values));
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < worker_count; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+}  // namespace
+
+VolumeGrid fit_volume_grid(const std::vector<Eigen::Vector3d>& atom_positions, int resolution, double padding) {
+    if (atom_positions.empty()) {
+        throw std::runtime_error("Cannot fit a volume grid without atoms");
+    }
+    resolution = std::max(resolution, 2);
+
+    Eigen::Vector3d lo = atom_positions.front();
+    Eigen::Vector3d hi = atom_positions.front();
+    for (const Eigen::Vector3d& position : atom_positions) {
+        lo = lo.cwiseMin(position);
+        hi = hi.cwiseMax(position);
+    }
+    lo.array() -= padding;
+    hi.array() += padding;
+    const Eigen::Vector3d extent = hi - lo;
+
+    VolumeGrid grid;
+    grid.spacing = std::max(extent.maxCoeff(), 1.0e-3) / static_cast<double>(resolution - 1);
+    const auto points_along = [&grid](double length) {
+        return std::max(2, static_cast<int>(std::ceil(length / grid.spacing - 1.0e-9)) + 1);
+    };
+    grid.nx = points_along(extent.x());
+    grid.ny = points_along(extent.y());
+    grid.nz = points_along(extent.z());
+    // Centre the (slightly larger) rounded grid on the box.
+    const Eigen::Vector3d covered = grid.spacing * Eigen::Vector3d(grid.nx - 1, grid.ny - 1, grid.nz - 1);
+    grid.origin = lo - 0.5 * (covered - extent);
+    return grid;
+}
+
+sbox::io::CubeData evaluate_orbital_volume(const sbox::basis::MOData& mo_data,
+                                           int mo_index,
+                                           const VolumeGrid& grid,
+                                           int threads) {
+    if (mo_index < 0 || mo_index >= mo_data.coefficients.cols()) {
+        throw std::runtime_error("MO index out of range");
+    }
+    if (mo_data.coefficients.rows() != mo_data.basis.num_basis_functions()) {
+        throw std::runtime_error("MO coefficient row count does not match basis function count");
+    }
+    sbox::io::CubeData cube = make_cube(mo_data, grid, "MO " + std::to_string(mo_index + 1));
+    const Eigen::VectorXd coefficients = mo_data.coefficients.col(mo_index);
+    fill_volume(mo_data, cube, threads, [&coefficients]() {
+        return [&coefficients](const std::vector<double>& basis_values) {
+            return Eigen::Map<const Eigen::VectorXd>(basis_values.data(), static_cast<Eigen::Index>(basis_values.size()))
+                .dot(coefficients);
+        };
+    });
+    return cube;
+}
+
+sbox::io::CubeData evaluate_density_volume(const sbox::basis::MOData& mo_data, const VolumeGrid& grid, int threads) {
+    const Eigen::MatrixXd density = sbox::basis::density_matrix(mo_data);
+    if (density.rows() != mo_data.basis.num_basis_functions()) {
+        throw std::runtime_error("MO coefficient row count does not match basis function count");
+    }
+
+    sbox::io::CubeData cube = make_cube(mo_data, grid, "Electron density");
+    fill_volume(mo_data, cube, threads, [&density]() {
+        return [&density, active = std::vector<int>()](const std::vector<double>& basis_values) mutable {
+            return sbox::basis::contract_density(density, basis_values, active);
+        };
+    });
+    return cube;
+}
+
+}  // namespace sbox::analysis
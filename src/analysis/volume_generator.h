@@ -0,0 +1,36 @@
+#pragma once
+
+#include "core/basis_set.h"
+#include "io/cube_io.h"
+
+#include <Eigen/Core>
+
+#include <vector>
+
+namespace sbox::analysis {
+
+struct VolumeGrid {
+    Eigen::Vector3d origin = Eigen::Vector3d::Zero();
+    double spacing = 0.0;  // bohr, identical along every axis
+    int nx = 0;
+    int ny = 0;
+    int nz = 0;
+};
+
+// Box around the atoms plus `padding` bohr on every side, with cubic voxels sized so that the
+// longest side gets `resolution` points. Elongated molecules get fewer points on the short axes.
+VolumeGrid fit_volume_grid(const std::vector<Eigen::Vector3d>& atom_positions, int resolution, double padding = 4.0);
+
+// Both evaluate the orbitals natively on `threads` worker threads (0 = one per hardware thread).
+sbox::io::CubeData evaluate_orbital_volume(const sbox::basis::MOData& mo_data,
+                                           int mo_index,
+                                           const VolumeGrid& grid,
+                                           int threads = 0);
+
+// Total electron density, sum_i n_i |psi_i|^2 over the occupied orbitals, evaluated as phi^T D phi
+// over the basis functions that reach each grid point.
+sbox::io::CubeData evaluate_density_volume(const sbox::basis::MOData& mo_data,
+                                           const VolumeGrid& grid,
+                                           int threads = 0);
+
+}  // namespace sbox::analysis
@@ -4,14 +4,18 @@
 #include "core/logging.h"
 #include "core/molden_parser.h"
 #include "core/paths.h"
+#include "io/npy_io.h"
 
 #include <json.hpp>
 
 #include <Eigen/Core>
 
+#include <algorithm>
 #include <chrono>
+#include <cerrno>
 #include <csignal>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -23,6 +27,7 @@
 #include <vector>
 
 #include <fcntl.h>
+#include <sys/resource.h>
 #include <sys/wait.h>
 
 namespace sbox::backend {
@@ -31,6 +36,13 @@ namespace {
 
 using json = nlohmann::json;
 
+constexpr const char* kScfCheckpointName = "scf.chk";
+
+std::string scf_checkpoint_path(const std::string& work_dir) {
+    const std::filesystem::path path = std::filesystem::path(work_dir) / kScfCheckpointName;
+    return std::filesystem::exists(path) ? path.string() : std::string{};
+}
+
 std::string property_to_string(PropertyRequest property) {
     switch (property) {
     case PropertyRequest::MullikenCharges: return "mulliken";
@@ -57,6 +69,14 @@ std::string scan_coord_type_to_string(JobSpec::ScanSpec::CoordType type) {
     return "distance";
 }
 
+void remove_work_dir(const std::string& work_dir) {
+    std::error_code ec;
+    std::filesystem::remove_all(work_dir, ec);
+    if (ec) {
+        SBOX_LOG_WARN("Failed to remove work directory %s: %s", work_dir.c_str(), ec.message().c_str());
+    }
+}
+
 double vec3_component_or_zero(const json& j, std::size_t index) {
     if (!j.is_array() || j.size() <= index) {
         return 0.0;
@@ -64,6 +84,59 @@ double vec3_component_or_zero(const json& j, std::size_t index) {
     return j[index].get<double>();
 }
 
+Eigen::Vector3d vec3_from_json(const json& j) {
+    return Eigen::Vector3d(vec3_component_or_zero(j, 0), vec3_component_or_zero(j, 1), vec3_component_or_zero(j, 2));
+}
+
+// Resolves an entry of the result.json "arrays" manifest to a file inside the job directory.
+std::filesystem::path binary_array_path(const json& arrays, const char* name, const std::string& work_dir) {
+    if (!arrays.is_object() || !arrays.contains(name)) {
+        return {};
+    }
+    const json& entry = arrays[name];
+    const std::string file = entry.is_string() ? entry.get<std::string>() : entry.value("file", std::string{});
+    if (file.empty()) {
+        return {};
+    }
+    return std::filesystem::path(work_dir) / std::filesystem::path(file).filename();
+}
+
+sbox::io::CubeData cube_from_npy(const json& entry,
+                                 const std::filesystem::path& path,
+                                 const sbox::chem::MolecularSystem& geometry) {
+    sbox::io::CubeData cube;
+    std::vector<std::size_t> shape;
+    cube.data = sbox::io::read_npy_floats(path.string(), &shape);
+    if (shape.size() != 3) {
+        throw std::runtime_error("Binary cube must be a 3-D array: " + path.string());
+    }
+    cube.nx = static_cast<int>(shape[0]);
+    cube.ny = static_cast<int>(shape[1]);
+    cube.nz = static_cast<int>(shape[2]);
+    cube.comment1 = entry.value("comment", path.stem().string());
+    cube.comment2 = "binary volume from driver";
+    cube.origin = vec3_from_json(entry.value("origin", json::array()));
+    cube.step_x = vec3_from_json(entry.value("step_x", json::array()));
+    cube.step_y = vec3_from_json(entry.value("step_y", json::array()));
+    cube.step_z = vec3_from_json(entry.value("step_z", json::array()));
+    cube.atom_Z.reserve(geometry.atoms().size());
+    cube.atom_pos.reserve(geometry.atoms().size());
+    for (const auto& atom : geometry.atoms()) {
+        cube.atom_Z.push_back(atom.Z);
+        cube.atom_pos.push_back(atom.position);
+    }
+    return cube;
+}
+
+void append_error(JobResult& result, const std::string& message) {
+    if (result.error_message.empty()) {
+        result.error_message = message;
+    } else {
+        result.error_message += "\n";
+        result.error_message += message;
+    }
+}
+
 json load_json_file(const std::filesystem::path& path) {
     std::ifstream in(path);
     if (!in) {
@@ -92,6 +165,20 @@ sbox::chem::MolecularSystem geometry_from_json(const json& atoms_json) {
     return mol;
 }
 
+JobResult::EnsembleMember ensemble_member_from_json(const json& entry) {
+    JobResult::EnsembleMember member;
+    member.index = entry.value("index", 0);
+    member.success = entry.value("success", false);
+    member.energy = entry.value("energy", 0.0);
+    member.dipole_moment = vec3_from_json(entry.value("dipole_moment", json::array()));
+    if (entry.contains("mulliken_charges") && entry["mulliken_charges"].is_array()) {
+        member.mulliken_charges = entry["mulliken_charges"].get<std::vector<double>>();
+    }
+    member.wall_time_seconds = entry.value("wall_time", 0.0);
+    member.error = entry.value("error", std::string{});
+    return member;
+}
+
 sbox::chem::MolecularSystem geometry_from_xyz_frame(const std::vector<std::string>& atom_lines) {
     sbox::chem::MolecularSystem mol;
     constexpr double ang_to_bohr = 1.8897;
@@ -142,8 +229,138 @@ std::vector<sbox::chem::MolecularSystem> read_xyz_trajectory(const std::filesyst
     return frames;
 }
 
+// Copies what a typed edge carries from a converged upstream result into the downstream spec.
+// Returns an error when the edge requires something the upstream result does not have; orbitals
+// and Hessians only warm-start the downstream job, so their absence is not an error.
+std::string apply_dependency(JobDependency::Kind kind, const JobResult& upstream, JobSpec& spec) {
+    switch (kind) {
+    case JobDependency::Kind::After:
+        break;
+    case JobDependency::Kind::GeometryFrom: {
+        const sbox::chem::MolecularSystem* geometry = nullptr;
+        if (upstream.has_optimized_geometry) {
+            geometry = &upstream.optimized_geometry;
+        } else if (upstream.has_neb && upstream.neb_result.ts_index >= 0
+                   && upstream.neb_result.ts_index < static_cast<int>(upstream.neb_result.path_geometries.size())) {
+            geometry = &upstream.neb_result.path_geometries[static_cast<std::size_t>(upstream.neb_result.ts_index)];
+        }
+        if (geometry == nullptr) {
+            return "upstream job " + std::to_string(upstream.job_id) + " produced no geometry to continue from";
+        }
+        spec.geometry = *geometry;
+        spec.geometry.set_charge(spec.charge);
+        spec.geometry.set_multiplicity(spec.multiplicity);
+        break;
+    }
+    case JobDependency::Kind::OrbitalsFrom:
+        if (!upstream.scf_checkpoint.empty()) {
+            spec.guess_checkpoint = upstream.scf_checkpoint;
+        }
+        break;
+    case JobDependency::Kind::HessianFrom:
+        if (!upstream.hessian_file.empty()) {
+            spec.initial_hessian = upstream.hessian_file;
+        }
+        break;
+    }
+    return {};
+}
+
+// Drivers lead their own process group so that worker processes they spawn are stopped with them.
+void terminate_driver(pid_t pid) {
+    if (::kill(-pid, SIGTERM) != 0) {
+        ::kill(pid, SIGTERM);
+    }
+}
+
+constexpr std::size_t kTelemetryHistoryLimit = 512;
+
+// Wall-clock seconds since the epoch; comparable with Python's time.time() in the driver.
+double epoch_seconds() {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+double timeval_seconds(const timeval& tv) {
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1.0e-6;
+}
+
+void apply_rusage(const rusage& usage, JobTelemetry& telemetry) {
+    telemetry.user_cpu_seconds = timeval_seconds(usage.ru_utime);
+    telemetry.system_cpu_seconds = timeval_seconds(usage.ru_stime);
+#ifdef __APPLE__
+    telemetry.peak_rss_kb = static_cast<long>(usage.ru_maxrss / 1024);  // bytes on macOS
+#else
+    telemetry.peak_rss_kb = static_cast<long>(usage.ru_maxrss);
+#endif
+}
+
+// Fills the end-of-job times and folds the driver's own stages into the named fields.
+void finish_telemetry(JobTelemetry& telemetry) {
+    telemetry.finished_at = epoch_seconds();
+    telemetry.wall_seconds = std::max(0.0, telemetry.finished_at - telemetry.submitted_at);
+    if (telemetry.spawned_at <= 0.0) {
+        telemetry.queue_wait_seconds = telemetry.wall_seconds;
+        return;
+    }
+    telemetry.queue_wait_seconds = std::max(0.0, telemetry.spawned_at - telemetry.submitted_at);
+    if (telemetry.driver_started_at > 0.0) {
+        telemetry.spawn_seconds = std::max(0.0, telemetry.driver_started_at - telemetry.spawned_at);
+    }
+    for (const auto& [stage, seconds] : telemetry.driver_stages) {
+        if (stage == "import") {
+            telemetry.import_seconds += seconds;
+        } else if (stage == "scf") {
+            telemetry.scf_seconds += seconds;
+        } else if (stage == "properties" || stage == "cubes") {
+            telemetry.properties_seconds += seconds;
+        }
+    }
+}
+
+json telemetry_to_json(const JobTelemetry& telemetry) {
+    json stages = json::array();
+    for (const auto& [stage, seconds] : telemetry.driver_stages) {
+        stages.push_back({stage, seconds});
+    }
+    return {
+        {"job_id", telemetry.job_id},
+        {"driver", telemetry.driver},
+        {"status", job_status_to_string(telemetry.status)},
+        {"submitted_at", telemetry.submitted_at},
+        {"finished_at", telemetry.finished_at},
+        {"queue_wait_s", telemetry.queue_wait_seconds},
+        {"spawn_s", telemetry.spawn_seconds},
+        {"import_s", telemetry.import_seconds},
+        {"scf_s", telemetry.scf_seconds},
+        {"properties_s", telemetry.properties_seconds},
+        {"parse_s", telemetry.parse_seconds},
+        {"wall_s", telemetry.wall_seconds},
+        {"user_cpu_s", telemetry.user_cpu_seconds},
+        {"sys_cpu_s", telemetry.system_cpu_seconds},
+        {"peak_rss_kb", telemetry.peak_rss_kb},
+        {"driver_stages", stages},
+    };
+}
+
 }  // namespace
 
+std::vector<JobResult::EnsembleMember> read_ensemble_stream(const std::filesystem::path& path) {
+    std::vector<JobResult::EnsembleMember> members;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        const json entry = json::parse(line, nullptr, false);
+        if (entry.is_discarded() || !entry.is_object()) {
+            continue;
+        }
+        members.push_back(ensemble_member_from_json(entry));
+    }
+    return members;
+}
+
 BackendManager::BackendManager()
     : scripts_dir_(std::filesystem::path(sbox::get_script_path("pyscf_driver.py")).parent_path().string()) {}
 
@@ -155,7 +372,7 @@ BackendManager::~BackendManager() {
             (void)job_id;
             job->cancelled.store(true);
             if (job->pid > 0) {
-                ::kill(job->pid, SIGTERM);
+                terminate_driver(job->pid);
             }
             jobs.push_back(job.get());
         }
@@ -189,25 +406,113 @@ int BackendManager::submit(const JobSpec& spec) {
     job->spec = job_spec;
     job->work_dir = create_work_dir(job_id);
     job->spec.work_dir = job->work_dir;
+    job->submitted_at = epoch_seconds();
     {
         std::lock_guard<std::mutex> lock(mutex_);
+        for (const JobDependency& dependency : job->spec.dependencies) {
+            const auto running_it = running_jobs_.find(dependency.job_id);
+            if (running_it != running_jobs_.end()) {
+                job->upstream.push_back({dependency, running_it->second->future});
+                continue;
+            }
+            const auto completed_it = completed_jobs_.find(dependency.job_id);
+            if (completed_it == completed_jobs_.end()) {
+                remove_work_dir(job->work_dir);
+                throw std::runtime_error("Job depends on unknown job " + std::to_string(dependency.job_id));
+            }
+            std::promise<JobResultHandle> finished;
+            finished.set_value(completed_it->second);
+            job->upstream.push_back({dependency, finished.get_future().share()});
+        }
         auto [it, inserted] = running_jobs_.emplace(job_id, std::move(job));
         (void)inserted;
         job_ptr = it->second.get();
     }
 
-    job_ptr->future = std::async(std::launch::async, [this, job_ptr]() {
-        return run_job(job_ptr->spec, job_ptr->work_dir, job_ptr->cancelled);
-    });
+    job_ptr->future = std::async(std::launch::async, [this, job_ptr]() -> JobResultHandle {
+        return std::make_shared<const JobResult>(
+            run_job(job_ptr->spec, job_ptr->work_dir, job_ptr->cancelled, job_ptr->upstream, job_ptr->submitted_at));
+    }).share();
 
     return job_id;
 }
 
+std::vector<int> BackendManager::submit_graph(const JobGraph& graph) {
+    const int node_count = static_cast<int>(graph.nodes.size());
+    std::vector<std::vector<const JobGraph::Edge*>> incoming(graph.nodes.size());
+    std::vector<int> pending_inputs(graph.nodes.size(), 0);
+    for (const JobGraph::Edge& edge : graph.edges) {
+        if (edge.from < 0 || edge.from >= node_count || edge.to < 0 || edge.to >= node_count || edge.from == edge.to) {
+            throw std::runtime_error("Job graph edge refers to an invalid node");
+        }
+        incoming[static_cast<std::size_t>(edge.to)].push_back(&edge);
+        ++pending_inputs[static_cast<std::size_t>(edge.to)];
+    }
+
+    // Kahn's algorithm: every node is submitted after its upstream nodes have job ids.
+    std::vector<int> order;
+    for (int node = 0; node < node_count; ++node) {
+        if (pending_inputs[static_cast<std::size_t>(node)] == 0) {
+            order.push_back(node);
+        }
+    }
+    for (std::size_t head = 0; head < order.size(); ++head) {
+        for (const JobGraph::Edge& edge : graph.edges) {
+            if (edge.from == order[head] && --pending_inputs[static_cast<std::size_t>(edge.to)] == 0) {
+                order.push_back(edge.to);
+            }
+        }
+    }
+    if (static_cast<int>(order.size()) != node_count) {
+        throw std::runtime_error("Job graph contains a cycle");
+    }
+
+    // Dependencies on jobs outside the graph are checked up front, so a bad node cannot leave the
+    // nodes before it queued.
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const JobSpec& node : graph.nodes) {
+            for (const JobDependency& dependency : node.dependencies) {
+                if (running_jobs_.find(dependency.job_id) == running_jobs_.end()
+                    && completed_jobs_.find(dependency.job_id) == completed_jobs_.end()) {
+                    throw std::runtime_error("Job depends on unknown job " + std::to_string(dependency.job_id));
+                }
+            }
+        }
+    }
+
+    std::vector<int> job_ids(graph.nodes.size(), -1);
+    try {
+        for (const int node : order) {
+            JobSpec spec = graph.nodes[static_cast<std::size_t>(node)];
+            for (const JobGraph::Edge* edge : incoming[static_cast<std::size_t>(node)]) {
+                spec.dependencies.push_back({job_ids[static_cast<std::size_t>(edge->from)], edge->kind});
+            }
+            job_ids[static_cast<std::size_t>(node)] = submit(spec);
+        }
+    } catch (...) {
+        // Anything submitted before the failure (e.g. a work directory that could not be created)
+        // is cancelled; its dependents are then skipped as well.
+        for (const int job_id : job_ids) {
+            if (job_id >= 0) {
+                cancel(job_id);
+            }
+        }
+        throw;
+    }
+    return job_ids;
+}
+
 bool BackendManager::is_running(int job_id) const {
     std::lock_guard<std::mutex> lock(mutex_);
     return running_jobs_.find(job_id) != running_jobs_.end();
 }
 
+bool BackendManager::has_running_jobs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !running_jobs_.empty();
+}
+
 JobStatus BackendManager::status(int job_id) const {
     std::lock_guard<std::mutex> lock(mutex_);
     const auto running_it = running_jobs_.find(job_id);
@@ -216,15 +521,15 @@ JobStatus BackendManager::status(int job_id) const {
     }
     const auto completed_it = completed_jobs_.find(job_id);
     if (completed_it != completed_jobs_.end()) {
-        return completed_it->second.status;
+        return completed_it->second->status;
     }
     return JobStatus::Pending;
 }
 
-const JobResult* BackendManager::result(int job_id) const {
+JobResultHandle BackendManager::result(int job_id) const {
     std::lock_guard<std::mutex> lock(mutex_);
     const auto it = completed_jobs_.find(job_id);
-    return it != completed_jobs_.end() ? &it->second : nullptr;
+    return it != completed_jobs_.end() ? it->second : nullptr;
 }
 
 std::string BackendManager::work_dir(int job_id) const {
@@ -235,7 +540,7 @@ std::string BackendManager::work_dir(int job_id) const {
     }
     const auto completed_it = completed_jobs_.find(job_id);
     if (completed_it != completed_jobs_.end()) {
-        return completed_it->second.work_dir;
+        return completed_it->second->work_dir;
     }
     return {};
 }
@@ -246,8 +551,8 @@ std::vector<int> BackendManager::poll_completed() {
     for (auto it = running_jobs_.begin(); it != running_jobs_.end();) {
         if (it->second->future.valid()
             && it->second->future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            JobResult completed = it->second->future.get();
-            completed_jobs_[it->first] = completed;
+            const JobResultHandle& finished = completed_jobs_[it->first] = it->second->future.get();
+            record_telemetry(finished->telemetry);
             newly_completed_.push_back(it->first);
             it = running_jobs_.erase(it);
         } else {
@@ -281,7 +586,7 @@ void BackendManager::cancel(int job_id) {
     }
     it->second->cancelled.store(true);
     if (it->second->pid > 0) {
-        ::kill(it->second->pid, SIGTERM);
+        terminate_driver(it->second->pid);
     }
 }
 
@@ -290,6 +595,113 @@ void BackendManager::clear_job(int job_id) {
     completed_jobs_.erase(job_id);
 }
 
+std::vector<JobTelemetry> BackendManager::telemetry() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {telemetry_history_.begin(), telemetry_history_.end()};
+}
+
+BackendManager::TelemetrySummary BackendManager::telemetry_summary(double window_seconds) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TelemetrySummary summary;
+    const double now = epoch_seconds();
+    double earliest_submit = now;
+    std::map<std::string, TelemetrySummary::Stage> stages;
+    auto add_stage = [&stages](const std::string& name, double seconds) {
+        TelemetrySummary::Stage& stage = stages[name];
+        stage.name = name;
+        stage.total_seconds += seconds;
+        ++stage.jobs;
+    };
+
+    for (const JobTelemetry& job : telemetry_history_) {
+        if (job.finished_at < now - window_seconds) {
+            continue;
+        }
+        ++summary.jobs;
+        earliest_submit = std::min(earliest_submit, job.submitted_at);
+        summary.mean_wall_seconds += job.wall_seconds;
+        summary.peak_rss_kb = std::max(summary.peak_rss_kb, job.peak_rss_kb);
+        add_stage("queue", job.queue_wait_seconds);
+        if (job.spawned_at > 0.0) {
+            add_stage("spawn", job.spawn_seconds);
+            add_stage("parse", job.parse_seconds);
+        }
+        for (const auto& [stage, seconds] : job.driver_stages) {
+            add_stage(stage, seconds);
+        }
+    }
+    if (summary.jobs == 0) {
+        return summary;
+    }
+
+    // A session younger than the window is measured from its first job, not from the window start.
+    const double span_seconds = std::max(1.0, std::min(window_seconds, now - earliest_submit));
+    summary.jobs_per_minute = 60.0 * summary.jobs / span_seconds;
+    summary.mean_wall_seconds /= summary.jobs;
+    for (auto& [name, stage] : stages) {
+        (void)name;
+        stage.mean_seconds = stage.total_seconds / stage.jobs;
+        summary.stages.push_back(stage);
+    }
+    std::sort(summary.stages.begin(), summary.stages.end(), [](const auto& a, const auto& b) {
+        return a.total_seconds > b.total_seconds;
+    });
+    return summary;
+}
+
+void BackendManager::set_telemetry_log(const std::string& path, std::uintmax_t max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    telemetry_log_.close();
+    telemetry_log_.clear();
+    telemetry_log_path_ = path;
+    telemetry_log_max_bytes_ = std::max<std::uintmax_t>(max_bytes, 1);
+    telemetry_log_bytes_ = 0;
+    if (path.empty()) {
+        return;
+    }
+    std::error_code ec;
+    const std::uintmax_t existing = std::filesystem::file_size(path, ec);
+    telemetry_log_bytes_ = ec ? 0 : existing;
+    telemetry_log_.open(path, std::ios::out | std::ios::app);
+    if (!telemetry_log_) {
+        SBOX_LOG_WARN("Could not open backend telemetry log %s", path.c_str());
+    }
+}
+
+// Called with mutex_ held.
+void BackendManager::record_telemetry(const JobTelemetry& telemetry) {
+    telemetry_history_.push_back(telemetry);
+    while (telemetry_history_.size() > kTelemetryHistoryLimit) {
+        telemetry_history_.pop_front();
+    }
+    if (!telemetry_log_.is_open()) {
+        return;
+    }
+    if (telemetry_log_bytes_ >= telemetry_log_max_bytes_) {
+        rotate_telemetry_log();
+    }
+    const std::string line = telemetry_to_json(telemetry).dump() + '\n';
+    telemetry_log_ << line;
+    telemetry_log_.flush();
+    telemetry_log_bytes_ += line.size();
+}
+
+// Called with mutex_ held. Keeps one previous log, so the two together stay near twice the cap.
+void BackendManager::rotate_telemetry_log() {
+    telemetry_log_.close();
+    telemetry_log_.clear();
+    std::error_code ec;
+    std::filesystem::rename(telemetry_log_path_, telemetry_log_path_ + ".1", ec);
+    if (ec) {
+        SBOX_LOG_WARN("Could not rotate backend telemetry log %s: %s", telemetry_log_path_.c_str(), ec.message().c_str());
+    }
+    telemetry_log_.open(telemetry_log_path_, std::ios::out | std::ios::trunc);
+    telemetry_log_bytes_ = 0;
+    if (!telemetry_log_) {
+        SBOX_LOG_WARN("Could not open backend telemetry log %s", telemetry_log_path_.c_str());
+    }
+}
+
 bool BackendManager::can_run_pyscf() const {
     return python_env_.is_valid() && python_env_.has_pyscf()
         && std::filesystem::exists(std::filesystem::path(scripts_dir_) / "pyscf_driver.py");
@@ -305,12 +717,50 @@ std::string BackendManager::scripts_dir() const {
     return scripts_dir_;
 }
 
-JobResult BackendManager::run_job(const JobSpec& spec, const std::string& work_dir, std::atomic<bool>& cancelled) {
+JobResult BackendManager::run_job(const JobSpec& job_spec,
+                                  const std::string& work_dir,
+                                  std::atomic<bool>& cancelled,
+                                  const std::vector<Upstream>& upstream,
+                                  double submitted_at) {
     JobResult result;
-    result.job_id = spec.job_id;
+    result.job_id = job_spec.job_id;
     result.status = JobStatus::Running;
     result.work_dir = work_dir;
+    result.telemetry.job_id = job_spec.job_id;
+    result.telemetry.driver = std::filesystem::path(driver_script(job_spec)).stem().string();
+    result.telemetry.submitted_at = submitted_at;
+
+    // A job that never reaches its driver leaves nothing in its work directory worth inspecting.
+    auto finish_without_driver = [&](JobStatus status, std::string message) {
+        result.status = status;
+        result.error_message = std::move(message);
+        remove_work_dir(result.work_dir);
+        result.work_dir.clear();
+        result.telemetry.status = result.status;
+        finish_telemetry(result.telemetry);
+        return result;
+    };
+
+    JobSpec spec = job_spec;
+    for (const Upstream& source : upstream) {
+        while (source.future.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+            if (cancelled.load()) {
+                return finish_without_driver(JobStatus::Cancelled, "Job cancelled");
+            }
+        }
+        const JobResult& upstream_result = *source.future.get();
+        if (!upstream_result.converged()) {
+            return finish_without_driver(
+                JobStatus::Cancelled,
+                "Skipped: upstream job " + std::to_string(source.dependency.job_id) + " did not converge");
+        }
+        const std::string dependency_error = apply_dependency(source.dependency.kind, upstream_result, spec);
+        if (!dependency_error.empty()) {
+            return finish_without_driver(JobStatus::Cancelled, "Skipped: " + dependency_error);
+        }
+    }
 
+    bool driver_spawned = false;
     try {
         if (!python_env_.is_valid()) {
             throw std::runtime_error("No valid Python environment configured");
@@ -325,12 +775,36 @@ JobResult BackendManager::run_job(const JobSpec& spec, const std::string& work_d
         const std::filesystem::path job_json_path = std::filesystem::path(work_dir) / "job.json";
         const std::filesystem::path log_path = std::filesystem::path(work_dir) / "subprocess.log";
 
+        // parse_result() builds a fresh JobResult; carry the backend-side measurements across it.
+        auto parse_timed = [&]() {
+            JobTelemetry telemetry = result.telemetry;
+            const auto parse_start = std::chrono::steady_clock::now();
+            result = parse_result(spec, work_dir);
+            telemetry.parse_seconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - parse_start).count();
+            telemetry.driver_started_at = result.telemetry.driver_started_at;
+            telemetry.driver_stages = std::move(result.telemetry.driver_stages);
+            result.telemetry = std::move(telemetry);
+        };
+
+        // The child reports a failed exec through this close-on-exec pipe; a successful exec closes it empty.
+        int exec_fds[2];
+        if (::pipe(exec_fds) != 0) {
+            throw std::runtime_error("Failed to create backend driver pipe");
+        }
+        ::fcntl(exec_fds[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(exec_fds[1], F_SETFD, FD_CLOEXEC);
+
+        result.telemetry.spawned_at = epoch_seconds();
         pid_t pid = ::fork();
         if (pid < 0) {
+            ::close(exec_fds[0]);
+            ::close(exec_fds[1]);
             throw std::runtime_error("Failed to fork backend driver process");
         }
 
         if (pid == 0) {
+            ::setpgid(0, 0);
             const int log_fd = ::open(log_path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
             if (log_fd >= 0) {
                 ::dup2(log_fd, STDOUT_FILENO);
@@ -345,9 +819,25 @@ JobResult BackendManager::run_job(const JobSpec& spec, const std::string& work_d
                 script_path.c_str(),
                 job_json_path.c_str(),
                 static_cast<char*>(nullptr));
+            const int exec_errno = errno;
+            (void)!::write(exec_fds[1], &exec_errno, sizeof(exec_errno));
             _exit(127);
         }
 
+        ::setpgid(pid, pid);
+        ::close(exec_fds[1]);
+        int exec_errno = 0;
+        ssize_t exec_read = 0;
+        do {
+            exec_read = ::read(exec_fds[0], &exec_errno, sizeof(exec_errno));
+        } while (exec_read < 0 && errno == EINTR);
+        ::close(exec_fds[0]);
+        if (exec_read > 0) {
+            ::waitpid(pid, nullptr, 0);
+            throw std::runtime_error("Failed to start backend driver " + python_env_.info().python_path + ": "
+                                     + std::strerror(exec_errno));
+        }
+        driver_spawned = true;
         {
             std::lock_guard<std::mutex> lock(mutex_);
             const auto it = running_jobs_.find(spec.job_id);
@@ -357,8 +847,9 @@ JobResult BackendManager::run_job(const JobSpec& spec, const std::string& work_d
         }
 
         int wait_status = 0;
+        rusage usage{};
         while (true) {
-            const pid_t wait_rc = ::waitpid(pid, &wait_status, WNOHANG);
+            const pid_t wait_rc = ::wait4(pid, &wait_status, WNOHANG, &usage);
             if (wait_rc == pid) {
                 break;
             }
@@ -367,8 +858,8 @@ JobResult BackendManager::run_job(const JobSpec& spec, const std::string& work_d
             }
 
             if (cancelled.load()) {
-                ::kill(pid, SIGTERM);
-                ::waitpid(pid, &wait_status, 0);
+                terminate_driver(pid);
+                ::wait4(pid, &wait_status, 0, &usage);
                 result.status = JobStatus::Cancelled;
                 result.error_message = "Job cancelled";
                 break;
@@ -385,14 +876,16 @@ JobResult BackendManager::run_job(const JobSpec& spec, const std::string& work_d
             }
         }
 
+        apply_rusage(usage, result.telemetry);
+
         if (result.status != JobStatus::Cancelled) {
             if (WIFEXITED(wait_status) && WEXITSTATUS(wait_status) == 0) {
-                result = parse_result(spec, work_dir);
+                parse_timed();
             } else if (cancelled.load()) {
                 result.status = JobStatus::Cancelled;
                 result.error_message = "Job cancelled";
             } else {
-                result = parse_result(spec, work_dir);
+                parse_timed();
                 if (result.status == JobStatus::Pending || result.status == JobStatus::Running) {
                     result.status = JobStatus::Failed;
                 }
@@ -404,9 +897,15 @@ JobResult BackendManager::run_job(const JobSpec& spec, const std::string& work_d
     } catch (const std::exception& e) {
         result.status = cancelled.load() ? JobStatus::Cancelled : JobStatus::Failed;
         result.error_message = e.what();
+        if (!driver_spawned) {
+            remove_work_dir(result.work_dir);
+            result.work_dir.clear();
+        }
     }
 
     result.job_id = spec.job_id;
+    result.telemetry.status = result.status;
+    finish_telemetry(result.telemetry);
 
     return result;
 }
@@ -442,7 +941,21 @@ void BackendManager::write_job_json(const JobSpec& spec, const std::string& work
     j["scf_convergence"] = spec.scf_convergence;
     j["properties"] = json::array();
     bool request_frequencies = false;
+    const auto requested = [&spec](PropertyRequest property) {
+        return std::find(spec.properties.begin(), spec.properties.end(), property) != spec.properties.end();
+    };
+    // When orbitals come back (molden / binary arrays) the app generates orbital and density volumes
+    // itself on demand, so the driver skips those cubes. A density paired with an ESP grid is still
+    // written, since the ESP surface needs both on the same grid.
+    const bool native_volumes = requested(PropertyRequest::MoldenFile);
+    const bool request_esp = requested(PropertyRequest::CubeESP);
     for (PropertyRequest property : spec.properties) {
+        const bool generated_natively = native_volumes
+            && (property == PropertyRequest::CubeHOMO || property == PropertyRequest::CubeLUMO
+                || (property == PropertyRequest::CubeDensity && !request_esp));
+        if (generated_natively) {
+            continue;
+        }
         j["properties"].push_back(property_to_string(property));
         request_frequencies = request_frequencies || property == PropertyRequest::Frequencies;
     }
@@ -487,6 +1000,7 @@ void BackendManager::write_job_json(const JobSpec& spec, const std::string& work
 
         j["scan"] = json::object();
         j["scan"]["type"] = spec.scan.is_2d ? "2d" : "1d";
+        j["scan"]["workers"] = spec.scan.resolved_workers();
         j["scan"]["coordinate_1"] = write_scan_coord(spec.scan.coord1);
         if (spec.scan.is_2d) {
             j["scan"]["coordinate_2"] = write_scan_coord(spec.scan.coord2);
@@ -508,10 +1022,34 @@ void BackendManager::write_job_json(const JobSpec& spec, const std::string& work
         j["product"] = write_geometry(spec.neb.product);
         j["num_images"] = spec.neb.num_images;
         j["max_neb_steps"] = spec.neb.max_neb_steps;
+        j["neb_workers"] = spec.neb.resolved_workers();
+    }
+    if (spec.run_ensemble) {
+        if (spec.ensemble.geometries.empty()) {
+            throw std::runtime_error("Ensemble job has no geometries");
+        }
+        j["ensemble"] = json::array();
+        for (const auto& mol : spec.ensemble.geometries) {
+            json geom = json::array();
+            for (const auto& atom : mol.atoms()) {
+                geom.push_back({
+                    atom.Z,
+                    {atom.position.x(), atom.position.y(), atom.position.z()},
+                });
+            }
+            j["ensemble"].push_back(std::move(geom));
+        }
     }
     j["solvent"] = spec.solvent;
+    if (!spec.guess_checkpoint.empty() && std::filesystem::exists(spec.guess_checkpoint)) {
+        j["initial_guess"] = {{"chkfile", spec.guess_checkpoint}};
+    }
+    if (!spec.initial_hessian.empty() && std::filesystem::exists(spec.initial_hessian)) {
+        j["initial_hessian"] = spec.initial_hessian;
+    }
     j["output_dir"] = work_dir;
-    j["cube_resolution"] = 80;
+    j["cube_resolution"] = spec.cube_resolution;
+    j["result_format"] = "npy";
 
     if (request_frequencies && !spec.optimize_geometry) {
         SBOX_LOG_WARN("Frequency calculation requested without geometry optimization; results will use the current geometry.");
@@ -531,12 +1069,24 @@ JobResult BackendManager::parse_result(const JobSpec& spec, const std::string& w
 
     const std::filesystem::path result_path = std::filesystem::path(work_dir) / "result.json";
     const json j = load_json_file(result_path);
+    result.scf_checkpoint = scf_checkpoint_path(work_dir);
 
     const bool success = j.value("success", false);
     result.status = success ? JobStatus::Converged : JobStatus::Failed;
     result.error_message = j.value("error", std::string{});
     result.total_energy = j.value("total_energy", 0.0);
     result.wall_time_seconds = j.value("wall_time", 0.0);
+    if (j.contains("timings") && j["timings"].is_object()) {
+        const json& timings = j["timings"];
+        result.telemetry.driver_started_at = timings.value("started_at", 0.0);
+        if (timings.contains("stages") && timings["stages"].is_array()) {
+            for (const json& stage : timings["stages"]) {
+                if (stage.is_array() && stage.size() == 2) {
+                    result.telemetry.driver_stages.emplace_back(stage[0].get<std::string>(), stage[1].get<double>());
+                }
+            }
+        }
+    }
     result.optimization_converged = j.value("optimization_converged", false);
     if (j.contains("scan_type")) {
         result.scan_result.is_2d = j.value("scan_type", std::string{}) == "2d";
@@ -554,7 +1104,13 @@ JobResult BackendManager::parse_result(const JobSpec& spec, const std::string& w
         result.lowdin_charges = j["lowdin_charges"].get<std::vector<double>>();
     }
 
-    if (j.contains("mayer_bond_orders") && j["mayer_bond_orders"].is_array() && !j["mayer_bond_orders"].empty()) {
+    const json arrays = j.value("arrays", json::object());
+    result.hessian_file = binary_array_path(arrays, "hessian", work_dir).string();
+
+    if (const std::filesystem::path mayer_path = binary_array_path(arrays, "mayer_bond_orders", work_dir);
+        !mayer_path.empty()) {
+        result.mayer_bond_orders = sbox::io::read_npy_matrix(mayer_path.string());
+    } else if (j.contains("mayer_bond_orders") && j["mayer_bond_orders"].is_array() && !j["mayer_bond_orders"].empty()) {
         const std::size_t rows = j["mayer_bond_orders"].size();
         const std::size_t cols = j["mayer_bond_orders"][0].size();
         result.mayer_bond_orders = Eigen::MatrixXd::Zero(static_cast<int>(rows), static_cast<int>(cols));
@@ -606,7 +1162,23 @@ JobResult BackendManager::parse_result(const JobSpec& spec, const std::string& w
         result.ir_intensities = j["ir_intensities"].get<std::vector<double>>();
         result.has_frequencies = result.has_frequencies || !result.ir_intensities.empty();
     }
-    if (j.contains("normal_modes") && j["normal_modes"].is_array()) {
+    if (const std::filesystem::path freq_path = binary_array_path(arrays, "frequencies_cm1", work_dir); !freq_path.empty()) {
+        const Eigen::VectorXd freqs = sbox::io::read_npy_vector(freq_path.string());
+        result.frequencies_cm1.assign(freqs.data(), freqs.data() + freqs.size());
+        result.has_frequencies = !result.frequencies_cm1.empty();
+    }
+    if (const std::filesystem::path ir_path = binary_array_path(arrays, "ir_intensities", work_dir); !ir_path.empty()) {
+        const Eigen::VectorXd intensities = sbox::io::read_npy_vector(ir_path.string());
+        result.ir_intensities.assign(intensities.data(), intensities.data() + intensities.size());
+        result.has_frequencies = result.has_frequencies || !result.ir_intensities.empty();
+    }
+    if (const std::filesystem::path modes_path = binary_array_path(arrays, "normal_modes", work_dir); !modes_path.empty()) {
+        const Eigen::MatrixXd modes = sbox::io::read_npy_matrix(modes_path.string());
+        result.normal_modes.reserve(static_cast<std::size_t>(modes.rows()));
+        for (Eigen::Index m = 0; m < modes.rows(); ++m) {
+            result.normal_modes.emplace_back(modes.row(m).transpose());
+        }
+    } else if (j.contains("normal_modes") && j["normal_modes"].is_array()) {
         for (const auto& mode : j["normal_modes"]) {
             if (!mode.is_array()) {
                 continue;
@@ -669,6 +1241,29 @@ JobResult BackendManager::parse_result(const JobSpec& spec, const std::string& w
     result.neb_result.converged = j.value("converged", false);
     result.has_neb = result.has_neb || result.neb_result.ts_index >= 0;
 
+    if (j.contains("ensemble") && j["ensemble"].is_array()) {
+        for (const auto& entry : j["ensemble"]) {
+            if (entry.is_object()) {
+                result.ensemble.push_back(ensemble_member_from_json(entry));
+            }
+        }
+        std::sort(result.ensemble.begin(), result.ensemble.end(), [](const auto& a, const auto& b) {
+            return a.index < b.index;
+        });
+        result.has_ensemble = !result.ensemble.empty();
+    }
+    if (spec.run_ensemble && !result.has_ensemble) {
+        // A driver that stopped early still leaves the members it finished in the stream.
+        const std::filesystem::path ensemble_path = std::filesystem::path(work_dir) / "ensemble.jsonl";
+        if (std::filesystem::exists(ensemble_path)) {
+            result.ensemble = read_ensemble_stream(ensemble_path);
+            std::sort(result.ensemble.begin(), result.ensemble.end(), [](const auto& a, const auto& b) {
+                return a.index < b.index;
+            });
+            result.has_ensemble = !result.ensemble.empty();
+        }
+    }
+
     const std::filesystem::path opt_history_path = std::filesystem::path(work_dir) / "optimization_history.json";
     if (std::filesystem::exists(opt_history_path)) {
         const json history_json = load_json_file(opt_history_path);
@@ -698,53 +1293,67 @@ JobResult BackendManager::parse_result(const JobSpec& spec, const std::string& w
             }
             result.has_trajectory = !result.trajectory_frames.empty();
         } catch (const std::exception& e) {
-            if (result.error_message.empty()) {
-                result.error_message = e.what();
-            } else {
-                result.error_message += "\n";
-                result.error_message += e.what();
-            }
+            append_error(result, e.what());
         }
     }
 
+    // Binary orbitals ship the basis as a header-only molden next to .npy arrays, skipping the text [MO] parse.
     const std::filesystem::path molden_path = std::filesystem::path(work_dir) / "result.molden";
-    if (std::filesystem::exists(molden_path)) {
+    const std::filesystem::path basis_molden_path = std::filesystem::path(work_dir) / "basis.molden";
+    const std::filesystem::path mo_coeff_path = binary_array_path(arrays, "mo_coefficients", work_dir);
+    if (!mo_coeff_path.empty() && std::filesystem::exists(basis_molden_path)) {
+        try {
+            result.mo_data = sbox::molden::parse_molden_file(basis_molden_path.string());
+            result.mo_data.coefficients = sbox::io::read_npy_matrix(mo_coeff_path.string());
+            result.mo_data.energies = sbox::io::read_npy_vector(binary_array_path(arrays, "mo_energies", work_dir).string());
+            result.mo_data.occupations =
+                sbox::io::read_npy_vector(binary_array_path(arrays, "mo_occupations", work_dir).string());
+            if (result.mo_data.coefficients.rows() != result.mo_data.basis.num_basis_functions()
+                || result.mo_data.coefficients.cols() != result.mo_data.energies.size()
+                || result.mo_data.energies.size() != result.mo_data.occupations.size()) {
+                throw std::runtime_error("Binary MO arrays do not match the basis in basis.molden");
+            }
+            result.has_mo_data = true;
+            result.mo_data.total_energy = result.total_energy;
+        } catch (const std::exception& e) {
+            append_error(result, e.what());
+        }
+    } else if (std::filesystem::exists(molden_path)) {
         try {
             result.mo_data = sbox::molden::parse_molden_file(molden_path.string());
             result.has_mo_data = true;
             result.mo_data.total_energy = result.total_energy;
         } catch (const std::exception& e) {
-            if (result.error_message.empty()) {
-                result.error_message = e.what();
-            } else {
-                result.error_message += "\n";
-                result.error_message += e.what();
-            }
+            append_error(result, e.what());
         }
     }
 
-    const std::filesystem::path density_path = std::filesystem::path(work_dir) / "density.cube";
-    if (std::filesystem::exists(density_path)) {
-        result.density_cube = sbox::io::read_cube(density_path.string());
-        result.has_density_cube = true;
-    }
-
-    const std::filesystem::path homo_path = std::filesystem::path(work_dir) / "homo.cube";
-    if (std::filesystem::exists(homo_path)) {
-        result.homo_cube = sbox::io::read_cube(homo_path.string());
-        result.has_homo_cube = true;
-    }
-
-    const std::filesystem::path lumo_path = std::filesystem::path(work_dir) / "lumo.cube";
-    if (std::filesystem::exists(lumo_path)) {
-        result.lumo_cube = sbox::io::read_cube(lumo_path.string());
-        result.has_lumo_cube = true;
-    }
-
-    const std::filesystem::path esp_path = std::filesystem::path(work_dir) / "esp.cube";
-    if (std::filesystem::exists(esp_path)) {
-        result.esp_cube = sbox::io::read_cube(esp_path.string());
-        result.has_esp_cube = true;
+    struct CubeSlot {
+        const char* name;
+        std::shared_ptr<const sbox::io::CubeData>* cube;
+        bool* present;
+    };
+    const CubeSlot cube_slots[] = {
+        {"density", &result.density_cube, &result.has_density_cube},
+        {"homo", &result.homo_cube, &result.has_homo_cube},
+        {"lumo", &result.lumo_cube, &result.has_lumo_cube},
+        {"esp", &result.esp_cube, &result.has_esp_cube},
+    };
+    for (const CubeSlot& slot : cube_slots) {
+        const std::string key = std::string(slot.name) + "_cube";
+        const std::filesystem::path npy_path = binary_array_path(arrays, key.c_str(), work_dir);
+        const std::filesystem::path text_path = std::filesystem::path(work_dir) / (std::string(slot.name) + ".cube");
+        if (!npy_path.empty()) {
+            try {
+                *slot.cube = std::make_shared<const sbox::io::CubeData>(cube_from_npy(arrays[key], npy_path, spec.geometry));
+                *slot.present = true;
+            } catch (const std::exception& e) {
+                append_error(result, e.what());
+            }
+        } else if (std::filesystem::exists(text_path)) {
+            *slot.cube = std::make_shared<const sbox::io::CubeData>(sbox::io::read_cube(text_path.string()));
+            *slot.present = true;
+        }
     }
 
     if (j.contains("optimized_geometry") && j["optimized_geometry"].is_array()) {
@@ -772,6 +1381,21 @@ BackendManager::Progress BackendManager::parse_progress(const std::string& work_
         progress.total = j.value("total", 0);
         progress.energy = j.value("energy", 0.0);
         progress.message = j.value("message", std::string{});
+        if (j.contains("images") && j["images"].is_array()) {
+            for (const auto& entry : j["images"]) {
+                Progress::ImageProgress image;
+                image.index = entry.value("index", 0);
+                image.energy = entry.value("energy", 0.0);
+                image.max_force = entry.value("max_force", 0.0);
+                image.scf_converged = entry.value("scf_converged", false);
+                image.converged = entry.value("converged", false);
+                progress.images.push_back(image);
+            }
+        }
+        const std::filesystem::path ensemble_path = std::filesystem::path(work_dir) / "ensemble.jsonl";
+        if (std::filesystem::exists(ensemble_path)) {
+            progress.ensemble = read_ensemble_stream(ensemble_path);
+        }
         return progress;
     } catch (...) {
         return {};
@@ -780,7 +1404,9 @@ BackendManager::Progress BackendManager::parse_progress(const std::string& work_
 
 std::string BackendManager::driver_script(const JobSpec& spec) const {
     const char* script_name = "pyscf_driver.py";
-    if (spec.run_neb) {
+    if (spec.run_ensemble) {
+        script_name = "ensemble_driver.py";
+    } else if (spec.run_neb) {
         script_name = "neb_driver.py";
     } else if (spec.run_pes_scan) {
         script_name = "pes_scan_driver.py";
@@ -4,6 +4,10 @@
 #include "backend/python_env.h"
 
 #include <atomic>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
 #include <future>
 #include <map>
 #include <memory>
@@ -23,38 +27,83 @@ public:
     void init(const PythonEnvironment& env);
 
     int submit(const JobSpec& spec);
+    // Submits every node of an acyclic graph; returns the job id of each node, in node order.
+    std::vector<int> submit_graph(const JobGraph& graph);
 
     bool is_running(int job_id) const;
+    // True while any job has not yet been collected by poll_completed().
+    bool has_running_jobs() const;
     JobStatus status(int job_id) const;
-    const JobResult* result(int job_id) const;
+    // Shared, immutable handle to a completed job's result; null while the job is pending or running.
+    JobResultHandle result(int job_id) const;
     std::string work_dir(int job_id) const;
 
     std::vector<int> poll_completed();
 
     struct Progress {
+        struct ImageProgress {
+            int index = 0;
+            double energy = 0.0;
+            double max_force = 0.0;  // eV/Angstrom, NEB-projected
+            bool scf_converged = false;
+            bool converged = false;
+        };
+
         std::string stage;
         int iteration = 0;
         int step = 0;
         int total = 0;
         double energy = 0.0;
         std::string message;
+        std::vector<ImageProgress> images;  // NEB only
+        std::vector<JobResult::EnsembleMember> ensemble;  // ensemble members finished so far, in completion order
     };
     Progress get_progress(int job_id) const;
 
     void cancel(int job_id);
     void clear_job(int job_id);
 
+    struct TelemetrySummary {
+        struct Stage {
+            std::string name;
+            double total_seconds = 0.0;
+            double mean_seconds = 0.0;
+            int jobs = 0;
+        };
+
+        int jobs = 0;
+        double jobs_per_minute = 0.0;
+        double mean_wall_seconds = 0.0;
+        long peak_rss_kb = 0;
+        std::vector<Stage> stages;  // slowest (largest total) first
+    };
+    // Telemetry of recently completed jobs, oldest first.
+    std::vector<JobTelemetry> telemetry() const;
+    // Throughput and per-stage totals over the jobs that finished in the last window_seconds.
+    TelemetrySummary telemetry_summary(double window_seconds = 600.0) const;
+    static constexpr std::uintmax_t kDefaultTelemetryLogBytes = 4U << 20U;
+    // Appends one JSON object per completed job to path; an empty path turns the log off. Once the log
+    // reaches max_bytes it is moved to "<path>.1", replacing the previous one, and a fresh log is started.
+    void set_telemetry_log(const std::string& path, std::uintmax_t max_bytes = kDefaultTelemetryLogBytes);
+
     bool can_run_pyscf() const;
     bool can_run_xtb() const;
 
     std::string scripts_dir() const;
 
 private:
+    struct Upstream {
+        JobDependency dependency;
+        std::shared_future<JobResultHandle> future;
+    };
+
     struct RunningJob {
         int job_id = 0;
         JobSpec spec;
-        std::future<JobResult> future;
+        std::shared_future<JobResultHandle> future;
+        std::vector<Upstream> upstream;
         std::string work_dir;
+        double submitted_at = 0.0;
         std::atomic<bool> cancelled{false};
         pid_t pid = -1;
     };
@@ -65,15 +114,30 @@ private:
 
     mutable std::mutex mutex_;
     std::map<int, std::unique_ptr<RunningJob>> running_jobs_;
-    std::map<int, JobResult> completed_jobs_;
+    std::map<int, JobResultHandle> completed_jobs_;
     std::vector<int> newly_completed_;
-
-    JobResult run_job(const JobSpec& spec, const std::string& work_dir, std::atomic<bool>& cancelled);
+    std::deque<JobTelemetry> telemetry_history_;
+    std::ofstream telemetry_log_;
+    std::string telemetry_log_path_;
+    std::uintmax_t telemetry_log_bytes_ = 0;
+    std::uintmax_t telemetry_log_max_bytes_ = kDefaultTelemetryLogBytes;
+
+    JobResult run_job(const JobSpec& spec,
+                      const std::string& work_dir,
+                      std::atomic<bool>& cancelled,
+                      const std::vector<Upstream>& upstream,
+                      double submitted_at);
     std::string create_work_dir(int job_id);
     void write_job_json(const JobSpec& spec, const std::string& work_dir);
     JobResult parse_result(const JobSpec& spec, const std::string& work_dir);
     Progress parse_progress(const std::string& work_dir) const;
+    void record_telemetry(const JobTelemetry& telemetry);
+    void rotate_telemetry_log();
     std::string driver_script(const JobSpec& spec) const;
 };
 
+// Reads a driver's ensemble.jsonl, which is appended to while the driver runs. Members come back in
+// completion order; a trailing line still being written is skipped.
+std::vector<JobResult::EnsembleMember> read_ensemble_stream(const std::filesystem::path& path);
+
 }  // namespace sbox::backend
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <memory>
+#include <optional>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <Eigen/Core>
@@ -144,6 +150,42 @@ inline const char* basis_display_name(BasisSetType b) {
     return "STO-3G";
 }
 
+inline const char* job_status_to_string(JobStatus status) {
+    switch (status) {
+    case JobStatus::Pending: return "pending";
+    case JobStatus::Running: return "running";
+    case JobStatus::Converged: return "converged";
+    case JobStatus::Failed: return "failed";
+    case JobStatus::Cancelled: return "cancelled";
+    case JobStatus::Timeout: return "timeout";
+    }
+    return "unknown";
+}
+
+// Inverse of method_to_string, ignoring case; nullopt for names it does not know.
+inline std::optional<Method> method_from_string(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (int i = 0; i <= static_cast<int>(Method::GFN_FF); ++i) {
+        if (lower == method_to_string(static_cast<Method>(i))) {
+            return static_cast<Method>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+// Inverse of basis_to_string, ignoring case; nullopt for names it does not know.
+inline std::optional<BasisSetType> basis_from_string(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (int i = 0; i <= static_cast<int>(BasisSetType::aug_cc_pVTZ); ++i) {
+        if (lower == basis_to_string(static_cast<BasisSetType>(i))) {
+            return static_cast<BasisSetType>(i);
+        }
+    }
+    return std::nullopt;
+}
+
 inline bool method_needs_basis(Method m) {
     return m != Method::GFN2_XTB && m != Method::GFN1_XTB && m != Method::GFN_FF;
 }
@@ -152,12 +194,33 @@ inline bool method_is_xtb(Method m) {
     return m == Method::GFN2_XTB || m == Method::GFN1_XTB || m == Method::GFN_FF;
 }
 
+// Typed edge from an upstream job: what the downstream job takes from the upstream result once it converges.
+struct JobDependency {
+    enum class Kind {
+        After,         // ordering only
+        GeometryFrom,  // optimized geometry, or the transition-state image of a NEB path
+        OrbitalsFrom,  // SCF checkpoint as the initial guess
+        HessianFrom,   // Cartesian Hessian of a frequency job as the optimizer's starting Hessian
+    };
+
+    int job_id = -1;
+    Kind kind = Kind::After;
+};
+
 struct JobSpec {
     struct NEBSpec {
         sbox::chem::MolecularSystem reactant;
         sbox::chem::MolecularSystem product;
         int num_images = 9;
         int max_neb_steps = 50;
+        int workers = 0;  // image-evaluation processes; 0 = one per intermediate image
+
+        // Each worker keeps its images' SCF densities between NEB iterations, so images stay pinned to workers.
+        int resolved_workers() const {
+            const int interior = std::max(1, num_images - 2);
+            const int hardware = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            return std::clamp(workers > 0 ? workers : interior, 1, std::min(interior, hardware));
+        }
     };
 
     struct ScanSpec {
@@ -178,6 +241,23 @@ struct JobSpec {
         ScanCoordinate coord1;
         ScanCoordinate coord2;
         bool is_2d = false;
+        int workers = 0;  // concurrent driver processes; 0 = one per hardware thread
+
+        int total_points() const {
+            return std::max(1, coord1.steps) * (is_2d ? std::max(1, coord2.steps) : 1);
+        }
+
+        // Number of chunks the driver splits the scan into, never more than there are points.
+        int resolved_workers() const {
+            const int requested = workers > 0 ? workers : static_cast<int>(std::thread::hardware_concurrency());
+            return std::clamp(requested, 1, total_points());
+        }
+    };
+
+    // Single points on many geometries that share method, basis, charge and multiplicity. The driver
+    // sets up the calculator once and streams each member's result back as it finishes.
+    struct EnsembleSpec {
+        std::vector<sbox::chem::MolecularSystem> geometries;
     };
 
     struct ConstraintSpec {
@@ -207,6 +287,8 @@ struct JobSpec {
         PropertyRequest::DipoleMoment,
         PropertyRequest::MoldenFile,
     };
+    // Points per cube axis for volumes the driver still writes (ESP and the density paired with it).
+    int cube_resolution = 80;
 
     bool optimize_geometry = false;
     int max_opt_steps = 100;
@@ -216,9 +298,19 @@ struct JobSpec {
     NEBSpec neb;
     bool run_pes_scan = false;
     ScanSpec scan;
+    bool run_ensemble = false;
+    EnsembleSpec ensemble;
 
     std::string solvent;
 
+    // Upstream jobs this one waits for. BackendManager fills guess_checkpoint, initial_hessian or the
+    // geometry from each upstream result before the driver starts; a failed upstream skips this job.
+    std::vector<JobDependency> dependencies;
+
+    // SCF warm start from a PySCF chkfile, projected by the driver onto this job's basis and geometry.
+    std::string guess_checkpoint;
+    std::string initial_hessian;  // .npy, (3N, 3N) Hartree/Bohr^2
+
     std::string work_dir;
 
     int job_id = 0;
@@ -239,6 +331,34 @@ struct OptimizationStep {
     sbox::chem::MolecularSystem geometry;
 };
 
+// Where one job's time and resources went. Queue, spawn and parse are measured by the backend; the
+// driver reports its own stages in result.json; CPU time and peak RSS come from wait4() rusage.
+struct JobTelemetry {
+    int job_id = 0;
+    std::string driver;  // driver script name, e.g. "pyscf_driver"
+    JobStatus status = JobStatus::Pending;
+
+    // Seconds since the Unix epoch; spawned_at and driver_started_at stay 0 if no driver ran.
+    double submitted_at = 0.0;
+    double spawned_at = 0.0;
+    double driver_started_at = 0.0;
+    double finished_at = 0.0;
+
+    double queue_wait_seconds = 0.0;  // submit -> fork, including the wait for upstream jobs
+    double spawn_seconds = 0.0;       // fork -> first driver statement (exec + interpreter start-up)
+    double import_seconds = 0.0;      // numpy / pyscf / tblite imports
+    double scf_seconds = 0.0;
+    double properties_seconds = 0.0;  // analysis, molden and cube writing
+    double parse_seconds = 0.0;       // reading result.json, arrays and cubes back in the app
+    double wall_seconds = 0.0;        // submit -> result ready
+
+    double user_cpu_seconds = 0.0;    // driver plus the worker processes it reaped
+    double system_cpu_seconds = 0.0;
+    long peak_rss_kb = 0;
+
+    std::vector<std::pair<std::string, double>> driver_stages;  // every stage the driver timed, in order
+};
+
 struct JobResult {
     struct NEBResult {
         std::vector<double> path_energies;
@@ -260,10 +380,22 @@ struct JobResult {
         int steps_2 = 0;
     };
 
+    struct EnsembleMember {
+        int index = 0;  // position in JobSpec::EnsembleSpec::geometries
+        bool success = false;
+        double energy = 0.0;
+        Eigen::Vector3d dipole_moment = Eigen::Vector3d::Zero();
+        std::vector<double> mulliken_charges;
+        double wall_time_seconds = 0.0;
+        std::string error;
+    };
+
     int job_id = 0;
     JobStatus status = JobStatus::Pending;
     std::string error_message;
     std::string work_dir;
+    std::string scf_checkpoint;  // converged-orbital chkfile usable as JobSpec::guess_checkpoint
+    std::string hessian_file;    // frequency-job Hessian usable as JobSpec::initial_hessian
 
     double total_energy = 0.0;
 
@@ -279,10 +411,11 @@ struct JobResult {
     std::vector<double> lowdin_charges;
     Eigen::MatrixXd mayer_bond_orders;
 
-    sbox::io::CubeData homo_cube;
-    sbox::io::CubeData lumo_cube;
-    sbox::io::CubeData density_cube;
-    sbox::io::CubeData esp_cube;
+    // Volumes are immutable once parsed and shared with whoever renders or analyses them.
+    std::shared_ptr<const sbox::io::CubeData> homo_cube;
+    std::shared_ptr<const sbox::io::CubeData> lumo_cube;
+    std::shared_ptr<const sbox::io::CubeData> density_cube;
+    std::shared_ptr<const sbox::io::CubeData> esp_cube;
     bool has_homo_cube = false;
     bool has_lumo_cube = false;
     bool has_density_cube = false;
@@ -301,8 +434,11 @@ struct JobResult {
     bool has_neb = false;
     ScanResult scan_result;
     bool has_scan = false;
+    std::vector<EnsembleMember> ensemble;  // ordered by index
+    bool has_ensemble = false;
 
     double wall_time_seconds = 0.0;
+    JobTelemetry telemetry;
 
     bool converged() const { return status == JobStatus::Converged; }
 
@@ -341,4 +477,29 @@ struct JobResult {
     }
 };
 
+// Completed results are immutable and handed out by reference count, never copied.
+using JobResultHandle = std::shared_ptr<const JobResult>;
+
+// A pipeline of jobs submitted together. Node indices are local to the graph; BackendManager::submit_graph
+// turns every edge into a JobDependency on the downstream node and runs independent branches concurrently.
+struct JobGraph {
+    struct Edge {
+        int from = 0;
+        int to = 0;
+        JobDependency::Kind kind = JobDependency::Kind::After;
+    };
+
+    std::vector<JobSpec> nodes;
+    std::vector<Edge> edges;
+
+    int add(const JobSpec& spec) {
+        nodes.push_back(spec);
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    void connect(int from, int to, JobDependency::Kind kind) {
+        edges.push_back({from, to, kind});
+    }
+};
+
 }  // namespace sbox::backend
@@ -1,19 +1,57 @@
 #include "backend/python_env.h"
 
+#include <json.hpp>
+
 #include <algorithm>
 #include <array>
-#include <cstdio>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 namespace sbox::backend {
 
 namespace {
 
+using json = nlohmann::json;
+
+constexpr double kVersionProbeTimeoutSeconds = 10.0;
+// Importing pyscf cold (no .pyc yet) can take a while on slow disks.
+constexpr double kPackageProbeTimeoutSeconds = 60.0;
+constexpr int kProbeCacheVersion = 1;
+
+constexpr std::array<const char*, 5> kProbedPackages = {"pyscf", "tblite", "xtb", "geometric", "ase"};
+
+// Imports the package named by argv[1] and prints its version. Each package gets its own interpreter,
+// so one that crashes, hangs or breaks the interpreter on import only marks itself missing.
+constexpr const char* kPackageProbeScript = R"(import importlib, sys
+module = importlib.import_module(sys.argv[1])
+print(getattr(module, "__version__", "unknown"))
+)";
+
+// Lists the site-packages directories, so a package install or removal shows up as a changed mtime.
+constexpr const char* kSitePackagesScript = R"(import site
+paths = list(getattr(site, "getsitepackages", lambda: [])())
+user_site = getattr(site, "getusersitepackages", lambda: "")()
+if user_site:
+    paths.append(user_site)
+for path in paths:
+    print(path)
+)";
+
 std::string trim(const std::string& input) {
     const std::size_t start = input.find_first_not_of(" \t\r\n");
     if (start == std::string::npos) {
@@ -54,7 +92,7 @@ std::string resolve_python_path(const std::string& path) {
     }
 
     std::string resolved;
-    const int status = PythonEnvironment::run_capture("command -v " + path, resolved);
+    const int status = PythonEnvironment::run_capture("command -v " + path, resolved, kVersionProbeTimeoutSeconds);
     if (status != 0) {
         return path;
     }
@@ -62,21 +100,67 @@ std::string resolve_python_path(const std::string& path) {
     return trimmed.empty() ? path : trimmed;
 }
 
-bool probe_package(const std::string& python_path,
-                   const std::string& import_name,
-                   std::string* out_version,
-                   const std::string& version_expr = "__version__") {
-    std::string output;
-    const std::string command = shell_quote(python_path) + " -c \"import " + import_name
-        + "; print(getattr(" + import_name + ", '" + version_expr + "', 'unknown'))\"";
-    const int status = PythonEnvironment::run_capture(command, output);
-    if (status != 0) {
-        return false;
+// Modification time as an opaque integer; -1 for paths that do not exist.
+long long mtime_key(const std::string& path) {
+    std::error_code error;
+    const auto time = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return -1;
     }
-    if (out_version != nullptr) {
-        *out_version = trim(output);
+    return static_cast<long long>(time.time_since_epoch().count());
+}
+
+json fingerprint(const PythonInfo& info) {
+    json directories = json::array();
+    for (const std::string& directory : info.site_packages) {
+        directories.push_back({directory, mtime_key(directory)});
     }
-    return true;
+    return {{"interpreter", mtime_key(info.python_path)}, {"site_packages", directories}};
+}
+
+json info_to_json(const PythonInfo& info) {
+    return {
+        {"python_path", info.python_path},
+        {"version", info.version},
+        {"has_pyscf", info.has_pyscf},
+        {"pyscf_version", info.pyscf_version},
+        {"has_tblite", info.has_tblite},
+        {"tblite_version", info.tblite_version},
+        {"has_xtb", info.has_xtb},
+        {"xtb_version", info.xtb_version},
+        {"has_geometric", info.has_geometric},
+        {"has_ase", info.has_ase},
+        {"site_packages", info.site_packages},
+    };
+}
+
+PythonInfo info_from_json(const json& j) {
+    PythonInfo info;
+    info.python_path = j.value("python_path", std::string{});
+    info.version = j.value("version", std::string{});
+    info.has_pyscf = j.value("has_pyscf", false);
+    info.pyscf_version = j.value("pyscf_version", std::string{});
+    info.has_tblite = j.value("has_tblite", false);
+    info.tblite_version = j.value("tblite_version", std::string{});
+    info.has_xtb = j.value("has_xtb", false);
+    info.xtb_version = j.value("xtb_version", std::string{});
+    info.has_geometric = j.value("has_geometric", false);
+    info.has_ase = j.value("has_ase", false);
+    info.site_packages = j.value("site_packages", std::vector<std::string>{});
+    info.valid = !info.python_path.empty() && !info.version.empty();
+    return info;
+}
+
+json read_cache_file(const std::string& cache_path) {
+    std::ifstream in(cache_path);
+    if (!in) {
+        return json::object();
+    }
+    const json parsed = json::parse(in, nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_object() || parsed.value("version", 0) != kProbeCacheVersion) {
+        return json::object();
+    }
+    return parsed;
 }
 
 }  // namespace
@@ -135,11 +219,54 @@ void PythonEnvironment::check_packages() {
         return;
     }
 
-    info_.has_pyscf = probe_package(info_.python_path, "pyscf", &info_.pyscf_version);
-    info_.has_tblite = probe_package(info_.python_path, "tblite", &info_.tblite_version);
-    info_.has_xtb = probe_package(info_.python_path, "xtb", &info_.xtb_version);
-    info_.has_geometric = probe_package(info_.python_path, "geometric", nullptr);
-    info_.has_ase = probe_package(info_.python_path, "ase", nullptr);
+    info_.has_pyscf = info_.has_tblite = info_.has_xtb = info_.has_geometric = info_.has_ase = false;
+    info_.site_packages.clear();
+
+    // The probes run side by side, so detection takes as long as the slowest import rather than the sum.
+    const std::string python = shell_quote(info_.python_path);
+    const auto probe = [](std::string command) {
+        std::string output;
+        const int status = run_capture(command + " 2>/dev/null", output, kPackageProbeTimeoutSeconds);
+        return std::make_pair(status, output);
+    };
+    std::vector<std::future<std::pair<int, std::string>>> package_probes;
+    for (const char* name : kProbedPackages) {
+        package_probes.push_back(std::async(std::launch::async, probe,
+                                            python + " -c " + shell_quote(kPackageProbeScript) + " " + name));
+    }
+    const auto [site_status, site_output] = probe(python + " -c " + shell_quote(kSitePackagesScript));
+    if (site_status == 0) {
+        std::istringstream lines(site_output);
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (!trim(line).empty()) {
+                info_.site_packages.push_back(trim(line));
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < kProbedPackages.size(); ++i) {
+        const auto [status, output] = package_probes[i].get();
+        if (status != 0) {
+            continue;
+        }
+        const std::string name = kProbedPackages[i];
+        const std::string version = trim(output);
+        if (name == "pyscf") {
+            info_.has_pyscf = true;
+            info_.pyscf_version = version;
+        } else if (name == "tblite") {
+            info_.has_tblite = true;
+            info_.tblite_version = version;
+        } else if (name == "xtb") {
+            info_.has_xtb = true;
+            info_.xtb_version = version;
+        } else if (name == "geometric") {
+            info_.has_geometric = true;
+        } else if (name == "ase") {
+            info_.has_ase = true;
+        }
+    }
 }
 
 const PythonInfo& PythonEnvironment::info() const {
@@ -178,31 +305,125 @@ void PythonEnvironment::set_python_path(const std::string& path) {
     }
 }
 
-int PythonEnvironment::run_capture(const std::string& command, std::string& stdout_out) {
+void PythonEnvironment::set_info(const PythonInfo& info) {
+    info_ = info;
+}
+
+bool PythonEnvironment::load_cache(const std::string& cache_path, const std::string& python_path) {
+    const json cache = read_cache_file(cache_path);
+    const std::string key = python_path.empty() ? cache.value("selected", std::string{}) : resolve_python_path(python_path);
+    if (key.empty() || !cache.contains("interpreters") || !cache["interpreters"].contains(key)) {
+        return false;
+    }
+
+    const json& entry = cache["interpreters"][key];
+    const PythonInfo cached = info_from_json(entry.value("info", json::object()));
+    if (!cached.valid || cached.site_packages.empty() || entry.value("fingerprint", json::object()) != fingerprint(cached)) {
+        return false;
+    }
+    info_ = cached;
+    return true;
+}
+
+void PythonEnvironment::save_cache(const std::string& cache_path) const {
+    if (!info_.valid || info_.python_path.empty()) {
+        return;
+    }
+
+    json cache = read_cache_file(cache_path);
+    cache["version"] = kProbeCacheVersion;
+    cache["selected"] = info_.python_path;
+    cache["interpreters"][info_.python_path] = {{"fingerprint", fingerprint(info_)}, {"info", info_to_json(info_)}};
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cache_path).parent_path(), error);
+    std::ofstream out(cache_path);
+    if (out) {
+        out << cache.dump(2);
+    }
+}
+
+int PythonEnvironment::run_capture(const std::string& command, std::string& stdout_out, double timeout_seconds) {
     stdout_out.clear();
 
-    // TODO: replace popen with a timeout-capable fork/exec implementation.
-    FILE* pipe = popen(command.c_str(), "r");
-    if (pipe == nullptr) {
+    int fds[2] = {-1, -1};
+    pid_t pid = -1;
+    {
+        // Probes run concurrently. Close-on-exec pipes, created and forked under one lock, keep a child
+        // from inheriting another probe's pipe and holding it open past that probe's own exit.
+        static std::mutex spawn_mutex;
+        std::lock_guard<std::mutex> lock(spawn_mutex);
+        if (::pipe(fds) != 0) {
+            return -1;
+        }
+        ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        pid = ::fork();
+    }
+    if (pid < 0) {
+        ::close(fds[0]);
+        ::close(fds[1]);
         return -1;
     }
+    if (pid == 0) {
+        ::setpgid(0, 0);
+        ::dup2(fds[1], STDOUT_FILENO);
+        ::close(fds[0]);
+        ::close(fds[1]);
+        ::execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+        ::_exit(127);
+    }
+    ::setpgid(pid, pid);
+    ::close(fds[1]);
 
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout_seconds);
+    bool timed_out = false;
     std::array<char, 256> buffer{};
-    while (fgets(buffer.data(), static_cast<int>(buffer.size()), pipe) != nullptr) {
-        stdout_out += buffer.data();
+    while (true) {
+        int wait_ms = -1;
+        if (timeout_seconds > 0.0) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                timed_out = true;
+                break;
+            }
+            wait_ms = static_cast<int>(remaining.count());
+        }
+        pollfd pfd{fds[0], POLLIN, 0};
+        const int ready = ::poll(&pfd, 1, wait_ms);
+        if (ready == 0 || (ready < 0 && errno == EINTR)) {
+            continue;
+        }
+        if (ready < 0) {
+            break;
+        }
+        const ssize_t count = ::read(fds[0], buffer.data(), buffer.size());
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        stdout_out.append(buffer.data(), static_cast<std::size_t>(count));
     }
+    ::close(fds[0]);
 
-    const int status = pclose(pipe);
-    if (status == -1) {
-        return -1;
+    if (timed_out) {
+        ::kill(-pid, SIGKILL);
+    }
+    int status = 0;
+    while (::waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            return -1;
+        }
     }
-    return status;
+    return timed_out ? -1 : status;
 }
 
 bool PythonEnvironment::test_python(const std::string& path) {
     const std::string resolved_path = resolve_python_path(path);
     std::string output;
-    const int status = run_capture(python_version_command(resolved_path), output);
+    const int status = run_capture(python_version_command(resolved_path), output, kVersionProbeTimeoutSeconds);
     if (status != 0) {
         return false;
     }
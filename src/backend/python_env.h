@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace sbox::backend {
 
@@ -16,6 +17,7 @@ struct PythonInfo {
     bool has_geometric = false;
     bool has_ase = false;
     bool valid = false;
+    std::vector<std::string> site_packages;  // package directories whose mtimes key the probe cache
 };
 
 class PythonEnvironment {
@@ -23,6 +25,8 @@ public:
     PythonEnvironment();
 
     void detect();
+    // Imports each optional package in its own interpreter, all at once, so a package that fails or
+    // hangs on import only marks itself missing.
     void check_packages();
 
     const PythonInfo& info() const;
@@ -32,8 +36,17 @@ public:
 
     void save_preference() const;
     void set_python_path(const std::string& path);
+    void set_info(const PythonInfo& info);
 
-    static int run_capture(const std::string& command, std::string& stdout_out);
+    // Probe results are cached per interpreter and trusted while the interpreter and its site-packages
+    // directories keep the modification times recorded with them. An empty python_path picks the
+    // interpreter that was selected when the cache was written. Returns false if nothing usable is cached.
+    bool load_cache(const std::string& cache_path, const std::string& python_path = {});
+    void save_cache(const std::string& cache_path) const;
+
+    // Runs command through /bin/sh. With a positive timeout the command's process group is killed once
+    // it runs longer, and -1 is returned.
+    static int run_capture(const std::string& command, std::string& stdout_out, double timeout_seconds = 0.0);
 
 private:
     PythonInfo info_;
@@ -0,0 +1,114 @@
+#include "backend/volume_cache.h"
+
+#include "analysis/volume_generator.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace sbox::backend {
+
+namespace {
+
+bool can_generate_from(const JobResultHandle& result) {
+    return result && result->has_mo_data && !result->mo_data.atom_positions.empty()
+        && result->mo_data.coefficients.cols() > 0;
+}
+
+}  // namespace
+
+void VolumeCache::reset(JobResultHandle result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result_ = std::move(result);
+    volumes_.clear();
+}
+
+void VolumeCache::set_resolution(int resolution) {
+    resolution = std::max(resolution, 2);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (resolution == resolution_) {
+        return;
+    }
+    resolution_ = resolution;
+    volumes_.clear();
+}
+
+int VolumeCache::resolution() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resolution_;
+}
+
+JobResultHandle VolumeCache::result() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return result_;
+}
+
+bool VolumeCache::can_generate() const {
+    return can_generate_from(result());
+}
+
+bool VolumeCache::has_density() const {
+    const JobResultHandle result = this->result();
+    return result && (result->has_density_cube || (can_generate_from(result) && result->mo_data.occupations.size() > 0));
+}
+
+VolumeCache::Volume VolumeCache::orbital(int mo_index) {
+    return generate(Kind::Orbital, mo_index);
+}
+
+VolumeCache::Volume VolumeCache::homo() {
+    const JobResultHandle result = this->result();
+    if (result && result->has_homo_cube) {
+        return result->homo_cube;
+    }
+    return result ? generate(Kind::Orbital, result->homo_index()) : nullptr;
+}
+
+VolumeCache::Volume VolumeCache::lumo() {
+    const JobResultHandle result = this->result();
+    if (result && result->has_lumo_cube) {
+        return result->lumo_cube;
+    }
+    return result ? generate(Kind::Orbital, result->lumo_index()) : nullptr;
+}
+
+VolumeCache::Volume VolumeCache::density() {
+    const JobResultHandle result = this->result();
+    if (result && result->has_density_cube) {
+        return result->density_cube;
+    }
+    return generate(Kind::Density, -1);
+}
+
+VolumeCache::Volume VolumeCache::generate(Kind kind, int mo_index) {
+    JobResultHandle result;
+    int resolution = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result = result_;
+        resolution = resolution_;
+        const auto cached = volumes_.find(Key{kind, mo_index, resolution});
+        if (cached != volumes_.end()) {
+            return cached->second;
+        }
+    }
+    if (!can_generate_from(result) || (kind == Kind::Orbital && (mo_index < 0 || mo_index >= result->mo_data.coefficients.cols()))) {
+        return nullptr;
+    }
+
+    // The result is immutable and held by `result`, so the grid is evaluated without the lock.
+    const sbox::basis::MOData& mo_data = result->mo_data;
+    const sbox::analysis::VolumeGrid grid = sbox::analysis::fit_volume_grid(mo_data.atom_positions, resolution);
+    Volume volume = std::make_shared<const sbox::io::CubeData>(
+        kind == Kind::Density ? sbox::analysis::evaluate_density_volume(mo_data, grid)
+                              : sbox::analysis::evaluate_orbital_volume(mo_data, mo_index, grid));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Only cached if neither reset() nor set_resolution() ran meanwhile; a concurrent evaluation of
+    // the same volume keeps whichever finished first.
+    if (result_ == result && resolution_ == resolution) {
+        return volumes_.emplace(Key{kind, mo_index, resolution}, volume).first->second;
+    }
+    return volume;
+}
+
+}  // namespace sbox::backend
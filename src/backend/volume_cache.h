@@ -0,0 +1,50 @@
+#pragma once
+
+#include "backend/job_types.h"
+#include "io/cube_io.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace sbox::backend {
+
+// Volumes derived from one job's orbitals. Nothing is generated when the result arrives; each volume
+// is evaluated natively the first time a panel or the renderer asks for it and cached for the
+// current resolution. Cubes the driver wrote itself (e.g. the density paired with an ESP grid) are
+// handed out unchanged. All members may be called from any thread; evaluation runs outside the lock,
+// so a slow grid never blocks readers.
+class VolumeCache {
+public:
+    using Volume = std::shared_ptr<const sbox::io::CubeData>;
+
+    void reset(JobResultHandle result);
+    JobResultHandle result() const;
+
+    // Points along the longest side of the fitted grid; changing it drops the generated volumes.
+    void set_resolution(int resolution);
+    int resolution() const;
+
+    bool can_generate() const;
+    bool has_density() const;
+
+    // Null when neither orbitals nor a driver cube are available.
+    Volume orbital(int mo_index);
+    Volume homo();
+    Volume lumo();
+    Volume density();
+
+private:
+    enum class Kind { Orbital, Density };
+    using Key = std::tuple<Kind, int, int>;  // kind, MO index, resolution
+
+    Volume generate(Kind kind, int mo_index);
+
+    JobResultHandle result_;
+    int resolution_ = 80;
+    mutable std::mutex mutex_;
+    std::map<Key, Volume> volumes_;
+};
+
+}  // namespace sbox::backend
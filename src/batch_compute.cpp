@@ -0,0 +1,184 @@
+#include "batch_compute.h"
+
+#include "core/elements.h"
+#include "core/logging.h"
+#include "io/file_loader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <thread>
+
+namespace sbox {
+
+namespace {
+
+using json = nlohmann::json;
+
+constexpr auto kPollInterval = std::chrono::milliseconds(50);
+
+json request_fields(int index, const ComputeRequest& request) {
+    return {
+        {"index", index},
+        {"input", request.input_file},
+        {"method", backend::method_to_string(request.method)},
+        {"basis", backend::method_needs_basis(request.method) ? json(backend::basis_to_string(request.basis)) : json(nullptr)},
+        {"charge", request.charge},
+        {"multiplicity", request.multiplicity},
+        {"optimize", request.optimize},
+    };
+}
+
+json geometry_to_json(const chem::MolecularSystem& molecule) {
+    json atoms = json::array();
+    for (const chem::Atom& atom : molecule.atoms()) {
+        atoms.push_back(json::array({elements::get_element(atom.Z).symbol, atom.position.x(), atom.position.y(), atom.position.z()}));
+    }
+    return atoms;
+}
+
+json failed_record(int index, const ComputeRequest& request, const std::string& error) {
+    json record = request_fields(index, request);
+    record["status"] = backend::job_status_to_string(backend::JobStatus::Failed);
+    record["error"] = error;
+    return record;
+}
+
+void write_record(std::ostream& out, const json& record) {
+    // One flushed line per job keeps the stream usable while the batch is still running.
+    out << record.dump() << '\n';
+    out.flush();
+}
+
+}  // namespace
+
+backend::JobSpec compute_job_spec(const ComputeRequest& request) {
+    backend::JobSpec spec;
+    spec.geometry = io::read_file(request.input_file, io::file_kind_from_path(request.input_file)).molecule;
+    if (spec.geometry.num_atoms() == 0) {
+        throw std::runtime_error("no atoms in " + request.input_file);
+    }
+    spec.method = request.method;
+    spec.basis = request.basis;
+    spec.charge = request.charge;
+    spec.multiplicity = request.multiplicity;
+    spec.optimize_geometry = request.optimize;
+    spec.properties = {
+        backend::PropertyRequest::MullikenCharges,
+        backend::PropertyRequest::LowdinCharges,
+        backend::PropertyRequest::DipoleMoment,
+    };
+    if (request.optimize) {
+        spec.properties.push_back(backend::PropertyRequest::Optimization);
+    }
+    return spec;
+}
+
+json compute_result_record(int index, const ComputeRequest& request, const backend::JobResult& result) {
+    json record = request_fields(index, request);
+    record["job_id"] = result.job_id;
+    record["status"] = backend::job_status_to_string(result.status);
+    if (!result.error_message.empty()) {
+        record["error"] = result.error_message;
+    }
+    record["work_dir"] = result.work_dir;
+
+    if (result.converged()) {
+        record["energy"] = result.total_energy;
+        record["scf_cycles"] = result.scf_history.size();
+        if (result.homo_index() >= 0 && result.lumo_index() >= 0) {
+            record["homo_lumo_gap_ev"] = result.homo_lumo_gap_eV();
+        }
+        record["dipole"] = {result.dipole_moment.x(), result.dipole_moment.y(), result.dipole_moment.z()};
+        record["dipole_norm"] = result.dipole_moment.norm();
+        if (!result.mulliken_charges.empty()) {
+            record["mulliken_charges"] = result.mulliken_charges;
+        }
+        if (!result.lowdin_charges.empty()) {
+            record["lowdin_charges"] = result.lowdin_charges;
+        }
+        if (result.has_optimized_geometry) {
+            record["optimization_converged"] = result.optimization_converged;
+            record["optimization_steps"] = result.opt_history.size();
+            record["geometry"] = geometry_to_json(result.optimized_geometry);
+        }
+    }
+
+    const backend::JobTelemetry& telemetry = result.telemetry;
+    record["timings"] = {
+        {"wall_s", telemetry.wall_seconds},
+        {"queue_wait_s", telemetry.queue_wait_seconds},
+        {"spawn_s", telemetry.spawn_seconds},
+        {"import_s", telemetry.import_seconds},
+        {"scf_s", telemetry.scf_seconds},
+        {"properties_s", telemetry.properties_seconds},
+        {"parse_s", telemetry.parse_seconds},
+        {"user_cpu_s", telemetry.user_cpu_seconds},
+        {"sys_cpu_s", telemetry.system_cpu_seconds},
+        {"peak_rss_kb", telemetry.peak_rss_kb},
+    };
+    return record;
+}
+
+int run_compute_batch(const std::vector<ComputeRequest>& requests,
+                      backend::BackendManager& backend,
+                      int max_parallel,
+                      std::ostream& out) {
+    const std::size_t limit = static_cast<std::size_t>(
+        std::max(1, max_parallel > 0 ? max_parallel : static_cast<int>(std::thread::hardware_concurrency())));
+
+    int failures = 0;
+    std::size_t next = 0;
+    std::map<int, std::size_t> in_flight;  // job id -> request index
+    while (next < requests.size() || !in_flight.empty()) {
+        while (next < requests.size() && in_flight.size() < limit) {
+            const int index = static_cast<int>(next);
+            const ComputeRequest& request = requests[next++];
+            try {
+                const int job_id = backend.submit(compute_job_spec(request));
+                in_flight.emplace(job_id, static_cast<std::size_t>(index));
+                SBOX_LOG_INFO("Batch job %d: %s", job_id, request.input_file.c_str());
+            } catch (const std::exception& ex) {
+                write_record(out, failed_record(index, request, ex.what()));
+                SBOX_LOG_ERROR("Batch input %s skipped: %s", request.input_file.c_str(), ex.what());
+                ++failures;
+            }
+        }
+
+        bool finished_any = false;
+        for (const int job_id : backend.poll_completed()) {
+            const auto it = in_flight.find(job_id);
+            if (it == in_flight.end()) {
+                continue;
+            }
+            const ComputeRequest& request = requests[it->second];
+            const backend::JobResultHandle result = backend.result(job_id);
+            if (result == nullptr) {
+                // Still counted as finished, or the batch would wait for this job forever.
+                write_record(out, failed_record(static_cast<int>(it->second), request, "job finished without a result"));
+                SBOX_LOG_ERROR("Batch job %d (%s) finished without a result", job_id, request.input_file.c_str());
+                ++failures;
+            } else {
+                write_record(out, compute_result_record(static_cast<int>(it->second), request, *result));
+                if (!result->converged()) {
+                    SBOX_LOG_ERROR("Batch job %d (%s) %s: %s",
+                                   job_id,
+                                   request.input_file.c_str(),
+                                   backend::job_status_to_string(result->status),
+                                   result->error_message.c_str());
+                    ++failures;
+                }
+            }
+            backend.clear_job(job_id);
+            in_flight.erase(it);
+            finished_any = true;
+        }
+        if (!finished_any && !in_flight.empty()) {
+            std::this_thread::sleep_for(kPollInterval);
+        }
+    }
+    return failures;
+}
+
+}  // namespace sbox
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "backend/backend_manager.h"
+#include "batch_manifest.h"
+
+#include <json.hpp>
+
+#include <ostream>
+#include <vector>
+
+namespace sbox {
+
+// The job a request submits: its input file's geometry plus Mulliken/Lowdin charges, the dipole and,
+// for optimize requests, the optimization. Throws std::runtime_error when the input has no atoms.
+backend::JobSpec compute_job_spec(const ComputeRequest& request);
+
+// Result line for request `index` of a batch: status, energy (Hartree), HOMO-LUMO gap (eV), dipole
+// (Debye), charges, the optimized geometry when there is one, and where the time went.
+nlohmann::json compute_result_record(int index, const ComputeRequest& request, const backend::JobResult& result);
+
+// Runs every request through `backend` with at most max_parallel jobs in flight (<= 0 means one per
+// hardware thread) and writes one JSON line per request to `out` as it finishes, so results arrive in
+// completion order and survive an interrupted run. Inputs that cannot be read are reported without
+// being submitted. Returns the number of requests that did not converge.
+int run_compute_batch(const std::vector<ComputeRequest>& requests,
+                      backend::BackendManager& backend,
+                      int max_parallel,
+                      std::ostream& out);
+
+}  // namespace sbox
@@ -0,0 +1,206 @@
+#include "batch_manifest.h"
+
+#include <json.hpp>
+
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+namespace sbox {
+
+namespace {
+
+using json = nlohmann::json;
+
+// Entries of a JSON array, or one entry per non-blank line.
+std::vector<json> read_manifest_entries(const std::string& text) {
+    std::vector<json> entries;
+    const std::size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        return entries;
+    }
+
+    if (text[first] == '[') {
+        json array;
+        try {
+            array = json::parse(text);
+        } catch (const json::exception& ex) {
+            throw std::runtime_error(std::string("Manifest is not valid JSON: ") + ex.what());
+        }
+        entries.assign(array.begin(), array.end());
+        return entries;
+    }
+
+    std::istringstream stream(text);
+    std::string line;
+    int line_number = 0;
+    while (std::getline(stream, line)) {
+        ++line_number;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        try {
+            entries.push_back(json::parse(line));
+        } catch (const json::exception& ex) {
+            throw std::runtime_error("Manifest line " + std::to_string(line_number) + " is not valid JSON: " + ex.what());
+        }
+    }
+    return entries;
+}
+
+backend::Method parse_method(const std::string& name, const std::string& where) {
+    const std::optional<backend::Method> method = backend::method_from_string(name);
+    if (!method) {
+        throw std::runtime_error(where + ": unknown method " + name);
+    }
+    return *method;
+}
+
+backend::BasisSetType parse_basis(const std::string& name, const std::string& where) {
+    const std::optional<backend::BasisSetType> basis = backend::basis_from_string(name);
+    if (!basis) {
+        throw std::runtime_error(where + ": unknown basis set " + name);
+    }
+    return *basis;
+}
+
+int parse_orbital(const json& value, int line) {
+    if (value.is_number_integer()) {
+        return value.get<int>();
+    }
+    if (value.is_string()) {
+        const std::string name = value.get<std::string>();
+        if (name == "homo") {
+            return -1;
+        }
+        if (name == "lumo") {
+            return -2;
+        }
+    }
+    throw std::runtime_error("Manifest entry " + std::to_string(line) + ": orbital must be an index, \"homo\" or \"lumo\"");
+}
+
+RenderRequest parse_render_entry(const json& entry, const RenderRequest& defaults, const std::string& previous_input, int line) {
+    if (!entry.is_object()) {
+        throw std::runtime_error("Manifest entry " + std::to_string(line) + " is not an object");
+    }
+    RenderRequest request = defaults;
+    request.output_path.clear();
+    if (!previous_input.empty()) {
+        request.input_file = previous_input;
+    }
+    try {
+        request.input_file = entry.value("input", request.input_file);
+        request.output_path = entry.value("output", request.output_path);
+        if (entry.contains("orbital")) {
+            request.orbital = parse_orbital(entry.at("orbital"), line);
+        }
+        request.render_mode = entry.value("render_mode", request.render_mode);
+        request.iso_value = entry.value("iso", request.iso_value);
+        if (entry.contains("resolution")) {
+            const std::string resolution = entry.at("resolution").get<std::string>();
+            const std::size_t x_pos = resolution.find_first_of("xX");
+            if (x_pos == std::string::npos) {
+                throw std::runtime_error("resolution must look like 1920x1080");
+            }
+            request.width = std::stoi(resolution.substr(0, x_pos));
+            request.height = std::stoi(resolution.substr(x_pos + 1));
+        }
+        request.width = entry.value("width", request.width);
+        request.height = entry.value("height", request.height);
+        request.yaw_deg = entry.value("yaw", request.yaw_deg);
+        request.pitch_deg = entry.value("pitch", request.pitch_deg);
+        request.zoom = entry.value("zoom", request.zoom);
+    } catch (const std::runtime_error&) {
+        throw;
+    } catch (const std::exception& ex) {
+        throw std::runtime_error("Manifest entry " + std::to_string(line) + ": " + ex.what());
+    }
+
+    if (request.input_file.empty() || request.output_path.empty()) {
+        throw std::runtime_error("Manifest entry " + std::to_string(line) + " needs both input and output");
+    }
+    if (request.width <= 0 || request.height <= 0 || request.zoom <= 0.0f) {
+        throw std::runtime_error("Manifest entry " + std::to_string(line) + " has an invalid size or zoom");
+    }
+    return request;
+}
+
+ComputeRequest parse_compute_entry(const json& entry, const ComputeRequest& defaults, int index) {
+    const std::string where = "Manifest entry " + std::to_string(index);
+    ComputeRequest request = defaults;
+    if (entry.is_string()) {
+        request.input_file = entry.get<std::string>();
+    } else if (entry.is_object()) {
+        try {
+            request.input_file = entry.value("input", std::string());
+            if (entry.contains("method")) {
+                request.method = parse_method(entry.at("method").get<std::string>(), where);
+            }
+            if (entry.contains("basis")) {
+                request.basis = parse_basis(entry.at("basis").get<std::string>(), where);
+            }
+            request.charge = entry.value("charge", request.charge);
+            request.multiplicity = entry.value("multiplicity", request.multiplicity);
+            request.optimize = entry.value("optimize", request.optimize);
+        } catch (const json::exception& ex) {
+            throw std::runtime_error(where + ": " + ex.what());
+        }
+    } else {
+        throw std::runtime_error(where + " is neither a path nor an object");
+    }
+
+    if (request.input_file.empty()) {
+        throw std::runtime_error(where + " needs an input");
+    }
+    if (request.multiplicity < 1) {
+        throw std::runtime_error(where + " has an invalid multiplicity");
+    }
+    return request;
+}
+
+}  // namespace
+
+RenderRequest render_request_from_cli(const CLIOptions& options) {
+    RenderRequest request;
+    request.input_file = options.input_file;
+    request.output_path = options.screenshot_path;
+    request.orbital = options.orbital;
+    request.render_mode = options.render_mode;
+    request.iso_value = options.iso_value;
+    request.width = options.screenshot_width;
+    request.height = options.screenshot_height;
+    return request;
+}
+
+std::vector<RenderRequest> parse_render_manifest(const std::string& text, const RenderRequest& defaults) {
+    std::vector<RenderRequest> requests;
+    int index = 0;
+    for (const json& entry : read_manifest_entries(text)) {
+        requests.push_back(parse_render_entry(entry, defaults, requests.empty() ? std::string() : requests.back().input_file, ++index));
+    }
+    return requests;
+}
+
+ComputeRequest compute_request_from_cli(const CLIOptions& options) {
+    ComputeRequest request;
+    request.optimize = options.optimize;
+    if (!options.method.empty()) {
+        request.method = parse_method(options.method, "--method");
+    }
+    if (!options.basis.empty()) {
+        request.basis = parse_basis(options.basis, "--basis");
+    }
+    return request;
+}
+
+std::vector<ComputeRequest> parse_compute_manifest(const std::string& text, const ComputeRequest& defaults) {
+    std::vector<ComputeRequest> requests;
+    int index = 0;
+    for (const json& entry : read_manifest_entries(text)) {
+        requests.push_back(parse_compute_entry(entry, defaults, ++index));
+    }
+    return requests;
+}
+
+}  // namespace sbox
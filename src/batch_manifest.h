@@ -0,0 +1,54 @@
+#pragma once
+
+#include "backend/job_types.h"
+#include "cli.h"
+
+#include <string>
+#include <vector>
+
+namespace sbox {
+
+// One image to render in a --render-batch run. Fields mirror the single-screenshot CLI options;
+// the view angles are applied on top of the camera the input file was framed with.
+struct RenderRequest {
+    std::string input_file;
+    std::string output_path;
+    int orbital = -1;  // -1 HOMO, -2 LUMO, otherwise an MO index
+    std::string render_mode;
+    float iso_value = -1.0f;
+    int width = 1920;
+    int height = 1080;
+    float yaw_deg = 0.0f;
+    float pitch_deg = 0.0f;
+    float zoom = 1.0f;
+};
+
+// Request built from the command line alone, also the defaults for manifest entries.
+RenderRequest render_request_from_cli(const CLIOptions& options);
+
+// Parses a manifest given either as a JSON array of objects or as one JSON object per line.
+// Keys: input, output, orbital (number, "homo" or "lumo"), render_mode, iso, resolution ("WxH")
+// or width/height, yaw, pitch, zoom. Missing keys keep their value from `defaults`; an entry
+// without input inherits the previous entry's, so many views of one file stay short.
+// Throws std::runtime_error on malformed input.
+std::vector<RenderRequest> parse_render_manifest(const std::string& text, const RenderRequest& defaults);
+
+// One calculation of a --compute / --optimize batch.
+struct ComputeRequest {
+    std::string input_file;
+    backend::Method method = backend::Method::HF;
+    backend::BasisSetType basis = backend::BasisSetType::STO_3G;
+    int charge = 0;
+    int multiplicity = 1;
+    bool optimize = false;
+};
+
+// Method, basis and --optimize from the command line; throws std::runtime_error for unknown names.
+ComputeRequest compute_request_from_cli(const CLIOptions& options);
+
+// Same container formats as parse_render_manifest. An entry is either a path or an object with
+// input, method, basis (names as in method_to_string / basis_to_string), charge, multiplicity and
+// optimize; missing keys come from `defaults`. Throws std::runtime_error on malformed input.
+std::vector<ComputeRequest> parse_compute_manifest(const std::string& text, const ComputeRequest& defaults);
+
+}  // namespace sbox
@@ -52,6 +52,8 @@ CLIOptions parse_cli(int argc, char* argv[]) {
             if (consume_value(i, argc, argv, value)) {
                 options.screenshot_path = value;
             }
+        } else if (arg == "--render-batch") {
+            consume_value(i, argc, argv, options.render_manifest);
         } else if (arg == "--resolution") {
             std::string value;
             if (consume_value(i, argc, argv, value)) {
@@ -85,16 +87,31 @@ CLIOptions parse_cli(int argc, char* argv[]) {
             consume_value(i, argc, argv, options.method);
         } else if (arg == "--basis") {
             consume_value(i, argc, argv, options.basis);
+        } else if (arg == "--manifest") {
+            consume_value(i, argc, argv, options.compute_manifest);
+        } else if (arg == "--jobs") {
+            std::string value;
+            if (consume_value(i, argc, argv, value)) {
+                try {
+                    options.max_parallel_jobs = std::stoi(value);
+                } catch (...) {
+                }
+            }
         } else if (arg == "--output") {
             consume_value(i, argc, argv, options.output_file);
+        } else if (arg == "--append") {
+            options.append_output = true;
         } else if (arg == "--log-level") {
             consume_value(i, argc, argv, options.log_level);
         } else if (arg == "--log-file") {
             consume_value(i, argc, argv, options.log_file);
         } else if (!arg.empty() && arg[0] == '-') {
             continue;
-        } else if (options.input_file.empty()) {
-            options.input_file = arg;
+        } else {
+            if (options.input_file.empty()) {
+                options.input_file = arg;
+            }
+            options.input_files.push_back(arg);
         }
     }
 
@@ -107,17 +124,21 @@ void print_help() {
         << "Options:\n"
         << "  -h, --help              Show this help message\n"
         << "  -v, --version           Show version and exit\n"
-        << "  --headless              Run without GUI (for batch processing)\n"
+        << "  --headless              Never open a window; needs --screenshot or --render-batch\n"
         << "  --screenshot FILE       Open file, render, save screenshot, and exit\n"
+        << "  --render-batch FILE     Render every image listed in a JSON manifest, and exit\n"
         << "  --resolution WxH        Set screenshot resolution (default: 1920x1080)\n"
         << "  --orbital N             Select orbital N, or homo/lumo\n"
         << "  --render-mode MODE      volume, isosurface, phase\n"
         << "  --iso VALUE             Isosurface threshold (default: 0.01)\n"
         << "  --method METHOD         Computation method for --compute\n"
         << "  --basis BASIS           Basis set for --compute\n"
-        << "  --compute               Run a single-point calculation on the input file\n"
-        << "  --optimize              Run geometry optimization\n"
-        << "  --output FILE           Output file for --compute results\n"
+        << "  --compute               Run a single-point calculation on each input file\n"
+        << "  --optimize              Run geometry optimization on each input file\n"
+        << "  --manifest FILE         JSON list of --compute inputs with per-input settings\n"
+        << "  --jobs N                Calculations run at once (default: one per CPU thread)\n"
+        << "  --output FILE           JSON-lines results of --compute (default: stdout)\n"
+        << "  --append                Add to an existing --output file instead of replacing it\n"
         << "  --log-level LEVEL       trace, debug, info, warn, error\n"
         << "  --log-file FILE         Write log to file\n\n"
         << "Positional:\n"
@@ -1,15 +1,18 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace sbox {
 
 struct CLIOptions {
     std::string input_file;
+    std::vector<std::string> input_files;  // every positional argument; input_file is the first
     bool show_help = false;
     bool show_version = false;
     bool headless = false;
     std::string screenshot_path;
+    std::string render_manifest;
     int screenshot_width = 1920;
     int screenshot_height = 1080;
     int orbital = -1;
@@ -20,6 +23,9 @@ struct CLIOptions {
     bool compute = false;
     bool optimize = false;
     std::string output_file;
+    bool append_output = false;  // add to an existing --output file instead of replacing it
+    std::string compute_manifest;
+    int max_parallel_jobs = 0;
     std::string log_level = "info";
     std::string log_file;
 };
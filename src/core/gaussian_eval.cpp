@@ -1,5 +1,6 @@
 #include "core/gaussian_eval.h"
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 #include <vector>
@@ -211,6 +212,50 @@ void evaluate_basis_at_point(const MOData& mo_data,
     }
 }
 
+std::vector<double> shell_screening_radii2(const BasisSet& basis, double threshold) {
+    const double log_threshold = -std::log(threshold);
+    std::vector<double> radii2;
+    radii2.reserve(basis.shells.size());
+    for (const BasisShell& shell : basis.shells) {
+        double min_exponent = 0.0;
+        double max_coefficient = 0.0;
+        for (const GaussianPrimitive& primitive : shell.primitives) {
+            if (min_exponent == 0.0 || primitive.exponent < min_exponent) {
+                min_exponent = primitive.exponent;
+            }
+            max_coefficient = std::max(max_coefficient, std::abs(primitive.coefficient));
+        }
+        // |c| exp(-a r^2) < threshold; the polynomial prefactor is covered by the generous threshold.
+        const double reach = log_threshold + std::log(std::max(max_coefficient, 1.0));
+        radii2.push_back(min_exponent > 0.0 ? reach / min_exponent : 0.0);
+    }
+    return radii2;
+}
+
+void evaluate_basis_screened(const MOData& mo_data,
+                             const std::vector<double>& screening_radii2,
+                             const Eigen::Vector3d& point,
+                             std::vector<double>& values) {
+    if (screening_radii2.size() != mo_data.basis.shells.size()) {
+        throw std::runtime_error("Screening radii do not match the basis set");
+    }
+    values.assign(static_cast<std::size_t>(mo_data.basis.num_basis_functions()), 0.0);
+
+    int basis_offset = 0;
+    for (std::size_t i = 0; i < mo_data.basis.shells.size(); ++i) {
+        const BasisShell& shell = mo_data.basis.shells[i];
+        if (shell.atom_index < 0 || shell.atom_index >= static_cast<int>(mo_data.atom_positions.size())) {
+            throw std::runtime_error("Basis shell atom index out of range");
+        }
+        const Eigen::Vector3d& center = mo_data.atom_positions[static_cast<std::size_t>(shell.atom_index)];
+        if ((point - center).squaredNorm() > screening_radii2[i]) {
+            basis_offset += shell_basis_count(shell.angular_momentum, mo_data.basis.spherical);
+            continue;
+        }
+        basis_offset += evaluate_shell_impl(shell, center, point, basis_offset, values, mo_data.basis.spherical);
+    }
+}
+
 double evaluate_mo_at_point(const MOData& mo_data, int mo_index, const Eigen::Vector3d& point) {
     if (mo_index < 0 || mo_index >= mo_data.coefficients.cols()) {
         throw std::runtime_error("MO index out of range");
@@ -226,6 +271,47 @@ double evaluate_mo_density_at_point(const MOData& mo_data, int mo_index, const E
     return psi * psi;
 }
 
+Eigen::MatrixXd density_matrix(const MOData& mo_data) {
+    const Eigen::Index num_basis = mo_data.coefficients.rows();
+    Eigen::MatrixXd density = Eigen::MatrixXd::Zero(num_basis, num_basis);
+    for (Eigen::Index i = 0; i < mo_data.occupations.size() && i < mo_data.coefficients.cols(); ++i) {
+        const double occupation = mo_data.occupations(i);
+        if (occupation > 1.0e-8) {
+            density.selfadjointView<Eigen::Lower>().rankUpdate(mo_data.coefficients.col(i), occupation);
+        }
+    }
+    density.triangularView<Eigen::StrictlyUpper>() = density.transpose();
+    return density;
+}
+
+double contract_density(const Eigen::MatrixXd& density,
+                        const std::vector<double>& basis_values,
+                        std::vector<int>& active) {
+    if (density.rows() != static_cast<Eigen::Index>(basis_values.size()) || density.cols() != density.rows()) {
+        throw std::runtime_error("Density matrix does not match the basis set");
+    }
+    active.clear();
+    for (std::size_t mu = 0; mu < basis_values.size(); ++mu) {
+        if (basis_values[mu] != 0.0) {
+            active.push_back(static_cast<int>(mu));
+        }
+    }
+
+    // D is symmetric: diagonal once, each off-diagonal pair twice, reading D column by column.
+    double rho = 0.0;
+    for (std::size_t k = 0; k < active.size(); ++k) {
+        const int nu = active[k];
+        const double* column = density.data() + static_cast<std::size_t>(nu) * static_cast<std::size_t>(density.rows());
+        double off_diagonal = 0.0;
+        for (std::size_t m = 0; m < k; ++m) {
+            off_diagonal += column[active[m]] * basis_values[static_cast<std::size_t>(active[m])];
+        }
+        const double phi = basis_values[static_cast<std::size_t>(nu)];
+        rho += phi * (column[nu] * phi + 2.0 * off_diagonal);
+    }
+    return rho;
+}
+
 Eigen::VectorXd evaluate_mo_on_grid(const MOData& mo_data,
                                     int mo_index,
                                     const Eigen::Vector3d& origin,
@@ -27,10 +27,30 @@ void evaluate_basis_at_point(const MOData& mo_data,
                              const Eigen::Vector3d& point,
                              Eigen::VectorXd& basis_values);
 
+// Squared distance beyond which each shell's most diffuse primitive falls below `threshold`.
+std::vector<double> shell_screening_radii2(const BasisSet& basis, double threshold);
+
+// evaluate_basis_at_point() into a caller-owned buffer; shells farther from `point` than their
+// screening radius are left at zero instead of evaluated. Intended for dense grids.
+void evaluate_basis_screened(const MOData& mo_data,
+                             const std::vector<double>& screening_radii2,
+                             const Eigen::Vector3d& point,
+                             std::vector<double>& values);
+
 double evaluate_mo_at_point(const MOData& mo_data, int mo_index, const Eigen::Vector3d& point);
 
 double evaluate_mo_density_at_point(const MOData& mo_data, int mo_index, const Eigen::Vector3d& point);
 
+// One-particle density matrix D = sum_i n_i c_i c_i^T over the occupied orbitals, so that the total
+// electron density is rho = phi^T D phi.
+Eigen::MatrixXd density_matrix(const MOData& mo_data);
+
+// phi^T D phi over the nonzero entries of `basis_values` only, so the cost follows the number of basis
+// function pairs reaching the point. `active` is a caller-owned buffer for the nonzero indices.
+double contract_density(const Eigen::MatrixXd& density,
+                        const std::vector<double>& basis_values,
+                        std::vector<int>& active);
+
 Eigen::VectorXd evaluate_mo_on_grid(const MOData& mo_data,
                                     int mo_index,
                                     const Eigen::Vector3d& origin,
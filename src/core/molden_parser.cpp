@@ -154,7 +154,11 @@ sbox::basis::MOData parse_molden_file(const std::string& filepath, const ParseOp
 
     int current_gto_atom = -1;
 
+    constexpr std::size_t kProgressInterval = 4096;
     for (std::size_t i = 0; i < lines.size(); ++i) {
+        if (options.progress && i % kProgressInterval == 0) {
+            options.progress(static_cast<double>(i) / static_cast<double>(lines.size()));
+        }
         const std::string line = trim(lines[i]);
         if (line.empty()) {
             continue;
@@ -2,6 +2,7 @@
 
 #include "core/basis_set.h"
 
+#include <functional>
 #include <string>
 
 namespace sbox::molden {
@@ -9,6 +10,8 @@ namespace sbox::molden {
 struct ParseOptions {
     // If false, parser renormalizes contraction coefficients per shell.
     bool contraction_coefficients_include_shell_normalization = true;
+    // Called with the fraction of lines parsed every few thousand lines. It may throw to stop the parse.
+    std::function<void(double fraction)> progress;
 };
 
 sbox::basis::MOData parse_molden_file(const std::string& filepath);
@@ -251,4 +251,47 @@ const std::vector<Bond>& MolecularSystem::bonds() const {
     return bonds_;
 }
 
+void BondsByAtom::build(const MolecularSystem& mol) {
+    offsets.assign(static_cast<std::size_t>(mol.num_atoms()) + 1, 0);
+    for (const Bond& bond : mol.bonds()) {
+        ++offsets[static_cast<std::size_t>(bond.atom_i) + 1];
+        ++offsets[static_cast<std::size_t>(bond.atom_j) + 1];
+    }
+    for (std::size_t i = 1; i < offsets.size(); ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+    bonds.assign(offsets.back(), 0);
+    std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (std::size_t bond_index = 0; bond_index < mol.bonds().size(); ++bond_index) {
+        const Bond& bond = mol.bonds()[bond_index];
+        bonds[cursor[static_cast<std::size_t>(bond.atom_i)]++] = static_cast<std::uint32_t>(bond_index);
+        bonds[cursor[static_cast<std::size_t>(bond.atom_j)]++] = static_cast<std::uint32_t>(bond_index);
+    }
+}
+
+void BondsByAtom::clear() {
+    offsets.clear();
+    bonds.clear();
+}
+
+bool BondsByAtom::matches(const MolecularSystem& mol) const {
+    if (offsets.size() != static_cast<std::size_t>(mol.num_atoms()) + 1 || bonds.size() != 2 * mol.bonds().size()) {
+        return false;
+    }
+    // With the sizes equal, finding every bond under both of its atoms accounts for every entry.
+    const auto listed_under = [&](std::uint32_t bond_index, int atom) {
+        const auto first = bonds.begin() + offsets[static_cast<std::size_t>(atom)];
+        const auto last = bonds.begin() + offsets[static_cast<std::size_t>(atom) + 1];
+        return std::find(first, last, bond_index) != last;
+    };
+    for (std::size_t bond_index = 0; bond_index < mol.bonds().size(); ++bond_index) {
+        const Bond& bond = mol.bonds()[bond_index];
+        const auto index = static_cast<std::uint32_t>(bond_index);
+        if (!listed_under(index, bond.atom_i) || !listed_under(index, bond.atom_j)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 }  // namespace sbox::chem
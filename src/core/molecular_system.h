@@ -73,4 +73,18 @@ private:
     int multiplicity_ = 1;
 };
 
+// Bond indices grouped by atom, with every bond listed under both of its atoms: the bonds of atom a
+// are bonds[offsets[a]] up to, not including, bonds[offsets[a + 1]]. Empty until built.
+struct BondsByAtom {
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> bonds;
+
+    void build(const MolecularSystem& mol);
+    void clear();
+    bool built() const { return !offsets.empty(); }
+    // True when built for mol's current bond list. Checks every bond, not just the counts, so edits
+    // that replace a bond are caught.
+    bool matches(const MolecularSystem& mol) const;
+};
+
 }  // namespace sbox::chem
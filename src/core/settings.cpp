@@ -128,6 +128,9 @@ nlohmann::json Settings::to_json() const {
         {"window_maximized", window_maximized},
         {"volume_steps", volume_steps},
         {"isosurface_steps", isosurface_steps},
+        {"bake_orbitals", bake_orbitals},
+        {"progressive_raymarch", progressive_raymarch},
+        {"raymarch_budget_ms", raymarch_budget_ms},
         {"default_iso_value", default_iso_value},
         {"default_gamma", default_gamma},
         {"mol_render_mode", mol_render_mode},
@@ -181,6 +184,9 @@ Settings Settings::from_json(const nlohmann::json& j) {
     load_if_present(j, "window_maximized", settings.window_maximized);
     load_if_present(j, "volume_steps", settings.volume_steps);
     load_if_present(j, "isosurface_steps", settings.isosurface_steps);
+    load_if_present(j, "bake_orbitals", settings.bake_orbitals);
+    load_if_present(j, "progressive_raymarch", settings.progressive_raymarch);
+    load_if_present(j, "raymarch_budget_ms", settings.raymarch_budget_ms);
     load_if_present(j, "default_iso_value", settings.default_iso_value);
     load_if_present(j, "default_gamma", settings.default_gamma);
     load_if_present(j, "mol_render_mode", settings.mol_render_mode);
@@ -25,6 +25,9 @@ struct Settings {
 
     int volume_steps = 192;
     int isosurface_steps = 256;
+    bool bake_orbitals = true;  // ray-march MOs from a grid evaluated once per orbital, not from the shells
+    bool progressive_raymarch = true;  // coarse volumes while the view moves, accumulated detail when it stops
+    float raymarch_budget_ms = 12.0f;  // GPU time the coarse ray march aims for per frame
     float default_iso_value = 0.01f;
     float default_gamma = 0.4f;
     int mol_render_mode = 0;
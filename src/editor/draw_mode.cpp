@@ -76,7 +76,7 @@ void DrawMode::on_mouse_down(const Ray& ray, int button, bool shift,
         return;
     }
 
-    const PickResult hit = pick(ray, mol);
+    const PickResult hit = pick(ray, mol, spatial_index_);
     draw_plane_normal_ = ray.direction.normalized();
     const Eigen::Vector3f plane_point =
         mol.num_atoms() > 0 ? Eigen::Vector3f(mol.center_of_mass().cast<float>()) : Eigen::Vector3f::Zero();
@@ -112,7 +112,7 @@ void DrawMode::on_mouse_up(const Ray& ray, int button,
         return;
     }
 
-    const PickResult hit = pick(ray, mol);
+    const PickResult hit = pick(ray, mol, spatial_index_);
     if (hit.type == PickResult::Type::Atom && hit.index != bond_start_atom_) {
         if (mol.has_bond(bond_start_atom_, hit.index)) {
             for (int i = 0; i < mol.num_bonds(); ++i) {
@@ -170,7 +170,7 @@ void DrawMode::on_mouse_move(const Ray& ray, float dx, float dy, bool dragging,
     (void)selection;
     (void)commands;
 
-    const PickResult hover = pick(ray, mol);
+    const PickResult hover = pick(ray, mol, spatial_index_);
     hovered_atom_ = (hover.type == PickResult::Type::Atom) ? hover.index : -1;
 
     if (drawing_bond_) {
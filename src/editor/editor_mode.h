@@ -7,6 +7,8 @@
 
 #include <imgui.h>
 
+#include <vector>
+
 namespace sbox::editor {
 
 class EditorMode {
@@ -42,6 +44,17 @@ public:
 
     virtual const char* name() const = 0;
     virtual const char* cursor() const { return "arrow"; }
+    // Atoms the drag in progress is moving; the renderer re-sends only these while it lasts.
+    virtual const std::vector<int>& moving_atoms() const {
+        static const std::vector<int> none;
+        return none;
+    }
+
+    // Shared index over the edited molecule; picks fall back to linear scans while it is null or stale.
+    void set_spatial_index(const SpatialIndex* spatial_index) { spatial_index_ = spatial_index; }
+
+protected:
+    const SpatialIndex* spatial_index_ = nullptr;
 };
 
 }  // namespace sbox::editor
@@ -48,7 +48,7 @@ void EraseMode::on_mouse_down(const Ray& ray, int button, bool shift,
         return;
     }
 
-    const PickResult hit = pick(ray, mol);
+    const PickResult hit = pick(ray, mol, spatial_index_);
     if (hit.type == PickResult::Type::Atom) {
         commands.execute(std::make_unique<RemoveAtomCommand>(hit.index), mol);
         selection.clear();
@@ -79,7 +79,7 @@ void EraseMode::on_mouse_move(const Ray& ray, float dx, float dy, bool dragging,
     (void)selection;
     (void)commands;
 
-    const PickResult hit = pick(ray, mol);
+    const PickResult hit = pick(ray, mol, spatial_index_);
     hover_atom_ = (hit.type == PickResult::Type::Atom) ? hit.index : -1;
     hover_bond_ = (hit.type == PickResult::Type::Bond) ? hit.index : -1;
 }
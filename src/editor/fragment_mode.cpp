@@ -115,7 +115,7 @@ void FragmentMode::on_mouse_move(const Ray& ray, float dx, float dy, bool draggi
     const float plane_z = (mol.num_atoms() > 0) ? static_cast<float>(mol.center_of_mass().z()) : 0.0f;
     preview_position_ = ray_plane_intersect(ray, Eigen::Vector3f::UnitZ(), -plane_z);
 
-    const PickResult atom_hit = pick_atom(ray, mol, 1.2f);
+    const PickResult atom_hit = pick_atom(ray, mol, 1.2f, spatial_index_);
     hover_atom_ = -1;
     if (atom_hit.type == PickResult::Type::Atom) {
         hover_atom_ = atom_hit.index;
@@ -92,7 +92,7 @@ void MeasureMode::on_mouse_down(const Ray& ray, int button, bool shift,
         return;
     }
 
-    const PickResult hit = pick_atom(ray, mol);
+    const PickResult hit = pick_atom(ray, mol, 1.0f, spatial_index_);
     if (hit.type != PickResult::Type::Atom) {
         return;
     }
@@ -1,26 +1,13 @@
 #include "editor/picking.h"
 
+#include "editor/spatial_index.h"
+
 #include <algorithm>
 #include <cmath>
 #include <limits>
 
 namespace sbox::editor {
 
-namespace {
-
-float atom_pick_radius(int Z) {
-    switch (Z) {
-    case 1: return 0.6f;
-    case 6: return 1.0f;
-    case 7: return 0.95f;
-    case 8: return 0.9f;
-    case 16: return 1.2f;
-    default: return 0.8f;
-    }
-}
-
-}  // namespace
-
 Ray screen_to_ray(float screen_x,
                   float screen_y,
                   const ImVec2& viewport_pos,
@@ -42,26 +29,83 @@ Ray screen_to_ray(float screen_x,
     return ray;
 }
 
-PickResult pick_atom(const Ray& ray, const sbox::chem::MolecularSystem& mol, float radius_scale) {
+float atom_pick_radius(int Z) {
+    switch (Z) {
+    case 1: return 0.6f;
+    case 6: return 1.0f;
+    case 7: return 0.95f;
+    case 8: return 0.9f;
+    case 16: return kMaxAtomPickRadius;
+    default: return 0.8f;
+    }
+}
+
+float ray_sphere_distance(const Ray& ray, const Eigen::Vector3f& center, float radius) {
+    const Eigen::Vector3f oc = ray.origin - center;
+    const float b = oc.dot(ray.direction);
+    const float c = oc.dot(oc) - radius * radius;
+    const float discriminant = b * b - c;
+    if (discriminant < 0.0f) {
+        return -1.0f;
+    }
+
+    const float sqrt_disc = std::sqrt(discriminant);
+    float t = -b - sqrt_disc;
+    if (t < 0.0f) {
+        t = -b + sqrt_disc;
+    }
+    return t;
+}
+
+float ray_bond_distance(const Ray& ray, const Eigen::Vector3f& p0, const Eigen::Vector3f& p1, float radius) {
+    const Eigen::Vector3f segment = p1 - p0;
+    const float segment_len = segment.norm();
+    if (segment_len <= 1.0e-6f) {
+        return -1.0f;
+    }
+
+    const Eigen::Vector3f axis = segment / segment_len;
+    const Eigen::Vector3f op_full = ray.origin - p0;
+    const Eigen::Vector3f dp = ray.direction - ray.direction.dot(axis) * axis;
+    const Eigen::Vector3f op = op_full - op_full.dot(axis) * axis;
+
+    const float a = dp.dot(dp);
+    if (a <= 1.0e-8f) {
+        return -1.0f;
+    }
+    const float b = 2.0f * op.dot(dp);
+    const float c = op.dot(op) - radius * radius;
+    const float discriminant = b * b - 4.0f * a * c;
+    if (discriminant < 0.0f) {
+        return -1.0f;
+    }
+
+    const float sqrt_disc = std::sqrt(discriminant);
+    float t = (-b - sqrt_disc) / (2.0f * a);
+    if (t < 0.0f) {
+        t = (-b + sqrt_disc) / (2.0f * a);
+    }
+    if (t < 0.0f) {
+        return -1.0f;
+    }
+
+    const float axis_t = (ray.origin + t * ray.direction - p0).dot(axis);
+    if (axis_t < 0.0f || axis_t > segment_len) {
+        return -1.0f;
+    }
+    return t;
+}
+
+PickResult pick_atom(const Ray& ray, const sbox::chem::MolecularSystem& mol, float radius_scale, const SpatialIndex* index) {
+    if (index != nullptr && index->matches(mol)) {
+        return index->pick_atom(ray, mol, radius_scale);
+    }
+
     PickResult best;
     best.distance = std::numeric_limits<float>::infinity();
 
     for (int i = 0; i < mol.num_atoms(); ++i) {
-        const Eigen::Vector3f center = mol.atom(i).position.cast<float>();
-        const float radius = atom_pick_radius(mol.atom(i).Z) * radius_scale;
-        const Eigen::Vector3f oc = ray.origin - center;
-        const float b = oc.dot(ray.direction);
-        const float c = oc.dot(oc) - radius * radius;
-        const float discriminant = b * b - c;
-        if (discriminant < 0.0f) {
-            continue;
-        }
-
-        const float sqrt_disc = std::sqrt(discriminant);
-        float t = -b - sqrt_disc;
-        if (t < 0.0f) {
-            t = -b + sqrt_disc;
-        }
+        const float t = ray_sphere_distance(ray, mol.atom(i).position.cast<float>(), atom_pick_radius(mol.atom(i).Z) * radius_scale);
         if (t < 0.0f || t >= best.distance) {
             continue;
         }
@@ -78,55 +122,28 @@ PickResult pick_atom(const Ray& ray, const sbox::chem::MolecularSystem& mol, flo
     return best;
 }
 
-PickResult pick_bond(const Ray& ray, const sbox::chem::MolecularSystem& mol, float radius) {
+PickResult pick_bond(const Ray& ray, const sbox::chem::MolecularSystem& mol, float radius, const SpatialIndex* index) {
+    if (index != nullptr && index->matches(mol)) {
+        return index->pick_bond(ray, mol, radius);
+    }
+
     PickResult best;
     best.distance = std::numeric_limits<float>::infinity();
 
     for (int i = 0; i < mol.num_bonds(); ++i) {
         const sbox::chem::Bond& bond = mol.bond(i);
-        const Eigen::Vector3f p0 = mol.atom(bond.atom_i).position.cast<float>();
-        const Eigen::Vector3f p1 = mol.atom(bond.atom_j).position.cast<float>();
-        const Eigen::Vector3f segment = p1 - p0;
-        const float segment_len = segment.norm();
-        if (segment_len <= 1.0e-6f) {
-            continue;
-        }
-
-        const Eigen::Vector3f axis = segment / segment_len;
-        const Eigen::Vector3f op_full = ray.origin - p0;
-        const Eigen::Vector3f dp = ray.direction - ray.direction.dot(axis) * axis;
-        const Eigen::Vector3f op = op_full - op_full.dot(axis) * axis;
-
-        const float a = dp.dot(dp);
-        if (a <= 1.0e-8f) {
-            continue;
-        }
-        const float b = 2.0f * op.dot(dp);
-        const float c = op.dot(op) - radius * radius;
-        const float discriminant = b * b - 4.0f * a * c;
-        if (discriminant < 0.0f) {
-            continue;
-        }
-
-        const float sqrt_disc = std::sqrt(discriminant);
-        float t = (-b - sqrt_disc) / (2.0f * a);
-        if (t < 0.0f) {
-            t = (-b + sqrt_disc) / (2.0f * a);
-        }
+        const float t = ray_bond_distance(ray,
+                                          mol.atom(bond.atom_i).position.cast<float>(),
+                                          mol.atom(bond.atom_j).position.cast<float>(),
+                                          radius);
         if (t < 0.0f || t >= best.distance) {
             continue;
         }
 
-        const Eigen::Vector3f hit_point = ray.origin + t * ray.direction;
-        const float axis_t = (hit_point - p0).dot(axis);
-        if (axis_t < 0.0f || axis_t > segment_len) {
-            continue;
-        }
-
         best.type = PickResult::Type::Bond;
         best.index = i;
         best.distance = t;
-        best.hit_point = hit_point;
+        best.hit_point = ray.origin + t * ray.direction;
     }
 
     if (best.type == PickResult::Type::None) {
@@ -135,9 +152,9 @@ PickResult pick_bond(const Ray& ray, const sbox::chem::MolecularSystem& mol, flo
     return best;
 }
 
-PickResult pick(const Ray& ray, const sbox::chem::MolecularSystem& mol) {
-    const PickResult atom_hit = pick_atom(ray, mol);
-    const PickResult bond_hit = pick_bond(ray, mol);
+PickResult pick(const Ray& ray, const sbox::chem::MolecularSystem& mol, const SpatialIndex* index) {
+    const PickResult atom_hit = pick_atom(ray, mol, 1.0f, index);
+    const PickResult bond_hit = pick_bond(ray, mol, 0.3f, index);
 
     if (atom_hit.type == PickResult::Type::None) {
         return bond_hit;
@@ -29,15 +29,30 @@ Ray screen_to_ray(float screen_x,
                   const ImVec2& viewport_size,
                   const Eigen::Matrix4f& inv_vp);
 
+// Largest atom_pick_radius() of any element; spatial queries inflate their boxes by it.
+inline constexpr float kMaxAtomPickRadius = 1.2f;
+
+float atom_pick_radius(int Z);
+
+// Distance along the ray to the first hit in front of its origin, or a negative value on a miss.
+float ray_sphere_distance(const Ray& ray, const Eigen::Vector3f& center, float radius);
+float ray_bond_distance(const Ray& ray, const Eigen::Vector3f& p0, const Eigen::Vector3f& p1, float radius);
+
+class SpatialIndex;
+
+// The pick functions go through `index` when it was built for `mol` and test every atom or bond
+// otherwise.
 PickResult pick_atom(const Ray& ray,
                      const sbox::chem::MolecularSystem& mol,
-                     float radius_scale = 1.0f);
+                     float radius_scale = 1.0f,
+                     const SpatialIndex* index = nullptr);
 
 PickResult pick_bond(const Ray& ray,
                      const sbox::chem::MolecularSystem& mol,
-                     float radius = 0.3f);
+                     float radius = 0.3f,
+                     const SpatialIndex* index = nullptr);
 
-PickResult pick(const Ray& ray, const sbox::chem::MolecularSystem& mol);
+PickResult pick(const Ray& ray, const sbox::chem::MolecularSystem& mol, const SpatialIndex* index = nullptr);
 
 struct Selection {
     std::vector<int> atoms;
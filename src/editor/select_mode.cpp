@@ -1,5 +1,6 @@
 #include "editor/select_mode.h"
 
+#include "editor/spatial_index.h"
 #include "ui/context_menu.h"
 
 #include <GLFW/glfw3.h>
@@ -11,17 +12,6 @@ namespace sbox::editor {
 
 namespace {
 
-float atom_render_radius_for_pick(int Z) {
-    switch (Z) {
-    case 1: return 0.6f;
-    case 6: return 1.0f;
-    case 7: return 0.95f;
-    case 8: return 0.9f;
-    case 16: return 1.2f;
-    default: return 0.8f;
-    }
-}
-
 ImVec2 world_to_screen(const Eigen::Vector3f& world_pos,
                        const Eigen::Matrix4f& vp_matrix,
                        const ImVec2& viewport_pos,
@@ -72,7 +62,7 @@ void SelectMode::on_mouse_down(const Ray& ray, int button, bool shift,
     (void)commands;
 
     if (button == 0) {
-        const PickResult hit = pick(ray, mol);
+        const PickResult hit = pick(ray, mol, spatial_index_);
         dragging_ = true;
         drag_start_ray_ = ray;
 
@@ -80,6 +70,10 @@ void SelectMode::on_mouse_down(const Ray& ray, int button, bool shift,
             if (!shift) {
                 selection.clear();
             }
+            // Shift-drag on empty space draws a selection box that adds to the selection.
+            box_selecting_ = shift;
+            box_start_ = ImGui::GetMousePos();
+            box_end_ = box_start_;
             is_drag_move_ = false;
             drag_atom_indices_.clear();
             drag_original_positions_.clear();
@@ -132,7 +126,7 @@ void SelectMode::on_mouse_down(const Ray& ray, int button, bool shift,
 
     if (button == 1) {
         if (context_menu_state_ != nullptr) {
-            const PickResult hit = pick(ray, mol);
+            const PickResult hit = pick(ray, mol, spatial_index_);
             context_menu_state_->show = true;
             context_menu_state_->position = ImGui::GetMousePos();
             context_menu_state_->clicked_atom = hit.type == PickResult::Type::Atom ? hit.index : -1;
@@ -145,12 +139,15 @@ void SelectMode::on_mouse_up(const Ray& ray, int button,
                              sbox::chem::MolecularSystem& mol,
                              Selection& selection,
                              CommandStack& commands) {
-    (void)selection;
-
     if (button != 0) {
         return;
     }
 
+    if (box_selecting_) {
+        box_selecting_ = false;
+        select_atoms_in_box(mol, selection);
+    }
+
     if (is_drag_move_ && !drag_atom_indices_.empty()) {
         std::vector<Eigen::Vector3d> final_positions;
         final_positions.reserve(drag_atom_indices_.size());
@@ -184,6 +181,13 @@ void SelectMode::on_mouse_move(const Ray& ray, float dx, float dy, bool dragging
     (void)selection;
     (void)commands;
 
+    if (box_selecting_) {
+        if (dragging) {
+            box_end_ = ImGui::GetMousePos();
+        }
+        return;
+    }
+
     if (!dragging || !dragging_ || !is_drag_move_ || drag_atom_indices_.empty()) {
         return;
     }
@@ -241,6 +245,16 @@ void SelectMode::draw_overlay(ImDrawList* draw_list,
                               const ImVec2& viewport_pos,
                               const ImVec2& viewport_size) {
     const ImU32 accent = IM_COL32(45, 185, 185, 255);
+    overlay_vp_ = vp_matrix;
+    overlay_viewport_pos_ = viewport_pos;
+    overlay_viewport_size_ = viewport_size;
+
+    if (box_selecting_) {
+        const ImVec2 box_min(std::min(box_start_.x, box_end_.x), std::min(box_start_.y, box_end_.y));
+        const ImVec2 box_max(std::max(box_start_.x, box_end_.x), std::max(box_start_.y, box_end_.y));
+        draw_list->AddRectFilled(box_min, box_max, IM_COL32(45, 185, 185, 40));
+        draw_list->AddRect(box_min, box_max, accent, 0.0f, 0, 1.5f);
+    }
 
     for (int atom_index : selection.atoms) {
         if (atom_index < 0 || atom_index >= mol.num_atoms()) {
@@ -255,7 +269,7 @@ void SelectMode::draw_overlay(ImDrawList* draw_list,
 
         bool visible_radius = false;
         const ImVec2 screen_radius = world_to_screen(
-            center + Eigen::Vector3f(atom_render_radius_for_pick(mol.atom(atom_index).Z), 0.0f, 0.0f),
+            center + Eigen::Vector3f(atom_pick_radius(mol.atom(atom_index).Z), 0.0f, 0.0f),
             vp_matrix,
             viewport_pos,
             viewport_size,
@@ -285,4 +299,41 @@ void SelectMode::draw_overlay(ImDrawList* draw_list,
 
 }
 
+void SelectMode::select_atoms_in_box(const sbox::chem::MolecularSystem& mol, Selection& selection) const {
+    constexpr float kMinBoxPixels = 3.0f;
+    if (std::abs(box_end_.x - box_start_.x) < kMinBoxPixels || std::abs(box_end_.y - box_start_.y) < kMinBoxPixels ||
+        overlay_viewport_size_.x <= 0.0f || overlay_viewport_size_.y <= 0.0f) {
+        return;
+    }
+
+    const auto to_ndc = [&](const ImVec2& p) {
+        return Eigen::Vector2f((p.x - overlay_viewport_pos_.x) / overlay_viewport_size_.x * 2.0f - 1.0f,
+                               1.0f - (p.y - overlay_viewport_pos_.y) / overlay_viewport_size_.y * 2.0f);
+    };
+    const Eigen::Vector2f a = to_ndc(box_start_);
+    const Eigen::Vector2f b = to_ndc(box_end_);
+
+    SpatialIndex local_index;
+    const SpatialIndex* index = spatial_index_;
+    if (index == nullptr || !index->matches(mol)) {
+        local_index.build(mol);
+        index = &local_index;
+    }
+    std::vector<int> boxed;
+    index->query_screen_rect(overlay_vp_, a.cwiseMin(b), a.cwiseMax(b), boxed);
+    std::sort(boxed.begin(), boxed.end());
+
+    std::vector<char> selected(static_cast<std::size_t>(mol.num_atoms()), 0);
+    for (int atom_index : selection.atoms) {
+        if (atom_index >= 0 && atom_index < mol.num_atoms()) {
+            selected[static_cast<std::size_t>(atom_index)] = 1;
+        }
+    }
+    for (int atom_index : boxed) {
+        if (selected[static_cast<std::size_t>(atom_index)] == 0) {
+            selection.atoms.push_back(atom_index);
+        }
+    }
+}
+
 }  // namespace sbox::editor
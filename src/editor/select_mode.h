@@ -40,8 +40,14 @@ public:
                       const ImVec2& viewport_size) override;
 
     const char* name() const override { return "Select"; }
+    const std::vector<int>& moving_atoms() const override {
+        return dragging_ && is_drag_move_ ? drag_atom_indices_ : EditorMode::moving_atoms();
+    }
 
 private:
+    // Adds the atoms whose centres project inside the drag box, using the camera of the last overlay.
+    void select_atoms_in_box(const sbox::chem::MolecularSystem& mol, Selection& selection) const;
+
     bool dragging_ = false;
     bool is_drag_move_ = false;
     Eigen::Vector3f drag_start_ = Eigen::Vector3f::Zero();
@@ -50,6 +56,12 @@ private:
     std::vector<Eigen::Vector3d> drag_original_positions_;
     Eigen::Vector3f drag_plane_normal_ = Eigen::Vector3f::UnitZ();
     float drag_plane_d_ = 0.0f;
+    bool box_selecting_ = false;
+    ImVec2 box_start_;
+    ImVec2 box_end_;
+    Eigen::Matrix4f overlay_vp_ = Eigen::Matrix4f::Identity();
+    ImVec2 overlay_viewport_pos_;
+    ImVec2 overlay_viewport_size_;
     sbox::ui::ContextMenuState* context_menu_state_ = nullptr;
 };
 
@@ -0,0 +1,546 @@
+#include "editor/spatial_index.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace sbox::editor {
+
+namespace {
+
+constexpr int kLeafSize = 4;
+constexpr int kMaxStackDepth = 64;
+
+struct Plane {
+    Eigen::Vector3f normal = Eigen::Vector3f::Zero();
+    float d = 0.0f;
+};
+
+Plane normalize_plane(const Eigen::Vector4f& coeffs) {
+    Plane plane;
+    plane.normal = coeffs.head<3>();
+    const float len = plane.normal.norm();
+    if (len > 1.0e-6f) {
+        plane.normal /= len;
+        plane.d = coeffs.w() / len;
+    } else {
+        plane.d = coeffs.w();
+    }
+    return plane;
+}
+
+// Returns -1 when the box is outside one of the planes, 1 when it is inside all of them and 0 when
+// it straddles. Every plane is moved outwards by `margin`.
+template <std::size_t N>
+int classify_box(const Eigen::Vector3f& box_min,
+                 const Eigen::Vector3f& box_max,
+                 const std::array<Plane, N>& planes,
+                 float margin) {
+    bool inside = true;
+    for (const Plane& plane : planes) {
+        Eigen::Vector3f positive = box_min;
+        Eigen::Vector3f negative = box_max;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (plane.normal[axis] >= 0.0f) {
+                positive[axis] = box_max[axis];
+                negative[axis] = box_min[axis];
+            }
+        }
+        if (plane.normal.dot(positive) + plane.d + margin < 0.0f) {
+            return -1;
+        }
+        if (plane.normal.dot(negative) + plane.d + margin < 0.0f) {
+            inside = false;
+        }
+    }
+    return inside ? 1 : 0;
+}
+
+Eigen::Vector3f safe_inverse(const Eigen::Vector3f& direction) {
+    Eigen::Vector3f inverse;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float d = direction[axis];
+        inverse[axis] = 1.0f / (std::abs(d) > 1.0e-20f ? d : std::copysign(1.0e-20f, d));
+    }
+    return inverse;
+}
+
+// Entry distance of the ray into the box grown by `inflate`, or a negative value when it misses
+// the box or only reaches it past max_t.
+float ray_box_entry(const Ray& ray,
+                    const Eigen::Vector3f& inv_dir,
+                    const Eigen::Vector3f& box_min,
+                    const Eigen::Vector3f& box_max,
+                    float inflate,
+                    float max_t) {
+    float t_near = 0.0f;
+    float t_far = max_t;
+    for (int axis = 0; axis < 3; ++axis) {
+        float t0 = (box_min[axis] - inflate - ray.origin[axis]) * inv_dir[axis];
+        float t1 = (box_max[axis] + inflate - ray.origin[axis]) * inv_dir[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        t_near = std::max(t_near, t0);
+        t_far = std::min(t_far, t1);
+        if (t_near > t_far) {
+            return -1.0f;
+        }
+    }
+    return t_near;
+}
+
+}  // namespace
+
+void SpatialIndex::Tree::build() {
+    nodes.clear();
+    parent.clear();
+    const int count = static_cast<int>(item_min.size());
+    order.resize(static_cast<std::size_t>(count));
+    leaf_of.assign(static_cast<std::size_t>(count), 0);
+    for (int i = 0; i < count; ++i) {
+        order[static_cast<std::size_t>(i)] = i;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    std::vector<Eigen::Vector3f> centroids(static_cast<std::size_t>(count));
+    for (std::size_t i = 0; i < centroids.size(); ++i) {
+        centroids[i] = 0.5f * (item_min[i] + item_max[i]);
+    }
+    nodes.reserve(static_cast<std::size_t>(2 * count / kLeafSize + 1));
+    build_range(0, count, -1, centroids);
+    node_dirty.assign(nodes.size(), 0);
+}
+
+int SpatialIndex::Tree::build_range(int begin,
+                                    int end,
+                                    int parent_index,
+                                    std::vector<Eigen::Vector3f>& centroids) {
+    const int node_index = static_cast<int>(nodes.size());
+    nodes.emplace_back();
+    parent.push_back(parent_index);
+    nodes.back().first = begin;
+    nodes.back().count = end - begin;
+    const auto make_leaf = [&] {
+        for (int k = begin; k < end; ++k) {
+            leaf_of[static_cast<std::size_t>(order[static_cast<std::size_t>(k)])] = node_index;
+        }
+        fit_leaf(nodes.back());
+        return node_index;
+    };
+    if (end - begin <= kLeafSize) {
+        return make_leaf();
+    }
+
+    Eigen::Vector3f centroid_min = Eigen::Vector3f::Constant(std::numeric_limits<float>::max());
+    Eigen::Vector3f centroid_max = Eigen::Vector3f::Constant(std::numeric_limits<float>::lowest());
+    for (int k = begin; k < end; ++k) {
+        const Eigen::Vector3f& c = centroids[static_cast<std::size_t>(order[static_cast<std::size_t>(k)])];
+        centroid_min = centroid_min.cwiseMin(c);
+        centroid_max = centroid_max.cwiseMax(c);
+    }
+    int axis = 0;
+    (centroid_max - centroid_min).maxCoeff(&axis);
+    if (centroid_max[axis] <= centroid_min[axis]) {
+        return make_leaf();  // coincident items cannot be split
+    }
+
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&](int a, int b) {
+        return centroids[static_cast<std::size_t>(a)][axis] < centroids[static_cast<std::size_t>(b)][axis];
+    });
+    build_range(begin, mid, node_index, centroids);
+    nodes[static_cast<std::size_t>(node_index)].right = build_range(mid, end, node_index, centroids);
+    fit_inner(static_cast<std::size_t>(node_index));
+    return node_index;
+}
+
+void SpatialIndex::Tree::fit_leaf(Node& node) const {
+    node.box_min = Eigen::Vector3f::Constant(std::numeric_limits<float>::max());
+    node.box_max = Eigen::Vector3f::Constant(std::numeric_limits<float>::lowest());
+    for (int k = node.first; k < node.first + node.count; ++k) {
+        const std::size_t item = static_cast<std::size_t>(order[static_cast<std::size_t>(k)]);
+        node.box_min = node.box_min.cwiseMin(item_min[item]);
+        node.box_max = node.box_max.cwiseMax(item_max[item]);
+    }
+}
+
+void SpatialIndex::Tree::fit_inner(std::size_t node_index) {
+    Node& node = nodes[node_index];
+    const Node& left = nodes[node_index + 1];
+    const Node& right = nodes[static_cast<std::size_t>(node.right)];
+    node.box_min = left.box_min.cwiseMin(right.box_min);
+    node.box_max = left.box_max.cwiseMax(right.box_max);
+}
+
+void SpatialIndex::Tree::refit() {
+    for (std::size_t i = nodes.size(); i-- > 0;) {
+        if (nodes[i].right < 0) {
+            fit_leaf(nodes[i]);
+        } else {
+            fit_inner(i);
+        }
+    }
+}
+
+void SpatialIndex::Tree::refit_items(const std::vector<int>& items) {
+    dirty_nodes.clear();
+    for (int item : items) {
+        // Paths of nearby items merge quickly; stop at the first node another item already marked.
+        int node = leaf_of[static_cast<std::size_t>(item)];
+        for (; node >= 0 && !node_dirty[static_cast<std::size_t>(node)]; node = parent[static_cast<std::size_t>(node)]) {
+            node_dirty[static_cast<std::size_t>(node)] = 1;
+            dirty_nodes.push_back(node);
+        }
+    }
+    // Children come after their parents, so descending indices refit bottom-up.
+    std::sort(dirty_nodes.begin(), dirty_nodes.end(), std::greater<int>());
+    for (int node : dirty_nodes) {
+        const std::size_t i = static_cast<std::size_t>(node);
+        if (nodes[i].right < 0) {
+            fit_leaf(nodes[i]);
+        } else {
+            fit_inner(i);
+        }
+        node_dirty[i] = 0;
+    }
+}
+
+void SpatialIndex::fill_item_boxes(const sbox::chem::MolecularSystem& mol) {
+    const std::size_t atom_count = static_cast<std::size_t>(mol.num_atoms());
+    atoms_.item_min.resize(atom_count);
+    atoms_.item_max.resize(atom_count);
+    for (std::size_t i = 0; i < atom_count; ++i) {
+        atoms_.item_min[i] = mol.atoms()[i].position.cast<float>();
+        atoms_.item_max[i] = atoms_.item_min[i];
+    }
+
+    const int bond_count = mol.num_bonds();
+    bonds_.item_min.resize(static_cast<std::size_t>(bond_count));
+    bonds_.item_max.resize(static_cast<std::size_t>(bond_count));
+    for (int i = 0; i < bond_count; ++i) {
+        fill_bond_box(mol, i);
+    }
+}
+
+void SpatialIndex::fill_bond_box(const sbox::chem::MolecularSystem& mol, int bond_index) {
+    const sbox::chem::Bond& bond = mol.bonds()[static_cast<std::size_t>(bond_index)];
+    const Eigen::Vector3f& p0 = atoms_.item_min[static_cast<std::size_t>(bond.atom_i)];
+    const Eigen::Vector3f& p1 = atoms_.item_min[static_cast<std::size_t>(bond.atom_j)];
+    bonds_.item_min[static_cast<std::size_t>(bond_index)] = p0.cwiseMin(p1);
+    bonds_.item_max[static_cast<std::size_t>(bond_index)] = p0.cwiseMax(p1);
+}
+
+void SpatialIndex::build(const sbox::chem::MolecularSystem& mol) {
+    fill_item_boxes(mol);
+    atoms_.build();
+    bonds_.build();
+    bonds_by_atom_.build(mol);
+}
+
+void SpatialIndex::refit(const sbox::chem::MolecularSystem& mol) {
+    if (!matches(mol)) {
+        build(mol);
+        return;
+    }
+    fill_item_boxes(mol);
+    atoms_.refit();
+    bonds_.refit();
+}
+
+void SpatialIndex::refit_atoms(const sbox::chem::MolecularSystem& mol, const std::vector<int>& moved_atoms) {
+    // Only the counts are checked here: a full topology check would cost O(n) per drag frame.
+    if (!matches(mol)) {
+        build(mol);
+        return;
+    }
+    moved_bonds_.clear();
+    for (int atom_index : moved_atoms) {
+        const std::size_t a = static_cast<std::size_t>(atom_index);
+        atoms_.item_min[a] = mol.atoms()[a].position.cast<float>();
+        atoms_.item_max[a] = atoms_.item_min[a];
+        for (std::uint32_t k = bonds_by_atom_.offsets[a]; k < bonds_by_atom_.offsets[a + 1]; ++k) {
+            moved_bonds_.push_back(static_cast<int>(bonds_by_atom_.bonds[k]));
+        }
+    }
+    // A bond between two moved atoms is listed twice; refitting it twice is harmless.
+    for (int bond_index : moved_bonds_) {
+        fill_bond_box(mol, bond_index);
+    }
+    atoms_.refit_items(moved_atoms);
+    bonds_.refit_items(moved_bonds_);
+}
+
+void SpatialIndex::update(const sbox::chem::MolecularSystem& mol) {
+    if (!matches(mol) || !bonds_by_atom_.matches(mol)) {
+        build(mol);
+        return;
+    }
+    moved_atoms_.clear();
+    for (int i = 0; i < mol.num_atoms(); ++i) {
+        const std::size_t a = static_cast<std::size_t>(i);
+        if (atoms_.item_min[a] != mol.atoms()[a].position.cast<float>()) {
+            moved_atoms_.push_back(i);
+        }
+    }
+    if (moved_atoms_.empty()) {
+        return;
+    }
+    // Past about half the atoms the shared ancestors make path refits dearer than a full sweep.
+    if (2 * moved_atoms_.size() > static_cast<std::size_t>(mol.num_atoms())) {
+        refit(mol);
+        return;
+    }
+    refit_atoms(mol, moved_atoms_);
+}
+
+void SpatialIndex::clear() {
+    atoms_ = Tree{};
+    bonds_ = Tree{};
+    bonds_by_atom_.clear();
+}
+
+bool SpatialIndex::matches(const sbox::chem::MolecularSystem& mol) const {
+    return num_atoms() == mol.num_atoms() && num_bonds() == mol.num_bonds();
+}
+
+int SpatialIndex::num_atoms() const {
+    return static_cast<int>(atoms_.item_min.size());
+}
+
+int SpatialIndex::num_bonds() const {
+    return static_cast<int>(bonds_.item_min.size());
+}
+
+PickResult SpatialIndex::pick_atom(const Ray& ray, const sbox::chem::MolecularSystem& mol, float radius_scale) const {
+    PickResult best;
+    best.distance = std::numeric_limits<float>::infinity();
+    if (atoms_.nodes.empty()) {
+        best.distance = 0.0f;
+        return best;
+    }
+
+    const Eigen::Vector3f inv_dir = safe_inverse(ray.direction);
+    const float inflate = kMaxAtomPickRadius * radius_scale;
+    std::array<int, kMaxStackDepth> stack{};
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+        const int node_index = stack[--stack_size];
+        const Node& node = atoms_.nodes[static_cast<std::size_t>(node_index)];
+        if (ray_box_entry(ray, inv_dir, node.box_min, node.box_max, inflate, best.distance) < 0.0f) {
+            continue;
+        }
+        if (node.right >= 0) {
+            const Node& left = atoms_.nodes[static_cast<std::size_t>(node_index + 1)];
+            const Node& right = atoms_.nodes[static_cast<std::size_t>(node.right)];
+            const float t_left = ray_box_entry(ray, inv_dir, left.box_min, left.box_max, inflate, best.distance);
+            const float t_right = ray_box_entry(ray, inv_dir, right.box_min, right.box_max, inflate, best.distance);
+            // Push the farther child first so the nearer one is visited first and tightens best.distance.
+            if (t_left <= t_right) {
+                stack[stack_size++] = node.right;
+                stack[stack_size++] = node_index + 1;
+            } else {
+                stack[stack_size++] = node_index + 1;
+                stack[stack_size++] = node.right;
+            }
+            continue;
+        }
+        for (int k = node.first; k < node.first + node.count; ++k) {
+            const int atom_index = atoms_.order[static_cast<std::size_t>(k)];
+            const sbox::chem::Atom& atom = mol.atom(atom_index);
+            const float t = ray_sphere_distance(ray, atom.position.cast<float>(), atom_pick_radius(atom.Z) * radius_scale);
+            if (t < 0.0f || t > best.distance || (t == best.distance && atom_index > best.index)) {
+                continue;
+            }
+            best.type = PickResult::Type::Atom;
+            best.index = atom_index;
+            best.distance = t;
+            best.hit_point = ray.origin + t * ray.direction;
+        }
+    }
+
+    if (best.type == PickResult::Type::None) {
+        best.distance = 0.0f;
+    }
+    return best;
+}
+
+PickResult SpatialIndex::pick_bond(const Ray& ray, const sbox::chem::MolecularSystem& mol, float radius) const {
+    PickResult best;
+    best.distance = std::numeric_limits<float>::infinity();
+    if (bonds_.nodes.empty()) {
+        best.distance = 0.0f;
+        return best;
+    }
+
+    const Eigen::Vector3f inv_dir = safe_inverse(ray.direction);
+    std::array<int, kMaxStackDepth> stack{};
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+        const int node_index = stack[--stack_size];
+        const Node& node = bonds_.nodes[static_cast<std::size_t>(node_index)];
+        if (ray_box_entry(ray, inv_dir, node.box_min, node.box_max, radius, best.distance) < 0.0f) {
+            continue;
+        }
+        if (node.right >= 0) {
+            const Node& left = bonds_.nodes[static_cast<std::size_t>(node_index + 1)];
+            const Node& right = bonds_.nodes[static_cast<std::size_t>(node.right)];
+            const float t_left = ray_box_entry(ray, inv_dir, left.box_min, left.box_max, radius, best.distance);
+            const float t_right = ray_box_entry(ray, inv_dir, right.box_min, right.box_max, radius, best.distance);
+            if (t_left <= t_right) {
+                stack[stack_size++] = node.right;
+                stack[stack_size++] = node_index + 1;
+            } else {
+                stack[stack_size++] = node_index + 1;
+                stack[stack_size++] = node.right;
+            }
+            continue;
+        }
+        for (int k = node.first; k < node.first + node.count; ++k) {
+            const int bond_index = bonds_.order[static_cast<std::size_t>(k)];
+            const sbox::chem::Bond& bond = mol.bond(bond_index);
+            const float t = ray_bond_distance(ray,
+                                              mol.atom(bond.atom_i).position.cast<float>(),
+                                              mol.atom(bond.atom_j).position.cast<float>(),
+                                              radius);
+            if (t < 0.0f || t > best.distance || (t == best.distance && bond_index > best.index)) {
+                continue;
+            }
+            best.type = PickResult::Type::Bond;
+            best.index = bond_index;
+            best.distance = t;
+            best.hit_point = ray.origin + t * ray.direction;
+        }
+    }
+
+    if (best.type == PickResult::Type::None) {
+        best.distance = 0.0f;
+    }
+    return best;
+}
+
+void SpatialIndex::query_sphere(const Eigen::Vector3f& center, float radius, std::vector<int>& atoms) const {
+    if (atoms_.nodes.empty()) {
+        return;
+    }
+    const float radius_sq = radius * radius;
+    std::array<int, kMaxStackDepth> stack{};
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+        const int node_index = stack[--stack_size];
+        const Node& node = atoms_.nodes[static_cast<std::size_t>(node_index)];
+        const Eigen::Vector3f nearest = center.cwiseMax(node.box_min).cwiseMin(node.box_max);
+        if ((nearest - center).squaredNorm() > radius_sq) {
+            continue;
+        }
+        if (node.right >= 0) {
+            stack[stack_size++] = node.right;
+            stack[stack_size++] = node_index + 1;
+            continue;
+        }
+        for (int k = node.first; k < node.first + node.count; ++k) {
+            const int atom_index = atoms_.order[static_cast<std::size_t>(k)];
+            if ((atoms_.item_min[static_cast<std::size_t>(atom_index)] - center).squaredNorm() <= radius_sq) {
+                atoms.push_back(atom_index);
+            }
+        }
+    }
+}
+
+void SpatialIndex::query_frustum(const Eigen::Matrix4f& vp_matrix, float margin, std::vector<std::uint32_t>& atoms) const {
+    if (atoms_.nodes.empty()) {
+        return;
+    }
+    const Eigen::Vector4f row0 = vp_matrix.row(0);
+    const Eigen::Vector4f row1 = vp_matrix.row(1);
+    const Eigen::Vector4f row2 = vp_matrix.row(2);
+    const Eigen::Vector4f row3 = vp_matrix.row(3);
+    const std::array<Plane, 6> planes = {{
+        normalize_plane(row3 + row0),
+        normalize_plane(row3 - row0),
+        normalize_plane(row3 + row1),
+        normalize_plane(row3 - row1),
+        normalize_plane(row3 + row2),
+        normalize_plane(row3 - row2),
+    }};
+
+    std::array<int, kMaxStackDepth> stack{};
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+        const int node_index = stack[--stack_size];
+        const Node& node = atoms_.nodes[static_cast<std::size_t>(node_index)];
+        const int side = classify_box(node.box_min, node.box_max, planes, margin);
+        if (side < 0) {
+            continue;
+        }
+        if (side > 0 || node.right < 0) {
+            // Subtrees cover contiguous ranges of `order`; an inside node needs no per-atom tests.
+            for (int k = node.first; k < node.first + node.count; ++k) {
+                const int atom_index = atoms_.order[static_cast<std::size_t>(k)];
+                const Eigen::Vector3f& p = atoms_.item_min[static_cast<std::size_t>(atom_index)];
+                if (side > 0 || classify_box(p, p, planes, margin) >= 0) {
+                    atoms.push_back(static_cast<std::uint32_t>(atom_index));
+                }
+            }
+            continue;
+        }
+        stack[stack_size++] = node.right;
+        stack[stack_size++] = node_index + 1;
+    }
+}
+
+void SpatialIndex::query_screen_rect(const Eigen::Matrix4f& vp_matrix,
+                                     const Eigen::Vector2f& ndc_min,
+                                     const Eigen::Vector2f& ndc_max,
+                                     std::vector<int>& atoms) const {
+    if (atoms_.nodes.empty()) {
+        return;
+    }
+    // The rectangle is a sub-frustum: ndc_min.x <= clip.x / clip.w <= ndc_max.x and likewise for y,
+    // cut by the near plane.
+    const Eigen::Vector4f row0 = vp_matrix.row(0);
+    const Eigen::Vector4f row1 = vp_matrix.row(1);
+    const Eigen::Vector4f row2 = vp_matrix.row(2);
+    const Eigen::Vector4f row3 = vp_matrix.row(3);
+    const std::array<Plane, 5> planes = {{
+        normalize_plane(row0 - ndc_min.x() * row3),
+        normalize_plane(ndc_max.x() * row3 - row0),
+        normalize_plane(row1 - ndc_min.y() * row3),
+        normalize_plane(ndc_max.y() * row3 - row1),
+        normalize_plane(row3 + row2),
+    }};
+
+    std::array<int, kMaxStackDepth> stack{};
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+        const int node_index = stack[--stack_size];
+        const Node& node = atoms_.nodes[static_cast<std::size_t>(node_index)];
+        const int side = classify_box(node.box_min, node.box_max, planes, 0.0f);
+        if (side < 0) {
+            continue;
+        }
+        if (side > 0 || node.right < 0) {
+            for (int k = node.first; k < node.first + node.count; ++k) {
+                const int atom_index = atoms_.order[static_cast<std::size_t>(k)];
+                const Eigen::Vector3f& p = atoms_.item_min[static_cast<std::size_t>(atom_index)];
+                if (side > 0 || classify_box(p, p, planes, 0.0f) >= 0) {
+                    atoms.push_back(atom_index);
+                }
+            }
+            continue;
+        }
+        stack[stack_size++] = node.right;
+        stack[stack_size++] = node_index + 1;
+    }
+}
+
+}  // namespace sbox::editor
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "core/molecular_system.h"
+#include "editor/picking.h"
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <vector>
+
+namespace sbox::editor {
+
+// Bounding-volume hierarchy over atom centres and bond segments, shared by picking, box selection
+// and the LOD renderer's frustum culling. Boxes hold the bare geometry; each query inflates them by
+// the radius it tests with, so one tree serves every atom and bond radius.
+class SpatialIndex {
+public:
+    void build(const sbox::chem::MolecularSystem& mol);
+    // Recomputes every box from the current positions, keeping the tree shape. Falls back to build()
+    // when the atom or bond count changed.
+    void refit(const sbox::chem::MolecularSystem& mol);
+    // Refits only the boxes on the leaf-to-root paths of `moved_atoms` and their bonds, so a drag
+    // costs O(k log n). Expects the bonds the index was built with; rebuilds when the counts changed.
+    void refit_atoms(const sbox::chem::MolecularSystem& mol, const std::vector<int>& moved_atoms);
+    // Brings the index up to date with mol after any change: rebuilds when the atoms or bonds were
+    // replaced, otherwise refits the atoms whose positions differ from their boxes.
+    void update(const sbox::chem::MolecularSystem& mol);
+    void clear();
+
+    // True when the index was built for a molecule with the same atom and bond counts. A cheap guard
+    // for queries; it does not notice moved atoms, so whoever changes the geometry calls update().
+    bool matches(const sbox::chem::MolecularSystem& mol) const;
+    int num_atoms() const;
+    int num_bonds() const;
+
+    // Same results as the linear pick_atom()/pick_bond() in picking.h.
+    PickResult pick_atom(const Ray& ray, const sbox::chem::MolecularSystem& mol, float radius_scale = 1.0f) const;
+    PickResult pick_bond(const Ray& ray, const sbox::chem::MolecularSystem& mol, float radius = 0.3f) const;
+
+    // Atoms whose centre lies within `radius` of `center`.
+    void query_sphere(const Eigen::Vector3f& center, float radius, std::vector<int>& atoms) const;
+    // Atoms whose centre is within `margin` of the view frustum of vp_matrix, in no particular order.
+    void query_frustum(const Eigen::Matrix4f& vp_matrix, float margin, std::vector<std::uint32_t>& atoms) const;
+    // Atoms in front of the camera whose centre projects inside the NDC rectangle [ndc_min, ndc_max].
+    void query_screen_rect(const Eigen::Matrix4f& vp_matrix,
+                           const Eigen::Vector2f& ndc_min,
+                           const Eigen::Vector2f& ndc_max,
+                           std::vector<int>& atoms) const;
+
+private:
+    struct Node {
+        Eigen::Vector3f box_min = Eigen::Vector3f::Zero();
+        Eigen::Vector3f box_max = Eigen::Vector3f::Zero();
+        // Every node covers items [first, first + count) of `order`. Inner nodes have their left child
+        // at the next index and their right child at `right`; leaves have right == -1.
+        int first = 0;
+        int count = 0;
+        int right = -1;
+    };
+
+    // Nodes are stored depth first, so every child comes after its parent.
+    struct Tree {
+        std::vector<Node> nodes;
+        std::vector<int> parent;   // per node; -1 for the root
+        std::vector<int> order;
+        std::vector<int> leaf_of;  // per item, the leaf whose range holds it
+        std::vector<Eigen::Vector3f> item_min;
+        std::vector<Eigen::Vector3f> item_max;
+        // Scratch for refit_items().
+        std::vector<char> node_dirty;
+        std::vector<int> dirty_nodes;
+
+        void build();
+        void refit();
+        // Refits the ancestors of `items`, whose item boxes are already current.
+        void refit_items(const std::vector<int>& items);
+        int build_range(int begin, int end, int parent_index, std::vector<Eigen::Vector3f>& centroids);
+        void fit_leaf(Node& node) const;
+        void fit_inner(std::size_t node_index);
+    };
+
+    void fill_item_boxes(const sbox::chem::MolecularSystem& mol);
+    void fill_bond_box(const sbox::chem::MolecularSystem& mol, int bond_index);
+
+    Tree atoms_;
+    Tree bonds_;
+    sbox::chem::BondsByAtom bonds_by_atom_;
+    // Scratch for refit_atoms() and update().
+    std::vector<int> moved_bonds_;
+    std::vector<int> moved_atoms_;
+};
+
+}  // namespace sbox::editor
@@ -1,5 +1,6 @@
 #include "io/cube_io.h"
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iomanip>
@@ -21,7 +22,7 @@ T read_value(std::istream& input, const std::string& what) {
     return value;
 }
 
-CubeData read_cube_stream(std::istream& input) {
+CubeData read_cube_stream(std::istream& input, const ReadProgress& progress) {
     CubeData cube;
 
     if (!std::getline(input, cube.comment1)) {
@@ -85,9 +86,14 @@ CubeData read_cube_stream(std::istream& input) {
         static_cast<std::size_t>(cube.nx) * static_cast<std::size_t>(cube.ny) * static_cast<std::size_t>(cube.nz);
     cube.data.reserve(total_values);
 
+    constexpr std::size_t kProgressInterval = 1 << 16;
     float value = 0.0f;
     while (input >> value) {
         cube.data.push_back(value);
+        if (progress && cube.data.size() % kProgressInterval == 0
+            && !progress(static_cast<double>(cube.data.size()) / static_cast<double>(std::max<std::size_t>(total_values, 1)))) {
+            throw ReadCancelled();
+        }
     }
 
     if (cube.data.size() != total_values) {
@@ -105,7 +111,15 @@ CubeData read_cube(const std::string& filepath) {
     if (!input) {
         throw std::runtime_error("Could not open cube file: " + filepath);
     }
-    return read_cube_stream(input);
+    return read_cube_stream(input, {});
+}
+
+CubeData read_cube(const std::string& filepath, const ReadProgress& progress) {
+    std::ifstream input(filepath);
+    if (!input) {
+        throw std::runtime_error("Could not open cube file: " + filepath);
+    }
+    return read_cube_stream(input, progress);
 }
 
 void write_cube(const std::string& filepath, const CubeData& cube) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "io/read_progress.h"
+
 #include <Eigen/Core>
 
 #include <string>
@@ -25,6 +27,8 @@ struct CubeData {
 };
 
 CubeData read_cube(const std::string& filepath);
+// Reports progress every few tens of thousands of values; throws ReadCancelled if progress returns false.
+CubeData read_cube(const std::string& filepath, const ReadProgress& progress);
 void write_cube(const std::string& filepath, const CubeData& cube);
 
 }  // namespace sbox::io
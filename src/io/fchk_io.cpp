@@ -61,11 +61,12 @@ EntryHeader parse_header_line(const std::string& line) {
     return header;
 }
 
-std::vector<int> read_int_array(std::istream& input, int count, const std::string& label) {
+std::vector<int> read_int_array(std::istream& input, int count, const std::string& label, StreamProgress& progress) {
     std::vector<int> values;
     values.reserve(static_cast<std::size_t>(count));
     int value = 0;
     for (int i = 0; i < count; ++i) {
+        progress.step();
         if (!(input >> value)) {
             throw std::runtime_error("Malformed FCHK integer array for label: " + label);
         }
@@ -74,11 +75,12 @@ std::vector<int> read_int_array(std::istream& input, int count, const std::strin
     return values;
 }
 
-std::vector<double> read_real_array(std::istream& input, int count, const std::string& label) {
+std::vector<double> read_real_array(std::istream& input, int count, const std::string& label, StreamProgress& progress) {
     std::vector<double> values;
     values.reserve(static_cast<std::size_t>(count));
     double value = 0.0;
     for (int i = 0; i < count; ++i) {
+        progress.step();
         if (!(input >> value)) {
             throw std::runtime_error("Malformed FCHK real array for label: " + label);
         }
@@ -87,18 +89,19 @@ std::vector<double> read_real_array(std::istream& input, int count, const std::s
     return values;
 }
 
-void skip_array(std::istream& input, char type, int count, const std::string& label) {
+void skip_array(std::istream& input, char type, int count, const std::string& label, StreamProgress& progress) {
     if (type == 'I') {
-        (void)read_int_array(input, count, label);
+        (void)read_int_array(input, count, label, progress);
         return;
     }
     if (type == 'R') {
-        (void)read_real_array(input, count, label);
+        (void)read_real_array(input, count, label, progress);
         return;
     }
     if (type == 'C') {
         std::string token;
         for (int i = 0; i < count; ++i) {
+            progress.step();
             if (!(input >> token)) {
                 throw std::runtime_error("Malformed FCHK character array for label: " + label);
             }
@@ -111,10 +114,15 @@ void skip_array(std::istream& input, char type, int count, const std::string& la
 }  // namespace
 
 FchkData read_fchk(const std::string& filepath) {
+    return read_fchk(filepath, {});
+}
+
+FchkData read_fchk(const std::string& filepath, const ReadProgress& read_progress) {
     std::ifstream input(filepath);
     if (!input) {
         throw std::runtime_error("Could not open FCHK file: " + filepath);
     }
+    StreamProgress progress(input, read_progress);
 
     FchkData data;
     if (!std::getline(input, data.title)) {
@@ -132,6 +140,7 @@ FchkData read_fchk(const std::string& filepath) {
 
     std::string line;
     while (std::getline(input, line)) {
+        progress.step();
         if (trim(line).empty()) {
             continue;
         }
@@ -140,27 +149,27 @@ FchkData read_fchk(const std::string& filepath) {
 
         if (header.is_array) {
             if (header.label == "Atomic numbers") {
-                data.atomic_numbers = read_int_array(input, header.count, header.label);
+                data.atomic_numbers = read_int_array(input, header.count, header.label, progress);
             } else if (header.label == "Shell types") {
-                data.shell_types = read_int_array(input, header.count, header.label);
+                data.shell_types = read_int_array(input, header.count, header.label, progress);
             } else if (header.label == "Shell to atom map") {
-                data.shell_to_atom_map = read_int_array(input, header.count, header.label);
+                data.shell_to_atom_map = read_int_array(input, header.count, header.label, progress);
             } else if (header.label == "Number of primitives per shell") {
-                data.primitives_per_shell = read_int_array(input, header.count, header.label);
+                data.primitives_per_shell = read_int_array(input, header.count, header.label, progress);
             } else if (header.label == "Current cartesian coordinates") {
-                data.coordinates = read_real_array(input, header.count, header.label);
+                data.coordinates = read_real_array(input, header.count, header.label, progress);
             } else if (header.label == "Primitive exponents") {
-                data.primitive_exponents = read_real_array(input, header.count, header.label);
+                data.primitive_exponents = read_real_array(input, header.count, header.label, progress);
             } else if (header.label == "Contraction coefficients") {
-                data.contraction_coefficients = read_real_array(input, header.count, header.label);
+                data.contraction_coefficients = read_real_array(input, header.count, header.label, progress);
             } else if (header.label == "P(S=P) Contraction coefficients") {
-                data.sp_contraction_coefficients = read_real_array(input, header.count, header.label);
+                data.sp_contraction_coefficients = read_real_array(input, header.count, header.label, progress);
             } else if (header.label == "Alpha Orbital Energies") {
-                const std::vector<double> values = read_real_array(input, header.count, header.label);
+                const std::vector<double> values = read_real_array(input, header.count, header.label, progress);
                 data.num_mo = static_cast<int>(values.size());
                 data.mo_energies = Eigen::Map<const Eigen::VectorXd>(values.data(), data.num_mo);
             } else if (header.label == "Alpha MO coefficients") {
-                const std::vector<double> values = read_real_array(input, header.count, header.label);
+                const std::vector<double> values = read_real_array(input, header.count, header.label, progress);
                 if (data.num_basis > 0 && data.num_mo > 0 &&
                     static_cast<int>(values.size()) == data.num_basis * data.num_mo) {
                     data.mo_coefficients =
@@ -168,14 +177,14 @@ FchkData read_fchk(const std::string& filepath) {
                             values.data(), data.num_basis, data.num_mo);
                 }
             } else if (header.label == "Dipole Moment") {
-                const std::vector<double> values = read_real_array(input, header.count, header.label);
+                const std::vector<double> values = read_real_array(input, header.count, header.label, progress);
                 if (values.size() >= 3U) {
                     data.dipole_moment = Eigen::Vector3d(values[0], values[1], values[2]);
                 }
             } else if (header.label == "Mulliken Charges") {
-                data.mulliken_charges = read_real_array(input, header.count, header.label);
+                data.mulliken_charges = read_real_array(input, header.count, header.label, progress);
             } else {
-                skip_array(input, header.type, header.count, header.label);
+                skip_array(input, header.type, header.count, header.label, progress);
             }
             continue;
         }
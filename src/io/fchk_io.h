@@ -1,5 +1,7 @@
 #pragma once
 
+#include "io/read_progress.h"
+
 #include <Eigen/Core>
 
 #include <string>
@@ -36,5 +38,7 @@ struct FchkData {
 };
 
 FchkData read_fchk(const std::string& filepath);
+// Reports progress every few thousand lines or array values; throws ReadCancelled if progress returns false.
+FchkData read_fchk(const std::string& filepath, const ReadProgress& progress);
 
 }  // namespace sbox::io
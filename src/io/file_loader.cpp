@@ -0,0 +1,250 @@
+#include "io/file_loader.h"
+
+#include "core/molden_parser.h"
+#include "io/project_io.h"
+#include "io/sdf_io.h"
+#include "io/xyz_io.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+namespace sbox::io {
+
+namespace {
+
+std::string lower_extension(const std::string& path) {
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+    return ext;
+}
+
+void add_atoms(sbox::chem::MolecularSystem& mol, const std::vector<int>& atomic_numbers, const std::vector<Eigen::Vector3d>& positions) {
+    const std::size_t count = std::min(atomic_numbers.size(), positions.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        mol.add_atom({atomic_numbers[i], positions[i], "", 0});
+    }
+}
+
+}  // namespace
+
+FileKind file_kind_from_path(const std::string& path) {
+    const std::string ext = lower_extension(path);
+    if (ext == ".xyz") {
+        return FileKind::XYZ;
+    }
+    if (ext == ".sdf" || ext == ".mol") {
+        return FileKind::SDF;
+    }
+    if (ext == ".molden") {
+        return FileKind::Molden;
+    }
+    if (ext == ".cube") {
+        return FileKind::Cube;
+    }
+    if (ext == ".fchk" || ext == ".fch") {
+        return FileKind::Fchk;
+    }
+    if (ext == ".pdb" || ext == ".ent") {
+        return FileKind::PDB;
+    }
+    if (ext == ".sbox") {
+        return FileKind::Project;
+    }
+    throw std::runtime_error("Unsupported file type: " + ext);
+}
+
+LoadedFile read_file(const std::string& path, FileKind kind, const ReadProgress& progress) {
+    const auto report = [&progress](double fraction) {
+        if (progress && !progress(fraction)) {
+            throw ReadCancelled();
+        }
+    };
+    // Readers of the formats that get large (XYZ, trajectories, Molden, cube, FCHK, PDB) get [begin, end)
+    // of the overall range and check for a cancel inside their parse loops; bond perception makes up
+    // the remainder. SDF and project files report only once parsing is done.
+    const auto scaled = [&progress](double begin, double end) -> ReadProgress {
+        if (!progress) {
+            return {};
+        }
+        return [&progress, begin, end](double fraction) { return progress(begin + (end - begin) * fraction); };
+    };
+    const std::string filename = std::filesystem::path(path).filename().string();
+
+    LoadedFile file;
+    file.kind = kind;
+    file.path = path;
+    report(0.0);
+
+    switch (kind) {
+    case FileKind::XYZ:
+        file.molecule = read_xyz(path, scaled(0.0, 0.95));
+        break;
+    case FileKind::Trajectory:
+        file.trajectory = read_trajectory_xyz(path, scaled(0.0, 1.0));
+        if (file.trajectory.empty()) {
+            throw std::runtime_error("Trajectory file did not contain any frames");
+        }
+        file.molecule = file.trajectory.frames.front().geometry;
+        file.molecule.set_name(filename);
+        break;
+    case FileKind::SDF:
+        file.molecule = read_sdf(path);
+        break;
+    case FileKind::Molden: {
+        sbox::molden::ParseOptions options;
+        options.progress = [&report](double fraction) { report(0.8 * fraction); };
+        file.mo_data = sbox::molden::parse_molden_file(path, options);
+        report(0.8);
+        file.molecule.set_name(filename);
+        add_atoms(file.molecule, file.mo_data.atomic_numbers, file.mo_data.atom_positions);
+        file.molecule.perceive_bonds();
+        break;
+    }
+    case FileKind::Cube:
+        file.cube = read_cube(path, scaled(0.0, 0.95));
+        file.molecule.set_name(filename);
+        add_atoms(file.molecule, file.cube.atom_Z, file.cube.atom_pos);
+        file.molecule.perceive_bonds();
+        break;
+    case FileKind::Fchk: {
+        file.fchk = read_fchk(path, scaled(0.0, 0.8));
+        report(0.8);
+        file.molecule.set_name(file.fchk.title);
+        file.molecule.set_charge(file.fchk.charge);
+        file.molecule.set_multiplicity(file.fchk.multiplicity);
+        for (int i = 0; i < file.fchk.num_atoms; ++i) {
+            const std::size_t offset = static_cast<std::size_t>(3 * i);
+            file.molecule.add_atom({file.fchk.atomic_numbers[static_cast<std::size_t>(i)],
+                                    Eigen::Vector3d(file.fchk.coordinates[offset + 0],
+                                                    file.fchk.coordinates[offset + 1],
+                                                    file.fchk.coordinates[offset + 2]),
+                                    "",
+                                    0});
+        }
+        file.molecule.perceive_bonds();
+        break;
+    }
+    case FileKind::PDB:
+        file.pdb = read_pdb(path, scaled(0.0, 0.8));
+        report(0.8);
+        file.molecule = file.pdb.to_molecular_system();
+        file.molecule.set_name(file.pdb.title.empty() ? filename : file.pdb.title);
+        break;
+    case FileKind::Project:
+        file.molecule = load_project(path, &file.project_state);
+        break;
+    }
+
+    report(1.0);
+    return file;
+}
+
+FileLoader::~FileLoader() {
+    std::vector<std::shared_ptr<Job>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs = std::move(retired_);
+        if (current_) {
+            jobs.push_back(std::move(current_));
+        }
+    }
+    for (const auto& job : jobs) {
+        job->cancelled.store(true);
+        if (job->worker.joinable()) {
+            job->worker.join();
+        }
+    }
+}
+
+void FileLoader::start(const std::string& path, FileKind kind) {
+    auto job = std::make_shared<Job>();
+    job->path = path;
+    job->kind = kind;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    reap_finished_jobs();
+    if (current_) {
+        current_->cancelled.store(true);
+        retired_.push_back(std::move(current_));
+    }
+
+    // The worker only touches its own Job, which stays alive until the worker has been joined.
+    Job* raw = job.get();
+    job->worker = std::thread([raw]() {
+        try {
+            raw->result = read_file(raw->path, raw->kind, [raw](double fraction) {
+                raw->progress.store(std::clamp(fraction, 0.0, 1.0));
+                return !raw->cancelled.load();
+            });
+        } catch (const ReadCancelled&) {
+            raw->result.reset();
+        } catch (...) {
+            raw->error = std::current_exception();
+        }
+        raw->done.store(true);
+    });
+    current_ = std::move(job);
+}
+
+void FileLoader::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_) {
+        current_->cancelled.store(true);
+        retired_.push_back(std::move(current_));
+    }
+    reap_finished_jobs();
+}
+
+bool FileLoader::busy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_ != nullptr && !current_->done.load();
+}
+
+double FileLoader::progress() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_ ? current_->progress.load() : 0.0;
+}
+
+std::string FileLoader::path() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_ ? current_->path : std::string{};
+}
+
+std::optional<LoadedFile> FileLoader::take() {
+    std::shared_ptr<Job> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reap_finished_jobs();
+        if (!current_ || !current_->done.load()) {
+            return std::nullopt;
+        }
+        finished = std::move(current_);
+    }
+    finished->worker.join();
+    if (finished->error) {
+        std::rethrow_exception(finished->error);
+    }
+    if (finished->cancelled.load()) {
+        return std::nullopt;
+    }
+    return std::move(finished->result);
+}
+
+void FileLoader::reap_finished_jobs() {
+    auto it = retired_.begin();
+    while (it != retired_.end()) {
+        if ((*it)->done.load()) {
+            (*it)->worker.join();
+            it = retired_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace sbox::io
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core/basis_set.h"
+#include "core/molecular_system.h"
+#include "io/cube_io.h"
+#include "io/fchk_io.h"
+#include "io/pdb_io.h"
+#include "io/read_progress.h"
+#include "io/trajectory_io.h"
+
+#include <json.hpp>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sbox::io {
+
+enum class FileKind {
+    XYZ,
+    Trajectory,
+    SDF,
+    Molden,
+    Cube,
+    Fchk,
+    PDB,
+    Project,
+};
+
+// Picks the kind from the file extension; throws for extensions the app cannot open.
+FileKind file_kind_from_path(const std::string& path);
+
+// Everything parsed from one file, ready to be swapped into the app. Only the members that belong to
+// `kind` are filled; `molecule` always holds the structure with bonds perceived.
+struct LoadedFile {
+    FileKind kind = FileKind::XYZ;
+    std::string path;
+    sbox::chem::MolecularSystem molecule;
+    sbox::basis::MOData mo_data;  // Molden
+    CubeData cube;                // Cube
+    FchkData fchk;                // Fchk
+    Trajectory trajectory;        // Trajectory
+    PDBData pdb;                  // PDB
+    nlohmann::json project_state; // Project
+};
+
+// Parses path completely, including bond perception. Throws ReadCancelled if progress returns false.
+LoadedFile read_file(const std::string& path, FileKind kind, const ReadProgress& progress = {});
+
+// Runs read_file on a worker thread. The worker fills its own LoadedFile; the main thread takes it
+// over in one move once it is complete, so nothing it is drawing from is ever written concurrently.
+class FileLoader {
+public:
+    FileLoader() = default;
+    ~FileLoader();
+
+    FileLoader(const FileLoader&) = delete;
+    FileLoader& operator=(const FileLoader&) = delete;
+
+    // Starts loading path; a load still in flight is cancelled and its result dropped.
+    void start(const std::string& path, FileKind kind);
+    void cancel();
+
+    bool busy() const;
+    double progress() const;  // 0..1 for the load in flight
+    std::string path() const; // file of the load in flight, empty when idle
+
+    // The finished file, handed over once. Rethrows the parse error of a failed load; a cancelled
+    // load yields nothing.
+    std::optional<LoadedFile> take();
+
+private:
+    struct Job {
+        std::string path;
+        FileKind kind = FileKind::XYZ;
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> done{false};
+        std::atomic<double> progress{0.0};
+        std::optional<LoadedFile> result;
+        std::exception_ptr error;
+        std::thread worker;
+    };
+
+    void reap_finished_jobs();
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<Job> current_;
+    std::vector<std::shared_ptr<Job>> retired_;  // cancelled jobs whose workers have not exited yet
+};
+
+}  // namespace sbox::io
@@ -0,0 +1,300 @@
+#include "io/npy_io.h"
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sbox::io {
+namespace {
+
+constexpr unsigned char kNpyMagic[] = {0x93, 'N', 'U', 'M', 'P', 'Y'};
+constexpr std::size_t kNpyMagicSize = sizeof(kNpyMagic);
+
+std::string header_value(const std::string& header, const std::string& key, const std::string& filepath) {
+    const std::size_t key_pos = header.find("'" + key + "'");
+    if (key_pos == std::string::npos) {
+        throw std::runtime_error("Malformed npy header: missing '" + key + "' in " + filepath);
+    }
+    const std::size_t colon = header.find(':', key_pos);
+    if (colon == std::string::npos) {
+        throw std::runtime_error("Malformed npy header: missing value for '" + key + "' in " + filepath);
+    }
+    std::size_t start = header.find_first_not_of(' ', colon + 1);
+    if (start == std::string::npos) {
+        throw std::runtime_error("Malformed npy header: missing value for '" + key + "' in " + filepath);
+    }
+
+    std::size_t end = std::string::npos;
+    if (header[start] == '\'') {
+        end = header.find('\'', start + 1);
+        ++start;
+    } else if (header[start] == '(') {
+        end = header.find(')', start);
+        ++start;
+    } else {
+        end = header.find_first_of(",}", start);
+    }
+    if (end == std::string::npos) {
+        throw std::runtime_error("Malformed npy header: unterminated '" + key + "' in " + filepath);
+    }
+    return header.substr(start, end - start);
+}
+
+std::vector<std::size_t> parse_shape(const std::string& text, const std::string& filepath) {
+    std::vector<std::size_t> shape;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        const std::size_t digit = text.find_first_of("0123456789", pos);
+        if (digit == std::string::npos) {
+            break;
+        }
+        std::size_t consumed = 0;
+        try {
+            shape.push_back(static_cast<std::size_t>(std::stoull(text.substr(digit), &consumed)));
+        } catch (const std::exception&) {
+            throw std::runtime_error("Malformed npy header: invalid shape in " + filepath);
+        }
+        pos = digit + consumed;
+    }
+    return shape;
+}
+
+template <typename T>
+void write_npy_impl(const std::string& filepath, const T* data, const std::vector<std::size_t>& shape, const char* descr) {
+    std::string shape_text = "(";
+    std::size_t count = 1;
+    for (std::size_t i = 0; i < shape.size(); ++i) {
+        shape_text += std::to_string(shape[i]);
+        shape_text += (shape.size() == 1 || i + 1 < shape.size()) ? "," : "";
+        if (i + 1 < shape.size()) {
+            shape_text += ' ';
+        }
+        count *= shape[i];
+    }
+    shape_text += ")";
+
+    std::string header = std::string("{'descr': '") + descr + "', 'fortran_order': False, 'shape': " + shape_text + ", }";
+    const std::size_t unpadded = kNpyMagicSize + 2 + 2 + header.size() + 1;
+    header.append((64 - unpadded % 64) % 64, ' ');
+    header.push_back('\n');
+    if (header.size() > 0xFFFF) {
+        throw std::runtime_error("npy header too large for " + filepath);
+    }
+
+    std::ofstream output(filepath, std::ios::binary);
+    if (!output) {
+        throw std::runtime_error("Could not open npy file for writing: " + filepath);
+    }
+    output.write(reinterpret_cast<const char*>(kNpyMagic), kNpyMagicSize);
+    const unsigned char version[2] = {1, 0};
+    output.write(reinterpret_cast<const char*>(version), 2);
+    const unsigned char header_len[2] = {
+        static_cast<unsigned char>(header.size() & 0xFF),
+        static_cast<unsigned char>((header.size() >> 8) & 0xFF),
+    };
+    output.write(reinterpret_cast<const char*>(header_len), 2);
+    output.write(header.data(), static_cast<std::streamsize>(header.size()));
+    output.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+    if (!output) {
+        throw std::runtime_error("Failed while writing npy file: " + filepath);
+    }
+}
+
+}  // namespace
+
+NpyFile::NpyFile(const std::string& filepath) {
+    const int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open npy file: " + filepath);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kNpyMagicSize + 4)) {
+        ::close(fd);
+        throw std::runtime_error("Malformed npy file: too small: " + filepath);
+    }
+    mapping_size_ = static_cast<std::size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping_size_ = 0;
+        throw std::runtime_error("Could not memory-map npy file: " + filepath);
+    }
+    mapping_ = mapping;
+    ::madvise(mapping_, mapping_size_, MADV_SEQUENTIAL);
+
+    try {
+        const auto* bytes = static_cast<const unsigned char*>(mapping_);
+        if (std::memcmp(bytes, kNpyMagic, kNpyMagicSize) != 0) {
+            throw std::runtime_error("Malformed npy file: bad magic: " + filepath);
+        }
+        const unsigned char major = bytes[kNpyMagicSize];
+        std::size_t header_len = 0;
+        std::size_t header_start = 0;
+        if (major == 1) {
+            header_len = static_cast<std::size_t>(bytes[8]) | (static_cast<std::size_t>(bytes[9]) << 8);
+            header_start = 10;
+        } else if (major == 2 || major == 3) {
+            if (mapping_size_ < 12) {
+                throw std::runtime_error("Malformed npy file: truncated header: " + filepath);
+            }
+            header_len = static_cast<std::size_t>(bytes[8]) | (static_cast<std::size_t>(bytes[9]) << 8)
+                | (static_cast<std::size_t>(bytes[10]) << 16) | (static_cast<std::size_t>(bytes[11]) << 24);
+            header_start = 12;
+        } else {
+            throw std::runtime_error("Unsupported npy format version " + std::to_string(major) + ": " + filepath);
+        }
+        if (header_start + header_len > mapping_size_) {
+            throw std::runtime_error("Malformed npy file: truncated header: " + filepath);
+        }
+
+        const std::string header(reinterpret_cast<const char*>(bytes + header_start), header_len);
+        const std::string descr = header_value(header, "descr", filepath);
+        if (descr == "<f8") {
+            item_size_ = 8;
+        } else if (descr == "<f4") {
+            item_size_ = 4;
+        } else {
+            throw std::runtime_error("Unsupported npy dtype '" + descr + "' (expected <f4 or <f8): " + filepath);
+        }
+        fortran_order_ = header_value(header, "fortran_order", filepath) == "True";
+        shape_ = parse_shape(header_value(header, "shape", filepath), filepath);
+
+        data_ = bytes + header_start + header_len;
+        if (num_elements() * item_size_ > mapping_size_ - (header_start + header_len)) {
+            throw std::runtime_error("Malformed npy file: payload shorter than shape: " + filepath);
+        }
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+NpyFile::~NpyFile() {
+    release();
+}
+
+NpyFile::NpyFile(NpyFile&& other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)),
+      mapping_size_(std::exchange(other.mapping_size_, 0)),
+      data_(std::exchange(other.data_, nullptr)),
+      shape_(std::move(other.shape_)),
+      fortran_order_(other.fortran_order_),
+      item_size_(other.item_size_) {}
+
+NpyFile& NpyFile::operator=(NpyFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mapping_size_ = std::exchange(other.mapping_size_, 0);
+        data_ = std::exchange(other.data_, nullptr);
+        shape_ = std::move(other.shape_);
+        fortran_order_ = other.fortran_order_;
+        item_size_ = other.item_size_;
+    }
+    return *this;
+}
+
+void NpyFile::release() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    data_ = nullptr;
+}
+
+std::size_t NpyFile::num_elements() const {
+    std::size_t count = 1;
+    for (std::size_t dim : shape_) {
+        count *= dim;
+    }
+    return count;
+}
+
+void NpyFile::copy_to(float* out) const {
+    const std::size_t count = num_elements();
+    if (item_size_ == sizeof(float)) {
+        std::memcpy(out, data_, count * sizeof(float));
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        double value = 0.0;
+        std::memcpy(&value, data_ + i * sizeof(double), sizeof(double));
+        out[i] = static_cast<float>(value);
+    }
+}
+
+void NpyFile::copy_to(double* out) const {
+    const std::size_t count = num_elements();
+    if (item_size_ == sizeof(double)) {
+        std::memcpy(out, data_, count * sizeof(double));
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        float value = 0.0f;
+        std::memcpy(&value, data_ + i * sizeof(float), sizeof(float));
+        out[i] = static_cast<double>(value);
+    }
+}
+
+Eigen::VectorXd read_npy_vector(const std::string& filepath) {
+    const NpyFile file(filepath);
+    if (file.shape().size() > 1) {
+        throw std::runtime_error("Expected a 1-D npy array: " + filepath);
+    }
+    Eigen::VectorXd vec(static_cast<Eigen::Index>(file.num_elements()));
+    file.copy_to(vec.data());
+    return vec;
+}
+
+Eigen::MatrixXd read_npy_matrix(const std::string& filepath) {
+    const NpyFile file(filepath);
+    if (file.shape().size() != 2) {
+        throw std::runtime_error("Expected a 2-D npy array: " + filepath);
+    }
+    const auto rows = static_cast<Eigen::Index>(file.shape()[0]);
+    const auto cols = static_cast<Eigen::Index>(file.shape()[1]);
+    Eigen::MatrixXd mat(rows, cols);
+    if (file.fortran_order()) {
+        file.copy_to(mat.data());
+    } else {
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> row_major(rows, cols);
+        file.copy_to(row_major.data());
+        mat = row_major;
+    }
+    return mat;
+}
+
+std::vector<float> read_npy_floats(const std::string& filepath, std::vector<std::size_t>* shape) {
+    const NpyFile file(filepath);
+    if (file.fortran_order() && file.shape().size() > 1) {
+        throw std::runtime_error("Fortran-ordered npy arrays are not supported here: " + filepath);
+    }
+    std::vector<float> values(file.num_elements());
+    file.copy_to(values.data());
+    if (shape != nullptr) {
+        *shape = file.shape();
+    }
+    return values;
+}
+
+void write_npy(const std::string& filepath, const float* data, const std::vector<std::size_t>& shape) {
+    write_npy_impl(filepath, data, shape, "<f4");
+}
+
+void write_npy(const std::string& filepath, const double* data, const std::vector<std::size_t>& shape) {
+    write_npy_impl(filepath, data, shape, "<f8");
+}
+
+}  // namespace sbox::io
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sbox::io {
+
+// Read-only memory-mapped view of a little-endian NumPy .npy file (float32/float64).
+class NpyFile {
+public:
+    explicit NpyFile(const std::string& filepath);
+    ~NpyFile();
+
+    NpyFile(const NpyFile&) = delete;
+    NpyFile& operator=(const NpyFile&) = delete;
+    NpyFile(NpyFile&& other) noexcept;
+    NpyFile& operator=(NpyFile&& other) noexcept;
+
+    const std::vector<std::size_t>& shape() const { return shape_; }
+    bool fortran_order() const { return fortran_order_; }
+    std::size_t item_size() const { return item_size_; }
+    std::size_t num_elements() const;
+
+    // Copies the payload in storage order, converting between float widths as needed.
+    void copy_to(float* out) const;
+    void copy_to(double* out) const;
+
+private:
+    void release();
+
+    void* mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
+    const unsigned char* data_ = nullptr;
+    std::vector<std::size_t> shape_;
+    bool fortran_order_ = false;
+    std::size_t item_size_ = 0;
+};
+
+Eigen::VectorXd read_npy_vector(const std::string& filepath);
+Eigen::MatrixXd read_npy_matrix(const std::string& filepath);
+std::vector<float> read_npy_floats(const std::string& filepath, std::vector<std::size_t>* shape = nullptr);
+
+void write_npy(const std::string& filepath, const float* data, const std::vector<std::size_t>& shape);
+void write_npy(const std::string& filepath, const double* data, const std::vector<std::size_t>& shape);
+
+}  // namespace sbox::io
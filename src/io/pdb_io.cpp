@@ -131,6 +131,11 @@ std::string field(const std::string& line, std::size_t start, std::size_t length
 
 }  // namespace
 
+bool PDBData::has_atom_lookups() const {
+    return atom_chain_index.size() == atoms.size() && atom_residue_index.size() == atoms.size()
+        && atom_residue_name_id.size() == atoms.size();
+}
+
 sbox::chem::MolecularSystem PDBData::to_molecular_system() const {
     sbox::chem::MolecularSystem mol;
     mol.set_name(title);
@@ -166,17 +171,24 @@ sbox::chem::MolecularSystem PDBData::to_molecular_system() const {
 }
 
 PDBData read_pdb(const std::string& filepath) {
+    return read_pdb(filepath, {});
+}
+
+PDBData read_pdb(const std::string& filepath, const ReadProgress& progress) {
     std::ifstream input(filepath);
     if (!input) {
         throw std::runtime_error("Could not open PDB file: " + filepath);
     }
+    StreamProgress stream_progress(input, progress);
 
     PDBData data;
     std::string line;
     std::map<std::tuple<std::string, int, std::string>, int> residue_lookup;
     std::map<std::string, int> chain_lookup;
+    std::unordered_map<std::string, int> residue_name_ids;
 
     while (std::getline(input, line)) {
+        stream_progress.step();
         if (line.size() < 6) {
             continue;
         }
@@ -242,6 +254,15 @@ PDBData read_pdb(const std::string& filepath) {
             if (residue_indices.empty() || residue_indices.back() != residue_index) {
                 residue_indices.push_back(residue_index);
             }
+
+            const auto [name_it, inserted] =
+                residue_name_ids.try_emplace(atom.residue_name, static_cast<int>(data.residue_names.size()));
+            if (inserted) {
+                data.residue_names.push_back(atom.residue_name);
+            }
+            data.atom_chain_index.push_back(chain_index);
+            data.atom_residue_index.push_back(residue_index);
+            data.atom_residue_name_id.push_back(name_it->second);
             continue;
         }
 
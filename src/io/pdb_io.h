@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/molecular_system.h"
+#include "io/read_progress.h"
 
 #include <Eigen/Core>
 
@@ -43,10 +44,21 @@ struct PDBData {
     std::vector<PDBChain> chains;
     std::vector<std::pair<int, int>> conect_bonds;
 
+    // Per-atom lookups built by read_pdb(), so per-atom color and selection code never searches
+    // chains or compares strings. Residue names are interned into residue_names.
+    std::vector<int> atom_chain_index;
+    std::vector<int> atom_residue_index;
+    std::vector<int> atom_residue_name_id;
+    std::vector<std::string> residue_names;
+
+    // True when the lookups above cover every atom.
+    bool has_atom_lookups() const;
     sbox::chem::MolecularSystem to_molecular_system() const;
 };
 
 PDBData read_pdb(const std::string& filepath);
+// Reports progress every few thousand lines; throws ReadCancelled if progress returns false.
+PDBData read_pdb(const std::string& filepath, const ReadProgress& progress);
 void write_pdb(const std::string& filepath, const PDBData& data);
 
 }  // namespace sbox::io
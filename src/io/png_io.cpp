@@ -0,0 +1,253 @@
+#include "io/png_io.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+namespace sbox::io {
+
+namespace {
+
+constexpr std::size_t kBytesPerPixel = 4;
+// Chunks smaller than this compress noticeably worse for little gain in parallelism.
+constexpr int kMinRowsPerChunk = 32;
+
+void put_u32(unsigned char* out, std::uint32_t value) {
+    out[0] = static_cast<unsigned char>(value >> 24);
+    out[1] = static_cast<unsigned char>(value >> 16);
+    out[2] = static_cast<unsigned char>(value >> 8);
+    out[3] = static_cast<unsigned char>(value);
+}
+
+unsigned char paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return static_cast<unsigned char>(a);
+    }
+    return static_cast<unsigned char>(pb <= pc ? b : c);
+}
+
+// Writes the filter byte and filtered row to `out`, choosing the filter with the smallest sum of
+// absolute residuals, the usual libpng heuristic. `prev` is null for the image's first row.
+void filter_row(const unsigned char* row,
+                const unsigned char* prev,
+                std::size_t row_bytes,
+                unsigned char* out,
+                std::array<std::vector<unsigned char>, 5>& candidates) {
+    unsigned long best_cost = ~0UL;
+    int best = 0;
+    for (int type = 0; type < 5; ++type) {
+        std::vector<unsigned char>& filtered = candidates[static_cast<std::size_t>(type)];
+        filtered.resize(row_bytes);
+        unsigned long cost = 0;
+        for (std::size_t i = 0; i < row_bytes; ++i) {
+            const int left = i >= kBytesPerPixel ? row[i - kBytesPerPixel] : 0;
+            const int up = prev != nullptr ? prev[i] : 0;
+            const int up_left = prev != nullptr && i >= kBytesPerPixel ? prev[i - kBytesPerPixel] : 0;
+            int predictor = 0;
+            switch (type) {
+            case 1: predictor = left; break;
+            case 2: predictor = up; break;
+            case 3: predictor = (left + up) / 2; break;
+            case 4: predictor = paeth(left, up, up_left); break;
+            default: break;
+            }
+            const auto residual = static_cast<unsigned char>(row[i] - predictor);
+            filtered[i] = residual;
+            cost += static_cast<unsigned long>(std::abs(static_cast<signed char>(residual)));
+        }
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = type;
+        }
+    }
+    out[0] = static_cast<unsigned char>(best);
+    std::copy(candidates[static_cast<std::size_t>(best)].begin(), candidates[static_cast<std::size_t>(best)].end(), out + 1);
+}
+
+struct CompressedChunk {
+    std::vector<unsigned char> data;
+    std::uint32_t adler = 1;
+    std::size_t filtered_size = 0;
+    bool ok = false;
+};
+
+// Filters and raw-deflates rows, ending with a sync flush so the output can be followed directly by
+// the next chunk's deflate data.
+void compress_rows(const unsigned char* rows, const unsigned char* prev, int count, std::size_t row_bytes, CompressedChunk& chunk) {
+    std::vector<unsigned char> filtered(static_cast<std::size_t>(count) * (row_bytes + 1));
+    std::array<std::vector<unsigned char>, 5> candidates;
+    for (int r = 0; r < count; ++r) {
+        const unsigned char* row = rows + static_cast<std::size_t>(r) * row_bytes;
+        const unsigned char* above = r > 0 ? row - row_bytes : prev;
+        filter_row(row, above, row_bytes, filtered.data() + static_cast<std::size_t>(r) * (row_bytes + 1), candidates);
+    }
+    chunk.filtered_size = filtered.size();
+    chunk.adler = static_cast<std::uint32_t>(adler32(1L, filtered.data(), static_cast<uInt>(filtered.size())));
+
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return;
+    }
+    // deflateBound() covers Z_FINISH; the sync flush marker needs a few bytes more.
+    chunk.data.resize(deflateBound(&stream, static_cast<uLong>(filtered.size())) + 16);
+    stream.next_in = filtered.data();
+    stream.avail_in = static_cast<uInt>(filtered.size());
+    stream.next_out = chunk.data.data();
+    stream.avail_out = static_cast<uInt>(chunk.data.size());
+    const int result = deflate(&stream, Z_SYNC_FLUSH);
+    chunk.ok = result == Z_OK && stream.avail_in == 0 && stream.avail_out > 0;
+    chunk.data.resize(stream.total_out);
+    deflateEnd(&stream);
+}
+
+}  // namespace
+
+PngStreamWriter::~PngStreamWriter() {
+    close_file();
+}
+
+void PngStreamWriter::open(const std::string& filepath, int width, int height, int threads) {
+    close_file();
+    if (width <= 0 || height <= 0) {
+        throw std::runtime_error("Invalid PNG size for " + filepath);
+    }
+    file_ = std::fopen(filepath.c_str(), "wb");
+    if (file_ == nullptr) {
+        throw std::runtime_error("Could not open PNG file for writing: " + filepath);
+    }
+    filepath_ = filepath;
+    width_ = width;
+    height_ = height;
+    threads_ = std::max(1, threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()));
+    rows_written_ = 0;
+    adler_ = 1;
+    previous_row_.clear();
+
+    static constexpr unsigned char kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (std::fwrite(kSignature, 1, sizeof(kSignature), file_) != sizeof(kSignature)) {
+        close_file();
+        throw std::runtime_error("Failed while writing PNG file: " + filepath);
+    }
+    std::array<unsigned char, 13> header{};
+    put_u32(header.data(), static_cast<std::uint32_t>(width));
+    put_u32(header.data() + 4, static_cast<std::uint32_t>(height));
+    header[8] = 8;  // bit depth
+    header[9] = 6;  // RGBA
+    write_chunk("IHDR", header.data(), header.size());
+
+    // zlib header (32K window, default level); the deflate data follows in later IDAT chunks.
+    static constexpr unsigned char kZlibHeader[2] = {0x78, 0x9C};
+    write_chunk("IDAT", kZlibHeader, sizeof(kZlibHeader));
+}
+
+void PngStreamWriter::write_rows(const unsigned char* rgba, int rows) {
+    if (file_ == nullptr) {
+        throw std::runtime_error("PNG writer is not open");
+    }
+    if (rows <= 0) {
+        return;
+    }
+    if (rows > height_ - rows_written_) {
+        throw std::runtime_error("Too many rows for PNG file: " + filepath_);
+    }
+
+    const std::size_t row_bytes = static_cast<std::size_t>(width_) * kBytesPerPixel;
+    const int chunk_count = std::clamp(rows / kMinRowsPerChunk, 1, threads_);
+    const int rows_per_chunk = (rows + chunk_count - 1) / chunk_count;
+    std::vector<CompressedChunk> chunks(static_cast<std::size_t>(chunk_count));
+
+    auto compress_chunk = [&](int index) {
+        const int first = index * rows_per_chunk;
+        const int count = std::min(rows_per_chunk, rows - first);
+        if (count <= 0) {
+            chunks[static_cast<std::size_t>(index)].ok = true;
+            return;
+        }
+        const unsigned char* start = rgba + static_cast<std::size_t>(first) * row_bytes;
+        const unsigned char* prev = first > 0 ? start - row_bytes : (previous_row_.empty() ? nullptr : previous_row_.data());
+        compress_rows(start, prev, count, row_bytes, chunks[static_cast<std::size_t>(index)]);
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < chunk_count; ++i) {
+        pool.emplace_back(compress_chunk, i);
+    }
+    compress_chunk(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    for (const CompressedChunk& chunk : chunks) {
+        if (!chunk.ok) {
+            throw std::runtime_error("Failed to compress PNG rows for " + filepath_);
+        }
+        if (chunk.filtered_size == 0) {
+            continue;
+        }
+        adler_ = static_cast<std::uint32_t>(adler32_combine(adler_, chunk.adler, static_cast<z_off_t>(chunk.filtered_size)));
+        write_chunk("IDAT", chunk.data.data(), chunk.data.size());
+    }
+
+    const unsigned char* last_row = rgba + static_cast<std::size_t>(rows - 1) * row_bytes;
+    previous_row_.assign(last_row, last_row + row_bytes);
+    rows_written_ += rows;
+}
+
+void PngStreamWriter::finish() {
+    if (file_ == nullptr) {
+        throw std::runtime_error("PNG writer is not open");
+    }
+    if (rows_written_ != height_) {
+        close_file();
+        throw std::runtime_error("PNG file ended before all rows were written: " + filepath_);
+    }
+
+    // An empty final stored block closes the deflate stream, then the zlib checksum.
+    std::array<unsigned char, 9> trailer = {0x01, 0x00, 0x00, 0xFF, 0xFF, 0, 0, 0, 0};
+    put_u32(trailer.data() + 5, adler_);
+    write_chunk("IDAT", trailer.data(), trailer.size());
+    write_chunk("IEND", nullptr, 0);
+
+    const bool ok = std::fflush(file_) == 0;
+    close_file();
+    if (!ok) {
+        throw std::runtime_error("Failed while writing PNG file: " + filepath_);
+    }
+}
+
+void PngStreamWriter::write_chunk(const char* type, const unsigned char* data, std::size_t size) {
+    std::array<unsigned char, 8> head{};
+    put_u32(head.data(), static_cast<std::uint32_t>(size));
+    std::copy(type, type + 4, head.begin() + 4);
+    uLong crc = crc32(0L, head.data() + 4, 4);
+    if (size > 0) {
+        crc = crc32(crc, data, static_cast<uInt>(size));
+    }
+    std::array<unsigned char, 4> tail{};
+    put_u32(tail.data(), static_cast<std::uint32_t>(crc));
+
+    const bool ok = std::fwrite(head.data(), 1, head.size(), file_) == head.size()
+                    && (size == 0 || std::fwrite(data, 1, size, file_) == size)
+                    && std::fwrite(tail.data(), 1, tail.size(), file_) == tail.size();
+    if (!ok) {
+        close_file();
+        throw std::runtime_error("Failed while writing PNG file: " + filepath_);
+    }
+}
+
+void PngStreamWriter::close_file() {
+    if (file_ != nullptr) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+}  // namespace sbox::io
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace sbox::io {
+
+// Writes an 8-bit RGBA PNG a band of rows at a time, so an image never has to be in memory whole.
+// Every band is split into chunks that are filtered and deflated on separate threads; each chunk
+// ends in a sync flush, which lets the pieces be appended into the single zlib stream PNG needs.
+class PngStreamWriter {
+public:
+    PngStreamWriter() = default;
+    ~PngStreamWriter();
+
+    PngStreamWriter(const PngStreamWriter&) = delete;
+    PngStreamWriter& operator=(const PngStreamWriter&) = delete;
+
+    // threads <= 0 uses every hardware thread.
+    void open(const std::string& filepath, int width, int height, int threads = 0);
+    // Appends `rows` tightly packed RGBA rows, top row first.
+    void write_rows(const unsigned char* rgba, int rows);
+    // Ends the stream once all rows are written.
+    void finish();
+
+    int rows_written() const { return rows_written_; }
+
+private:
+    void write_chunk(const char* type, const unsigned char* data, std::size_t size);
+    void close_file();
+
+    std::FILE* file_ = nullptr;
+    std::string filepath_;
+    int width_ = 0;
+    int height_ = 0;
+    int threads_ = 1;
+    int rows_written_ = 0;
+    std::uint32_t adler_ = 1;
+    // Last row of the previous band; the filters of the next band's first row refer to it.
+    std::vector<unsigned char> previous_row_;
+};
+
+}  // namespace sbox::io
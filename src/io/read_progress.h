@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <istream>
+#include <stdexcept>
+
+namespace sbox::io {
+
+// Called by long-running readers with the fraction of the input consumed so far. Returning false
+// asks the reader to stop, which it does by throwing ReadCancelled.
+using ReadProgress = std::function<bool(double fraction)>;
+
+class ReadCancelled : public std::runtime_error {
+public:
+    ReadCancelled() : std::runtime_error("Read cancelled") {}
+};
+
+// For readers that loop over lines or values of a stream: every kInterval steps, reports the stream
+// position as a fraction of its size, so a cancel is seen within a few thousand lines.
+class StreamProgress {
+public:
+    static constexpr int kInterval = 4096;
+
+    StreamProgress(std::istream& input, const ReadProgress& progress) : input_(input), progress_(progress) {
+        if (progress_) {
+            const auto start = input_.tellg();
+            input_.seekg(0, std::ios::end);
+            size_ = std::max(1.0, static_cast<double>(input_.tellg()));
+            input_.seekg(start);
+        }
+    }
+
+    // Throws ReadCancelled if progress returns false.
+    void step() {
+        if (!progress_ || ++steps_ < kInterval) {
+            return;
+        }
+        steps_ = 0;
+        const auto offset = input_.tellg();  // -1 once the stream hit end of file
+        if (!progress_(offset < 0 ? 1.0 : static_cast<double>(offset) / size_)) {
+            throw ReadCancelled();
+        }
+    }
+
+private:
+    std::istream& input_;
+    const ReadProgress& progress_;
+    double size_ = 1.0;
+    int steps_ = 0;
+};
+
+}  // namespace sbox::io
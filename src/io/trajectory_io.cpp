@@ -157,10 +157,17 @@ sbox::chem::MolecularSystem Trajectory::interpolate(double t) const {
 }
 
 Trajectory read_trajectory_xyz(const std::string& filepath) {
+    return read_trajectory_xyz(filepath, {});
+}
+
+Trajectory read_trajectory_xyz(const std::string& filepath, const ReadProgress& progress) {
     std::ifstream input(filepath);
     if (!input) {
         throw std::runtime_error("Could not open trajectory XYZ file: " + filepath);
     }
+    input.seekg(0, std::ios::end);
+    const double file_size = std::max(1.0, static_cast<double>(input.tellg()));
+    input.seekg(0, std::ios::beg);
 
     Trajectory traj;
     int frame_index = 0;
@@ -178,6 +185,12 @@ Trajectory read_trajectory_xyz(const std::string& filepath) {
         input.clear();
         input.seekg(pos);
         traj.frames.push_back(read_frame(input, frame_index++));
+        if (progress) {
+            const auto offset = input.tellg();  // -1 once the last frame hit end of file
+            if (!progress(offset < 0 ? 1.0 : static_cast<double>(offset) / file_size)) {
+                throw ReadCancelled();
+            }
+        }
     }
     return traj;
 }
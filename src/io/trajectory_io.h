@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/molecular_system.h"
+#include "io/read_progress.h"
 
 #include <string>
 #include <vector>
@@ -28,6 +29,8 @@ struct Trajectory {
 };
 
 Trajectory read_trajectory_xyz(const std::string& filepath);
+// Reports progress after every frame; throws ReadCancelled if progress returns false.
+Trajectory read_trajectory_xyz(const std::string& filepath, const ReadProgress& progress);
 void write_trajectory_xyz(const std::string& filepath, const Trajectory& traj);
 
 }  // namespace sbox::io
@@ -42,7 +42,8 @@ int symbol_to_z(const std::string& symbol) {
     throw std::runtime_error("Unknown element symbol in XYZ: " + symbol);
 }
 
-sbox::chem::MolecularSystem read_xyz_stream(std::istream& input) {
+sbox::chem::MolecularSystem read_xyz_stream(std::istream& input, const ReadProgress& progress) {
+    StreamProgress stream_progress(input, progress);
     std::string line;
     if (!std::getline(input, line)) {
         throw std::runtime_error("Malformed XYZ: missing atom count line");
@@ -63,6 +64,7 @@ sbox::chem::MolecularSystem read_xyz_stream(std::istream& input) {
     mol.set_name(comment);
 
     for (int i = 0; i < atom_count; ++i) {
+        stream_progress.step();
         if (!std::getline(input, line)) {
             throw std::runtime_error("Malformed XYZ: atom count does not match number of coordinate lines");
         }
@@ -91,16 +93,20 @@ sbox::chem::MolecularSystem read_xyz_stream(std::istream& input) {
 }  // namespace
 
 sbox::chem::MolecularSystem read_xyz(const std::string& filepath) {
+    return read_xyz(filepath, {});
+}
+
+sbox::chem::MolecularSystem read_xyz(const std::string& filepath, const ReadProgress& progress) {
     std::ifstream input(filepath);
     if (!input) {
         throw std::runtime_error("Could not open XYZ file: " + filepath);
     }
-    return read_xyz_stream(input);
+    return read_xyz_stream(input, progress);
 }
 
 sbox::chem::MolecularSystem read_xyz_string(const std::string& content) {
     std::istringstream input(content);
-    return read_xyz_stream(input);
+    return read_xyz_stream(input, {});
 }
 
 void write_xyz(const std::string& filepath, const sbox::chem::MolecularSystem& mol) {
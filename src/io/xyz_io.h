@@ -1,12 +1,15 @@
 #pragma once
 
 #include "core/molecular_system.h"
+#include "io/read_progress.h"
 
 #include <string>
 
 namespace sbox::io {
 
 sbox::chem::MolecularSystem read_xyz(const std::string& filepath);
+// Reports progress every few thousand atoms; throws ReadCancelled if progress returns false.
+sbox::chem::MolecularSystem read_xyz(const std::string& filepath, const ReadProgress& progress);
 sbox::chem::MolecularSystem read_xyz_string(const std::string& content);
 void write_xyz(const std::string& filepath, const sbox::chem::MolecularSystem& mol);
 
@@ -1,3 +1,7 @@
+#include "backend/backend_manager.h"
+#include "backend/python_env.h"
+#include "batch_compute.h"
+#include "batch_manifest.h"
 #include "cli.h"
 #include "renderer/screenshot.h"
 #include "ui/app.h"
@@ -6,8 +10,20 @@
 #include "core/settings.h"
 #include "version.h"
 
+#include <Eigen/Geometry>
+
+#include <algorithm>
+#include <cstdlib>
 #include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace {
 
@@ -19,6 +35,201 @@ sbox::LogLevel parse_log_level(const std::string& level) {
     return sbox::LogLevel::Info;
 }
 
+constexpr float kDegToRad = 3.14159265358979323846f / 180.0f;
+
+// View of a freshly loaded file; manifest entries are applied relative to it.
+struct ViewDefaults {
+    int selected_mo = -1;
+    int render_mode = 0;
+    float iso_value = 0.0f;
+    Eigen::Quaternionf orientation = Eigen::Quaternionf::Identity();
+    Eigen::Vector3f target = Eigen::Vector3f::Zero();
+    float distance = 1.0f;
+};
+
+std::string read_text_file(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not open manifest " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+void apply_render_request(sbox::App& app, const sbox::RenderRequest& request, const ViewDefaults& defaults) {
+    auto& state = app.state();
+    if (request.orbital >= 0) {
+        state.selected_mo = request.orbital;
+    } else if (request.orbital == -2 && state.homo_index >= 0) {
+        state.selected_mo = state.homo_index + 1;
+    } else {
+        state.selected_mo = defaults.selected_mo;
+    }
+
+    state.iso_value = request.iso_value > 0.0f ? request.iso_value : defaults.iso_value;
+
+    state.render_mode = defaults.render_mode;
+    if (request.render_mode == "volume") {
+        state.render_mode = 0;
+    } else if (request.render_mode == "isosurface") {
+        state.render_mode = 1;
+    } else if (request.render_mode == "phase") {
+        state.render_mode = 2;
+    }
+
+    // Same composition as a mouse drag: yaw about the world up axis, pitch about the camera's own.
+    sbox::Camera& camera = app.camera();
+    const Eigen::Quaternionf yaw(Eigen::AngleAxisf(request.yaw_deg * kDegToRad, Eigen::Vector3f::UnitY()));
+    const Eigen::Quaternionf pitch(Eigen::AngleAxisf(request.pitch_deg * kDegToRad, Eigen::Vector3f::UnitX()));
+    camera.setTarget(defaults.target);
+    camera.setOrientation((yaw * defaults.orientation * pitch).normalized());
+    camera.setDistance(defaults.distance / request.zoom);
+}
+
+bool save_render(sbox::App& app, const sbox::RenderRequest& request) {
+    // Poster-size PNGs are rendered in tiles and streamed, so they are not bound by GL limits.
+    const std::string extension = std::filesystem::path(request.output_path).extension().string();
+    const bool tiled = (extension == ".png" || extension == ".PNG") && std::max(request.width, request.height) > 4096;
+    if (tiled) {
+        return sbox::render::save_screenshot_tiled(
+            request.output_path,
+            request.width,
+            request.height,
+            [&app](unsigned int fbo, const sbox::render::RenderTile& tile) { app.render_tile_to_fbo(fbo, tile); });
+    }
+    return sbox::render::save_screenshot_highres(
+        request.output_path,
+        request.width,
+        request.height,
+        [&app](unsigned int fbo, int w, int h) { app.render_to_fbo(fbo, w, h); });
+}
+
+// Renders --screenshot or every --render-batch entry through one headless App, so the GL context,
+// shaders and a loaded file's orbital data are reused from image to image. Returns the number of
+// images that could not be written.
+int render_batch(const sbox::CLIOptions& options) {
+    if (options.render_manifest.empty() && options.screenshot_path.empty()) {
+        SBOX_LOG_FATAL("--headless needs --screenshot FILE or --render-batch FILE");
+        return 1;
+    }
+    const sbox::RenderRequest cli_request = sbox::render_request_from_cli(options);
+    std::vector<sbox::RenderRequest> requests;
+    try {
+        if (options.render_manifest.empty()) {
+            requests.push_back(cli_request);
+        } else {
+            requests = sbox::parse_render_manifest(read_text_file(options.render_manifest), cli_request);
+        }
+    } catch (const std::exception& ex) {
+        SBOX_LOG_FATAL("Render batch failed: %s", ex.what());
+        return 1;
+    }
+
+    std::unique_ptr<sbox::App> app;
+    try {
+        app = std::make_unique<sbox::App>(true);
+    } catch (const std::exception& ex) {
+        SBOX_LOG_FATAL("Could not create an offscreen GL context: %s", ex.what());
+        return static_cast<int>(requests.size()) + 1;
+    }
+
+    int failures = 0;
+    std::string loaded_file;
+    ViewDefaults defaults;
+    for (const sbox::RenderRequest& request : requests) {
+        try {
+            if (request.input_file != loaded_file) {
+                loaded_file.clear();
+                app->load_file_by_extension(request.input_file);
+                loaded_file = request.input_file;
+                defaults.selected_mo = app->state().selected_mo;
+                defaults.render_mode = app->state().render_mode;
+                defaults.iso_value = app->state().iso_value;
+                defaults.orientation = app->camera().orientation();
+                defaults.target = app->camera().target();
+                defaults.distance = app->camera().distance();
+            }
+            apply_render_request(*app, request, defaults);
+            app->render_single_frame();
+            if (!save_render(*app, request)) {
+                throw std::runtime_error("could not write " + request.output_path);
+            }
+            SBOX_LOG_INFO("Screenshot saved to %s", request.output_path.c_str());
+        } catch (const std::exception& ex) {
+            SBOX_LOG_ERROR("Screenshot %s failed: %s", request.output_path.c_str(), ex.what());
+            ++failures;
+        }
+    }
+    if (requests.size() > 1) {
+        SBOX_LOG_INFO("Rendered %d of %d images", static_cast<int>(requests.size()) - failures, static_cast<int>(requests.size()));
+    }
+    return failures;
+}
+
+// Runs --compute / --optimize over every input file or manifest entry without creating a window,
+// writing one JSON line per calculation to --output or stdout. Returns the number of failures.
+int compute_batch(const sbox::CLIOptions& options) {
+    std::vector<sbox::ComputeRequest> requests;
+    try {
+        const sbox::ComputeRequest defaults = sbox::compute_request_from_cli(options);
+        if (!options.compute_manifest.empty()) {
+            requests = sbox::parse_compute_manifest(read_text_file(options.compute_manifest), defaults);
+        }
+        for (const std::string& input : options.input_files) {
+            sbox::ComputeRequest request = defaults;
+            request.input_file = input;
+            requests.push_back(request);
+        }
+    } catch (const std::exception& ex) {
+        SBOX_LOG_FATAL("Compute batch failed: %s", ex.what());
+        return 1;
+    }
+    if (requests.empty()) {
+        SBOX_LOG_FATAL("--compute needs input files or --manifest");
+        return 1;
+    }
+
+    std::ofstream output_file;
+    if (!options.output_file.empty()) {
+        output_file.open(options.output_file, options.append_output ? std::ios::app : std::ios::trunc);
+        if (!output_file) {
+            SBOX_LOG_FATAL("Could not open %s for writing", options.output_file.c_str());
+            return 1;
+        }
+    }
+    std::ostream& out = options.output_file.empty() ? std::cout : output_file;
+
+    sbox::SettingsManager settings;
+    settings.load();
+    sbox::backend::PythonEnvironment python_env;
+    if (!python_env.load_cache((std::filesystem::path(sbox::get_app_data_dir()) / "python_env_cache.json").string(),
+                               settings.settings().python_path)) {
+        if (!settings.settings().python_path.empty()) {
+            python_env.set_python_path(settings.settings().python_path);
+        }
+        if (!python_env.is_valid()) {
+            python_env.detect();
+        }
+    }
+
+    // Each driver would otherwise start one OpenMP thread per core on top of its siblings.
+    const int hardware = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int parallel = options.max_parallel_jobs > 0 ? options.max_parallel_jobs : hardware;
+    if (parallel > 1 && std::getenv("OMP_NUM_THREADS") == nullptr) {
+        setenv("OMP_NUM_THREADS", std::to_string(std::max(1, hardware / parallel)).c_str(), 0);
+    }
+
+    sbox::backend::BackendManager backend;
+    backend.init(python_env);
+    SBOX_LOG_INFO("Running %d calculations, %d at a time", static_cast<int>(requests.size()), parallel);
+    const int failures = sbox::run_compute_batch(requests, backend, parallel, out);
+    SBOX_LOG_INFO("Compute batch finished: %d of %d converged",
+                  static_cast<int>(requests.size()) - failures,
+                  static_cast<int>(requests.size()));
+    return failures;
+}
+
 }  // namespace
 
 int main(int argc, char* argv[]) {
@@ -39,48 +250,17 @@ int main(int argc, char* argv[]) {
     logger.set_file(options.log_file.empty() ? sbox::get_app_data_dir() + "schrodingers_sandbox.log" : options.log_file);
     SBOX_LOG_INFO("Schrodinger's Sandbox %s starting", sbox::VERSION);
 
-    if (!options.screenshot_path.empty() && !options.input_file.empty()) {
-        try {
-            sbox::App app;
-            app.load_file_by_extension(options.input_file);
-
-            if (options.orbital >= 0) {
-                app.state().selected_mo = options.orbital;
-            } else if (options.orbital == -2 && app.state().homo_index >= 0) {
-                app.state().selected_mo = app.state().homo_index + 1;
-            }
-
-            if (options.iso_value > 0.0f) {
-                app.state().iso_value = options.iso_value;
-            }
-
-            if (options.render_mode == "volume") {
-                app.state().render_mode = 0;
-            } else if (options.render_mode == "isosurface") {
-                app.state().render_mode = 1;
-            } else if (options.render_mode == "phase") {
-                app.state().render_mode = 2;
-            }
-
-            app.render_single_frame();
-            if (!sbox::render::save_screenshot_highres(
-                    options.screenshot_path,
-                    options.screenshot_width,
-                    options.screenshot_height,
-                    [&app](unsigned int fbo, int w, int h) { app.render_to_fbo(fbo, w, h); })) {
-                SBOX_LOG_FATAL("Screenshot failed: could not write %s", options.screenshot_path.c_str());
-                logger.shutdown();
-                return 1;
-            }
+    if (options.compute || options.optimize) {
+        const int failures = compute_batch(options);
+        logger.shutdown();
+        return failures == 0 ? 0 : 1;
+    }
 
-            SBOX_LOG_INFO("Screenshot saved to %s", options.screenshot_path.c_str());
-            logger.shutdown();
-            return 0;
-        } catch (const std::exception& ex) {
-            SBOX_LOG_FATAL("Screenshot failed: %s", ex.what());
-            logger.shutdown();
-            return 1;
-        }
+    if (options.headless || !options.render_manifest.empty()
+        || (!options.screenshot_path.empty() && !options.input_file.empty())) {
+        const int failures = render_batch(options);
+        logger.shutdown();
+        return failures == 0 ? 0 : 1;
     }
 
     try {
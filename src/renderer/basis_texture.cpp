@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 
@@ -28,27 +29,6 @@ int num_basis_in_shell(int angular_momentum, bool spherical) {
     }
 }
 
-void configure_texture(unsigned int texture) {
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-}
-
-void upload_rgba32f(unsigned int texture, int width, int height, const std::vector<float>& data) {
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D,
-                 0,
-                 GL_RGBA32F,
-                 width,
-                 height,
-                 0,
-                 GL_RGBA,
-                 GL_FLOAT,
-                 data.empty() ? nullptr : data.data());
-}
-
 void set_sampler_uniform(unsigned int shader_id, const char* name, int value) {
     const int location = glGetUniformLocation(shader_id, name);
     if (location >= 0) {
@@ -56,31 +36,103 @@ void set_sampler_uniform(unsigned int shader_id, const char* name, int value) {
     }
 }
 
-void ensure_texture(unsigned int* texture) {
+void ensure_buffer_texture(unsigned int* buffer, unsigned int* texture) {
+    if (*buffer == 0) {
+        glGenBuffers(1, buffer);
+    }
+    if (*texture == 0) {
+        glGenTextures(1, texture);
+    }
+}
+
+// Reallocates the buffer and re-attaches it; zero-sized buffers get one texel so the sampler stays complete.
+void upload_buffer_texture(unsigned int buffer,
+                           unsigned int texture,
+                           GLenum internal_format,
+                           const void* data,
+                           std::size_t bytes) {
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(std::max<std::size_t>(bytes, 16)), nullptr, GL_STATIC_DRAW);
+    if (bytes > 0) {
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, static_cast<GLsizeiptr>(bytes), data);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, internal_format, buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void delete_buffer_texture(unsigned int* buffer, unsigned int* texture) {
     if (*texture != 0) {
-        return;
+        glDeleteTextures(1, texture);
+        *texture = 0;
+    }
+    if (*buffer != 0) {
+        glDeleteBuffers(1, buffer);
+        *buffer = 0;
     }
-    glGenTextures(1, texture);
-    configure_texture(*texture);
 }
 
 }  // namespace
 
-BasisTextures::BasisTextures() = default;
+std::uint16_t float_to_half(float value) {
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const std::uint32_t sign = (bits >> 16) & 0x8000u;
+    const std::uint32_t magnitude = bits & 0x7fffffffu;
 
-BasisTextures::~BasisTextures() {
-    if (tex_shells_ != 0) {
-        glDeleteTextures(1, &tex_shells_);
+    if (magnitude >= 0x7f800000u) {
+        return static_cast<std::uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
     }
-    if (tex_meta_ != 0) {
-        glDeleteTextures(1, &tex_meta_);
+    if (magnitude >= 0x477ff000u) {  // rounds to 65520 or more
+        return static_cast<std::uint16_t>(sign | 0x7c00u);
     }
-    if (tex_primitives_ != 0) {
-        glDeleteTextures(1, &tex_primitives_);
+    if (magnitude < 0x38800000u) {  // below the smallest normal half, 2^-14
+        if (magnitude < 0x33000000u) {
+            return static_cast<std::uint16_t>(sign);
+        }
+        const std::uint32_t mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+        const std::uint32_t shift = 126u - (magnitude >> 23);
+        std::uint32_t half = mantissa >> shift;
+        const std::uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const std::uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half & 1u) != 0)) {
+            ++half;
+        }
+        return static_cast<std::uint16_t>(sign | half);
     }
-    if (tex_mo_coeffs_ != 0) {
-        glDeleteTextures(1, &tex_mo_coeffs_);
+
+    std::uint32_t half = (magnitude - 0x38000000u) >> 13;
+    const std::uint32_t remainder = magnitude & 0x1fffu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u) != 0)) {
+        ++half;
     }
+    return static_cast<std::uint16_t>(sign | half);
+}
+
+float half_to_float(std::uint16_t value) {
+    const std::uint32_t sign = (static_cast<std::uint32_t>(value) & 0x8000u) << 16;
+    const std::uint32_t exponent = (value >> 10) & 0x1fu;
+    const std::uint32_t mantissa = value & 0x3ffu;
+
+    if (exponent == 0) {
+        const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign != 0 ? -magnitude : magnitude;
+    }
+    const std::uint32_t bits =
+        exponent == 31 ? (sign | 0x7f800000u | (mantissa << 13)) : (sign | ((exponent + 112u) << 23) | (mantissa << 13));
+    float result = 0.0f;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+BasisTextures::BasisTextures() = default;
+
+BasisTextures::~BasisTextures() {
+    delete_buffer_texture(&buf_shells_, &tex_shells_);
+    delete_buffer_texture(&buf_meta_, &tex_meta_);
+    delete_buffer_texture(&buf_primitives_, &tex_primitives_);
+    delete_buffer_texture(&buf_mo_coeffs_, &tex_mo_coeffs_);
 }
 
 bool BasisTextures::pack(const sbox::basis::MOData& mo_data) {
@@ -89,13 +141,15 @@ bool BasisTextures::pack(const sbox::basis::MOData& mo_data) {
     num_mo_ = static_cast<int>(mo_data.coefficients.cols());
     spherical_ = mo_data.basis.spherical;
     uploaded_ = false;
+    selected_mo_ = -1;
+    mo_half_ = false;
 
     num_primitives_ = 0;
     for (const sbox::basis::BasisShell& shell : mo_data.basis.shells) {
         num_primitives_ += static_cast<int>(shell.primitives.size());
     }
 
-    if (num_shells_ > MAX_SHELLS || num_primitives_ > MAX_PRIMITIVES || num_basis_ > MAX_BASIS || num_mo_ > MAX_MO) {
+    if (num_shells_ == 0 || num_basis_ == 0 || num_mo_ == 0) {
         shell_data_.clear();
         meta_data_.clear();
         prim_data_.clear();
@@ -110,9 +164,7 @@ bool BasisTextures::pack(const sbox::basis::MOData& mo_data) {
     shell_data_.assign(static_cast<std::size_t>(num_shells_) * 4, 0.0f);
     meta_data_.assign(static_cast<std::size_t>(num_shells_) * 4, 0.0f);
     prim_data_.assign(static_cast<std::size_t>(num_primitives_) * 4, 0.0f);
-
-    const int mo_tex_height = std::max(1, (num_mo_ + 3) / 4);
-    mo_data_.assign(static_cast<std::size_t>(num_basis_) * static_cast<std::size_t>(mo_tex_height) * 4, 0.0f);
+    mo_data_.assign(static_cast<std::size_t>(num_basis_) * static_cast<std::size_t>(num_mo_), 0.0f);
 
     int primitive_offset = 0;
     int basis_offset = 0;
@@ -147,16 +199,10 @@ bool BasisTextures::pack(const sbox::basis::MOData& mo_data) {
         basis_offset += basis_in_shell;
     }
 
-    for (int mu = 0; mu < num_basis_; ++mu) {
-        for (int mo = 0; mo < num_mo_; ++mo) {
-            const int texel_y = mo / 4;
-            const int channel = mo % 4;
-            const std::size_t offset =
-                (static_cast<std::size_t>(mu) * static_cast<std::size_t>(mo_tex_height)
-                 + static_cast<std::size_t>(texel_y))
-                * 4
-                + static_cast<std::size_t>(channel);
-            mo_data_[offset] = static_cast<float>(mo_data.coefficients(mu, mo));
+    for (int mo = 0; mo < num_mo_; ++mo) {
+        float* column = mo_data_.data() + static_cast<std::size_t>(mo) * static_cast<std::size_t>(num_basis_);
+        for (int mu = 0; mu < num_basis_; ++mu) {
+            column[mu] = static_cast<float>(mo_data.coefficients(mu, mo));
         }
     }
 
@@ -165,21 +211,73 @@ bool BasisTextures::pack(const sbox::basis::MOData& mo_data) {
 }
 
 bool BasisTextures::upload(const sbox::basis::MOData& mo_data) {
+    gpu_ready_ = false;
     if (!pack(mo_data)) {
         return false;
     }
 
-    ensure_texture(&tex_shells_);
-    ensure_texture(&tex_meta_);
-    ensure_texture(&tex_primitives_);
-    ensure_texture(&tex_mo_coeffs_);
+    GLint max_texels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &max_texels);
+    if (std::max({num_shells_, num_primitives_, num_basis_}) > max_texels) {
+        uploaded_ = false;
+        return false;
+    }
 
-    const int mo_tex_height = std::max(1, (num_mo_ + 3) / 4);
-    upload_rgba32f(tex_shells_, std::max(1, num_shells_), 1, shell_data_);
-    upload_rgba32f(tex_meta_, std::max(1, num_shells_), 1, meta_data_);
-    upload_rgba32f(tex_primitives_, std::max(1, num_primitives_), 1, prim_data_);
-    upload_rgba32f(tex_mo_coeffs_, std::max(1, num_basis_), mo_tex_height, mo_data_);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    ensure_buffer_texture(&buf_shells_, &tex_shells_);
+    ensure_buffer_texture(&buf_meta_, &tex_meta_);
+    ensure_buffer_texture(&buf_primitives_, &tex_primitives_);
+    ensure_buffer_texture(&buf_mo_coeffs_, &tex_mo_coeffs_);
+
+    upload_buffer_texture(buf_shells_, tex_shells_, GL_RGBA32F, shell_data_.data(), shell_data_.size() * sizeof(float));
+    upload_buffer_texture(buf_meta_, tex_meta_, GL_RGBA32F, meta_data_.data(), meta_data_.size() * sizeof(float));
+    upload_buffer_texture(buf_primitives_, tex_primitives_, GL_RGBA32F, prim_data_.data(), prim_data_.size() * sizeof(float));
+    mo_buffer_bytes_ = 0;
+    gpu_ready_ = true;
+    return true;
+}
+
+bool BasisTextures::select_mo(int mo_index) {
+    if (!uploaded_ || mo_index < 0 || mo_index >= num_mo_) {
+        return false;
+    }
+    if (mo_index == selected_mo_) {
+        return true;
+    }
+
+    const float* column = mo_data_.data() + static_cast<std::size_t>(mo_index) * static_cast<std::size_t>(num_basis_);
+    float max_abs = 0.0f;
+    for (int mu = 0; mu < num_basis_; ++mu) {
+        max_abs = std::max(max_abs, std::abs(column[mu]));
+    }
+
+    mo_half_column_.resize(static_cast<std::size_t>(num_basis_));
+    const float tolerance = kHalfPrecisionTolerance * max_abs;
+    mo_half_ = true;
+    for (int mu = 0; mu < num_basis_ && mo_half_; ++mu) {
+        const std::uint16_t half = float_to_half(column[mu]);
+        mo_half_column_[static_cast<std::size_t>(mu)] = half;
+        mo_half_ = std::abs(half_to_float(half) - column[mu]) <= tolerance;
+    }
+    if (!mo_half_) {
+        mo_half_column_.clear();
+    }
+    selected_mo_ = mo_index;
+
+    if (!gpu_ready_) {
+        return true;
+    }
+
+    const void* data = mo_half_ ? static_cast<const void*>(mo_half_column_.data()) : static_cast<const void*>(column);
+    const std::size_t bytes = static_cast<std::size_t>(num_basis_) * (mo_half_ ? sizeof(std::uint16_t) : sizeof(float));
+    if (bytes == mo_buffer_bytes_ && mo_half_ == mo_buffer_half_) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buf_mo_coeffs_);
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, static_cast<GLsizeiptr>(bytes), data);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    } else {
+        upload_buffer_texture(buf_mo_coeffs_, tex_mo_coeffs_, mo_half_ ? GL_R16F : GL_R32F, data, bytes);
+        mo_buffer_bytes_ = bytes;
+        mo_buffer_half_ = mo_half_;
+    }
     return true;
 }
 
@@ -187,13 +285,13 @@ void BasisTextures::bind(unsigned int shader_id, int first_unit) const {
     bound_first_unit_ = first_unit;
 
     glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(first_unit + 0));
-    glBindTexture(GL_TEXTURE_2D, tex_shells_);
+    glBindTexture(GL_TEXTURE_BUFFER, tex_shells_);
     glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(first_unit + 1));
-    glBindTexture(GL_TEXTURE_2D, tex_meta_);
+    glBindTexture(GL_TEXTURE_BUFFER, tex_meta_);
     glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(first_unit + 2));
-    glBindTexture(GL_TEXTURE_2D, tex_primitives_);
+    glBindTexture(GL_TEXTURE_BUFFER, tex_primitives_);
     glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(first_unit + 3));
-    glBindTexture(GL_TEXTURE_2D, tex_mo_coeffs_);
+    glBindTexture(GL_TEXTURE_BUFFER, tex_mo_coeffs_);
 
     set_sampler_uniform(shader_id, "u_shell_desc", first_unit + 0);
     set_sampler_uniform(shader_id, "u_shell_meta", first_unit + 1);
@@ -203,13 +301,13 @@ void BasisTextures::bind(unsigned int shader_id, int first_unit) const {
 
 void BasisTextures::unbind() const {
     glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(bound_first_unit_ + 0));
-    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
     glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(bound_first_unit_ + 1));
-    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
     glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(bound_first_unit_ + 2));
-    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
     glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(bound_first_unit_ + 3));
-    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
 }
 
 int BasisTextures::num_shells() const {
@@ -236,6 +334,14 @@ bool BasisTextures::is_uploaded() const {
     return uploaded_;
 }
 
+int BasisTextures::selected_mo() const {
+    return selected_mo_;
+}
+
+bool BasisTextures::mo_is_half_precision() const {
+    return mo_half_;
+}
+
 const std::vector<float>& BasisTextures::shell_data() const {
     return shell_data_;
 }
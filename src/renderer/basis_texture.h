@@ -2,15 +2,22 @@
 
 #include "core/basis_set.h"
 
+#include <cstdint>
 #include <vector>
 
 namespace sbox::render {
 
-inline constexpr int MAX_SHELLS = 512;
-inline constexpr int MAX_PRIMITIVES = 2048;
-inline constexpr int MAX_BASIS = 2048;
-inline constexpr int MAX_MO = 512;
+// A coefficient column is stored as half floats when no coefficient moves by more than this
+// fraction of the column's largest |coefficient|.
+inline constexpr float kHalfPrecisionTolerance = 1e-3f;
 
+// IEEE 754 binary16 conversion, round to nearest even; out-of-range values become infinities.
+std::uint16_t float_to_half(float value);
+float half_to_float(std::uint16_t value);
+
+// Shells, primitives and MO coefficients as buffer textures for the analytic MO ray marcher. There are
+// no fixed caps besides GL_MAX_TEXTURE_BUFFER_SIZE, and only the coefficient column of the orbital
+// being drawn is on the GPU.
 class BasisTextures {
 public:
     BasisTextures();
@@ -21,6 +28,8 @@ public:
 
     bool pack(const sbox::basis::MOData& mo_data);
     bool upload(const sbox::basis::MOData& mo_data);
+    // Makes mo_index the column read by u_mo_coeffs; uploads only when the selection changes.
+    bool select_mo(int mo_index);
     void bind(unsigned int shader_id, int first_unit = 1) const;
     void unbind() const;
 
@@ -30,13 +39,20 @@ public:
     int num_primitives() const;
     bool is_spherical() const;
     bool is_uploaded() const;
+    int selected_mo() const;
+    bool mo_is_half_precision() const;
 
     const std::vector<float>& shell_data() const;
     const std::vector<float>& meta_data() const;
     const std::vector<float>& primitive_data() const;
+    // All MO coefficients, one column of num_basis() values per MO.
     const std::vector<float>& mo_coeff_data() const;
 
 private:
+    unsigned int buf_shells_ = 0;
+    unsigned int buf_meta_ = 0;
+    unsigned int buf_primitives_ = 0;
+    unsigned int buf_mo_coeffs_ = 0;
     unsigned int tex_shells_ = 0;
     unsigned int tex_meta_ = 0;
     unsigned int tex_primitives_ = 0;
@@ -48,11 +64,18 @@ private:
     int num_primitives_ = 0;
     bool spherical_ = true;
     bool uploaded_ = false;
+    bool gpu_ready_ = false;
+
+    int selected_mo_ = -1;
+    bool mo_half_ = false;
+    bool mo_buffer_half_ = false;
+    std::size_t mo_buffer_bytes_ = 0;
 
     std::vector<float> shell_data_;
     std::vector<float> meta_data_;
     std::vector<float> prim_data_;
     std::vector<float> mo_data_;
+    std::vector<std::uint16_t> mo_half_column_;
 
     mutable int bound_first_unit_ = 1;
 };
@@ -0,0 +1,306 @@
+#include "renderer/brick_grid.h"
+
+#include <glad/gl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace sbox::render {
+
+namespace {
+
+// Shells are dropped from bricks where their bound is below this; the total dropped mass is added
+// back to every brick so the grid stays a true upper bound.
+constexpr double kShellCutoff = 1e-8;
+
+int num_basis_in_shell(int angular_momentum, bool spherical) {
+    switch (angular_momentum) {
+    case 0:
+        return 1;
+    case 1:
+        return 3;
+    case 2:
+        return spherical ? 5 : 6;
+    case 3:
+        return spherical ? 7 : 10;
+    default:
+        throw std::runtime_error("Unsupported shell angular momentum: " + std::to_string(angular_momentum));
+    }
+}
+
+std::size_t brick_index(const Eigen::Vector3i& dims, int x, int y, int z) {
+    return (static_cast<std::size_t>(z) * static_cast<std::size_t>(dims.y()) + static_cast<std::size_t>(y))
+        * static_cast<std::size_t>(dims.x())
+        + static_cast<std::size_t>(x);
+}
+
+struct ShellBound {
+    int angular_momentum = 0;
+    double scale = 0.0;  // sum of |MO coefficient| over the shell's basis functions
+    std::vector<double> exponents;
+    std::vector<double> weights;  // |contraction coefficient|
+    std::vector<double> peak_radii;
+
+    // Largest scale * sum_p w_p r^L exp(-alpha_p r^2) over r in [r_min, r_max].
+    double max_over(double r_min, double r_max) const {
+        double total = 0.0;
+        for (std::size_t p = 0; p < exponents.size(); ++p) {
+            const double r = std::clamp(peak_radii[p], r_min, r_max);
+            total += weights[p] * std::pow(r, angular_momentum) * std::exp(-exponents[p] * r * r);
+        }
+        return scale * total;
+    }
+
+    // Radius past which the shell contributes less than kShellCutoff anywhere.
+    double cutoff_radius() const {
+        const auto tail = [this](double r) { return max_over(r, 1e30); };
+        double hi = 1.0;
+        while (tail(hi) > kShellCutoff && hi < 1e4) {
+            hi *= 2.0;
+        }
+        double lo = 0.0;
+        for (int i = 0; i < 40; ++i) {
+            const double mid = 0.5 * (lo + hi);
+            (tail(mid) > kShellCutoff ? lo : hi) = mid;
+        }
+        return hi;
+    }
+};
+
+}  // namespace
+
+bool BrickGrid::empty() const {
+    return max_abs.empty();
+}
+
+float BrickGrid::at(int x, int y, int z) const {
+    return max_abs[brick_index(dims, x, y, z)];
+}
+
+float BrickGrid::bound_at(const Eigen::Vector3f& world_pos, float outside) const {
+    const Eigen::Vector3f b = world_to_brick * (world_pos - origin);
+    const int x = static_cast<int>(std::floor(b.x()));
+    const int y = static_cast<int>(std::floor(b.y()));
+    const int z = static_cast<int>(std::floor(b.z()));
+    if (x < 0 || y < 0 || z < 0 || x >= dims.x() || y >= dims.y() || z >= dims.z()) {
+        return outside;
+    }
+    return at(x, y, z);
+}
+
+BrickGrid build_volume_bricks(const float* data,
+                              int nx,
+                              int ny,
+                              int nz,
+                              const Eigen::Vector3f& origin,
+                              const Eigen::Matrix3f& world_to_grid,
+                              int voxels_per_brick) {
+    BrickGrid grid;
+    if (data == nullptr || nx <= 0 || ny <= 0 || nz <= 0 || voxels_per_brick <= 0) {
+        return grid;
+    }
+
+    const int b = voxels_per_brick;
+    grid.dims = Eigen::Vector3i((nx + b - 1) / b, (ny + b - 1) / b, (nz + b - 1) / b);
+    grid.origin = origin;
+    grid.world_to_brick = world_to_grid / static_cast<float>(b);
+    grid.max_abs.assign(static_cast<std::size_t>(grid.dims.prod()), 0.0f);
+
+    const auto voxel = [&](int i, int j, int k) {
+        return data[(static_cast<std::size_t>(i) * static_cast<std::size_t>(ny) + static_cast<std::size_t>(j))
+                        * static_cast<std::size_t>(nz)
+                    + static_cast<std::size_t>(k)];
+    };
+
+    for (int bz = 0; bz < grid.dims.z(); ++bz) {
+        const int k0 = std::max(0, bz * b - 1);
+        const int k1 = std::min(nz - 1, (bz + 1) * b + 1);
+        for (int by = 0; by < grid.dims.y(); ++by) {
+            const int j0 = std::max(0, by * b - 1);
+            const int j1 = std::min(ny - 1, (by + 1) * b + 1);
+            for (int bx = 0; bx < grid.dims.x(); ++bx) {
+                const int i0 = std::max(0, bx * b - 1);
+                const int i1 = std::min(nx - 1, (bx + 1) * b + 1);
+                float brick_max = 0.0f;
+                for (int i = i0; i <= i1; ++i) {
+                    for (int j = j0; j <= j1; ++j) {
+                        for (int k = k0; k <= k1; ++k) {
+                            brick_max = std::max(brick_max, std::abs(voxel(i, j, k)));
+                        }
+                    }
+                }
+                grid.max_abs[brick_index(grid.dims, bx, by, bz)] = brick_max;
+            }
+        }
+    }
+    return grid;
+}
+
+BrickGrid build_orbital_bricks(const sbox::basis::MOData& mo_data,
+                               int mo_index,
+                               float bound_radius,
+                               int bricks_per_axis) {
+    BrickGrid grid;
+    if (mo_index < 0 || mo_index >= mo_data.coefficients.cols() || bound_radius <= 0.0f || bricks_per_axis <= 0) {
+        return grid;
+    }
+
+    const int n = bricks_per_axis;
+    const double brick_size = 2.0 * static_cast<double>(bound_radius) / static_cast<double>(n);
+    grid.dims = Eigen::Vector3i::Constant(n);
+    grid.origin = Eigen::Vector3f::Constant(-bound_radius);
+    grid.world_to_brick = Eigen::Matrix3f::Identity() * static_cast<float>(1.0 / brick_size);
+    std::vector<double> bounds(static_cast<std::size_t>(n) * static_cast<std::size_t>(n) * static_cast<std::size_t>(n), 0.0);
+
+    int basis_offset = 0;
+    double dropped = 0.0;
+    for (const sbox::basis::BasisShell& shell : mo_data.basis.shells) {
+        const int basis_count = num_basis_in_shell(shell.angular_momentum, mo_data.basis.spherical);
+        ShellBound bound;
+        bound.angular_momentum = shell.angular_momentum;
+        for (int mu = basis_offset; mu < basis_offset + basis_count; ++mu) {
+            bound.scale += std::abs(mo_data.coefficients(mu, mo_index));
+        }
+        basis_offset += basis_count;
+        if (bound.scale == 0.0 || shell.atom_index < 0
+            || shell.atom_index >= static_cast<int>(mo_data.atom_positions.size())) {
+            continue;
+        }
+        for (const sbox::basis::GaussianPrimitive& primitive : shell.primitives) {
+            bound.exponents.push_back(primitive.exponent);
+            bound.weights.push_back(std::abs(primitive.coefficient));
+            bound.peak_radii.push_back(std::sqrt(static_cast<double>(shell.angular_momentum) / (2.0 * primitive.exponent)));
+        }
+
+        const Eigen::Vector3d center = mo_data.atom_positions[static_cast<std::size_t>(shell.atom_index)];
+        const double cutoff = bound.cutoff_radius();
+        dropped += kShellCutoff;
+
+        Eigen::Vector3i lo;
+        Eigen::Vector3i hi;
+        for (int axis = 0; axis < 3; ++axis) {
+            const double start = center[axis] + static_cast<double>(bound_radius);
+            lo[axis] = std::clamp(static_cast<int>(std::floor((start - cutoff) / brick_size)), 0, n - 1);
+            hi[axis] = std::clamp(static_cast<int>(std::floor((start + cutoff) / brick_size)), 0, n - 1);
+        }
+
+        for (int z = lo.z(); z <= hi.z(); ++z) {
+            for (int y = lo.y(); y <= hi.y(); ++y) {
+                for (int x = lo.x(); x <= hi.x(); ++x) {
+                    const Eigen::Vector3d box_min =
+                        Eigen::Vector3d(x, y, z) * brick_size - Eigen::Vector3d::Constant(bound_radius);
+                    const Eigen::Vector3d box_max = box_min + Eigen::Vector3d::Constant(brick_size);
+                    const Eigen::Vector3d nearest = center.cwiseMax(box_min).cwiseMin(box_max);
+                    const Eigen::Vector3d farthest = (center - box_min).cwiseAbs().cwiseMax((center - box_max).cwiseAbs());
+                    const double r_min = (nearest - center).norm();
+                    if (r_min > cutoff) {
+                        continue;
+                    }
+                    bounds[brick_index(grid.dims, x, y, z)] += bound.max_over(r_min, farthest.norm());
+                }
+            }
+        }
+    }
+
+    // The relative slack absorbs float rounding in the shader's evaluation of the same sum.
+    grid.max_abs.resize(bounds.size());
+    for (std::size_t i = 0; i < bounds.size(); ++i) {
+        grid.max_abs[i] = static_cast<float>((bounds[i] + dropped) * 1.001);
+    }
+    return grid;
+}
+
+BrickTexture::~BrickTexture() {
+    if (texture_3d_ != 0) {
+        glDeleteTextures(1, &texture_3d_);
+    }
+}
+
+bool BrickTexture::upload(const BrickGrid& grid) {
+    if (grid.empty()) {
+        uploaded_ = false;
+        return false;
+    }
+
+    if (texture_3d_ == 0) {
+        glGenTextures(1, &texture_3d_);
+    }
+    glBindTexture(GL_TEXTURE_3D, texture_3d_);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexImage3D(GL_TEXTURE_3D,
+                 0,
+                 GL_R32F,
+                 grid.dims.x(),
+                 grid.dims.y(),
+                 grid.dims.z(),
+                 0,
+                 GL_RED,
+                 GL_FLOAT,
+                 grid.max_abs.data());
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    dims_ = grid.dims;
+    origin_ = grid.origin;
+    world_to_brick_ = grid.world_to_brick;
+    uploaded_ = true;
+    return true;
+}
+
+void BrickTexture::clear() {
+    uploaded_ = false;
+}
+
+void BrickTexture::bind(unsigned int shader_id, int texture_unit, float outside_max) const {
+    const int use_loc = glGetUniformLocation(shader_id, "u_use_bricks");
+    if (use_loc >= 0) {
+        glUniform1i(use_loc, uploaded_ ? 1 : 0);
+    }
+    if (!uploaded_) {
+        return;
+    }
+
+    bound_texture_unit_ = texture_unit;
+    glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(texture_unit));
+    glBindTexture(GL_TEXTURE_3D, texture_3d_);
+
+    const int sampler_loc = glGetUniformLocation(shader_id, "u_brick_max");
+    if (sampler_loc >= 0) {
+        glUniform1i(sampler_loc, texture_unit);
+    }
+    const int dims_loc = glGetUniformLocation(shader_id, "u_brick_dims");
+    if (dims_loc >= 0) {
+        glUniform3i(dims_loc, dims_.x(), dims_.y(), dims_.z());
+    }
+    const int origin_loc = glGetUniformLocation(shader_id, "u_brick_origin");
+    if (origin_loc >= 0) {
+        glUniform3f(origin_loc, origin_.x(), origin_.y(), origin_.z());
+    }
+    const int transform_loc = glGetUniformLocation(shader_id, "u_world_to_brick");
+    if (transform_loc >= 0) {
+        glUniformMatrix3fv(transform_loc, 1, GL_FALSE, world_to_brick_.data());
+    }
+    const int outside_loc = glGetUniformLocation(shader_id, "u_brick_outside_max");
+    if (outside_loc >= 0) {
+        glUniform1f(outside_loc, outside_max);
+    }
+}
+
+void BrickTexture::unbind() const {
+    if (!uploaded_) {
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(bound_texture_unit_));
+    glBindTexture(GL_TEXTURE_3D, 0);
+}
+
+bool BrickTexture::is_uploaded() const {
+    return uploaded_;
+}
+
+}  // namespace sbox::render
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "core/basis_set.h"
+
+#include <Eigen/Core>
+
+#include <vector>
+
+namespace sbox::render {
+
+inline constexpr int kVoxelsPerBrick = 8;
+inline constexpr int kOrbitalBricksPerAxis = 32;
+
+// Coarse grid of upper bounds on |value| used by the ray marchers to skip empty space. Brick space
+// is the world mapped so that every brick is a unit cube starting at the brick-space origin.
+struct BrickGrid {
+    Eigen::Vector3i dims = Eigen::Vector3i::Zero();
+    Eigen::Vector3f origin = Eigen::Vector3f::Zero();
+    Eigen::Matrix3f world_to_brick = Eigen::Matrix3f::Identity();
+    std::vector<float> max_abs;  // x fastest, then y, then z
+
+    bool empty() const;
+    float at(int x, int y, int z) const;
+    // Bound for the brick containing world_pos; `outside` for positions past the grid.
+    float bound_at(const Eigen::Vector3f& world_pos, float outside) const;
+};
+
+// Max |value| per brick of a volume stored in cube order (z fastest). Each brick also covers the one-voxel apron that
+// trilinear filtering reaches into, so the bound holds for every texture lookup inside the brick.
+BrickGrid build_volume_bricks(const float* data,
+                              int nx,
+                              int ny,
+                              int nz,
+                              const Eigen::Vector3f& origin,
+                              const Eigen::Matrix3f& world_to_grid,
+                              int voxels_per_brick = kVoxelsPerBrick);
+
+// Bound on |psi| of one MO over a cube of side 2 * bound_radius centred on the origin, from each
+// shell's radial extent: |angular part| <= r^L for every real solid harmonic and Cartesian
+// monomial up to f, and r^L exp(-alpha r^2) peaks at r = sqrt(L / (2 alpha)).
+BrickGrid build_orbital_bricks(const sbox::basis::MOData& mo_data,
+                               int mo_index,
+                               float bound_radius,
+                               int bricks_per_axis = kOrbitalBricksPerAxis);
+
+// R32F 3D texture holding a BrickGrid, sampled with texelFetch.
+class BrickTexture {
+public:
+    BrickTexture() = default;
+    ~BrickTexture();
+
+    BrickTexture(const BrickTexture&) = delete;
+    BrickTexture& operator=(const BrickTexture&) = delete;
+
+    bool upload(const BrickGrid& grid);
+    void clear();
+    // Sets the u_brick_* uniforms; with nothing uploaded the shader is told to march every step.
+    void bind(unsigned int shader_id, int texture_unit = 10, float outside_max = 0.0f) const;
+    void unbind() const;
+
+    bool is_uploaded() const;
+
+private:
+    unsigned int texture_3d_ = 0;
+    Eigen::Vector3i dims_ = Eigen::Vector3i::Zero();
+    Eigen::Vector3f origin_ = Eigen::Vector3f::Zero();
+    Eigen::Matrix3f world_to_brick_ = Eigen::Matrix3f::Identity();
+    bool uploaded_ = false;
+
+    mutable int bound_texture_unit_ = 10;
+};
+
+}  // namespace sbox::render
@@ -81,9 +81,34 @@ Eigen::Matrix4f Camera::viewMatrix() const {
     return LookAt(eye, target_, up);
 }
 
+void Camera::setProjectionTile(int image_width, int image_height, int x, int y, int width, int height) {
+    tile_image_size_ = Eigen::Vector2f(static_cast<float>(std::max(image_width, 1)), static_cast<float>(std::max(image_height, 1)));
+    const Eigen::Vector2f tile_min(static_cast<float>(x), static_cast<float>(y));
+    const Eigen::Vector2f tile_size(static_cast<float>(std::max(width, 1)), static_cast<float>(std::max(height, 1)));
+    tile_ndc_min_ = 2.0f * tile_min.cwiseQuotient(tile_image_size_) - Eigen::Vector2f::Ones();
+    tile_ndc_max_ = 2.0f * (tile_min + tile_size).cwiseQuotient(tile_image_size_) - Eigen::Vector2f::Ones();
+    tile_active_ = true;
+}
+
+void Camera::clearProjectionTile() {
+    tile_active_ = false;
+}
+
 Eigen::Matrix4f Camera::projectionMatrix() const {
-    const float aspect = viewport_width_ / viewport_height_;
-    return Perspective(45.0f * kPi / 180.0f, aspect, 0.1f, 1000.0f);
+    if (!tile_active_) {
+        const float aspect = viewport_width_ / viewport_height_;
+        return Perspective(45.0f * kPi / 180.0f, aspect, 0.1f, 1000.0f);
+    }
+
+    // Scale and shift clip space so the tile's NDC window fills [-1, 1].
+    const Eigen::Vector2f extent = tile_ndc_max_ - tile_ndc_min_;
+    Eigen::Matrix4f crop = Eigen::Matrix4f::Identity();
+    crop(0, 0) = 2.0f / extent.x();
+    crop(1, 1) = 2.0f / extent.y();
+    crop(0, 3) = -(tile_ndc_max_.x() + tile_ndc_min_.x()) / extent.x();
+    crop(1, 3) = -(tile_ndc_max_.y() + tile_ndc_min_.y()) / extent.y();
+    const float aspect = tile_image_size_.x() / tile_image_size_.y();
+    return crop * Perspective(45.0f * kPi / 180.0f, aspect, 0.1f, 1000.0f);
 }
 
 Eigen::Matrix4f Camera::inverseViewProjection() const {
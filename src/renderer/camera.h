@@ -16,6 +16,11 @@ public:
     void setTarget(const Eigen::Vector3f& target);
     void setDistance(float distance);
     void setOrientation(const Eigen::Quaternionf& orientation);
+    // Narrows the projection to the pixel window [x, x + width) x [y, y + height) of an
+    // image_width x image_height image (y from the bottom), for rendering that image in tiles. The
+    // aspect ratio follows the full image rather than the viewport until clearProjectionTile().
+    void setProjectionTile(int image_width, int image_height, int x, int y, int width, int height);
+    void clearProjectionTile();
 
     [[nodiscard]] Eigen::Matrix4f viewMatrix() const;
     [[nodiscard]] Eigen::Matrix4f projectionMatrix() const;
@@ -39,6 +44,11 @@ private:
     float distance_;
     float viewport_width_;
     float viewport_height_;
+
+    bool tile_active_ = false;
+    Eigen::Vector2f tile_image_size_ = Eigen::Vector2f::Ones();
+    Eigen::Vector2f tile_ndc_min_ = -Eigen::Vector2f::Ones();
+    Eigen::Vector2f tile_ndc_max_ = Eigen::Vector2f::Ones();
 };
 
 }  // namespace sbox
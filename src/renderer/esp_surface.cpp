@@ -38,7 +38,8 @@ void configure_3d_texture(unsigned int tex, int nx, int ny, int nz, const float*
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_BORDER);
     const float border[4] = {0.0f, 0.0f, 0.0f, 0.0f};
     glTexParameterfv(GL_TEXTURE_3D, GL_TEXTURE_BORDER_COLOR, border);
-    glTexImage3D(GL_TEXTURE_3D, 0, GL_R32F, nx, ny, nz, 0, GL_RED, GL_FLOAT, data);
+    // Cube data is z-fastest, so the texture's s axis is the grid's z axis; shaders sample with uvw.zyx.
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_R32F, nz, ny, nx, 0, GL_RED, GL_FLOAT, data);
     glBindTexture(GL_TEXTURE_3D, 0);
 }
 
@@ -0,0 +1,99 @@
+#include "renderer/frame_writer_queue.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace sbox::render {
+
+FrameWriterQueue::~FrameWriterQueue() {
+    finish();
+}
+
+void FrameWriterQueue::start(WriteFn write) {
+    finish();
+    write_ = std::move(write);
+    frames_written_ = 0;
+    write_failed_ = false;
+    stop_writer_ = false;
+    writer_ = std::thread(&FrameWriterQueue::writer_loop, this);
+}
+
+bool FrameWriterQueue::push(const unsigned char* data, std::size_t row_bytes, int rows, bool bottom_up) {
+    if (!writer_.joinable() || data == nullptr) {
+        return false;
+    }
+
+    std::vector<unsigned char> frame;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        frame_taken_.wait(lock, [this] { return queued_.size() < kMaxQueuedFrames || write_failed_; });
+        if (write_failed_) {
+            return false;
+        }
+        if (!free_buffers_.empty()) {
+            frame = std::move(free_buffers_.back());
+            free_buffers_.pop_back();
+        }
+    }
+
+    frame.resize(row_bytes * static_cast<std::size_t>(rows));
+    if (bottom_up) {
+        for (int y = 0; y < rows; ++y) {
+            const unsigned char* row = data + static_cast<std::size_t>(rows - 1 - y) * row_bytes;
+            std::copy(row, row + row_bytes, frame.data() + static_cast<std::size_t>(y) * row_bytes);
+        }
+    } else {
+        std::copy(data, data + frame.size(), frame.data());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_.push_back(std::move(frame));
+    }
+    frame_queued_.notify_one();
+    return true;
+}
+
+void FrameWriterQueue::writer_loop() {
+    for (;;) {
+        std::vector<unsigned char> frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            frame_queued_.wait(lock, [this] { return stop_writer_ || !queued_.empty(); });
+            if (queued_.empty()) {
+                return;
+            }
+            frame = std::move(queued_.front());
+            queued_.pop_front();
+        }
+        frame_taken_.notify_one();
+
+        // After a failed write the remaining frames are only drained, so finish() cannot hang.
+        const bool ok = !write_failed_ && write_(frame);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (ok) {
+                ++frames_written_;
+            } else {
+                write_failed_ = true;
+            }
+            free_buffers_.push_back(std::move(frame));
+        }
+        frame_taken_.notify_one();
+    }
+}
+
+bool FrameWriterQueue::finish() {
+    if (writer_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_writer_ = true;
+        }
+        frame_queued_.notify_one();
+        writer_.join();
+    }
+    free_buffers_.clear();
+    return !write_failed_;
+}
+
+}  // namespace sbox::render
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sbox::render {
+
+// Hands frames to a writer thread in the order they were pushed. push() copies the frame and returns;
+// it blocks only while kMaxQueuedFrames frames are already waiting. Buffers are recycled, so a steady
+// stream of equally sized frames stops allocating.
+class FrameWriterQueue {
+public:
+    // Writes one frame; returning false fails the queue.
+    using WriteFn = std::function<bool(const std::vector<unsigned char>& frame)>;
+
+    static constexpr std::size_t kMaxQueuedFrames = 4;
+
+    FrameWriterQueue() = default;
+    ~FrameWriterQueue();
+
+    FrameWriterQueue(const FrameWriterQueue&) = delete;
+    FrameWriterQueue& operator=(const FrameWriterQueue&) = delete;
+
+    void start(WriteFn write);
+    // Queues `rows` rows of `row_bytes` bytes each. `bottom_up` frames (row 0 at the bottom, as
+    // glReadPixels returns them) are flipped during the copy. Returns false once a write failed.
+    bool push(const unsigned char* data, std::size_t row_bytes, int rows, bool bottom_up = false);
+    // Waits until every queued frame was written, then stops the writer thread. Frames queued after a
+    // failed write are dropped rather than written. Returns false when any write failed.
+    bool finish();
+
+    int frames_written() const { return frames_written_.load(); }
+    bool failed() const { return write_failed_.load(); }
+
+private:
+    void writer_loop();
+
+    WriteFn write_;
+    std::atomic<int> frames_written_{0};
+    std::atomic<bool> write_failed_{false};
+
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable frame_queued_;
+    std::condition_variable frame_taken_;
+    std::deque<std::vector<unsigned char>> queued_;
+    std::vector<std::vector<unsigned char>> free_buffers_;
+    bool stop_writer_ = false;
+};
+
+}  // namespace sbox::render
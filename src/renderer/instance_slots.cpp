@@ -0,0 +1,133 @@
+#include "renderer/instance_slots.h"
+
+#include <algorithm>
+
+namespace sbox::render {
+
+InstanceSlots::InstanceSlots(std::size_t floats_per_slot)
+    : floats_per_slot_(floats_per_slot) {}
+
+void InstanceSlots::clear() {
+    data_.clear();
+    free_.clear();
+    dirty_.clear();
+}
+
+void InstanceSlots::reserve(std::size_t slots) {
+    data_.reserve(slots * floats_per_slot_);
+}
+
+int InstanceSlots::take() {
+    if (!free_.empty()) {
+        const int reused = free_.back();
+        free_.pop_back();
+        return reused;
+    }
+    data_.resize(data_.size() + floats_per_slot_, 0.0f);
+    return slot_count() - 1;
+}
+
+void InstanceSlots::release(int slot) {
+    float* first = this->slot(slot);
+    std::fill(first, first + floats_per_slot_, 0.0f);
+    free_.push_back(slot);
+    dirty_.push_back(slot);
+}
+
+float* InstanceSlots::slot(int slot) {
+    return data_.data() + static_cast<std::size_t>(slot) * floats_per_slot_;
+}
+
+const float* InstanceSlots::slot(int slot) const {
+    return data_.data() + static_cast<std::size_t>(slot) * floats_per_slot_;
+}
+
+void InstanceSlots::mark_dirty(int slot) {
+    dirty_.push_back(slot);
+}
+
+InstanceSlots::Edit InstanceSlots::find_edit(std::size_t old_count, std::size_t new_count, const SameItem& same) {
+    const std::size_t shared = std::min(old_count, new_count);
+    Edit edit;
+    while (edit.prefix < shared && same(edit.prefix, edit.prefix)) {
+        ++edit.prefix;
+    }
+    std::size_t suffix = 0;
+    while (suffix < shared - edit.prefix && same(old_count - 1 - suffix, new_count - 1 - suffix)) {
+        ++suffix;
+    }
+    edit.old_run = old_count - edit.prefix - suffix;
+    edit.new_run = new_count - edit.prefix - suffix;
+    return edit;
+}
+
+void InstanceSlots::apply_edit(const Edit& edit,
+                               std::vector<int>& item_slots,
+                               const SameItem& same,
+                               std::vector<std::size_t>& stale) {
+    // The start of the run is rewritten in place; only its longer tail is removed or inserted.
+    const std::size_t common = std::min(edit.old_run, edit.new_run);
+    for (std::size_t i = edit.prefix; i < edit.prefix + common; ++i) {
+        if (!same(i, i)) {
+            stale.push_back(i);
+        }
+    }
+    const auto tail = item_slots.begin() + static_cast<std::ptrdiff_t>(edit.prefix + common);
+    if (edit.old_run > common) {
+        const auto last = item_slots.begin() + static_cast<std::ptrdiff_t>(edit.prefix + edit.old_run);
+        for (auto it = tail; it != last; ++it) {
+            release(*it);
+        }
+        item_slots.erase(tail, last);
+    } else if (edit.new_run > common) {
+        std::vector<int> added(edit.new_run - common);
+        for (std::size_t k = 0; k < added.size(); ++k) {
+            added[k] = take();
+            stale.push_back(edit.prefix + common + k);
+        }
+        item_slots.insert(tail, added.begin(), added.end());
+    }
+}
+
+std::size_t InstanceSlots::floats_per_slot() const {
+    return floats_per_slot_;
+}
+
+int InstanceSlots::slot_count() const {
+    return static_cast<int>(data_.size() / floats_per_slot_);
+}
+
+std::size_t InstanceSlots::free_count() const {
+    return free_.size();
+}
+
+std::vector<float>& InstanceSlots::data() {
+    return data_;
+}
+
+const std::vector<float>& InstanceSlots::data() const {
+    return data_;
+}
+
+std::vector<InstanceSlots::Run> InstanceSlots::take_dirty_runs(int merge_gap) {
+    std::vector<Run> runs;
+    std::sort(dirty_.begin(), dirty_.end());
+    dirty_.erase(std::unique(dirty_.begin(), dirty_.end()), dirty_.end());
+    std::size_t i = 0;
+    while (i < dirty_.size()) {
+        const int begin = dirty_[i];
+        int end = begin + 1;
+        for (++i; i < dirty_.size() && dirty_[i] - end <= merge_gap; ++i) {
+            end = dirty_[i] + 1;
+        }
+        runs.push_back({static_cast<std::size_t>(begin), static_cast<std::size_t>(end - begin)});
+    }
+    dirty_.clear();
+    return runs;
+}
+
+void InstanceSlots::clear_dirty() {
+    dirty_.clear();
+}
+
+}  // namespace sbox::render
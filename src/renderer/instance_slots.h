@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace sbox::render {
+
+// CPU copy of an instance buffer whose slots stay put across edits, so the GL buffer can be patched
+// in place. Released slots are zeroed, which draws nothing, and handed out again by later take()
+// calls. Every slot written or released is recorded as dirty until take_dirty_runs().
+class InstanceSlots {
+public:
+    // A range of slots to re-send: [first, first + count).
+    struct Run {
+        std::size_t first = 0;
+        std::size_t count = 0;
+    };
+
+    // An edit of an item list: items [prefix, prefix + old_run) of the old list became items
+    // [prefix, prefix + new_run) of the new one, and the items before and after are unchanged.
+    struct Edit {
+        std::size_t prefix = 0;
+        std::size_t old_run = 0;
+        std::size_t new_run = 0;
+    };
+    // Whether the slot of old item `old_index` already holds new item `new_index`.
+    using SameItem = std::function<bool(std::size_t old_index, std::size_t new_index)>;
+
+    // The run between the longest unchanged prefix and suffix; appends, removals and moves all leave
+    // most of a structure in place.
+    static Edit find_edit(std::size_t old_count, std::size_t new_count, const SameItem& same);
+
+    explicit InstanceSlots(std::size_t floats_per_slot);
+
+    // Drops every slot, free or live.
+    void clear();
+    void reserve(std::size_t slots);
+
+    // Reuses the most recently released slot, or appends a zeroed one.
+    int take();
+    void release(int slot);
+    // The slot's floats; mark_dirty() after writing through the non-const overload.
+    float* slot(int slot);
+    const float* slot(int slot) const;
+    void mark_dirty(int slot);
+    // Carries `item_slots`, the slot of every old item in order, over to the new list: removed items
+    // release their slots, inserted items take free or new ones and all others keep theirs. Appends
+    // the new-list index of every item whose slot has to be written to `stale`.
+    void apply_edit(const Edit& edit, std::vector<int>& item_slots, const SameItem& same, std::vector<std::size_t>& stale);
+
+    std::size_t floats_per_slot() const;
+    int slot_count() const;
+    std::size_t free_count() const;
+    std::vector<float>& data();
+    const std::vector<float>& data() const;
+
+    // Dirty slots in ascending order, grouped into runs. Runs separated by at most `merge_gap` clean
+    // slots are joined, since re-sending a few clean slots is cheaper than another buffer call.
+    // Clears the dirty list.
+    std::vector<Run> take_dirty_runs(int merge_gap);
+    void clear_dirty();
+
+private:
+    std::size_t floats_per_slot_;
+    std::vector<float> data_;
+    std::vector<int> free_;
+    std::vector<int> dirty_;
+};
+
+}  // namespace sbox::render
@@ -1,82 +1,46 @@
 #pragma once
 
 #include "core/molecular_system.h"
-#include "io/pdb_io.h"
 #include "renderer/mol_renderer.h"
-#include "renderer/shader.h"
 
 #include <Eigen/Core>
 
 #include <cstdint>
-#include <memory>
-#include <unordered_map>
 #include <vector>
 
 namespace sbox::render {
 
-class SpatialHash {
-public:
-    explicit SpatialHash(float cell_size = 10.0f);
-
-    void build(const sbox::chem::MolecularSystem& mol);
-    void clear();
-
-    std::vector<int> query_sphere(const Eigen::Vector3f& center, float radius) const;
-    std::vector<int> query_frustum(const Eigen::Matrix4f& vp_matrix) const;
-
-    int count() const;
-
-private:
-    struct Cell {
-        std::vector<int> atom_indices;
-        int ix = 0;
-        int iy = 0;
-        int iz = 0;
-    };
-
-    float cell_size_;
-    std::unordered_map<int64_t, Cell> cells_;
-    std::vector<Eigen::Vector3f> positions_;
-
-    int64_t hash_position(float x, float y, float z) const;
-};
-
+// Draws large structures as impostors near the camera and points further out. It keeps no instance
+// data of its own: both sets are drawn from a MolRenderer holding the molecule, so whatever the
+// MolRenderer was last given, including edits and drags, shows up here unchanged.
 class LODRenderer {
 public:
-    LODRenderer();
-    ~LODRenderer();
-
-    void rebuild(const sbox::chem::MolecularSystem& mol,
-                 ColorMode color_mode = ColorMode::CPK,
-                 const sbox::io::PDBData* pdb_data = nullptr,
-                 const std::vector<double>* charges = nullptr);
+    // Atoms are culled by centre; this keeps the largest impostor at the frustum edge from popping.
+    static constexpr float kCullMargin = 3.0f;
 
+    // `visible_atoms` are the atoms inside the view frustum grown by kCullMargin, in any order; the
+    // caller answers that query from whatever spatial index it keeps. `instances` must hold `mol`.
     void render(const Eigen::Matrix4f& view_matrix,
                 const Eigen::Matrix4f& proj_matrix,
                 const Eigen::Vector3f& camera_pos,
                 MolRenderMode mode,
                 const sbox::chem::MolecularSystem& mol,
-                ColorMode color_mode = ColorMode::CPK,
-                const sbox::io::PDBData* pdb_data = nullptr,
-                const std::vector<double>* charges = nullptr);
+                const std::vector<std::uint32_t>& visible_atoms,
+                MolRenderer& instances);
 
     int atoms_rendered() const;
     int atoms_culled() const;
     int bonds_rendered() const;
 
 private:
-    SpatialHash spatial_hash_;
-    MolRenderer full_renderer_;
-    unsigned int point_vao_ = 0;
-    unsigned int point_vbo_ = 0;
-    std::unique_ptr<sbox::Shader> point_shader_;
+    std::vector<std::uint8_t> near_flags_;
+    std::vector<std::uint32_t> near_atoms_;
+    std::vector<std::uint32_t> near_bonds_;
+    std::vector<std::uint32_t> far_atoms_;
 
     int atoms_rendered_ = 0;
     int atoms_culled_ = 0;
     int bonds_rendered_ = 0;
-    ColorMode color_mode_ = ColorMode::CPK;
-    const sbox::io::PDBData* pdb_data_ = nullptr;
-    const std::vector<double>* charges_ = nullptr;
 };
 
 }  // namespace sbox::render
@@ -5,6 +5,7 @@
 
 #include <glad/gl.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdio>
@@ -113,6 +114,8 @@ float vdw_radius(int Z) {
     }
 }
 
+constexpr std::size_t kAtomFloats = 8;
+constexpr std::size_t kBondFloats = 13;
 constexpr float kBondRadiusBallAndStick = 0.15f;
 constexpr float kBondRadiusStickOnly = 0.08f;
 float g_atom_radius_scale = 1.0f;
@@ -173,6 +176,68 @@ void create_quad_buffer(unsigned int* vao,
     glBindVertexArray(0);
 }
 
+// Atom instances: position + radius, color + Z (8 floats).
+void set_atom_instance_attributes(unsigned int vao, unsigned int instance_buffer) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), nullptr);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2,
+                          4,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          8 * sizeof(float),
+                          reinterpret_cast<void*>(4 * sizeof(float)));
+    glVertexAttribDivisor(2, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+// Bond instances: both endpoints, both colors and the radius (13 floats).
+void set_bond_instance_attributes(unsigned int vao, unsigned int instance_buffer) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 13 * sizeof(float), nullptr);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2,
+                          3,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          13 * sizeof(float),
+                          reinterpret_cast<void*>(3 * sizeof(float)));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3,
+                          3,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          13 * sizeof(float),
+                          reinterpret_cast<void*>(6 * sizeof(float)));
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4,
+                          3,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          13 * sizeof(float),
+                          reinterpret_cast<void*>(9 * sizeof(float)));
+    glVertexAttribDivisor(4, 1);
+    glEnableVertexAttribArray(5);
+    glVertexAttribPointer(5,
+                          1,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          13 * sizeof(float),
+                          reinterpret_cast<void*>(12 * sizeof(float)));
+    glVertexAttribDivisor(5, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
 void upload_atom_instances(unsigned int buffer, const std::vector<float>& data) {
     glBindBuffer(GL_ARRAY_BUFFER, buffer);
     glBufferData(GL_ARRAY_BUFFER,
@@ -191,6 +256,114 @@ void upload_bond_instances(unsigned int buffer, const std::vector<float>& data)
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+// Writes each run of dirty slots with one glBufferSubData call.
+void patch_instance_slots(unsigned int buffer, InstanceSlots& slots) {
+    constexpr int kMergeGap = 16;
+    const std::vector<InstanceSlots::Run> runs = slots.take_dirty_runs(kMergeGap);
+    if (runs.empty()) {
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    const std::size_t floats_per_slot = slots.floats_per_slot();
+    for (const InstanceSlots::Run& run : runs) {
+        const std::size_t offset = run.first * floats_per_slot;
+        glBufferSubData(GL_ARRAY_BUFFER,
+                        static_cast<GLintptr>(offset * sizeof(float)),
+                        static_cast<GLsizeiptr>(run.count * floats_per_slot * sizeof(float)),
+                        slots.data().data() + offset);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Makes the GL buffer hold the slots. When they outgrew the buffer, or rewrite_all is set, the whole
+// buffer is written (reallocated with headroom if needed); otherwise only the dirty slots are patched.
+void sync_instance_buffer(unsigned int buffer, std::size_t& capacity_slots, InstanceSlots& slots, bool rewrite_all) {
+    const std::size_t count = static_cast<std::size_t>(slots.slot_count());
+    if (count > capacity_slots) {
+        capacity_slots = std::max(count, capacity_slots * 2);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER,
+                     static_cast<GLsizeiptr>(capacity_slots * slots.floats_per_slot() * sizeof(float)),
+                     nullptr,
+                     GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        rewrite_all = true;
+    }
+    if (rewrite_all) {
+        slots.clear_dirty();
+        const std::vector<float>& data = slots.data();
+        if (!data.empty()) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(data.size() * sizeof(float)), data.data());
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        return;
+    }
+    patch_instance_slots(buffer, slots);
+}
+
+float atom_radius_for_mode(int Z, int atom_mode) {
+    return atom_mode == 1 ? vdw_radius(Z) : atom_render_radius(Z);
+}
+
+float bond_radius_for_mode(int bond_mode) {
+    return bond_mode == 1 ? kBondRadiusStickOnly : kBondRadiusBallAndStick;
+}
+
+// Quad corners plus one instance index per instance, read with glVertexAttribIPointer.
+void create_index_vao(unsigned int* vao, unsigned int* index_buffer, unsigned int quad_buffer) {
+    glGenVertexArrays(1, vao);
+    glGenBuffers(1, index_buffer);
+
+    glBindVertexArray(*vao);
+    glBindBuffer(GL_ARRAY_BUFFER, quad_buffer);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+    glBindBuffer(GL_ARRAY_BUFFER, *index_buffer);
+    glEnableVertexAttribArray(1);
+    glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, sizeof(std::uint32_t), nullptr);
+    glVertexAttribDivisor(1, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+// Atom instances as point vertices: position, then color + Z, which the point shader sizes by. The
+// element buffer binding is VAO state and holds the slots of the current draw.
+void create_point_vao(unsigned int* vao, unsigned int* element_buffer, unsigned int instance_buffer) {
+    glGenVertexArrays(1, vao);
+    glGenBuffers(1, element_buffer);
+
+    glBindVertexArray(*vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), nullptr);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), reinterpret_cast<void*>(4 * sizeof(float)));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *element_buffer);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+// Buffer texture over an existing instance buffer; it follows the buffer across reallocations.
+unsigned int create_instance_texture(unsigned int buffer, GLenum internal_format) {
+    unsigned int texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, internal_format, buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    return texture;
+}
+
+void upload_instance_indices(unsigned int buffer, const std::vector<std::uint32_t>& indices) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(indices.size() * sizeof(std::uint32_t)),
+                 indices.empty() ? nullptr : indices.data(),
+                 GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 }  // namespace
 
 Eigen::Vector3f chain_color(int chain_index) {
@@ -203,6 +376,19 @@ Eigen::Vector3f chain_color(int chain_index) {
     return palette[static_cast<std::size_t>(idx)];
 }
 
+int pdb_chain_index(const sbox::io::PDBData& pdb, std::size_t atom_index) {
+    if (pdb.has_atom_lookups()) {
+        return pdb.atom_chain_index[atom_index];
+    }
+    const std::string& chain_id = pdb.atoms[atom_index].chain_id;
+    for (std::size_t i = 0; i < pdb.chains.size(); ++i) {
+        if (pdb.chains[i].id == chain_id) {
+            return static_cast<int>(i);
+        }
+    }
+    return 0;
+}
+
 Eigen::Vector3f residue_color(const std::string& residue_name) {
     const std::string res = residue_name;
     if (res == "ALA") return {0.78f, 0.78f, 0.78f};
@@ -229,6 +415,15 @@ Eigen::Vector3f residue_color(const std::string& residue_name) {
     return {0.5f, 0.5f, 0.5f};
 }
 
+std::vector<Eigen::Vector3f> residue_colors(const std::vector<std::string>& residue_names) {
+    std::vector<Eigen::Vector3f> colors;
+    colors.reserve(residue_names.size());
+    for (const std::string& name : residue_names) {
+        colors.push_back(residue_color(name));
+    }
+    return colors;
+}
+
 Eigen::Vector3f bfactor_color(float b_factor, float b_min, float b_max) {
     const float denom = std::max(1.0e-6f, b_max - b_min);
     const float t = std::clamp((b_factor - b_min) / denom, 0.0f, 1.0f);
@@ -246,7 +441,9 @@ void set_bond_radius_scale(float scale) {
     g_bond_radius_scale = std::max(0.05f, scale);
 }
 
-MolRenderer::MolRenderer() {
+MolRenderer::MolRenderer()
+    : atom_instances_(kAtomFloats),
+      bond_instances_(kBondFloats) {
     atom_shader_ = std::make_unique<sbox::Shader>(sbox::get_shader_path("atom_impostor.vert"),
                                                   sbox::get_shader_path("atom_impostor.frag"));
     bond_shader_ = std::make_unique<sbox::Shader>(sbox::get_shader_path("bond_impostor.vert"),
@@ -255,6 +452,12 @@ MolRenderer::MolRenderer() {
                                                           sbox::get_shader_path("gbuffer_atom.frag"));
     gbuffer_bond_shader_ = std::make_unique<sbox::Shader>(sbox::get_shader_path("gbuffer_bond.vert"),
                                                           sbox::get_shader_path("gbuffer_bond.frag"));
+    atom_indexed_shader_ = std::make_unique<sbox::Shader>(sbox::get_shader_path("atom_impostor_indexed.vert"),
+                                                          sbox::get_shader_path("atom_impostor.frag"));
+    bond_indexed_shader_ = std::make_unique<sbox::Shader>(sbox::get_shader_path("bond_impostor_indexed.vert"),
+                                                          sbox::get_shader_path("bond_impostor.frag"));
+    point_shader_ = std::make_unique<sbox::Shader>(sbox::get_shader_path("atom_point.vert"),
+                                                   sbox::get_shader_path("atom_point.frag"));
 
     constexpr std::array<float, 12> quad_vertices = {
         -1.0f, -1.0f,
@@ -268,64 +471,37 @@ MolRenderer::MolRenderer() {
     create_quad_buffer(&atom_vao_, &atom_vbo_, &atom_instance_vbo_, quad_vertices);
     create_quad_buffer(&bond_vao_, &bond_vbo_, &bond_instance_vbo_, quad_vertices);
 
-    glBindVertexArray(atom_vao_);
-    glBindBuffer(GL_ARRAY_BUFFER, atom_instance_vbo_);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), nullptr);
-    glVertexAttribDivisor(1, 1);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2,
-                          4,
-                          GL_FLOAT,
-                          GL_FALSE,
-                          8 * sizeof(float),
-                          reinterpret_cast<void*>(4 * sizeof(float)));
-    glVertexAttribDivisor(2, 1);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
-    glBindVertexArray(bond_vao_);
-    glBindBuffer(GL_ARRAY_BUFFER, bond_instance_vbo_);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 13 * sizeof(float), nullptr);
-    glVertexAttribDivisor(1, 1);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2,
-                          3,
-                          GL_FLOAT,
-                          GL_FALSE,
-                          13 * sizeof(float),
-                          reinterpret_cast<void*>(3 * sizeof(float)));
-    glVertexAttribDivisor(2, 1);
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3,
-                          3,
-                          GL_FLOAT,
-                          GL_FALSE,
-                          13 * sizeof(float),
-                          reinterpret_cast<void*>(6 * sizeof(float)));
-    glVertexAttribDivisor(3, 1);
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4,
-                          3,
-                          GL_FLOAT,
-                          GL_FALSE,
-                          13 * sizeof(float),
-                          reinterpret_cast<void*>(9 * sizeof(float)));
-    glVertexAttribDivisor(4, 1);
-    glEnableVertexAttribArray(5);
-    glVertexAttribPointer(5,
-                          1,
-                          GL_FLOAT,
-                          GL_FALSE,
-                          13 * sizeof(float),
-                          reinterpret_cast<void*>(12 * sizeof(float)));
-    glVertexAttribDivisor(5, 1);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    set_atom_instance_attributes(atom_vao_, atom_instance_vbo_);
+    set_bond_instance_attributes(bond_vao_, bond_instance_vbo_);
+    create_quad_buffer(&highlight_atom_vao_, &highlight_atom_vbo_, &highlight_atom_instance_vbo_, quad_vertices);
+    create_quad_buffer(&highlight_bond_vao_, &highlight_bond_vbo_, &highlight_bond_instance_vbo_, quad_vertices);
+    set_atom_instance_attributes(highlight_atom_vao_, highlight_atom_instance_vbo_);
+    set_bond_instance_attributes(highlight_bond_vao_, highlight_bond_instance_vbo_);
+
+    create_index_vao(&atom_index_vao_, &atom_index_vbo_, atom_vbo_);
+    create_index_vao(&bond_index_vao_, &bond_index_vbo_, bond_vbo_);
+    atom_instance_tex_ = create_instance_texture(atom_instance_vbo_, GL_RGBA32F);
+    bond_instance_tex_ = create_instance_texture(bond_instance_vbo_, GL_R32F);
+    create_point_vao(&point_vao_, &point_ebo_, atom_instance_vbo_);
 }
 
 MolRenderer::~MolRenderer() {
+    for (unsigned int* texture : {&atom_instance_tex_, &bond_instance_tex_}) {
+        if (*texture != 0) {
+            glDeleteTextures(1, texture);
+        }
+    }
+    for (unsigned int* buffer : {&atom_index_vbo_, &bond_index_vbo_, &point_ebo_, &highlight_atom_vbo_,
+                                 &highlight_atom_instance_vbo_, &highlight_bond_vbo_, &highlight_bond_instance_vbo_}) {
+        if (*buffer != 0) {
+            glDeleteBuffers(1, buffer);
+        }
+    }
+    for (unsigned int* vao : {&atom_index_vao_, &bond_index_vao_, &point_vao_, &highlight_atom_vao_, &highlight_bond_vao_}) {
+        if (*vao != 0) {
+            glDeleteVertexArrays(1, vao);
+        }
+    }
     if (atom_instance_vbo_ != 0) {
         glDeleteBuffers(1, &atom_instance_vbo_);
     }
@@ -347,21 +523,23 @@ MolRenderer::~MolRenderer() {
     }
 }
 
-void MolRenderer::upload(const sbox::chem::MolecularSystem& mol,
-                         ColorMode color_mode,
-                         const sbox::io::PDBData* pdb_data,
-                         const std::vector<double>* charges) {
-    atom_instances_.clear();
-    bond_instances_.clear();
-
-    atom_count_ = mol.num_atoms();
-    bond_count_ = mol.num_bonds();
-
-    const bool has_pdb = pdb_data != nullptr && pdb_data->atoms.size() == mol.atoms().size();
-    float b_min = std::numeric_limits<float>::max();
-    float b_max = std::numeric_limits<float>::lowest();
+void MolRenderer::AtomColoring::prepare(const sbox::chem::MolecularSystem& mol,
+                                        ColorMode color_mode,
+                                        const sbox::io::PDBData* pdb,
+                                        const std::vector<double>* atom_charges,
+                                        std::uint64_t color_revision) {
+    mode = color_mode;
+    revision = color_revision;
+    pdb_data = pdb;
+    charges = atom_charges;
+    has_pdb = pdb != nullptr && pdb->atoms.size() == mol.atoms().size();
+    has_lookups = has_pdb && pdb->has_atom_lookups();
+    residue_palette = has_lookups && mode == ColorMode::ByResidue ? residue_colors(pdb->residue_names)
+                                                                  : std::vector<Eigen::Vector3f>{};
+    b_min = std::numeric_limits<float>::max();
+    b_max = std::numeric_limits<float>::lowest();
     if (has_pdb) {
-        for (const auto& atom : pdb_data->atoms) {
+        for (const auto& atom : pdb->atoms) {
             b_min = std::min(b_min, static_cast<float>(atom.b_factor));
             b_max = std::max(b_max, static_cast<float>(atom.b_factor));
         }
@@ -370,74 +548,241 @@ void MolRenderer::upload(const sbox::chem::MolecularSystem& mol,
             b_max = 1.0f;
         }
     }
-    double max_abs_charge = 0.0;
+    max_abs_charge = 0.0;
     if (charges != nullptr) {
         for (double q : *charges) {
             max_abs_charge = std::max(max_abs_charge, std::abs(q));
         }
     }
+}
+
+Eigen::Vector3f MolRenderer::AtomColoring::color(const sbox::chem::Atom& atom, std::size_t atom_index) const {
+    if (mode == ColorMode::ByChain && has_pdb) {
+        return chain_color(pdb_chain_index(*pdb_data, atom_index));
+    }
+    if (mode == ColorMode::ByResidue && has_pdb) {
+        return has_lookups ? residue_palette[static_cast<std::size_t>(pdb_data->atom_residue_name_id[atom_index])]
+                           : residue_color(pdb_data->atoms[atom_index].residue_name);
+    }
+    if (mode == ColorMode::ByBFactor && has_pdb) {
+        return bfactor_color(static_cast<float>(pdb_data->atoms[atom_index].b_factor), b_min, b_max);
+    }
+    if (mode == ColorMode::ByCharge && charges != nullptr && atom_index < charges->size()) {
+        return charge_color((*charges)[atom_index], max_abs_charge);
+    }
+    if (mode == ColorMode::BySecondary) {
+        return Eigen::Vector3f(0.6f, 0.6f, 0.65f);
+    }
+    return cpk_color_internal(atom.Z);
+}
 
-    atom_instances_.reserve(static_cast<std::size_t>(atom_count_) * 8);
+void MolRenderer::upload(const sbox::chem::MolecularSystem& mol,
+                         ColorMode color_mode,
+                         const sbox::io::PDBData* pdb_data,
+                         const std::vector<double>* charges,
+                         std::uint64_t color_revision) {
+    atom_instances_.clear();
+    bond_instances_.clear();
+    bonds_by_atom_.clear();
+
+    atom_count_ = mol.num_atoms();
+    bond_count_ = mol.num_bonds();
+    coloring_.prepare(mol, color_mode, pdb_data, charges, color_revision);
+    gpu_atom_radius_mode_ = 0;
+    gpu_bond_radius_mode_ = 0;
+    gpu_atom_radius_scale_ = g_atom_radius_scale;
+    gpu_bond_radius_scale_ = g_bond_radius_scale;
+
+    // Slots start out in molecule order; update() keeps them stable from here on.
+    atom_instances_.reserve(static_cast<std::size_t>(atom_count_));
+    atom_slots_.resize(mol.atoms().size());
     for (std::size_t atom_index = 0; atom_index < mol.atoms().size(); ++atom_index) {
         const sbox::chem::Atom& atom = mol.atoms()[atom_index];
-        Eigen::Vector3f color = cpk_color_internal(atom.Z);
-        if (color_mode == ColorMode::ByChain && has_pdb) {
-            int chain_index = 0;
-            const std::string chain_id = pdb_data->atoms[atom_index].chain_id;
-            for (std::size_t i = 0; i < pdb_data->chains.size(); ++i) {
-                if (pdb_data->chains[i].id == chain_id) {
-                    chain_index = static_cast<int>(i);
-                    break;
-                }
+        atom_slots_[atom_index] = atom_instances_.take();
+        write_atom_slot(atom_slots_[atom_index], atom, coloring_.color(atom, atom_index));
+    }
+
+    bond_instances_.reserve(static_cast<std::size_t>(bond_count_));
+    bond_slots_.resize(mol.bonds().size());
+    for (std::size_t bond_index = 0; bond_index < mol.bonds().size(); ++bond_index) {
+        bond_slots_[bond_index] = bond_instances_.take();
+        write_bond_slot(bond_slots_[bond_index], mol.bonds()[bond_index]);
+    }
+
+    // Sized to fit, so a fresh structure does not keep the headroom of an edited one.
+    atom_buffer_slots_ = 0;
+    bond_buffer_slots_ = 0;
+    sync_instance_buffer(atom_instance_vbo_, atom_buffer_slots_, atom_instances_, true);
+    sync_instance_buffer(bond_instance_vbo_, bond_buffer_slots_, bond_instances_, true);
+}
+
+void MolRenderer::update(const sbox::chem::MolecularSystem& mol,
+                         ColorMode color_mode,
+                         const sbox::io::PDBData* pdb_data,
+                         const std::vector<double>* charges,
+                         std::uint64_t color_revision) {
+    const std::size_t old_atoms = atom_slots_.size();
+    const std::size_t new_atoms = mol.atoms().size();
+    const bool has_pdb = pdb_data != nullptr && pdb_data->atoms.size() == new_atoms;
+    // Colors that depend on atom indices or on whole-structure ranges are only reusable while the
+    // atom count holds.
+    const bool index_colored = color_mode == ColorMode::ByCharge || has_pdb;
+    if (gpu_atom_radius_mode_ < 0 || color_mode != coloring_.mode || color_revision != coloring_.revision
+        || pdb_data != coloring_.pdb_data || charges != coloring_.charges || has_pdb != coloring_.has_pdb
+        || (index_colored && old_atoms != new_atoms)) {
+        upload(mol, color_mode, pdb_data, charges, color_revision);
+        return;
+    }
+    if (bonds_by_atom_.built() && !bonds_by_atom_.matches(mol)) {
+        bonds_by_atom_.clear();
+    }
+
+    const std::vector<sbox::chem::Atom>& atoms = mol.atoms();
+    const InstanceSlots::SameItem same_atom = [&](std::size_t old_index, std::size_t new_index) {
+        const float* slot = atom_instances_.slot(atom_slots_[old_index]);
+        const sbox::chem::Atom& atom = atoms[new_index];
+        return slot[0] == static_cast<float>(atom.position.x()) && slot[1] == static_cast<float>(atom.position.y())
+               && slot[2] == static_cast<float>(atom.position.z()) && slot[7] == static_cast<float>(atom.Z);
+    };
+    const InstanceSlots::Edit atom_edit = InstanceSlots::find_edit(old_atoms, new_atoms, same_atom);
+    if (2 * std::max(atom_edit.old_run, atom_edit.new_run) > new_atoms) {
+        upload(mol, color_mode, pdb_data, charges, color_revision);
+        return;
+    }
+    std::vector<std::size_t> stale;
+    atom_instances_.apply_edit(atom_edit, atom_slots_, same_atom, stale);
+    for (const std::size_t atom_index : stale) {
+        write_atom_slot(atom_slots_[atom_index], atoms[atom_index], coloring_.color(atoms[atom_index], atom_index));
+    }
+
+    // Bonds are compared by the instance data they would produce, so bonds to moved or recolored
+    // atoms are rewritten along with them.
+    const std::vector<sbox::chem::Bond>& bonds = mol.bonds();
+    const InstanceSlots::SameItem same_bond = [&](std::size_t old_index, std::size_t new_index) {
+        return bond_slot_matches(bond_slots_[old_index], bonds[new_index]);
+    };
+    const InstanceSlots::Edit bond_edit = InstanceSlots::find_edit(bond_slots_.size(), bonds.size(), same_bond);
+    stale.clear();
+    bond_instances_.apply_edit(bond_edit, bond_slots_, same_bond, stale);
+    for (const std::size_t bond_index : stale) {
+        write_bond_slot(bond_slots_[bond_index], bonds[bond_index]);
+    }
+
+    atom_count_ = mol.num_atoms();
+    bond_count_ = mol.num_bonds();
+    // Compact once free slots outnumber live ones, so draws do not keep paying for deleted atoms.
+    if (atom_instances_.free_count() > atom_slots_.size() || bond_instances_.free_count() > bond_slots_.size()) {
+        upload(mol, color_mode, pdb_data, charges, color_revision);
+        return;
+    }
+    sync_instance_buffer(atom_instance_vbo_, atom_buffer_slots_, atom_instances_, false);
+    sync_instance_buffer(bond_instance_vbo_, bond_buffer_slots_, bond_instances_, false);
+}
+
+void MolRenderer::update_atoms(const sbox::chem::MolecularSystem& mol, const std::vector<int>& moved_atoms) {
+    if (gpu_atom_radius_mode_ < 0 || atom_slots_.size() != mol.atoms().size() || bond_slots_.size() != mol.bonds().size()) {
+        update(mol, coloring_.mode, coloring_.pdb_data, coloring_.charges, coloring_.revision);
+        return;
+    }
+    const sbox::chem::BondsByAtom& adjacency = bonds_by_atom(mol);
+
+    // Moving an atom keeps its color, so only the position floats of its slot change.
+    for (const int atom_index : moved_atoms) {
+        if (atom_index < 0 || static_cast<std::size_t>(atom_index) >= atom_slots_.size()) {
+            continue;
+        }
+        const int slot = atom_slots_[static_cast<std::size_t>(atom_index)];
+        const sbox::chem::Atom& atom = mol.atom(atom_index);
+        float* data = atom_instances_.slot(slot);
+        data[0] = static_cast<float>(atom.position.x());
+        data[1] = static_cast<float>(atom.position.y());
+        data[2] = static_cast<float>(atom.position.z());
+        atom_instances_.mark_dirty(slot);
+    }
+    for (const int atom_index : moved_atoms) {
+        if (atom_index < 0 || static_cast<std::size_t>(atom_index) >= atom_slots_.size()) {
+            continue;
+        }
+        const std::size_t atom = static_cast<std::size_t>(atom_index);
+        for (std::uint32_t k = adjacency.offsets[atom]; k < adjacency.offsets[atom + 1]; ++k) {
+            const std::uint32_t bond_index = adjacency.bonds[k];
+            write_bond_slot(bond_slots_[bond_index], mol.bonds()[bond_index]);
+        }
+    }
+    sync_instance_buffer(atom_instance_vbo_, atom_buffer_slots_, atom_instances_, false);
+    sync_instance_buffer(bond_instance_vbo_, bond_buffer_slots_, bond_instances_, false);
+}
+
+const sbox::chem::BondsByAtom& MolRenderer::bonds_by_atom(const sbox::chem::MolecularSystem& mol) {
+    if (!bonds_by_atom_.built()) {
+        bonds_by_atom_.build(mol);
+    }
+    return bonds_by_atom_;
+}
+
+void MolRenderer::write_atom_slot(int slot, const sbox::chem::Atom& atom, const Eigen::Vector3f& color) {
+    float* data = atom_instances_.slot(slot);
+    data[0] = static_cast<float>(atom.position.x());
+    data[1] = static_cast<float>(atom.position.y());
+    data[2] = static_cast<float>(atom.position.z());
+    data[3] = atom_radius_for_mode(atom.Z, gpu_atom_radius_mode_) * gpu_atom_radius_scale_;
+    data[4] = color.x();
+    data[5] = color.y();
+    data[6] = color.z();
+    data[7] = static_cast<float>(atom.Z);
+    atom_instances_.mark_dirty(slot);
+}
+
+void MolRenderer::bond_instance(const sbox::chem::Bond& bond, float* out) const {
+    const float* atom_a = atom_instances_.slot(atom_slots_[static_cast<std::size_t>(bond.atom_i)]);
+    const float* atom_b = atom_instances_.slot(atom_slots_[static_cast<std::size_t>(bond.atom_j)]);
+    std::copy(atom_a, atom_a + 3, out);
+    std::copy(atom_b, atom_b + 3, out + 3);
+    std::copy(atom_a + 4, atom_a + 7, out + 6);
+    std::copy(atom_b + 4, atom_b + 7, out + 9);
+    out[12] = bond_radius_for_mode(gpu_bond_radius_mode_) * gpu_bond_radius_scale_;
+}
+
+bool MolRenderer::bond_slot_matches(int slot, const sbox::chem::Bond& bond) const {
+    std::array<float, kBondFloats> expected{};
+    bond_instance(bond, expected.data());
+    return std::equal(expected.begin(), expected.end(), bond_instances_.slot(slot));
+}
+
+void MolRenderer::write_bond_slot(int slot, const sbox::chem::Bond& bond) {
+    bond_instance(bond, bond_instances_.slot(slot));
+    bond_instances_.mark_dirty(slot);
+}
+
+void MolRenderer::sync_instance_radii(MolRenderMode mode) {
+    // Radii are rewritten in the mirror, so slots written later by update() already carry them.
+    // Free slots keep their zero radius.
+    const int atom_mode = mode == MolRenderMode::SpaceFilling ? 1 : 0;
+    if (gpu_atom_radius_mode_ != atom_mode || gpu_atom_radius_scale_ != g_atom_radius_scale) {
+        std::vector<float>& atoms = atom_instances_.data();
+        for (std::size_t base = 0; base < atoms.size(); base += kAtomFloats) {
+            if (atoms[base + 3] > 0.0f) {
+                atoms[base + 3] = atom_radius_for_mode(static_cast<int>(atoms[base + 7]), atom_mode) * g_atom_radius_scale;
             }
-            color = chain_color(chain_index);
-        } else if (color_mode == ColorMode::ByResidue && has_pdb) {
-            color = residue_color(pdb_data->atoms[atom_index].residue_name);
-        } else if (color_mode == ColorMode::ByBFactor && has_pdb) {
-            color = bfactor_color(static_cast<float>(pdb_data->atoms[atom_index].b_factor), b_min, b_max);
-        } else if (color_mode == ColorMode::ByCharge && charges != nullptr && atom_index < charges->size()) {
-            color = charge_color((*charges)[atom_index], max_abs_charge);
-        } else if (color_mode == ColorMode::BySecondary) {
-            color = Eigen::Vector3f(0.6f, 0.6f, 0.65f);
         }
-        atom_instances_.push_back(static_cast<float>(atom.position.x()));
-        atom_instances_.push_back(static_cast<float>(atom.position.y()));
-        atom_instances_.push_back(static_cast<float>(atom.position.z()));
-        atom_instances_.push_back(atom_render_radius(atom.Z) * g_atom_radius_scale);
-        atom_instances_.push_back(color.x());
-        atom_instances_.push_back(color.y());
-        atom_instances_.push_back(color.z());
-        atom_instances_.push_back(static_cast<float>(atom.Z));
-    }
-
-    bond_instances_.reserve(static_cast<std::size_t>(bond_count_) * 13);
-    for (const sbox::chem::Bond& bond : mol.bonds()) {
-        const sbox::chem::Atom& atom_a = mol.atom(bond.atom_i);
-        const sbox::chem::Atom& atom_b = mol.atom(bond.atom_j);
-        const Eigen::Vector3f color_a(atom_instances_[static_cast<std::size_t>(bond.atom_i) * 8 + 4],
-                                      atom_instances_[static_cast<std::size_t>(bond.atom_i) * 8 + 5],
-                                      atom_instances_[static_cast<std::size_t>(bond.atom_i) * 8 + 6]);
-        const Eigen::Vector3f color_b(atom_instances_[static_cast<std::size_t>(bond.atom_j) * 8 + 4],
-                                      atom_instances_[static_cast<std::size_t>(bond.atom_j) * 8 + 5],
-                                      atom_instances_[static_cast<std::size_t>(bond.atom_j) * 8 + 6]);
-
-        bond_instances_.push_back(static_cast<float>(atom_a.position.x()));
-        bond_instances_.push_back(static_cast<float>(atom_a.position.y()));
-        bond_instances_.push_back(static_cast<float>(atom_a.position.z()));
-        bond_instances_.push_back(static_cast<float>(atom_b.position.x()));
-        bond_instances_.push_back(static_cast<float>(atom_b.position.y()));
-        bond_instances_.push_back(static_cast<float>(atom_b.position.z()));
-        bond_instances_.push_back(color_a.x());
-        bond_instances_.push_back(color_a.y());
-        bond_instances_.push_back(color_a.z());
-        bond_instances_.push_back(color_b.x());
-        bond_instances_.push_back(color_b.y());
-        bond_instances_.push_back(color_b.z());
-        bond_instances_.push_back(kBondRadiusBallAndStick * g_bond_radius_scale);
-    }
-
-    upload_atom_instances(atom_instance_vbo_, atom_instances_);
-    upload_bond_instances(bond_instance_vbo_, bond_instances_);
+        sync_instance_buffer(atom_instance_vbo_, atom_buffer_slots_, atom_instances_, true);
+        gpu_atom_radius_mode_ = atom_mode;
+        gpu_atom_radius_scale_ = g_atom_radius_scale;
+    }
+
+    const int bond_mode = mode == MolRenderMode::StickOnly ? 1 : 0;
+    if (gpu_bond_radius_mode_ != bond_mode || gpu_bond_radius_scale_ != g_bond_radius_scale) {
+        const float bond_radius = bond_radius_for_mode(bond_mode) * g_bond_radius_scale;
+        std::vector<float>& bonds = bond_instances_.data();
+        for (std::size_t base = 0; base < bonds.size(); base += kBondFloats) {
+            if (bonds[base + 12] > 0.0f) {
+                bonds[base + 12] = bond_radius;
+            }
+        }
+        sync_instance_buffer(bond_instance_vbo_, bond_buffer_slots_, bond_instances_, true);
+        gpu_bond_radius_mode_ = bond_mode;
+        gpu_bond_radius_scale_ = g_bond_radius_scale;
+    }
 }
 
 void MolRenderer::render(const Eigen::Matrix4f& view_matrix,
@@ -453,35 +798,20 @@ void MolRenderer::render(const Eigen::Matrix4f& view_matrix,
     const bool render_atoms = (mode == MolRenderMode::BallAndStick || mode == MolRenderMode::SpaceFilling);
     const bool render_bonds = (mode == MolRenderMode::BallAndStick || mode == MolRenderMode::StickOnly || mode == MolRenderMode::Wireframe);
 
-    if (render_atoms) {
-        std::vector<float> atom_draw_data = atom_instances_;
-        if (mode == MolRenderMode::SpaceFilling) {
-            for (int i = 0; i < atom_count_; ++i) {
-                const std::size_t base = static_cast<std::size_t>(i) * 8;
-                atom_draw_data[base + 3] = vdw_radius(static_cast<int>(atom_draw_data[base + 7])) * g_atom_radius_scale;
-            }
-        }
-
-        upload_atom_instances(atom_instance_vbo_, atom_draw_data);
+    sync_instance_radii(mode);
 
+    if (render_atoms) {
         atom_shader_->bind();
         atom_shader_->setUniform("u_view", view_matrix);
         atom_shader_->setUniform("u_proj", proj_matrix);
         atom_shader_->setUniform("u_camera_pos", camera_pos);
 
         glBindVertexArray(atom_vao_);
-        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, atom_count_);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, atom_instances_.slot_count());
         glBindVertexArray(0);
     }
 
     if (render_bonds && bond_count_ > 0) {
-        std::vector<float> bond_draw_data = bond_instances_;
-        const float bond_radius = ((mode == MolRenderMode::StickOnly) ? kBondRadiusStickOnly : kBondRadiusBallAndStick) * g_bond_radius_scale;
-        for (int i = 0; i < bond_count_; ++i) {
-            bond_draw_data[static_cast<std::size_t>(i) * 13 + 12] = bond_radius;
-        }
-        upload_bond_instances(bond_instance_vbo_, bond_draw_data);
-
         bond_shader_->bind();
         bond_shader_->setUniform("u_view", view_matrix);
         bond_shader_->setUniform("u_proj", proj_matrix);
@@ -491,14 +821,110 @@ void MolRenderer::render(const Eigen::Matrix4f& view_matrix,
         glBindVertexArray(bond_vao_);
         if (mode == MolRenderMode::Wireframe) {
             glLineWidth(1.5f);
-            glDrawArraysInstanced(GL_LINES, 4, 2, bond_count_);
+            glDrawArraysInstanced(GL_LINES, 4, 2, bond_instances_.slot_count());
         } else {
-            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, bond_count_);
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, bond_instances_.slot_count());
         }
         glBindVertexArray(0);
     }
 }
 
+void MolRenderer::render_instances(const Eigen::Matrix4f& view_matrix,
+                                   const Eigen::Matrix4f& proj_matrix,
+                                   const Eigen::Vector3f& camera_pos,
+                                   MolRenderMode mode,
+                                   const std::vector<std::uint32_t>& atom_indices,
+                                   const std::vector<std::uint32_t>& bond_indices) {
+    if (!has_data()) {
+        return;
+    }
+
+    glEnable(GL_DEPTH_TEST);
+
+    const bool render_atoms = (mode == MolRenderMode::BallAndStick || mode == MolRenderMode::SpaceFilling);
+    const bool render_bonds = (mode == MolRenderMode::BallAndStick || mode == MolRenderMode::StickOnly || mode == MolRenderMode::Wireframe);
+
+    sync_instance_radii(mode);
+    glActiveTexture(GL_TEXTURE0);
+
+    if (render_atoms && !atom_indices.empty()) {
+        slot_indices_.clear();
+        for (const std::uint32_t atom_index : atom_indices) {
+            slot_indices_.push_back(static_cast<std::uint32_t>(atom_slots_[atom_index]));
+        }
+        upload_instance_indices(atom_index_vbo_, slot_indices_);
+
+        atom_indexed_shader_->bind();
+        atom_indexed_shader_->setUniform("u_view", view_matrix);
+        atom_indexed_shader_->setUniform("u_proj", proj_matrix);
+        atom_indexed_shader_->setUniform("u_camera_pos", camera_pos);
+        atom_indexed_shader_->setUniform("u_atom_instances", 0);
+        glBindTexture(GL_TEXTURE_BUFFER, atom_instance_tex_);
+
+        glBindVertexArray(atom_index_vao_);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(atom_indices.size()));
+        glBindVertexArray(0);
+    }
+
+    if (render_bonds && !bond_indices.empty()) {
+        slot_indices_.clear();
+        for (const std::uint32_t bond_index : bond_indices) {
+            slot_indices_.push_back(static_cast<std::uint32_t>(bond_slots_[bond_index]));
+        }
+        upload_instance_indices(bond_index_vbo_, slot_indices_);
+
+        bond_indexed_shader_->bind();
+        bond_indexed_shader_->setUniform("u_view", view_matrix);
+        bond_indexed_shader_->setUniform("u_proj", proj_matrix);
+        bond_indexed_shader_->setUniform("u_camera_pos", camera_pos);
+        bond_indexed_shader_->setUniform("u_wireframe", mode == MolRenderMode::Wireframe ? 1 : 0);
+        bond_indexed_shader_->setUniform("u_bond_instances", 0);
+        glBindTexture(GL_TEXTURE_BUFFER, bond_instance_tex_);
+
+        glBindVertexArray(bond_index_vao_);
+        if (mode == MolRenderMode::Wireframe) {
+            glLineWidth(1.5f);
+            glDrawArraysInstanced(GL_LINES, 4, 2, static_cast<GLsizei>(bond_indices.size()));
+        } else {
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(bond_indices.size()));
+        }
+        glBindVertexArray(0);
+    }
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void MolRenderer::render_points(const Eigen::Matrix4f& view_matrix,
+                                const Eigen::Matrix4f& proj_matrix,
+                                const Eigen::Vector3f& camera_pos,
+                                const std::vector<std::uint32_t>& atom_indices) {
+    if (!has_data() || atom_indices.empty()) {
+        return;
+    }
+
+    slot_indices_.clear();
+    for (const std::uint32_t atom_index : atom_indices) {
+        slot_indices_.push_back(static_cast<std::uint32_t>(atom_slots_[atom_index]));
+    }
+
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    point_shader_->bind();
+    point_shader_->setUniform("u_view", view_matrix);
+    point_shader_->setUniform("u_proj", proj_matrix);
+    point_shader_->setUniform("u_camera_pos", camera_pos);
+
+    glBindVertexArray(point_vao_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(slot_indices_.size() * sizeof(std::uint32_t)),
+                 slot_indices_.data(),
+                 GL_STREAM_DRAW);
+    glDrawElements(GL_POINTS, static_cast<GLsizei>(slot_indices_.size()), GL_UNSIGNED_INT, nullptr);
+    glBindVertexArray(0);
+}
+
 void MolRenderer::render_gbuffer(const Eigen::Matrix4f& view_matrix,
                                  const Eigen::Matrix4f& proj_matrix,
                                  const Eigen::Vector3f& camera_pos,
@@ -512,47 +938,29 @@ void MolRenderer::render_gbuffer(const Eigen::Matrix4f& view_matrix,
     const bool render_atoms = (mode == MolRenderMode::BallAndStick || mode == MolRenderMode::SpaceFilling);
     const bool render_bonds = (mode == MolRenderMode::BallAndStick || mode == MolRenderMode::StickOnly);
 
-    if (render_atoms) {
-        std::vector<float> atom_draw_data = atom_instances_;
-        if (mode == MolRenderMode::SpaceFilling) {
-            for (int i = 0; i < atom_count_; ++i) {
-                const std::size_t base = static_cast<std::size_t>(i) * 8;
-                atom_draw_data[base + 3] = vdw_radius(static_cast<int>(atom_draw_data[base + 7])) * g_atom_radius_scale;
-            }
-        }
-
-        upload_atom_instances(atom_instance_vbo_, atom_draw_data);
+    sync_instance_radii(mode);
 
+    if (render_atoms) {
         gbuffer_atom_shader_->bind();
         gbuffer_atom_shader_->setUniform("u_view", view_matrix);
         gbuffer_atom_shader_->setUniform("u_proj", proj_matrix);
         gbuffer_atom_shader_->setUniform("u_camera_pos", camera_pos);
 
         glBindVertexArray(atom_vao_);
-        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, atom_count_);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, atom_instances_.slot_count());
         glBindVertexArray(0);
     }
 
     if (render_bonds && bond_count_ > 0) {
-        std::vector<float> bond_draw_data = bond_instances_;
-        const float bond_radius = ((mode == MolRenderMode::StickOnly) ? kBondRadiusStickOnly : kBondRadiusBallAndStick) * g_bond_radius_scale;
-        for (int i = 0; i < bond_count_; ++i) {
-            bond_draw_data[static_cast<std::size_t>(i) * 13 + 12] = bond_radius;
-        }
-        upload_bond_instances(bond_instance_vbo_, bond_draw_data);
-
         gbuffer_bond_shader_->bind();
         gbuffer_bond_shader_->setUniform("u_view", view_matrix);
         gbuffer_bond_shader_->setUniform("u_proj", proj_matrix);
         gbuffer_bond_shader_->setUniform("u_camera_pos", camera_pos);
 
         glBindVertexArray(bond_vao_);
-        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, bond_count_);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, bond_instances_.slot_count());
         glBindVertexArray(0);
     }
-
-    upload_atom_instances(atom_instance_vbo_, atom_instances_);
-    upload_bond_instances(bond_instance_vbo_, bond_instances_);
 }
 
 void MolRenderer::render_highlights(const Eigen::Matrix4f& view_matrix,
@@ -575,13 +983,13 @@ void MolRenderer::render_highlights(const Eigen::Matrix4f& view_matrix,
             draw_data[i + 5] = highlight_color.y();
             draw_data[i + 6] = highlight_color.z();
         }
-        upload_atom_instances(atom_instance_vbo_, draw_data);
+        upload_atom_instances(highlight_atom_instance_vbo_, draw_data);
 
         atom_shader_->bind();
         atom_shader_->setUniform("u_view", view_matrix);
         atom_shader_->setUniform("u_proj", proj_matrix);
         atom_shader_->setUniform("u_camera_pos", camera_pos);
-        glBindVertexArray(atom_vao_);
+        glBindVertexArray(highlight_atom_vao_);
         glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<int>(draw_data.size() / 8));
         glBindVertexArray(0);
     }
@@ -597,20 +1005,18 @@ void MolRenderer::render_highlights(const Eigen::Matrix4f& view_matrix,
             draw_data[i + 11] = highlight_color.z();
             draw_data[i + 12] *= 1.5f;
         }
-        upload_bond_instances(bond_instance_vbo_, draw_data);
+        upload_bond_instances(highlight_bond_instance_vbo_, draw_data);
 
         bond_shader_->bind();
         bond_shader_->setUniform("u_view", view_matrix);
         bond_shader_->setUniform("u_proj", proj_matrix);
         bond_shader_->setUniform("u_camera_pos", camera_pos);
         bond_shader_->setUniform("u_wireframe", 0);
-        glBindVertexArray(bond_vao_);
+        glBindVertexArray(highlight_bond_vao_);
         glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<int>(draw_data.size() / 13));
         glBindVertexArray(0);
     }
 
-    upload_atom_instances(atom_instance_vbo_, atom_instances_);
-    upload_bond_instances(bond_instance_vbo_, bond_instances_);
     glDepthMask(GL_TRUE);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glDisable(GL_BLEND);
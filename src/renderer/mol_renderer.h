@@ -3,13 +3,17 @@
 #include "core/molecular_system.h"
 #include "editor/picking.h"
 #include "io/pdb_io.h"
+#include "renderer/instance_slots.h"
 #include "renderer/shader.h"
 
 #include <Eigen/Core>
 
 #include <imgui.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace sbox::render {
@@ -32,7 +36,12 @@ enum class ColorMode : int {
 };
 
 Eigen::Vector3f chain_color(int chain_index);
+// Index into pdb.chains of the atom's chain. Uses the per-atom lookups when read_pdb() built them and
+// falls back to matching the chain id otherwise.
+int pdb_chain_index(const sbox::io::PDBData& pdb, std::size_t atom_index);
 Eigen::Vector3f residue_color(const std::string& residue_name);
+// residue_color() of each name, indexed like PDBData::residue_names.
+std::vector<Eigen::Vector3f> residue_colors(const std::vector<std::string>& residue_names);
 Eigen::Vector3f bfactor_color(float b_factor, float b_min, float b_max);
 void set_atom_radius_scale(float scale);
 void set_bond_radius_scale(float scale);
@@ -45,15 +54,48 @@ public:
     MolRenderer(const MolRenderer&) = delete;
     MolRenderer& operator=(const MolRenderer&) = delete;
 
+    // `color_revision` identifies the contents of pdb_data and charges; bump it whenever either
+    // changes in place, since the pointers alone cannot show that.
     void upload(const sbox::chem::MolecularSystem& mol,
                 ColorMode color_mode = ColorMode::CPK,
                 const sbox::io::PDBData* pdb_data = nullptr,
-                const std::vector<double>* charges = nullptr);
+                const std::vector<double>* charges = nullptr,
+                std::uint64_t color_revision = 0);
+    // Brings the uploaded instances in line with an edited molecule. Finding the edit compares the
+    // whole structure against the CPU copy, but only the atom and bond slots that changed are sent
+    // to the GPU. Slots stay stable across edits: removed atoms and bonds leave empty slots that
+    // later additions reuse. Falls back to upload() when the coloring inputs changed or the edit
+    // touches most of the structure.
+    void update(const sbox::chem::MolecularSystem& mol,
+                ColorMode color_mode = ColorMode::CPK,
+                const sbox::io::PDBData* pdb_data = nullptr,
+                const std::vector<double>* charges = nullptr,
+                std::uint64_t color_revision = 0);
+    // For callers that know which atoms moved, such as an editor drag: rewrites those atoms and
+    // their bonds without looking at the rest of the structure. Falls back to update() when the
+    // atom or bond count no longer matches the upload.
+    void update_atoms(const sbox::chem::MolecularSystem& mol, const std::vector<int>& moved_atoms);
+    // Bonds of every atom of `mol`, which must be the molecule last passed to upload() or update().
+    const sbox::chem::BondsByAtom& bonds_by_atom(const sbox::chem::MolecularSystem& mol);
 
     void render(const Eigen::Matrix4f& view_matrix,
                 const Eigen::Matrix4f& proj_matrix,
                 const Eigen::Vector3f& camera_pos,
                 MolRenderMode mode = MolRenderMode::BallAndStick);
+    // Draws only the listed atom and bond instances of the uploaded structure. The index lists are
+    // the only per-frame upload; the instance data stays on the GPU until the next upload() or update().
+    void render_instances(const Eigen::Matrix4f& view_matrix,
+                          const Eigen::Matrix4f& proj_matrix,
+                          const Eigen::Vector3f& camera_pos,
+                          MolRenderMode mode,
+                          const std::vector<std::uint32_t>& atom_indices,
+                          const std::vector<std::uint32_t>& bond_indices);
+    // Draws the listed atoms as round points sized by element, read straight from the atom instance
+    // buffer; the LOD renderer uses them for distant atoms.
+    void render_points(const Eigen::Matrix4f& view_matrix,
+                       const Eigen::Matrix4f& proj_matrix,
+                       const Eigen::Vector3f& camera_pos,
+                       const std::vector<std::uint32_t>& atom_indices);
     void render_gbuffer(const Eigen::Matrix4f& view_matrix,
                         const Eigen::Matrix4f& proj_matrix,
                         const Eigen::Vector3f& camera_pos,
@@ -87,13 +129,84 @@ private:
     unsigned int bond_instance_vbo_ = 0;
     int bond_count_ = 0;
 
+    // Index-driven draws read the instance buffers above through buffer textures.
+    unsigned int atom_index_vao_ = 0;
+    unsigned int atom_index_vbo_ = 0;
+    unsigned int atom_instance_tex_ = 0;
+    unsigned int bond_index_vao_ = 0;
+    unsigned int bond_index_vbo_ = 0;
+    unsigned int bond_instance_tex_ = 0;
+    // The atom instance buffer read as plain vertices, one point per slot, drawn through an index list.
+    unsigned int point_vao_ = 0;
+    unsigned int point_ebo_ = 0;
+
     std::unique_ptr<sbox::Shader> atom_shader_;
     std::unique_ptr<sbox::Shader> bond_shader_;
     std::unique_ptr<sbox::Shader> gbuffer_atom_shader_;
     std::unique_ptr<sbox::Shader> gbuffer_bond_shader_;
-
-    std::vector<float> atom_instances_;
-    std::vector<float> bond_instances_;
+    std::unique_ptr<sbox::Shader> atom_indexed_shader_;
+    std::unique_ptr<sbox::Shader> bond_indexed_shader_;
+    std::unique_ptr<sbox::Shader> point_shader_;
+
+    // Highlights get their own instance buffers so drawing them leaves the structure untouched.
+    unsigned int highlight_atom_vao_ = 0;
+    unsigned int highlight_atom_vbo_ = 0;
+    unsigned int highlight_atom_instance_vbo_ = 0;
+    unsigned int highlight_bond_vao_ = 0;
+    unsigned int highlight_bond_vbo_ = 0;
+    unsigned int highlight_bond_instance_vbo_ = 0;
+
+    // Per-atom color inputs of the last upload(), reused by update() for the atoms it rewrites.
+    struct AtomColoring {
+        ColorMode mode = ColorMode::CPK;
+        const sbox::io::PDBData* pdb_data = nullptr;
+        const std::vector<double>* charges = nullptr;
+        std::uint64_t revision = 0;
+        bool has_pdb = false;
+        bool has_lookups = false;
+        std::vector<Eigen::Vector3f> residue_palette;
+        float b_min = 0.0f;
+        float b_max = 1.0f;
+        double max_abs_charge = 0.0;
+
+        void prepare(const sbox::chem::MolecularSystem& mol,
+                     ColorMode color_mode,
+                     const sbox::io::PDBData* pdb,
+                     const std::vector<double>* atom_charges,
+                     std::uint64_t color_revision);
+        Eigen::Vector3f color(const sbox::chem::Atom& atom, std::size_t atom_index) const;
+    };
+    AtomColoring coloring_;
+
+    // CPU copies of the instance buffers, 8 floats per atom slot and 13 per bond slot. Free slots
+    // have radius 0 and draw nothing.
+    InstanceSlots atom_instances_;
+    InstanceSlots bond_instances_;
+    // Slot of every atom and bond of the molecule, in molecule order.
+    std::vector<int> atom_slots_;
+    std::vector<int> bond_slots_;
+    // Built on first use by bonds_by_atom() and dropped when an upload or edit changes the bonds.
+    sbox::chem::BondsByAtom bonds_by_atom_;
+    // Slots the GL instance buffers have room for.
+    std::size_t atom_buffer_slots_ = 0;
+    std::size_t bond_buffer_slots_ = 0;
+    // Molecule indices of render_instances() and render_points() translated to slots.
+    std::vector<std::uint32_t> slot_indices_;
+
+    // Radii currently in the instance buffers: the render mode they were sized for (-1 before the
+    // first upload) and the radius scale applied.
+    int gpu_atom_radius_mode_ = -1;
+    int gpu_bond_radius_mode_ = -1;
+    float gpu_atom_radius_scale_ = 0.0f;
+    float gpu_bond_radius_scale_ = 0.0f;
+
+    void sync_instance_radii(MolRenderMode mode);
+
+    void write_atom_slot(int slot, const sbox::chem::Atom& atom, const Eigen::Vector3f& color);
+    void write_bond_slot(int slot, const sbox::chem::Bond& bond);
+    // Instance data of a bond, taken from the slots of its two atoms.
+    void bond_instance(const sbox::chem::Bond& bond, float* out) const;
+    bool bond_slot_matches(int slot, const sbox::chem::Bond& bond) const;
 
     void render_highlights(const Eigen::Matrix4f& view_matrix,
                            const Eigen::Matrix4f& proj_matrix,
@@ -0,0 +1,288 @@
+#include "renderer/progressive_raymarch.h"
+
+#include "core/paths.h"
+
+#include <glad/gl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace sbox::render {
+
+namespace {
+
+// Interactive frames change the scale by at most these factors, so one slow frame does not collapse it.
+constexpr float kMaxScaleDrop = 0.5f;
+constexpr float kMaxScaleRise = 1.25f;
+// Interactive frames march at least this fraction of the configured steps.
+constexpr float kMinStepScale = 0.25f;
+
+float halton(int index, int base) {
+    float result = 0.0f;
+    float f = 1.0f;
+    while (index > 0) {
+        f /= static_cast<float>(base);
+        result += f * static_cast<float>(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+}  // namespace
+
+ProgressiveSchedule::Frame ProgressiveSchedule::next(std::uint64_t view_key, int width, int height) {
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+    const bool changed = !has_history_ || view_key != last_key_ || width != last_width_ || height != last_height_;
+    last_key_ = view_key;
+    last_width_ = width;
+    last_height_ = height;
+
+    Frame frame;
+    if (changed) {
+        // The first frame of a new view is already coarse; it becomes exact once the view settles.
+        const bool first = !has_history_;
+        has_history_ = true;
+        accumulated_ = 0;
+        ++interactive_frames_;
+        frame.interactive = !first;
+        const float scale = first ? 1.0f : scale_;
+        frame.width = std::max(1, static_cast<int>(std::lround(static_cast<float>(width) * scale)));
+        frame.height = std::max(1, static_cast<int>(std::lround(static_cast<float>(height) * scale)));
+        frame.step_scale = first ? 1.0f : std::max(scale, kMinStepScale);
+        // Varying offsets while moving turn the banding of a low step count into noise that the eye averages.
+        frame.jitter = Eigen::Vector2f(2.0f * (halton(interactive_frames_, 2) - 0.5f) / static_cast<float>(frame.width),
+                                       2.0f * (halton(interactive_frames_, 3) - 0.5f) / static_cast<float>(frame.height));
+        frame.sample_offset = halton(interactive_frames_, 5) - 0.5f;
+        if (first) {
+            frame.jitter.setZero();
+            frame.sample_offset = 0.0f;
+            accumulated_ = 1;
+        }
+        return frame;
+    }
+
+    if (accumulated_ >= converged_frames_) {
+        frame.march = false;
+        frame.width = width;
+        frame.height = height;
+        return frame;
+    }
+
+    frame.width = width;
+    frame.height = height;
+    // The first settled frame is the exact, unjittered image; later ones add sub-pixel and sub-step
+    // samples around it.
+    if (accumulated_ > 0) {
+        frame.jitter = Eigen::Vector2f(2.0f * (halton(accumulated_, 2) - 0.5f) / static_cast<float>(width),
+                                       2.0f * (halton(accumulated_, 3) - 0.5f) / static_cast<float>(height));
+        frame.sample_offset = halton(accumulated_, 5) - 0.5f;
+    }
+    frame.blend = 1.0f / static_cast<float>(accumulated_ + 1);
+    ++accumulated_;
+    return frame;
+}
+
+void ProgressiveSchedule::report_march_ms(double ms) {
+    if (ms <= 0.0) {
+        return;
+    }
+    // Cost goes with pixels times steps, i.e. with the cube of the scale.
+    const float ratio = std::cbrt(budget_ms_ / static_cast<float>(ms));
+    scale_ = std::clamp(scale_ * std::clamp(ratio, kMaxScaleDrop, kMaxScaleRise), kMinInteractiveScale, 1.0f);
+}
+
+void ProgressiveSchedule::invalidate() {
+    has_history_ = false;
+    accumulated_ = 0;
+}
+
+void ProgressiveSchedule::set_frame_budget_ms(float ms) {
+    budget_ms_ = std::max(ms, 1.0f);
+}
+
+void ProgressiveSchedule::set_converged_frames(int frames) {
+    converged_frames_ = std::max(frames, 1);
+}
+
+bool ProgressiveSchedule::converged() const {
+    return has_history_ && accumulated_ >= converged_frames_;
+}
+
+ProgressiveTarget::ProgressiveTarget() = default;
+
+ProgressiveTarget::~ProgressiveTarget() {
+    release();
+}
+
+void ProgressiveTarget::begin_march(const ProgressiveSchedule::Frame& frame, int width, int height) {
+    ensure_target(width, height);
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &saved_fbo_);
+    glGetIntegerv(GL_VIEWPORT, saved_viewport_.data());
+    saved_blend_ = glIsEnabled(GL_BLEND) == GL_TRUE;
+    glGetIntegerv(GL_BLEND_SRC_RGB, &saved_blend_func_[0]);
+    glGetIntegerv(GL_BLEND_DST_RGB, &saved_blend_func_[1]);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &saved_blend_func_[2]);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &saved_blend_func_[3]);
+    glGetFloatv(GL_BLEND_COLOR, saved_blend_color_.data());
+    saved_depth_test_ = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+    marching_ = true;
+
+    // Only interactive marches are timed: their cost is what the interactive scale controls.
+    timing_ = frame.interactive;
+    if (timing_) {
+        query_index_ = (query_index_ + 1) % kQueryRing;
+        if (queries_[0][0] == 0U) {
+            for (auto& pair : queries_) {
+                glGenQueries(2, pair.data());
+            }
+        }
+        glQueryCounter(queries_[static_cast<std::size_t>(query_index_)][0], GL_TIMESTAMP);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glViewport(0, 0, frame.width, frame.height);
+    glDisable(GL_DEPTH_TEST);
+    if (frame.blend < 1.0f) {
+        glEnable(GL_BLEND);
+        glBlendColor(0.0f, 0.0f, 0.0f, frame.blend);
+        glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
+    } else {
+        glDisable(GL_BLEND);
+    }
+    uv_scale_ = Eigen::Vector2f(static_cast<float>(frame.width) / static_cast<float>(width_),
+                                static_cast<float>(frame.height) / static_cast<float>(height_));
+    history_valid_ = true;
+}
+
+void ProgressiveTarget::end_march() {
+    if (!marching_) {
+        return;
+    }
+    marching_ = false;
+    if (timing_) {
+        glQueryCounter(queries_[static_cast<std::size_t>(query_index_)][1], GL_TIMESTAMP);
+        query_pending_[static_cast<std::size_t>(query_index_)] = true;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<unsigned int>(saved_fbo_));
+    glViewport(saved_viewport_[0], saved_viewport_[1], saved_viewport_[2], saved_viewport_[3]);
+    if (saved_blend_) {
+        glEnable(GL_BLEND);
+    } else {
+        glDisable(GL_BLEND);
+    }
+    glBlendFuncSeparate(static_cast<GLenum>(saved_blend_func_[0]), static_cast<GLenum>(saved_blend_func_[1]),
+                        static_cast<GLenum>(saved_blend_func_[2]), static_cast<GLenum>(saved_blend_func_[3]));
+    glBlendColor(saved_blend_color_[0], saved_blend_color_[1], saved_blend_color_[2], saved_blend_color_[3]);
+    if (saved_depth_test_) {
+        glEnable(GL_DEPTH_TEST);
+    } else {
+        glDisable(GL_DEPTH_TEST);
+    }
+}
+
+void ProgressiveTarget::composite(unsigned int fullscreen_vao) {
+    if (!history_valid_) {
+        return;
+    }
+    if (!composite_shader_) {
+        composite_shader_ = std::make_unique<Shader>(sbox::get_shader_path("fullscreen_quad.vert"),
+                                                     sbox::get_shader_path("progressive_composite.frag"));
+    }
+    composite_shader_->bind();
+    composite_shader_->setUniform("u_history", 0);
+    const int scale_loc = glGetUniformLocation(composite_shader_->id(), "u_uv_scale");
+    if (scale_loc >= 0) {
+        glUniform2f(scale_loc, uv_scale_.x(), uv_scale_.y());
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, color_tex_);
+    glBindVertexArray(fullscreen_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+double ProgressiveTarget::take_march_ms() {
+    double latest = -1.0;
+    // Oldest first, so the newest available result wins.
+    for (int k = 1; k <= kQueryRing; ++k) {
+        const std::size_t i = static_cast<std::size_t>((query_index_ + k) % kQueryRing);
+        if (!query_pending_[i]) {
+            continue;
+        }
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(queries_[i][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            continue;
+        }
+        GLuint64 start = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(queries_[i][0], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(queries_[i][1], GL_QUERY_RESULT, &end);
+        query_pending_[i] = false;
+        latest = end > start ? static_cast<double>(end - start) / 1.0e6 : 0.0;
+    }
+    return latest;
+}
+
+void ProgressiveTarget::release() {
+    composite_shader_.reset();
+    if (queries_[0][0] != 0U) {
+        for (auto& pair : queries_) {
+            glDeleteQueries(2, pair.data());
+            pair = {0U, 0U};
+        }
+    }
+    query_pending_.fill(false);
+    if (color_tex_ != 0U) {
+        glDeleteTextures(1, &color_tex_);
+        color_tex_ = 0;
+    }
+    if (fbo_ != 0U) {
+        glDeleteFramebuffers(1, &fbo_);
+        fbo_ = 0;
+    }
+    width_ = 0;
+    height_ = 0;
+    history_valid_ = false;
+}
+
+void ProgressiveTarget::ensure_target(int width, int height) {
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+    if (fbo_ != 0U && width == width_ && height == height_) {
+        return;
+    }
+    if (fbo_ == 0U) {
+        glGenFramebuffers(1, &fbo_);
+        glGenTextures(1, &color_tex_);
+    }
+    width_ = width;
+    height_ = height;
+    history_valid_ = false;
+
+    // Half floats keep 1/N accumulation weights from quantizing into visible steps.
+    glBindTexture(GL_TEXTURE_2D, color_tex_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width_, height_, 0, GL_RGBA, GL_HALF_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLint previous_fbo = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color_tex_, 0);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<unsigned int>(previous_fbo));
+    if (!complete) {
+        throw std::runtime_error("Progressive ray-march framebuffer is incomplete");
+    }
+}
+
+}  // namespace sbox::render
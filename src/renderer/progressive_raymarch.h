@@ -0,0 +1,140 @@
+#pragma once
+
+#include "renderer/shader.h"
+
+#include <Eigen/Core>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace sbox::render {
+
+// FNV-1a over the raw bytes of everything that feeds a march; any change gives a new key.
+class ViewKey {
+public:
+    template <typename T, typename = std::enable_if_t<std::is_scalar_v<T>>>
+    ViewKey& add(T value) {
+        return add_bytes(&value, sizeof(T));
+    }
+    template <typename Derived>
+    ViewKey& add(const Eigen::DenseBase<Derived>& matrix) {
+        for (Eigen::Index i = 0; i < matrix.size(); ++i) {
+            add(matrix.derived().coeff(i));
+        }
+        return *this;
+    }
+
+    std::uint64_t value() const { return hash_; }
+
+private:
+    ViewKey& add_bytes(const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash_ = (hash_ ^ bytes[i]) * 1099511628211ULL;
+        }
+        return *this;
+    }
+
+    std::uint64_t hash_ = 14695981039346656037ULL;
+};
+
+// Decides, frame by frame, how much ray marching the viewport needs. While the view key changes the
+// march runs at a reduced resolution and step count sized to the frame budget; once the view holds
+// still, full-resolution frames with sub-pixel and step-offset jitter are averaged until enough have
+// been accumulated, after which nothing needs marching until the view changes again.
+class ProgressiveSchedule {
+public:
+    struct Frame {
+        bool march = true;         // false once converged: the history already holds the image
+        bool interactive = false;  // reduced resolution and steps
+        int width = 0;             // march resolution, at most the viewport's
+        int height = 0;
+        float step_scale = 1.0f;   // multiplier on the configured volume / isosurface steps
+        Eigen::Vector2f jitter = Eigen::Vector2f::Zero();  // sub-pixel ray offset in NDC
+        float sample_offset = 0.0f;  // shift of every ray sample, in steps, within [-0.5, 0.5)
+        float blend = 1.0f;          // weight of this frame in the history; 1 replaces it
+    };
+
+    static constexpr int kDefaultConvergedFrames = 16;
+    static constexpr float kMinInteractiveScale = 0.25f;
+
+    // `view_key` must change whenever anything that affects the marched image changes.
+    Frame next(std::uint64_t view_key, int width, int height);
+    // GPU time of the last interactive march; the interactive scale follows it toward the budget.
+    void report_march_ms(double ms);
+    // Drops the history, e.g. after the volume data changed under an unchanged key.
+    void invalidate();
+
+    void set_frame_budget_ms(float ms);
+    void set_converged_frames(int frames);
+
+    bool converged() const;
+    int accumulated_frames() const { return accumulated_; }
+    float interactive_scale() const { return scale_; }
+
+private:
+    std::uint64_t last_key_ = 0;
+    int last_width_ = 0;
+    int last_height_ = 0;
+    bool has_history_ = false;
+    int accumulated_ = 0;
+    int interactive_frames_ = 0;
+    int converged_frames_ = kDefaultConvergedFrames;
+    float budget_ms_ = 12.0f;
+    float scale_ = 0.5f;
+};
+
+// Viewport-sized RGBA16F history the ray-march passes render into, and the pass that composites it
+// back over the scene. A GL_TIMESTAMP pair around each march feeds ProgressiveSchedule's budget.
+class ProgressiveTarget {
+public:
+    ProgressiveTarget();
+    ~ProgressiveTarget();
+
+    ProgressiveTarget(const ProgressiveTarget&) = delete;
+    ProgressiveTarget& operator=(const ProgressiveTarget&) = delete;
+
+    // Binds the history for `frame`, blending the march into it with weight frame.blend. The caller's
+    // framebuffer, viewport, blend enable/function/color and depth test are restored by end_march().
+    void begin_march(const ProgressiveSchedule::Frame& frame, int width, int height);
+    void end_march();
+    // Draws the history into the bound framebuffer, covering the caller's viewport.
+    void composite(unsigned int fullscreen_vao);
+    // Milliseconds of the latest interactive march whose timestamps have arrived, or a negative value.
+    double take_march_ms();
+
+    bool has_history() const { return history_valid_; }
+    void release();
+
+private:
+    void ensure_target(int width, int height);
+
+    unsigned int fbo_ = 0;
+    unsigned int color_tex_ = 0;
+    int width_ = 0;
+    int height_ = 0;
+    Eigen::Vector2f uv_scale_ = Eigen::Vector2f::Ones();
+    bool history_valid_ = false;
+    std::unique_ptr<Shader> composite_shader_;
+
+    static constexpr int kQueryRing = 3;
+    std::array<std::array<unsigned int, 2>, kQueryRing> queries_{};
+    std::array<bool, kQueryRing> query_pending_{};
+    int query_index_ = 0;
+    bool timing_ = false;
+
+    // Caller state saved by begin_march().
+    int saved_fbo_ = 0;
+    std::array<int, 4> saved_viewport_{};
+    bool saved_blend_ = false;
+    // GL_BLEND_SRC_RGB, GL_BLEND_DST_RGB, GL_BLEND_SRC_ALPHA, GL_BLEND_DST_ALPHA.
+    std::array<int, 4> saved_blend_func_{};
+    std::array<float, 4> saved_blend_color_{};
+    bool saved_depth_test_ = false;
+    bool marching_ = false;
+};
+
+}  // namespace sbox::render
@@ -1,5 +1,8 @@
 #include "renderer/screenshot.h"
 
+#include "core/logging.h"
+#include "io/png_io.h"
+
 #include <glad/gl.h>
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -7,6 +10,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <exception>
 #include <filesystem>
 #include <string>
 #include <vector>
@@ -111,6 +115,106 @@ bool save_screenshot_highres(
     return ok;
 }
 
+bool save_screenshot_tiled(
+    const std::string& filepath,
+    int width,
+    int height,
+    std::function<void(unsigned int fbo, const RenderTile& tile)> render_fn,
+    int tile_size,
+    int tile_overlap) {
+    if (width <= 0 || height <= 0 || !render_fn || tile_size <= 0 || tile_overlap < 0) {
+        return false;
+    }
+
+    GLint max_texture_size = 0;
+    GLint max_viewport[2] = {0, 0};
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, max_viewport);
+    const int max_target = std::min({max_texture_size, max_viewport[0], max_viewport[1]});
+    // Multiples of 4 keep the 4x4 SSAO noise pattern continuous across tile edges.
+    tile_overlap = (tile_overlap + 3) / 4 * 4;
+    tile_size = std::min(tile_size, max_target - 2 * tile_overlap) / 4 * 4;
+    if (tile_size <= 0) {
+        return false;
+    }
+    const int target_size = tile_size + 2 * tile_overlap;
+
+    unsigned int tile_fbo = 0;
+    unsigned int color_tex = 0;
+    unsigned int depth_rbo = 0;
+    glGenFramebuffers(1, &tile_fbo);
+    glGenTextures(1, &color_tex);
+    glGenRenderbuffers(1, &depth_rbo);
+
+    glBindTexture(GL_TEXTURE_2D, color_tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, target_size, target_size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_rbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, target_size, target_size);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, tile_fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color_tex, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_rbo);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    bool ok = false;
+    if (complete) {
+        try {
+            sbox::io::PngStreamWriter png;
+            png.open(filepath, width, height);
+
+            const std::size_t row_bytes = static_cast<std::size_t>(width) * 4u;
+            std::vector<unsigned char> strip(row_bytes * static_cast<std::size_t>(tile_size));
+            std::vector<unsigned char> tile_pixels(static_cast<std::size_t>(tile_size) * static_cast<std::size_t>(tile_size) * 4u);
+
+            // Strips run top to bottom, the order PNG rows are stored in, but are cut from the GL origin
+            // at the bottom so every tile starts on a multiple of 4; only the topmost strip is short.
+            const int strip_count = (height + tile_size - 1) / tile_size;
+            for (int strip_index = strip_count; strip_index-- > 0;) {
+                const int gl_y = strip_index * tile_size;
+                const int strip_height = std::min(tile_size, height - gl_y);
+                for (int x = 0; x < width; x += tile_size) {
+                    const int tile_width = std::min(tile_size, width - x);
+                    RenderTile tile;
+                    tile.image_width = width;
+                    tile.image_height = height;
+                    tile.x = x - tile_overlap;
+                    tile.y = gl_y - tile_overlap;
+                    tile.width = tile_width + 2 * tile_overlap;
+                    tile.height = strip_height + 2 * tile_overlap;
+                    render_fn(tile_fbo, tile);
+
+                    glBindFramebuffer(GL_FRAMEBUFFER, tile_fbo);
+                    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                    glReadPixels(tile_overlap, tile_overlap, tile_width, strip_height, GL_RGBA, GL_UNSIGNED_BYTE, tile_pixels.data());
+                    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+                    const std::size_t tile_row_bytes = static_cast<std::size_t>(tile_width) * 4u;
+                    for (int row = 0; row < strip_height; ++row) {
+                        const unsigned char* src = tile_pixels.data() + static_cast<std::size_t>(strip_height - 1 - row) * tile_row_bytes;
+                        std::copy(src, src + tile_row_bytes,
+                                  strip.data() + static_cast<std::size_t>(row) * row_bytes + static_cast<std::size_t>(x) * 4u);
+                    }
+                }
+                png.write_rows(strip.data(), strip_height);
+            }
+            png.finish();
+            ok = true;
+        } catch (const std::exception& ex) {
+            SBOX_LOG_ERROR("Tiled screenshot failed: %s", ex.what());
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteRenderbuffers(1, &depth_rbo);
+    glDeleteTextures(1, &color_tex);
+    glDeleteFramebuffers(1, &tile_fbo);
+    return ok;
+}
+
 bool save_screenshot_transparent(
     const std::string& filepath,
     unsigned int fbo,
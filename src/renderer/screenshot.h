@@ -13,6 +13,30 @@ bool save_screenshot_highres(
     int render_height,
     std::function<void(unsigned int fbo, int w, int h)> render_fn);
 
+// Pixel window of one tile of a tiled render: the image is image_width x image_height and the tile
+// covers columns [x, x + width) and rows [y, y + height), counted from the bottom as in GL.
+struct RenderTile {
+    int image_width = 0;
+    int image_height = 0;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// Renders a width x height PNG in tiles of at most tile_size pixels and streams it to disk one strip
+// of tiles at a time, so neither GL's framebuffer limits nor memory bound the image size. Each tile
+// is rendered with tile_overlap extra pixels on every side that are then discarded, giving
+// screen-space passes such as SSAO and FXAA the same neighbourhood they would see in a single render.
+// render_fn must draw the tile window into the bound-size framebuffer it is given.
+bool save_screenshot_tiled(
+    const std::string& filepath,
+    int width,
+    int height,
+    std::function<void(unsigned int fbo, const RenderTile& tile)> render_fn,
+    int tile_size = 2048,
+    int tile_overlap = 32);
+
 bool save_screenshot_transparent(
     const std::string& filepath,
     unsigned int fbo,
@@ -10,6 +10,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace sbox::render {
@@ -45,18 +46,6 @@ int close_pipe(FILE* pipe) {
 #endif
 }
 
-void flip_rgba_rows(std::vector<unsigned char>& pixels, int width, int height) {
-    const std::size_t row_bytes = static_cast<std::size_t>(width) * 4u;
-    std::vector<unsigned char> temp(row_bytes);
-    for (int y = 0; y < height / 2; ++y) {
-        unsigned char* top = pixels.data() + static_cast<std::size_t>(y) * row_bytes;
-        unsigned char* bottom = pixels.data() + static_cast<std::size_t>(height - 1 - y) * row_bytes;
-        std::copy(top, top + row_bytes, temp.data());
-        std::copy(bottom, bottom + row_bytes, top);
-        std::copy(temp.data(), temp.data() + row_bytes, bottom);
-    }
-}
-
 struct OffscreenTarget {
     unsigned int fbo = 0;
     unsigned int color = 0;
@@ -104,15 +93,10 @@ void destroy_offscreen_target(OffscreenTarget& target) {
 bool capture_frame(sbox::App& app,
                    const VideoExporter::ExportSettings& settings,
                    const OffscreenTarget& target,
-                   std::vector<unsigned char>& pixels,
+                   FrameReadback& readback,
                    VideoExporter& exporter) {
     app.render_to_fbo(target.fbo, settings.width, settings.height, settings.transparent_background);
-    glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
-    glPixelStorei(GL_PACK_ALIGNMENT, 1);
-    glReadPixels(0, 0, settings.width, settings.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    flip_rgba_rows(pixels, settings.width, settings.height);
-    return exporter.write_frame(pixels.data(), settings.width, settings.height);
+    return readback.read(target.fbo, exporter);
 }
 
 }  // namespace
@@ -136,7 +120,6 @@ bool VideoExporter::begin(const ExportSettings& settings) {
     end();
 
     settings_ = settings;
-    frames_written_ = 0;
 
     std::string codec = settings_.codec;
     std::string pixel_format = settings_.pixel_format;
@@ -173,10 +156,15 @@ bool VideoExporter::begin(const ExportSettings& settings) {
 
     ffmpeg_pipe_ = open_pipe(command);
     exporting_ = ffmpeg_pipe_ != nullptr;
+    if (exporting_) {
+        queue_.start([pipe = ffmpeg_pipe_](const std::vector<unsigned char>& frame) {
+            return std::fwrite(frame.data(), 1, frame.size(), pipe) == frame.size();
+        });
+    }
     return exporting_;
 }
 
-bool VideoExporter::write_frame(const unsigned char* rgba_data, int width, int height) {
+bool VideoExporter::write_frame(const unsigned char* rgba_data, int width, int height, bool bottom_up) {
     if (!exporting_ || ffmpeg_pipe_ == nullptr || rgba_data == nullptr) {
         return false;
     }
@@ -184,19 +172,13 @@ bool VideoExporter::write_frame(const unsigned char* rgba_data, int width, int h
         return false;
     }
 
-    const std::size_t bytes = static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4u;
-    const std::size_t written = std::fwrite(rgba_data, 1, bytes, ffmpeg_pipe_);
-    if (written != bytes) {
-        return false;
-    }
-    ++frames_written_;
-    return true;
+    return queue_.push(rgba_data, static_cast<std::size_t>(width) * 4u, height, bottom_up);
 }
 
 bool VideoExporter::end() {
-    bool ok = true;
+    bool ok = queue_.finish();
     if (ffmpeg_pipe_ != nullptr) {
-        ok = close_pipe(ffmpeg_pipe_) == 0;
+        ok = close_pipe(ffmpeg_pipe_) == 0 && ok;
         ffmpeg_pipe_ = nullptr;
     }
     exporting_ = false;
@@ -204,7 +186,7 @@ bool VideoExporter::end() {
 }
 
 int VideoExporter::frames_written() const {
-    return frames_written_;
+    return queue_.frames_written();
 }
 
 int VideoExporter::total_frames() const {
@@ -219,7 +201,73 @@ float VideoExporter::progress() const {
     if (settings_.total_frames <= 0) {
         return 0.0f;
     }
-    return std::clamp(static_cast<float>(frames_written_) / static_cast<float>(settings_.total_frames), 0.0f, 1.0f);
+    return std::clamp(static_cast<float>(queue_.frames_written()) / static_cast<float>(settings_.total_frames), 0.0f, 1.0f);
+}
+
+FrameReadback::~FrameReadback() {
+    release();
+}
+
+void FrameReadback::resize(int width, int height) {
+    if (buffers_[0] == 0U) {
+        glGenBuffers(kDepth, buffers_.data());
+    }
+    const std::size_t bytes = static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4u;
+    for (unsigned int buffer : buffers_) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    width_ = width;
+    height_ = height;
+    oldest_ = 0;
+    pending_ = 0;
+}
+
+bool FrameReadback::read(unsigned int fbo, VideoExporter& exporter) {
+    const int slot = (oldest_ + pending_) % kDepth;
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers_[static_cast<std::size_t>(slot)]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    ++pending_;
+    return pending_ < kDepth || write_oldest(exporter);
+}
+
+bool FrameReadback::flush(VideoExporter& exporter) {
+    bool ok = true;
+    while (pending_ > 0) {
+        ok = write_oldest(exporter) && ok;
+    }
+    return ok;
+}
+
+void FrameReadback::release() {
+    if (buffers_[0] != 0U) {
+        glDeleteBuffers(kDepth, buffers_.data());
+        buffers_.fill(0);
+    }
+    width_ = 0;
+    height_ = 0;
+    oldest_ = 0;
+    pending_ = 0;
+}
+
+bool FrameReadback::write_oldest(VideoExporter& exporter) {
+    const std::size_t bytes = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_) * 4u;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers_[static_cast<std::size_t>(oldest_)]);
+    const auto* pixels =
+        static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_READ_BIT));
+    const bool ok = pixels != nullptr && exporter.write_frame(pixels, width_, height_, true);
+    if (pixels != nullptr) {
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    oldest_ = (oldest_ + 1) % kDepth;
+    --pending_;
+    return ok;
 }
 
 void export_turntable(sbox::App& app,
@@ -236,14 +284,15 @@ void export_turntable(sbox::App& app,
     const float original_distance = app.camera().distance();
 
     OffscreenTarget target = create_offscreen_target(settings.width, settings.height);
-    std::vector<unsigned char> pixels(static_cast<std::size_t>(settings.width) * static_cast<std::size_t>(settings.height) * 4u);
+    FrameReadback readback;
+    readback.resize(settings.width, settings.height);
 
     for (int frame = 0; frame < settings.total_frames; ++frame) {
         const float t = settings.total_frames > 1 ? static_cast<float>(frame) / static_cast<float>(settings.total_frames - 1) : 0.0f;
         const float angle_deg = start_angle + (end_angle - start_angle) * t;
         app.camera().setOrientation(Eigen::AngleAxisf(angle_deg * 3.14159265358979323846f / 180.0f,
                                                       Eigen::Vector3f::UnitY()) * original_orientation);
-        if (!capture_frame(app, settings, target, pixels, exporter)) {
+        if (!capture_frame(app, settings, target, readback, exporter)) {
             break;
         }
     }
@@ -251,6 +300,7 @@ void export_turntable(sbox::App& app,
     app.camera().setOrientation(original_orientation);
     app.camera().setTarget(original_target);
     app.camera().setDistance(original_distance);
+    readback.flush(exporter);
     destroy_offscreen_target(target);
     exporter.end();
 }
@@ -269,7 +319,8 @@ void export_trajectory(sbox::App& app,
 
     const sbox::chem::MolecularSystem original_molecule = app.current_molecule();
     OffscreenTarget target = create_offscreen_target(settings.width, settings.height);
-    std::vector<unsigned char> pixels(static_cast<std::size_t>(settings.width) * static_cast<std::size_t>(settings.height) * 4u);
+    FrameReadback readback;
+    readback.resize(settings.width, settings.height);
 
     for (int frame = 0; frame < settings.total_frames; ++frame) {
         const double t = settings.total_frames > 1
@@ -277,12 +328,13 @@ void export_trajectory(sbox::App& app,
                                    static_cast<double>(std::max(trajectory.num_frames() - 1, 0))
                              : 0.0;
         app.set_current_molecule_for_export(trajectory.interpolate(t));
-        if (!capture_frame(app, settings, target, pixels, exporter)) {
+        if (!capture_frame(app, settings, target, readback, exporter)) {
             break;
         }
     }
 
     app.set_current_molecule_for_export(original_molecule);
+    readback.flush(exporter);
     destroy_offscreen_target(target);
     exporter.end();
 }
@@ -305,17 +357,19 @@ void export_orbital_sweep(sbox::App& app,
     const int frames_per_orbital = std::max(1, settings.total_frames / num_orbitals);
 
     OffscreenTarget target = create_offscreen_target(settings.width, settings.height);
-    std::vector<unsigned char> pixels(static_cast<std::size_t>(settings.width) * static_cast<std::size_t>(settings.height) * 4u);
+    FrameReadback readback;
+    readback.resize(settings.width, settings.height);
 
     for (int frame = 0; frame < settings.total_frames; ++frame) {
         const int orbital_index = std::min(end_mo, start_mo + frame / frames_per_orbital);
         app.state().selected_mo = orbital_index;
-        if (!capture_frame(app, settings, target, pixels, exporter)) {
+        if (!capture_frame(app, settings, target, readback, exporter)) {
             break;
         }
     }
 
     app.state().selected_mo = original_mo;
+    readback.flush(exporter);
     destroy_offscreen_target(target);
     exporter.end();
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "io/trajectory_io.h"
+#include "renderer/frame_writer_queue.h"
 
+#include <array>
 #include <cstdio>
 #include <string>
 
@@ -31,7 +33,12 @@ public:
     };
 
     bool begin(const ExportSettings& settings);
-    bool write_frame(const unsigned char* rgba_data, int width, int height);
+    // Queues a copy of the frame for the encoder thread and returns once it is copied; blocks only
+    // while FrameWriterQueue::kMaxQueuedFrames frames are already waiting. `bottom_up` frames (row 0
+    // at the bottom, as glReadPixels returns them) are flipped during the copy. Returns false once a
+    // pipe write failed.
+    bool write_frame(const unsigned char* rgba_data, int width, int height, bool bottom_up = false);
+    // Waits for queued frames to reach ffmpeg, then closes the pipe.
     bool end();
 
     int frames_written() const;
@@ -42,8 +49,41 @@ public:
 private:
     FILE* ffmpeg_pipe_ = nullptr;
     ExportSettings settings_;
-    int frames_written_ = 0;
     bool exporting_ = false;
+    // Carries frames from write_frame() to the thread that writes them into the pipe.
+    FrameWriterQueue queue_;
+};
+
+// Reads rendered frames back through a ring of pixel-pack buffers. read() only queues the copy on
+// the GPU; the frame is mapped and handed to the exporter kDepth - 1 reads later, by which time the
+// GPU has long finished it, so rendering, readback and encoding overlap instead of waiting in turn.
+class FrameReadback {
+public:
+    static constexpr int kDepth = 3;
+
+    FrameReadback() = default;
+    ~FrameReadback();
+
+    FrameReadback(const FrameReadback&) = delete;
+    FrameReadback& operator=(const FrameReadback&) = delete;
+
+    // Sizes the buffers for width x height RGBA frames, dropping frames still in flight.
+    void resize(int width, int height);
+    // Starts reading the colour attachment of `fbo`, then passes the oldest frame to `exporter` once
+    // the ring is full. Returns false when the exporter rejected a frame.
+    bool read(unsigned int fbo, VideoExporter& exporter);
+    // Passes every frame still in flight to `exporter`, oldest first.
+    bool flush(VideoExporter& exporter);
+    void release();
+
+private:
+    bool write_oldest(VideoExporter& exporter);
+
+    std::array<unsigned int, kDepth> buffers_{};
+    int width_ = 0;
+    int height_ = 0;
+    int oldest_ = 0;
+    int pending_ = 0;
 };
 
 void export_turntable(
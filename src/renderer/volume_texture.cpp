@@ -89,19 +89,23 @@ bool VolumeTexture::upload(const Eigen::Vector3d& origin,
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_BORDER);
     const float border[4] = {0.0f, 0.0f, 0.0f, 0.0f};
     glTexParameterfv(GL_TEXTURE_3D, GL_TEXTURE_BORDER_COLOR, border);
+    // Cube data is z-fastest, so the texture's s axis is the grid's z axis; shaders sample with uvw.zyx.
     glTexImage3D(GL_TEXTURE_3D,
                  0,
                  GL_R32F,
-                 nx_,
-                 ny_,
                  nz_,
+                 ny_,
+                 nx_,
                  0,
                  GL_RED,
                  GL_FLOAT,
                  data);
     glBindTexture(GL_TEXTURE_3D, 0);
 
+    bricks_.upload(build_volume_bricks(data, nx_, ny_, nz_, origin_, world_to_grid_));
+
     uploaded_ = true;
+    ++revision_;
     return true;
 }
 
@@ -149,4 +153,8 @@ float VolumeTexture::max_abs_value() const {
     return max_abs_val_;
 }
 
+const BrickTexture& VolumeTexture::bricks() const {
+    return bricks_;
+}
+
 }  // namespace sbox::render
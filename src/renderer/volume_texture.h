@@ -1,6 +1,7 @@
 #pragma once
 
 #include "io/cube_io.h"
+#include "renderer/brick_grid.h"
 
 #include <Eigen/Core>
 
@@ -36,6 +37,10 @@ public:
     Eigen::Matrix3f grid_to_world() const;
     Eigen::Matrix3f world_to_grid() const;
     float max_abs_value() const;
+    // Per-brick max |value|, rebuilt on every upload, for empty-space skipping in the ray marchers.
+    const BrickTexture& bricks() const;
+    // Incremented by every upload, so cached renderings of the volume can tell they are stale.
+    unsigned int revision() const { return revision_; }
 
 private:
     unsigned int texture_3d_ = 0;
@@ -47,6 +52,8 @@ private:
     Eigen::Matrix3f world_to_grid_ = Eigen::Matrix3f::Identity();
     float max_abs_val_ = 1.0f;
     bool uploaded_ = false;
+    unsigned int revision_ = 0;
+    BrickTexture bricks_;
 
     mutable int bound_texture_unit_ = 5;
 };
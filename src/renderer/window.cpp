@@ -12,6 +12,7 @@
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 
+#include <array>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -26,29 +27,80 @@ std::unordered_map<GLFWwindow*, Window*>& WindowMap() {
     return map;
 }
 
-}  // namespace
-
-Window::Window(int width, int height, const std::string& title) {
-    glfwSetErrorCallback(&Window::ErrorCallback);
-    if (glfwInit() == GLFW_FALSE) {
-        throw std::runtime_error("Failed to initialize GLFW");
-    }
-
+void set_context_hints() {
+    glfwDefaultWindowHints();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
 #endif
+}
+
+// Tries the offscreen context backends in order of preference; GLFW is left initialized for the
+// one that worked.
+GLFWwindow* create_headless_window(int width, int height, const std::string& title) {
+    struct Backend {
+        int platform;
+        int context_api;
+        const char* name;
+    };
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+    constexpr std::array<Backend, 3> kBackends = {{
+        {GLFW_PLATFORM_NULL, GLFW_EGL_CONTEXT_API, "surfaceless EGL"},
+        {GLFW_PLATFORM_NULL, GLFW_OSMESA_CONTEXT_API, "OSMesa"},
+        {GLFW_ANY_PLATFORM, GLFW_NATIVE_CONTEXT_API, "hidden window"},
+    }};
+#else
+    constexpr std::array<Backend, 1> kBackends = {{{0, GLFW_NATIVE_CONTEXT_API, "hidden window"}}};
+#endif
 
-    window_ = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (window_ == nullptr) {
+    for (const Backend& backend : kBackends) {
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+        glfwInitHint(GLFW_PLATFORM, backend.platform);
+#endif
+        if (glfwInit() == GLFW_FALSE) {
+            continue;
+        }
+        set_context_hints();
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, backend.context_api);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        GLFWwindow* window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
+        if (window != nullptr) {
+            SBOX_LOG_INFO("Headless OpenGL context: %s", backend.name);
+            return window;
+        }
+        SBOX_LOG_WARN("Headless OpenGL context via %s unavailable", backend.name);
         glfwTerminate();
-        throw std::runtime_error("Failed to create GLFW window");
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+Window::Window(int width, int height, const std::string& title, bool headless) {
+    glfwSetErrorCallback(&Window::ErrorCallback);
+    if (headless) {
+        window_ = create_headless_window(width, height, title);
+        if (window_ == nullptr) {
+            throw std::runtime_error("Failed to create a headless OpenGL context");
+        }
+    } else {
+        if (glfwInit() == GLFW_FALSE) {
+            throw std::runtime_error("Failed to initialize GLFW");
+        }
+        set_context_hints();
+        window_ = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
+        if (window_ == nullptr) {
+            glfwTerminate();
+            throw std::runtime_error("Failed to create GLFW window");
+        }
     }
 
     glfwMakeContextCurrent(window_);
-    glfwSwapInterval(1);
+    if (!headless) {
+        glfwSwapInterval(1);
+    }
 
     if (gladLoadGL(reinterpret_cast<GLADloadfunc>(glfwGetProcAddress)) == 0) {
         glfwDestroyWindow(window_);
@@ -78,6 +130,10 @@ void Window::pollEvents() const {
     glfwPollEvents();
 }
 
+void Window::waitEvents(double timeout_seconds) const {
+    glfwWaitEventsTimeout(timeout_seconds);
+}
+
 void Window::swapBuffers() const {
     glfwSwapBuffers(window_);
 }
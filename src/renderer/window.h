@@ -16,7 +16,10 @@ namespace sbox {
 
 class Window {
 public:
-    Window(int width, int height, const std::string& title);
+    // A headless window is never shown: it exists only to own an OpenGL context for offscreen
+    // rendering. It is created on GLFW's null platform with a surfaceless EGL context (Mesa's
+    // llvmpipe works on GPU-less servers), falling back to OSMesa and then to a hidden window.
+    Window(int width, int height, const std::string& title, bool headless = false);
     ~Window();
 
     Window(const Window&) = delete;
@@ -26,6 +29,8 @@ public:
     [[nodiscard]] bool shouldClose() const;
 
     void pollEvents() const;
+    // Blocks until an event arrives or `timeout_seconds` pass.
+    void waitEvents(double timeout_seconds) const;
     void swapBuffers() const;
 
     [[nodiscard]] int framebufferWidth() const { return framebuffer_width_; }
@@ -8,17 +8,20 @@
 
 #include "ui/app.h"
 
+#include "analysis/volume_generator.h"
 #include "core/logging.h"
 #include "core/settings.h"
 #include "core/update_checker.h"
 #include "ui/about_dialog.h"
 #include "ui/annotation_editor.h"
 #include "ui/annotations.h"
+#include "ui/backend_telemetry_panel.h"
 #include "ui/bond_order_panel.h"
 #include "core/gaussian_eval.h"
 #include "core/hydrogen.h"
 #include "core/molden_parser.h"
 #include "core/paths.h"
+#include "io/file_loader.h"
 #include "io/project_io.h"
 #include "ui/charge_overlay.h"
 #include "ui/complex_builder.h"
@@ -29,6 +32,7 @@
 #include "ui/d_orbital_viewer.h"
 #include "ui/dos_panel.h"
 #include "ui/editor_toolbar.h"
+#include "ui/ensemble_panel.h"
 #include "ui/esp_controls.h"
 #include "ui/export_dialog.h"
 #include "ui/file_dialog.h"
@@ -60,18 +64,25 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <chrono>
 #include <cmath>
 #include <ctime>
 #include <cstdlib>
 #include <filesystem>
+#include <limits>
 #include <optional>
 #include <stdexcept>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace sbox {
 
 namespace {
 
+// Bake key of the total electron density, next to the MO indices of orbital bakes.
+constexpr int kTotalDensityBake = -2;
+
 constexpr std::size_t kRenderPassCount =
     static_cast<std::size_t>(App::GpuTimingState::Pass::Count);
 
@@ -88,6 +99,10 @@ const char* render_pass_name(App::GpuTimingState::Pass pass) {
     return "Unknown";
 }
 
+std::string python_env_cache_path() {
+    return (std::filesystem::path(get_app_data_dir()) / "python_env_cache.json").string();
+}
+
 void ensure_gpu_timing_queries(App::GpuTimingState& state) {
     if (state.initialized) {
         return;
@@ -200,8 +215,8 @@ void clear_mo_summary(ui::AppState& state) {
     state.mol_has_mo_summary = false;
 }
 
-const std::vector<double>* current_charges_for_render(const std::optional<sbox::backend::JobResult>& result) {
-    if (result.has_value() && !result->mulliken_charges.empty()) {
+const std::vector<double>* current_charges_for_render(const sbox::backend::JobResultHandle& result) {
+    if (result && !result->mulliken_charges.empty()) {
         return &result->mulliken_charges;
     }
     return nullptr;
@@ -311,7 +326,7 @@ std::string default_screenshot_path() {
 
 void draw_color_legend(const ui::AppState& state,
                        const sbox::io::PDBData& pdb_data,
-                       const std::optional<sbox::backend::JobResult>& result,
+                       const sbox::backend::JobResultHandle& result,
                        const ImVec2& viewport_pos) {
     if (state.view_mode != ui::ViewMode::MolecularOrbital) {
         return;
@@ -386,7 +401,7 @@ void draw_color_legend(const ui::AppState& state,
                       Eigen::Vector3f(1.0f, 1.0f, 1.0f),
                       Eigen::Vector3f(0.95f, 0.20f, 0.15f),
                       "-", "0", "+");
-        if (!result.has_value() || result->mulliken_charges.empty()) {
+        if (!result || result->mulliken_charges.empty()) {
             draw->AddText(ImVec2(box_min.x + 12.0f, box_min.y + 70.0f), IM_COL32(225, 160, 120, 230), "No charges loaded");
         }
         break;
@@ -485,17 +500,44 @@ std::optional<sbox::basis::MOData> mo_data_from_fchk(const sbox::io::FchkData& f
     return mo_data;
 }
 
+// True when this frame carries input that can change the scene: mouse buttons, the wheel or keys
+// anywhere, or pointer motion over the viewport. Motion over panels alone only redraws the UI.
+bool frame_has_scene_input(bool viewport_hovered) {
+    const ImGuiIO& io = ImGui::GetIO();
+    if (io.MouseWheel != 0.0f || io.MouseWheelH != 0.0f) {
+        return true;
+    }
+    for (int button = 0; button < ImGuiMouseButton_COUNT; ++button) {
+        if (io.MouseDown[button] || io.MouseReleased[button]) {
+            return true;
+        }
+    }
+    for (int key = ImGuiKey_NamedKey_BEGIN; key < ImGuiKey_NamedKey_END; ++key) {
+        if (ImGui::IsKeyDown(static_cast<ImGuiKey>(key)) || ImGui::IsKeyReleased(static_cast<ImGuiKey>(key))) {
+            return true;
+        }
+    }
+    return viewport_hovered && (io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f);
+}
+
+// Step count for a progressive frame; coarse frames march fewer, longer steps.
+int scaled_steps(int steps, float scale) {
+    return std::max(1, static_cast<int>(std::lround(static_cast<float>(steps) * scale)));
+}
+
 }  // namespace
 
-App::App() {
+App::App(bool headless) : headless_(headless) {
     settings_manager_.load();
     const auto& settings = settings_manager_.settings();
 
-    window_ = std::make_unique<Window>(settings.window_width, settings.window_height, "Schrödinger's Sandbox");
-    if (settings.window_maximized) {
-        glfwMaximizeWindow(window_->handle());
+    window_ = std::make_unique<Window>(settings.window_width, settings.window_height, "Schrödinger's Sandbox", headless_);
+    if (!headless_) {
+        if (settings.window_maximized) {
+            glfwMaximizeWindow(window_->handle());
+        }
+        glfwSwapInterval(settings.enable_vsync ? 1 : 0);
     }
-    glfwSwapInterval(settings.enable_vsync ? 1 : 0);
     gradient_shader_ = std::make_unique<Shader>(sbox::get_shader_path("fullscreen_quad.vert"),
                                                 sbox::get_shader_path("test_gradient.frag"));
     orbital_shader_ = try_load_shader(sbox::get_shader_path("orbital_raymarch.vert"),
@@ -519,31 +561,37 @@ App::App() {
 
     glGenVertexArrays(1, &fullscreen_vao_);
 
-    python_env_.detect();
-    python_env_.check_packages();
-    backend_.init(python_env_);
-    if (!python_env_.has_pyscf() && !python_env_.has_tblite()) {
-        wizard_state_.show_wizard = true;
+    if (!headless_) {
+        // Importing pyscf and friends takes seconds, so the first frame runs on the cached probe and the
+        // interpreter is re-checked in the background.
+        (void)python_env_.load_cache(python_env_cache_path(), settings.python_path);
+        backend_.init(python_env_);
+        backend_.set_telemetry_log((std::filesystem::path(get_app_data_dir()) / "backend_telemetry.jsonl").string());
+        startPythonProbe(settings.python_path);
+
+        glfwSetWindowUserPointer(window_->handle(), this);
+        glfwSetScrollCallback(window_->handle(), &App::ScrollCallback);
+        glfwSetWindowContentScaleCallback(window_->handle(), [](GLFWwindow* win, float x_scale, float y_scale) {
+            auto* self = static_cast<App*>(glfwGetWindowUserPointer(win));
+            if (self != nullptr) {
+                self->on_content_scale_change(x_scale, y_scale);
+            }
+        });
     }
 
-    glfwSetWindowUserPointer(window_->handle(), this);
-    glfwSetScrollCallback(window_->handle(), &App::ScrollCallback);
-    glfwSetWindowContentScaleCallback(window_->handle(), [](GLFWwindow* win, float x_scale, float y_scale) {
-        auto* self = static_cast<App*>(glfwGetWindowUserPointer(win));
-        if (self != nullptr) {
-            self->on_content_scale_change(x_scale, y_scale);
-        }
-    });
-
-    editor_state_.select_mode = std::make_unique<sbox::editor::SelectMode>();
-    editor_state_.draw_mode = std::make_unique<sbox::editor::DrawMode>();
-    editor_state_.erase_mode = std::make_unique<sbox::editor::EraseMode>();
-    editor_state_.measure_mode = std::make_unique<sbox::editor::MeasureMode>();
-    editor_state_.fragment_mode = std::make_unique<sbox::editor::FragmentMode>(&editor_state_.fragment_library);
-    editor_state_.select_mode->set_context_menu_state(&editor_state_.context_menu);
+    if (!headless_) {
+        editor_state_.select_mode = std::make_unique<sbox::editor::SelectMode>();
+        editor_state_.draw_mode = std::make_unique<sbox::editor::DrawMode>();
+        editor_state_.erase_mode = std::make_unique<sbox::editor::EraseMode>();
+        editor_state_.measure_mode = std::make_unique<sbox::editor::MeasureMode>();
+        editor_state_.fragment_mode = std::make_unique<sbox::editor::FragmentMode>(&editor_state_.fragment_library);
+        editor_state_.select_mode->set_context_menu_state(&editor_state_.context_menu);
+        editor_state_.attach_spatial_index();
+    }
 
     state_.iso_value = settings.default_iso_value;
     state_.gamma = settings.default_gamma;
+    result_volumes_.set_resolution(settings.cube_resolution);
     state_.mol_render_mode = settings.mol_render_mode;
     state_.color_mode = settings.color_mode;
     state_.computation.method = static_cast<sbox::backend::Method>(std::clamp(settings.default_method, 0, static_cast<int>(sbox::backend::Method::GFN_FF)));
@@ -552,26 +600,21 @@ App::App() {
     state_.computation.multiplicity = settings.default_multiplicity;
     sbox::render::set_atom_radius_scale(settings.atom_scale);
     sbox::render::set_bond_radius_scale(settings.bond_scale);
-    if (!settings.python_path.empty()) {
-        python_env_.set_python_path(settings.python_path);
-        python_env_.detect();
-        python_env_.check_packages();
-        backend_.init(python_env_);
-    }
-
     ui::set_about_dialog_context(&python_env_);
-    if (settings.check_for_updates) {
+    if (settings.check_for_updates && !headless_) {
         update_checker_ = std::make_unique<sbox::UpdateChecker>("Manav02012002/SchrodingersSandbox");
         update_checker_->check_async();
     }
 
-    initImGui();
+    if (!headless_) {
+        initImGui();
+    }
     ensureViewportTarget(viewport_width_, viewport_height_);
     state_.current_rendering_mode = "Rendering: Forward";
 }
 
 App::~App() {
-    if (window_ != nullptr) {
+    if (window_ != nullptr && !headless_) {
         int win_w = settings_manager_.settings().window_width;
         int win_h = settings_manager_.settings().window_height;
         glfwGetWindowSize(window_->handle(), &win_w, &win_h);
@@ -589,10 +632,13 @@ App::~App() {
         settings_manager_.settings().mol_render_mode = state_.mol_render_mode;
         settings_manager_.settings().color_mode = state_.color_mode;
     }
-    settings_manager_.save();
-
-    shutdownImGui();
+    if (!headless_) {
+        settings_manager_.save();
+        shutdownImGui();
+    }
 
+    ui::release_export_dialog();
+    raymarch_target_.release();
     if (fullscreen_vao_ != 0U) {
         glDeleteVertexArrays(1, &fullscreen_vao_);
         fullscreen_vao_ = 0;
@@ -625,7 +671,12 @@ void App::run() {
     static bool dock_layout_built = false;
 
     while (!window_->shouldClose()) {
-        window_->pollEvents();
+        const double wait_seconds = redraw_.wait_timeout(glfwGetTime());
+        if (wait_seconds > 0.0) {
+            window_->waitEvents(wait_seconds);
+        } else {
+            window_->pollEvents();
+        }
         ++update_poll_frame_counter_;
         if (update_checker_ && update_poll_frame_counter_ % 60 == 0) {
             const std::optional<sbox::UpdateInfo> result = update_checker_->get_result();
@@ -638,11 +689,23 @@ void App::run() {
             }
         }
 
+        try {
+            if (std::optional<sbox::io::LoadedFile> loaded = file_loader_.take()) {
+                applyLoadedFile(*loaded);
+                redraw_.invalidate();
+            }
+        } catch (const std::exception& ex) {
+            SBOX_LOG_ERROR("Failed to load file: %s", ex.what());
+        }
+
         const std::vector<int> completed_jobs = backend_.poll_completed();
+        if (!completed_jobs.empty()) {
+            redraw_.invalidate();
+        }
         for (int job_id : completed_jobs) {
-            const sbox::backend::JobResult* job_result = backend_.result(job_id);
+            const sbox::backend::JobResultHandle job_result = backend_.result(job_id);
             if (job_id == state_.solvent.gas_job_id && job_result != nullptr) {
-                state_.solvent.gas_result = *job_result;
+                state_.solvent.gas_result = job_result;
                 state_.solvent.gas_done = true;
                 continue;
             }
@@ -658,12 +721,27 @@ void App::run() {
                 }
                 continue;
             }
+            if (job_id == state_.ensemble.job_id && job_result != nullptr) {
+                state_.ensemble.running = false;
+                state_.ensemble.complete = job_result->has_ensemble;
+                state_.ensemble.members = job_result->ensemble;
+                state_.ensemble.error = job_result->error_message;
+                if (state_.ensemble.frames == current_trajectory_.num_frames()) {
+                    for (const auto& member : job_result->ensemble) {
+                        if (member.success && member.index >= 0 && member.index < current_trajectory_.num_frames()) {
+                            current_trajectory_.frames[static_cast<std::size_t>(member.index)].energy = member.energy;
+                        }
+                    }
+                }
+                continue;
+            }
             if (job_id == state_.solvent.solvent_job_id && job_result != nullptr) {
-                state_.solvent.solvent_result = *job_result;
+                state_.solvent.solvent_result = job_result;
                 state_.solvent.solvent_done = true;
-                if (state_.solvent.gas_done && state_.solvent.solvent_result.converged() && state_.solvent.gas_result.converged()) {
-                    const auto& solvent = state_.solvent.solvent_result;
-                    const auto& gas = state_.solvent.gas_result;
+                if (state_.solvent.gas_done && state_.solvent.gas_result != nullptr
+                    && state_.solvent.solvent_result->converged() && state_.solvent.gas_result->converged()) {
+                    const auto& solvent = *state_.solvent.solvent_result;
+                    const auto& gas = *state_.solvent.gas_result;
                     const auto& opt = state_.solvent.selected_solvent_index;
                     const std::array<std::pair<const char*, double>, 10> solvents = {{
                         {"Gas Phase", 1.0}, {"Water", 78.4}, {"DMSO", 46.7}, {"Acetonitrile", 35.7},
@@ -688,7 +766,9 @@ void App::run() {
             state_.computation.job_completed = true;
             state_.computation.last_progress_iteration = 0;
             if (job_result != nullptr) {
-                latest_result_ = *job_result;
+                latest_result_ = job_result;
+                ++color_revision_;
+                result_volumes_.reset(job_result);
                 state_.computation.last_error = job_result->error_message;
                 if (job_result->status == sbox::backend::JobStatus::Converged) {
                     try {
@@ -712,6 +792,8 @@ void App::run() {
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
+        pollPythonProbe();
+        updateOrbitalBake();
         const bool wizard_active = ui::draw_setup_wizard(wizard_state_, python_env_);
         backend_.init(python_env_);
         (void)wizard_active;
@@ -721,6 +803,7 @@ void App::run() {
                 if (ImGui::MenuItem("New Molecule")) {
                     current_molecule_.clear();
                     current_pdb_data_ = sbox::io::PDBData{};
+                    ++color_revision_;
                     current_molecule_.set_name("Untitled");
                     editor_state_.commands.clear();
                     editor_state_.selection.clear();
@@ -737,7 +820,7 @@ void App::run() {
                     try {
                         const std::string path = ui::open_file_dialog("Open Molden File", "molden");
                         if (!path.empty()) {
-                            loadMoldenFile(path);
+                            openFileAsync(path, sbox::io::FileKind::Molden);
                         }
                     } catch (const std::exception& ex) {
                         SBOX_LOG_ERROR("Failed to load Molden file: %s", ex.what());
@@ -747,7 +830,7 @@ void App::run() {
                     try {
                         const std::string path = ui::open_file_dialog("Open XYZ File", "xyz");
                         if (!path.empty()) {
-                            loadXYZFile(path);
+                            openFileAsync(path, sbox::io::FileKind::XYZ);
                         }
                     } catch (const std::exception& ex) {
                         SBOX_LOG_ERROR("Failed to load XYZ file: %s", ex.what());
@@ -757,7 +840,7 @@ void App::run() {
                     try {
                         const std::string path = ui::open_file_dialog("Open Trajectory File", "xyz");
                         if (!path.empty()) {
-                            loadTrajectoryFile(path);
+                            openFileAsync(path, sbox::io::FileKind::Trajectory);
                         }
                     } catch (const std::exception& ex) {
                         SBOX_LOG_ERROR("Failed to load trajectory file: %s", ex.what());
@@ -767,7 +850,7 @@ void App::run() {
                     try {
                         const std::string path = ui::open_file_dialog("Open SDF File", "sdf,mol");
                         if (!path.empty()) {
-                            loadSDFFile(path);
+                            openFileAsync(path, sbox::io::FileKind::SDF);
                         }
                     } catch (const std::exception& ex) {
                         SBOX_LOG_ERROR("Failed to load SDF file: %s", ex.what());
@@ -777,7 +860,7 @@ void App::run() {
                     try {
                         const std::string path = ui::open_file_dialog("Open PDB File", "pdb,ent");
                         if (!path.empty()) {
-                            loadPDBFile(path);
+                            openFileAsync(path, sbox::io::FileKind::PDB);
                         }
                     } catch (const std::exception& ex) {
                         SBOX_LOG_ERROR("Failed to load PDB file: %s", ex.what());
@@ -787,7 +870,7 @@ void App::run() {
                     try {
                         const std::string path = ui::open_file_dialog("Open Cube File", "cube");
                         if (!path.empty()) {
-                            loadCubeFile(path);
+                            openFileAsync(path, sbox::io::FileKind::Cube);
                         }
                     } catch (const std::exception& ex) {
                         SBOX_LOG_ERROR("Failed to load Cube file: %s", ex.what());
@@ -797,7 +880,7 @@ void App::run() {
                     try {
                         const std::string path = ui::open_file_dialog("Open FCHK File", "fchk,fch");
                         if (!path.empty()) {
-                            loadFchkFile(path);
+                            openFileAsync(path, sbox::io::FileKind::Fchk);
                         }
                     } catch (const std::exception& ex) {
                         SBOX_LOG_ERROR("Failed to load FCHK file: %s", ex.what());
@@ -840,6 +923,19 @@ void App::run() {
                             ensureViewportTarget(viewport_width_, viewport_height_);
                         }
                     }
+                    if (ImGui::MenuItem("Poster 16K (15360x8640, PNG)")) {
+                        const std::string path = ui::save_file_dialog("Save Screenshot", "png", "SchrodingersSandbox_16k.png");
+                        if (!path.empty()) {
+                            if (sbox::render::save_screenshot_tiled(path, 15360, 8640, [this](unsigned int fbo, const sbox::render::RenderTile& tile) {
+                                    render_tile_to_fbo(fbo, tile);
+                                })) {
+                                SBOX_LOG_INFO("16K screenshot saved to %s", path.c_str());
+                            } else {
+                                SBOX_LOG_ERROR("Failed to save 16K screenshot to %s", path.c_str());
+                            }
+                            ensureViewportTarget(viewport_width_, viewport_height_);
+                        }
+                    }
                     if (ImGui::MenuItem("Transparent Background (PNG)")) {
                         const std::string path = ui::save_file_dialog("Save Screenshot", "png", "SchrodingersSandbox_transparent.png");
                         if (!path.empty()) {
@@ -862,7 +958,7 @@ void App::run() {
                         const std::string filename = std::filesystem::path(path).filename().string();
                         if (ImGui::MenuItem(filename.c_str())) {
                             try {
-                                load_file_by_extension(path);
+                                openFileAsync(path, sbox::io::file_kind_from_path(path));
                             } catch (const std::exception& ex) {
                                 SBOX_LOG_ERROR("Failed to load recent file: %s", ex.what());
                             }
@@ -926,6 +1022,10 @@ void App::run() {
                     const ImGuiID reset_dockspace_id = ImGui::GetID("MainDockSpace");
                     ImGui::DockBuilderRemoveNode(reset_dockspace_id);
                 }
+                ImGui::Separator();
+                if (ImGui::MenuItem("Backend Telemetry", nullptr, state_.show_backend_telemetry)) {
+                    state_.show_backend_telemetry = !state_.show_backend_telemetry;
+                }
                 ImGui::EndMenu();
             }
 
@@ -1042,7 +1142,12 @@ void App::run() {
 
         ui::draw_about_dialog(show_about_);
         ui::draw_shortcuts_dialog(show_shortcuts_);
+        const bool was_exporting = ui::export_in_progress();
         ui::draw_export_dialog(show_export_dialog_, *this);
+        if (was_exporting && !ui::export_in_progress()) {
+            // The export put back the camera and molecule it rendered over.
+            redraw_.invalidate();
+        }
         if (pending_update_.has_value() && show_update_dialog_) {
             draw_update_dialog(show_update_dialog_, *pending_update_, settings_manager_);
         }
@@ -1134,7 +1239,7 @@ void App::run() {
             ui::draw_properties(state_);
         }
         if (state_.view_mode == ui::ViewMode::MolecularOrbital && has_mo_data_ &&
-            (!latest_result_.has_value() || !latest_result_->has_mo_data)) {
+            (!latest_result_ || !latest_result_->has_mo_data)) {
             ui::draw_mo_diagram(state_, current_mo_data_);
         } else {
             if (state_.view_mode != ui::ViewMode::MolecularOrbital) {
@@ -1143,15 +1248,26 @@ void App::run() {
         }
         ui::draw_computation_panel(state_, backend_);
         ui::draw_pes_panel(state_, backend_, current_molecule_, editor_state_.selection);
+        if (has_trajectory_) {
+            ui::draw_ensemble_panel(state_, backend_, current_trajectory_);
+        }
+        if (state_.ensemble.show_frame_requested >= 0) {
+            showTrajectoryFrame(state_.ensemble.show_frame_requested);
+            state_.ensemble.show_frame_requested = -1;
+        }
         ui::draw_solvent_panel(state_, backend_);
         if (state_.show_spectrochemical) {
             ui::draw_spectrochemical_panel(state_, backend_, ligand_library_);
         }
-        if (latest_result_.has_value() && (!latest_result_->opt_history.empty() || state_.computation.job_running)) {
-            ui::draw_optimization_panel(state_, *latest_result_, current_molecule_, mol_renderer_);
+        if (state_.show_backend_telemetry) {
+            ui::draw_backend_telemetry_panel(state_, backend_);
         }
-        if (latest_result_.has_value() && latest_result_->converged()) {
-            ui::draw_results_panel(state_, *latest_result_, current_molecule_);
+        drawFileLoadProgress();
+        if (latest_result_ && (!latest_result_->opt_history.empty() || state_.computation.job_running)) {
+            ui::draw_optimization_panel(state_, *latest_result_, current_molecule_, [this] { uploadCurrentMoleculeToRenderers(); });
+        }
+        if (latest_result_ && latest_result_->converged()) {
+            ui::draw_results_panel(state_, *latest_result_, current_molecule_, result_volumes_);
             ui::draw_nci_panel(state_, *latest_result_);
             if (has_d_orbital_analysis_) {
                 ui::draw_crystal_field_panel(state_, *latest_result_, current_molecule_);
@@ -1187,10 +1303,14 @@ void App::run() {
             }
         }
 
-        if (state_.nci_compute_requested && latest_result_.has_value() && latest_result_->has_density_cube) {
+        if (state_.nci_compute_requested && latest_result_ && result_volumes_.has_density()) {
             state_.nci_compute_requested = false;
             try {
-                nci_grid_ = sbox::analysis::compute_nci(latest_result_->density_cube,
+                const sbox::backend::VolumeCache::Volume density = result_volumes_.density();
+                if (!density) {
+                    throw std::runtime_error("No electron density available for NCI analysis");
+                }
+                nci_grid_ = sbox::analysis::compute_nci(*density,
                                                         std::max(0.5f, state_.nci_rdg_iso),
                                                         state_.nci_rho_cutoff);
                 const auto& grid = *nci_grid_;
@@ -1261,8 +1381,13 @@ void App::run() {
                 sbox::backend::JobSpec solv_spec = gas_spec;
                 solv_spec.solvent = solvent_values[static_cast<std::size_t>(std::clamp(state_.solvent.selected_solvent_index, 0, 9))];
 
-                state_.solvent.gas_job_id = backend_.submit(gas_spec);
-                state_.solvent.solvent_job_id = backend_.submit(solv_spec);
+                sbox::backend::JobGraph graph;
+                const int gas_node = graph.add(gas_spec);
+                const int solvent_node = graph.add(solv_spec);
+                graph.connect(gas_node, solvent_node, sbox::backend::JobDependency::Kind::OrbitalsFrom);
+                const std::vector<int> job_ids = backend_.submit_graph(graph);
+                state_.solvent.gas_job_id = job_ids[static_cast<std::size_t>(gas_node)];
+                state_.solvent.solvent_job_id = job_ids[static_cast<std::size_t>(solvent_node)];
                 state_.solvent.gas_done = false;
                 state_.solvent.solvent_done = false;
             } catch (const std::exception& ex) {
@@ -1272,7 +1397,7 @@ void App::run() {
 
         if (state_.computation.apply_results_requested) {
             state_.computation.apply_results_requested = false;
-            if (const sbox::backend::JobResult* job_result = backend_.result(state_.computation.active_job_id)) {
+            if (const sbox::backend::JobResultHandle job_result = backend_.result(state_.computation.active_job_id)) {
                 applyBackendResult(*job_result);
             }
         }
@@ -1304,8 +1429,10 @@ void App::run() {
             if (mode != nullptr) {
                 if (ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
                     if (editor_state_.current_mode == ui::EditorState::Mode::Select) {
-                        const sbox::editor::PickResult hit = sbox::editor::pick(ray, current_molecule_);
-                        editor_consuming_left_drag_ = (hit.type != sbox::editor::PickResult::Type::None);
+                        const sbox::editor::PickResult hit =
+                            sbox::editor::pick(ray, current_molecule_, &editor_state_.spatial_index);
+                        // Shift-drag on empty space is a box selection rather than an orbit.
+                        editor_consuming_left_drag_ = hit.type != sbox::editor::PickResult::Type::None || shift;
                     } else {
                         editor_consuming_left_drag_ = true;
                     }
@@ -1326,6 +1453,13 @@ void App::run() {
                 const bool dragging = ImGui::IsMouseDown(ImGuiMouseButton_Left);
                 const ImVec2 delta = ImGui::GetIO().MouseDelta;
                 mode->on_mouse_move(ray, delta.x, delta.y, dragging, current_molecule_, editor_state_.selection, editor_state_.commands);
+                const std::vector<int>& moving_atoms = mode->moving_atoms();
+                if (dragging && editor_consuming_left_drag_ && !moving_atoms.empty()) {
+                    editor_state_.spatial_index.refit_atoms(current_molecule_, moving_atoms);
+                    // Only the dragged atoms and their bonds are re-sent, so the structure follows the cursor;
+                    // the LOD path draws from the same buffers.
+                    mol_renderer_.update_atoms(current_molecule_, moving_atoms);
+                }
 
                 struct KeyMap { ImGuiKey imgui; int glfw; };
                 const std::array<KeyMap, 11> keys = {{
@@ -1471,7 +1605,7 @@ void App::run() {
 
         if ((state_.show_charges || state_.show_bond_orders || state_.show_dipole) &&
             state_.computation.active_job_id >= 0) {
-            if (const sbox::backend::JobResult* job_result = backend_.result(state_.computation.active_job_id)) {
+            if (const sbox::backend::JobResultHandle job_result = backend_.result(state_.computation.active_job_id)) {
                 const Eigen::Matrix4f view = camera_.viewMatrix();
                 const Eigen::Matrix4f proj = camera_.projectionMatrix();
                 if (state_.show_charges && !job_result->mulliken_charges.empty()) {
@@ -1539,10 +1673,21 @@ void App::run() {
 
         if (state_.view_mode == ui::ViewMode::AtomicOrbital && state_.needs_update) {
             state_.update();
+            redraw_.invalidate();
         }
-        updateMaxDensityEstimate();
 
-        renderViewportToTexture();
+        ui::RedrawScheduler::FrameActivity activity;
+        activity.scene_input = frame_has_scene_input(viewport_state.hovered) || ImGui::IsAnyItemActive();
+        activity.ui_input = activity.scene_input || mouse_delta.x != 0.0f || mouse_delta.y != 0.0f;
+        activity.animating = raymarch_refining_ || state_.optimization_player.playing ||
+                             state_.reaction_path.player.playing || ui::export_in_progress();
+        activity.background_work = backend_.has_running_jobs() || file_loader_.busy() || mo_bake_.valid();
+        activity.text_input = ImGui::GetIO().WantTextInput;
+        // Otherwise the viewport texture still holds the last frame, and ImGui presents it again.
+        if (redraw_.update(activity, glfwGetTime())) {
+            updateMaxDensityEstimate();
+            renderViewportToTexture(true);
+        }
 
         ImGui::Render();
 
@@ -1693,6 +1838,7 @@ void App::ensureViewportTarget(int width, int height) {
 
     viewport_width_ = width;
     viewport_height_ = height;
+    redraw_.invalidate();
 
     if (viewport_fbo_ == 0U) {
         glGenFramebuffers(1, &viewport_fbo_);
@@ -1807,7 +1953,7 @@ void App::apply_settings() {
     }
 
     if (python_env_.is_valid()) {
-        python_env_.check_packages();
+        python_env_.save_cache(python_env_cache_path());
         backend_.init(python_env_);
     }
 
@@ -1817,28 +1963,134 @@ void App::apply_settings() {
     settings_manager_.save();
 }
 
+void App::startPythonProbe(const std::string& preferred_path) {
+    python_probe_from_ = python_env_.info().python_path;
+    // A detached thread rather than std::async: the future of std::async would block App's shutdown
+    // until a slow or hung interpreter timed out. The thread only touches its own state.
+    std::promise<sbox::backend::PythonInfo> result;
+    python_probe_ = result.get_future();
+    std::thread([preferred_path, result = std::move(result)]() mutable {
+        sbox::backend::PythonEnvironment probe;
+        if (!preferred_path.empty()) {
+            probe.set_python_path(preferred_path);
+        }
+        if (!probe.is_valid()) {
+            probe.detect();
+        }
+        result.set_value(probe.info());
+    }).detach();
+}
+
+void App::pollPythonProbe() {
+    if (!python_probe_.valid() || python_probe_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+
+    const sbox::backend::PythonInfo info = python_probe_.get();
+    // The settings panel and setup wizard switch interpreters directly on python_env_; if the user picked
+    // another one while the probe ran, their choice wins.
+    const std::string& current_path = python_env_.info().python_path;
+    if (current_path != python_probe_from_ && current_path != info.python_path) {
+        return;
+    }
+    python_env_.set_info(info);
+    python_env_.save_cache(python_env_cache_path());
+    backend_.init(python_env_);
+    if (!python_env_.has_pyscf() && !python_env_.has_tblite()) {
+        wizard_state_.show_wizard = true;
+    }
+}
+
+void App::updateOrbitalBake() {
+    if (mo_bake_.valid() && mo_bake_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        baked_mo_valid_ = false;
+        try {
+            const sbox::io::CubeData cube = mo_bake_.get();
+            baked_mo_valid_ = baked_mo_texture_.upload(cube);
+            redraw_.invalidate();
+        } catch (const std::exception& ex) {
+            if (pending_mo_key_[0] == kTotalDensityBake) {
+                SBOX_LOG_ERROR("Failed to bake total density: %s", ex.what());
+            } else {
+                SBOX_LOG_ERROR("Failed to bake orbital %d: %s", pending_mo_key_[0] + 1, ex.what());
+            }
+        }
+        // A failed bake is remembered too, so it falls back to the analytic path instead of retrying every frame.
+        baked_mo_key_ = pending_mo_key_;
+    }
+
+    const sbox::Settings& settings = settings_manager_.settings();
+    const bool total_density = state_.show_total_density;
+    if (mo_bake_.valid() || !(settings.bake_orbitals || total_density) || !has_mo_data_ || use_cube_fallback_) {
+        return;
+    }
+    const int target = bakeTarget();
+    if ((!total_density && (target < 0 || target >= current_mo_data_.coefficients.cols()))
+        || current_mo_data_.atom_positions.empty()) {
+        return;
+    }
+    const std::array<int, 3> wanted{target, settings.cube_resolution, mo_data_generation_};
+    if (wanted == baked_mo_key_) {
+        return;
+    }
+
+    pending_mo_key_ = wanted;
+    mo_bake_ = std::async(std::launch::async, [mo_data = current_mo_data_, target, resolution = settings.cube_resolution]() {
+        const sbox::analysis::VolumeGrid grid = sbox::analysis::fit_volume_grid(mo_data.atom_positions, resolution);
+        if (target != kTotalDensityBake) {
+            return sbox::analysis::evaluate_orbital_volume(mo_data, target, grid);
+        }
+        // The cube ray marcher squares what it samples, so the density is stored as sqrt(rho).
+        sbox::io::CubeData cube = sbox::analysis::evaluate_density_volume(mo_data, grid);
+        for (float& value : cube.data) {
+            value = std::sqrt(std::max(value, 0.0f));
+        }
+        return cube;
+    });
+}
+
+int App::bakeTarget() const {
+    if (state_.show_total_density) {
+        return kTotalDensityBake;
+    }
+    return state_.selected_mo >= 0 ? state_.selected_mo : find_homo_index();
+}
+
+bool App::bakedOrbitalReady() const {
+    // An older bake at another resolution keeps being shown until its replacement lands.
+    return (settings_manager_.settings().bake_orbitals || state_.show_total_density) && baked_mo_valid_
+        && baked_mo_key_[0] == bakeTarget() && baked_mo_key_[2] == mo_data_generation_;
+}
+
 void App::applyMOData(const sbox::basis::MOData& mo_data, const std::string& name_hint) {
+    sbox::chem::MolecularSystem molecule;
+    molecule.set_name(name_hint);
+    const std::size_t atom_count = std::min(mo_data.atom_positions.size(), mo_data.atomic_numbers.size());
+    for (std::size_t i = 0; i < atom_count; ++i) {
+        molecule.add_atom({mo_data.atomic_numbers[i], mo_data.atom_positions[i], "", 0});
+    }
+    molecule.perceive_bonds();
+    applyMOData(mo_data, std::move(molecule));
+}
+
+void App::applyMOData(const sbox::basis::MOData& mo_data, sbox::chem::MolecularSystem molecule) {
     current_mo_data_ = mo_data;
     nci_grid_.reset();
     state_.show_nci = false;
     state_.nci_plot_rdg.clear();
     state_.nci_plot_sign_rho.clear();
     state_.nci_compute_requested = false;
-    current_molecule_.clear();
+    current_molecule_ = std::move(molecule);
     current_pdb_data_ = sbox::io::PDBData{};
-    current_molecule_.set_name(name_hint);
-
-    const std::size_t atom_count = std::min(current_mo_data_.atom_positions.size(), current_mo_data_.atomic_numbers.size());
-    for (std::size_t i = 0; i < atom_count; ++i) {
-        current_molecule_.add_atom({current_mo_data_.atomic_numbers[i], current_mo_data_.atom_positions[i], "", 0});
-    }
+    ++color_revision_;
     current_molecule_.set_charge(state_.computation.charge);
     current_molecule_.set_multiplicity(state_.computation.multiplicity);
-    current_molecule_.perceive_bonds();
     uploadCurrentMoleculeToRenderers();
 
     use_cube_fallback_ = !basis_textures_.upload(current_mo_data_);
     has_mo_data_ = !use_cube_fallback_;
+    orbital_bricks_mo_ = -1;
+    ++mo_data_generation_;
     has_cube_data_ = false;
     state_.molecule_loaded = current_molecule_.num_atoms() > 0;
     state_.mol_has_mo_summary = true;
@@ -1868,6 +2120,7 @@ void App::applyBackendResult(const sbox::backend::JobResult& result) {
     if (result.has_optimized_geometry) {
         current_molecule_ = result.optimized_geometry;
         current_pdb_data_ = sbox::io::PDBData{};
+        ++color_revision_;
         uploadCurrentMoleculeToRenderers();
         state_.molecule_loaded = current_molecule_.num_atoms() > 0;
         state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
@@ -1883,15 +2136,17 @@ void App::applyBackendResult(const sbox::backend::JobResult& result) {
     }
 
     if (result.has_homo_cube) {
-        if (!volume_texture_.upload(result.homo_cube)) {
+        const sbox::io::CubeData& cube = *result.homo_cube;
+        if (!volume_texture_.upload(cube)) {
             throw std::runtime_error("Failed to upload HOMO cube result");
         }
         current_molecule_.clear();
-        for (std::size_t i = 0; i < result.homo_cube.atom_Z.size() && i < result.homo_cube.atom_pos.size(); ++i) {
-            current_molecule_.add_atom({result.homo_cube.atom_Z[i], result.homo_cube.atom_pos[i], "", 0});
+        for (std::size_t i = 0; i < cube.atom_Z.size() && i < cube.atom_pos.size(); ++i) {
+            current_molecule_.add_atom({cube.atom_Z[i], cube.atom_pos[i], "", 0});
         }
         current_molecule_.perceive_bonds();
         current_pdb_data_ = sbox::io::PDBData{};
+        ++color_revision_;
         uploadCurrentMoleculeToRenderers();
         has_cube_data_ = true;
         has_mo_data_ = false;
@@ -1904,15 +2159,17 @@ void App::applyBackendResult(const sbox::backend::JobResult& result) {
     }
 
     if (result.has_density_cube) {
-        if (!volume_texture_.upload(result.density_cube)) {
+        const sbox::io::CubeData& cube = *result.density_cube;
+        if (!volume_texture_.upload(cube)) {
             throw std::runtime_error("Failed to upload density cube result");
         }
         current_molecule_.clear();
-        for (std::size_t i = 0; i < result.density_cube.atom_Z.size() && i < result.density_cube.atom_pos.size(); ++i) {
-            current_molecule_.add_atom({result.density_cube.atom_Z[i], result.density_cube.atom_pos[i], "", 0});
+        for (std::size_t i = 0; i < cube.atom_Z.size() && i < cube.atom_pos.size(); ++i) {
+            current_molecule_.add_atom({cube.atom_Z[i], cube.atom_pos[i], "", 0});
         }
         current_molecule_.perceive_bonds();
         current_pdb_data_ = sbox::io::PDBData{};
+        ++color_revision_;
         uploadCurrentMoleculeToRenderers();
         has_cube_data_ = true;
         has_mo_data_ = false;
@@ -1929,7 +2186,7 @@ void App::applyBackendResult(const sbox::backend::JobResult& result) {
 
 void App::loadESPSurface(const sbox::backend::JobResult& result) {
     if (result.has_density_cube && result.has_esp_cube) {
-        esp_surface_.upload(result.density_cube, result.esp_cube);
+        esp_surface_.upload(*result.density_cube, *result.esp_cube);
     }
 }
 
@@ -1975,7 +2232,7 @@ void App::run_crystal_field_analysis() {
         }
     }
 
-    if ((!latest_result_.has_value() || !latest_result_->has_mo_data) && current_mo_data_.coefficients.cols() == 0) {
+    if ((!latest_result_ || !latest_result_->has_mo_data) && current_mo_data_.coefficients.cols() == 0) {
         has_d_orbital_analysis_ = false;
         message_popup_title_ = "Crystal Field Analysis";
         message_popup_text_ = "Run a calculation first (HF, DFT, or xTB).";
@@ -1984,7 +2241,7 @@ void App::run_crystal_field_analysis() {
     }
 
     const sbox::basis::MOData& mo_data =
-        (latest_result_.has_value() && latest_result_->has_mo_data) ? latest_result_->mo_data : current_mo_data_;
+        (latest_result_ && latest_result_->has_mo_data) ? latest_result_->mo_data : current_mo_data_;
     current_d_orbitals_ = sbox::analysis::extract_d_orbitals(mo_data, current_molecule_, current_metal_index_);
     const sbox::chem::CoordinationGeometry geometry =
         sbox::chem::detect_coordination_geometry(current_molecule_, current_metal_index_);
@@ -2013,17 +2270,31 @@ sbox::backend::JobSpec App::makeJobSpecFromState() const {
         sbox::backend::PropertyRequest::DipoleMoment,
     };
 
-    if (sbox::backend::method_is_xtb(spec.method)) {
-        spec.properties.push_back(sbox::backend::PropertyRequest::MoldenFile);
-    } else {
-        spec.properties.push_back(sbox::backend::PropertyRequest::MoldenFile);
-        spec.properties.push_back(sbox::backend::PropertyRequest::CubeHOMO);
-        spec.properties.push_back(sbox::backend::PropertyRequest::CubeLUMO);
-    }
+    // HOMO/LUMO and density volumes are generated from these orbitals on demand (VolumeCache).
+    spec.properties.push_back(sbox::backend::PropertyRequest::MoldenFile);
+    spec.cube_resolution = settings_manager_.settings().cube_resolution;
 
     if (spec.optimize_geometry) {
         spec.properties.push_back(sbox::backend::PropertyRequest::Optimization);
     }
+
+    // Re-running the same molecule (e.g. after a small geometry edit) starts from the last converged orbitals.
+    if (latest_result_ && latest_result_->status == sbox::backend::JobStatus::Converged
+        && !latest_result_->scf_checkpoint.empty() && latest_result_->has_mo_data
+        && !sbox::backend::method_is_xtb(spec.method)) {
+        const std::vector<int>& previous_z = latest_result_->mo_data.atomic_numbers;
+        bool same_atoms = static_cast<int>(previous_z.size()) == spec.geometry.num_atoms();
+        int electrons = -spec.charge;
+        for (int i = 0; same_atoms && i < spec.geometry.num_atoms(); ++i) {
+            same_atoms = previous_z[static_cast<std::size_t>(i)] == spec.geometry.atom(i).Z;
+            electrons += spec.geometry.atom(i).Z;
+        }
+        const double previous_electrons = latest_result_->mo_data.occupations.sum();
+        if (same_atoms && std::abs(previous_electrons - static_cast<double>(electrons)) < 0.5) {
+            spec.guess_checkpoint = latest_result_->scf_checkpoint;
+        }
+    }
+
     for (const auto& constraint : state_.constraints) {
         if (!constraint.active) {
             continue;
@@ -2057,258 +2328,117 @@ sbox::backend::JobSpec App::makeJobSpecFromState() const {
     return spec;
 }
 
-void App::loadMoldenFile(const std::string& path) {
-    applyMOData(sbox::molden::parse_molden_file(path), std::filesystem::path(path).filename().string());
-    state_.computation.charge = current_molecule_.charge();
-    state_.computation.multiplicity = current_molecule_.multiplicity();
-    settings_manager_.settings().last_open_directory = std::filesystem::path(path).parent_path().string();
-    settings_manager_.add_recent_file(path);
-}
+void App::applyLoadedFile(sbox::io::LoadedFile& file) {
+    using sbox::io::FileKind;
 
-void App::loadCubeFile(const std::string& path) {
-    const sbox::io::CubeData cube = sbox::io::read_cube(path);
-    nci_grid_.reset();
-    state_.show_nci = false;
-    state_.nci_plot_rdg.clear();
-    state_.nci_plot_sign_rho.clear();
-    state_.nci_compute_requested = false;
-    current_molecule_.clear();
-    current_pdb_data_ = sbox::io::PDBData{};
-    current_molecule_.set_name(std::filesystem::path(path).filename().string());
-    for (std::size_t i = 0; i < cube.atom_Z.size() && i < cube.atom_pos.size(); ++i) {
-        current_molecule_.add_atom({cube.atom_Z[i], cube.atom_pos[i], "", 0});
-    }
-    current_molecule_.perceive_bonds();
-    uploadCurrentMoleculeToRenderers();
+    if (file.kind == FileKind::Molden) {
+        applyMOData(file.mo_data, std::move(file.molecule));
+    } else {
+        nci_grid_.reset();
+        state_.show_nci = false;
+        state_.nci_plot_rdg.clear();
+        state_.nci_plot_sign_rho.clear();
+        state_.nci_compute_requested = false;
+        if (file.kind == FileKind::XYZ || file.kind == FileKind::Project) {
+            current_trajectory_ = sbox::io::Trajectory{};
+            has_trajectory_ = false;
+        }
+        if (file.kind == FileKind::Trajectory) {
+            current_trajectory_ = std::move(file.trajectory);
+            has_trajectory_ = !current_trajectory_.empty();
+            if (state_.ensemble.running) {
+                // Keep the job id so its completion is still routed here, but don't write its energies back.
+                backend_.cancel(state_.ensemble.job_id);
+                state_.ensemble.frames = 0;
+            } else {
+                state_.ensemble = {};
+            }
+            state_.optimization_player = {};
+            state_.optimization_player.total_frames = current_trajectory_.num_frames();
+        }
 
-    if (!volume_texture_.upload(cube)) {
-        throw std::runtime_error("Failed to upload cube volume texture");
-    }
+        current_molecule_ = std::move(file.molecule);
+        current_pdb_data_ = file.kind == FileKind::PDB ? std::move(file.pdb) : sbox::io::PDBData{};
+        ++color_revision_;
+        uploadCurrentMoleculeToRenderers();
 
-    has_cube_data_ = true;
-    use_cube_fallback_ = true;
-    has_mo_data_ = false;
-    state_.molecule_loaded = current_molecule_.num_atoms() > 0;
-    state_.view_mode = ui::ViewMode::MolecularOrbital;
-    state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
-    clear_mo_summary(state_);
-    state_.computation.charge = current_molecule_.charge();
-    state_.computation.multiplicity = current_molecule_.multiplicity();
-    settings_manager_.settings().last_open_directory = std::filesystem::path(path).parent_path().string();
-    settings_manager_.add_recent_file(path);
-}
+        has_cube_data_ = false;
+        use_cube_fallback_ = false;
+        has_mo_data_ = false;
+        if (file.kind != FileKind::Trajectory && file.kind != FileKind::Cube) {
+            current_mo_data_ = sbox::basis::MOData{};
+        }
+        clear_mo_summary(state_);
 
-void App::loadXYZFile(const std::string& path) {
-    nci_grid_.reset();
-    state_.show_nci = false;
-    state_.nci_plot_rdg.clear();
-    state_.nci_plot_sign_rho.clear();
-    state_.nci_compute_requested = false;
-    current_trajectory_ = sbox::io::Trajectory{};
-    has_trajectory_ = false;
-    current_molecule_ = sbox::io::read_xyz(path);
-    current_pdb_data_ = sbox::io::PDBData{};
-    uploadCurrentMoleculeToRenderers();
-    current_mo_data_ = sbox::basis::MOData{};
-    has_mo_data_ = false;
-    has_cube_data_ = false;
-    use_cube_fallback_ = false;
-    state_.molecule_loaded = current_molecule_.num_atoms() > 0;
-    state_.view_mode = ui::ViewMode::MolecularOrbital;
-    state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
-    clear_mo_summary(state_);
-    state_.computation.charge = current_molecule_.charge();
-    state_.computation.multiplicity = current_molecule_.multiplicity();
-    settings_manager_.settings().last_open_directory = std::filesystem::path(path).parent_path().string();
-    settings_manager_.add_recent_file(path);
-}
+        if (file.kind == FileKind::Cube) {
+            if (!volume_texture_.upload(file.cube)) {
+                throw std::runtime_error("Failed to upload cube volume texture");
+            }
+            has_cube_data_ = true;
+            use_cube_fallback_ = true;
+        } else if (file.kind == FileKind::Fchk) {
+            const sbox::io::FchkData& fchk = file.fchk;
+            const std::optional<sbox::basis::MOData> maybe_mo = mo_data_from_fchk(fchk);
+            if (maybe_mo.has_value()) {
+                current_mo_data_ = *maybe_mo;
+                use_cube_fallback_ = !basis_textures_.upload(current_mo_data_);
+                has_mo_data_ = !use_cube_fallback_;
+                orbital_bricks_mo_ = -1;
+                ++mo_data_generation_;
+            }
+            state_.num_mo = static_cast<int>(fchk.mo_energies.size());
+            state_.homo_index = -1;
+            for (int i = 0; i < fchk.occupations.size(); ++i) {
+                if (fchk.occupations(i) > 0.5) {
+                    state_.homo_index = i;
+                }
+            }
+            state_.selected_mo = state_.homo_index;
+            state_.mol_num_basis = fchk.num_basis;
+            state_.mol_total_energy_h = fchk.total_energy;
+            state_.mol_has_mo_summary = true;
+            if (state_.homo_index >= 0 && state_.homo_index + 1 < fchk.mo_energies.size()) {
+                state_.mol_homo_lumo_gap_ev =
+                    (fchk.mo_energies(state_.homo_index + 1) - fchk.mo_energies(state_.homo_index)) * 27.2114;
+            } else {
+                state_.mol_homo_lumo_gap_ev = 0.0;
+            }
+        }
 
-void App::loadTrajectoryFile(const std::string& path) {
-    nci_grid_.reset();
-    state_.show_nci = false;
-    state_.nci_plot_rdg.clear();
-    state_.nci_plot_sign_rho.clear();
-    state_.nci_compute_requested = false;
-    current_trajectory_ = sbox::io::read_trajectory_xyz(path);
-    has_trajectory_ = !current_trajectory_.empty();
-    if (!has_trajectory_) {
-        throw std::runtime_error("Trajectory file did not contain any frames");
+        state_.molecule_loaded = current_molecule_.num_atoms() > 0;
+        state_.view_mode = ui::ViewMode::MolecularOrbital;
+        state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
     }
 
-    current_molecule_ = current_trajectory_.frames.front().geometry;
-    current_molecule_.set_name(std::filesystem::path(path).filename().string());
-    current_pdb_data_ = sbox::io::PDBData{};
-    uploadCurrentMoleculeToRenderers();
-    state_.view_mode = ui::ViewMode::MolecularOrbital;
-    has_mo_data_ = false;
-    has_cube_data_ = false;
-    use_cube_fallback_ = false;
-    clear_mo_summary(state_);
-    state_.molecule_loaded = current_molecule_.num_atoms() > 0;
-    state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
-    state_.computation.charge = current_molecule_.charge();
-    state_.computation.multiplicity = current_molecule_.multiplicity();
-    state_.optimization_player = {};
-    state_.optimization_player.total_frames = current_trajectory_.num_frames();
-    settings_manager_.settings().last_open_directory = std::filesystem::path(path).parent_path().string();
-    settings_manager_.add_recent_file(path);
-}
-
-void App::loadSDFFile(const std::string& path) {
-    nci_grid_.reset();
-    state_.show_nci = false;
-    state_.nci_plot_rdg.clear();
-    state_.nci_plot_sign_rho.clear();
-    state_.nci_compute_requested = false;
-    current_molecule_ = sbox::io::read_sdf(path);
-    current_pdb_data_ = sbox::io::PDBData{};
-    uploadCurrentMoleculeToRenderers();
-    current_mo_data_ = sbox::basis::MOData{};
-    has_mo_data_ = false;
-    has_cube_data_ = false;
-    use_cube_fallback_ = false;
-    state_.molecule_loaded = current_molecule_.num_atoms() > 0;
-    state_.view_mode = ui::ViewMode::MolecularOrbital;
-    state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
-    clear_mo_summary(state_);
-    state_.computation.charge = current_molecule_.charge();
-    state_.computation.multiplicity = current_molecule_.multiplicity();
-    settings_manager_.settings().last_open_directory = std::filesystem::path(path).parent_path().string();
-    settings_manager_.add_recent_file(path);
-}
-
-void App::loadPDBFile(const std::string& path) {
-    nci_grid_.reset();
-    state_.show_nci = false;
-    state_.nci_plot_rdg.clear();
-    state_.nci_plot_sign_rho.clear();
-    state_.nci_compute_requested = false;
-    current_pdb_data_ = sbox::io::read_pdb(path);
-    current_molecule_ = current_pdb_data_.to_molecular_system();
-    current_molecule_.set_name(current_pdb_data_.title.empty() ? std::filesystem::path(path).filename().string() : current_pdb_data_.title);
-    uploadCurrentMoleculeToRenderers();
-    current_mo_data_ = sbox::basis::MOData{};
-    has_mo_data_ = false;
-    has_cube_data_ = false;
-    use_cube_fallback_ = false;
-    state_.molecule_loaded = current_molecule_.num_atoms() > 0;
-    state_.view_mode = ui::ViewMode::MolecularOrbital;
-    state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
-    clear_mo_summary(state_);
     state_.computation.charge = current_molecule_.charge();
     state_.computation.multiplicity = current_molecule_.multiplicity();
-    settings_manager_.settings().last_open_directory = std::filesystem::path(path).parent_path().string();
-    settings_manager_.add_recent_file(path);
+    settings_manager_.settings().last_open_directory = std::filesystem::path(file.path).parent_path().string();
+    settings_manager_.add_recent_file(file.path);
 }
 
-void App::loadFchkFile(const std::string& path) {
-    nci_grid_.reset();
-    state_.show_nci = false;
-    state_.nci_plot_rdg.clear();
-    state_.nci_plot_sign_rho.clear();
-    state_.nci_compute_requested = false;
-    const sbox::io::FchkData fchk = sbox::io::read_fchk(path);
-    current_molecule_.clear();
-    current_pdb_data_ = sbox::io::PDBData{};
-    current_molecule_.set_name(fchk.title);
-    current_molecule_.set_charge(fchk.charge);
-    current_molecule_.set_multiplicity(fchk.multiplicity);
-    for (int i = 0; i < fchk.num_atoms; ++i) {
-        current_molecule_.add_atom({fchk.atomic_numbers[static_cast<std::size_t>(i)],
-                                    Eigen::Vector3d(fchk.coordinates[static_cast<std::size_t>(3 * i + 0)],
-                                                    fchk.coordinates[static_cast<std::size_t>(3 * i + 1)],
-                                                    fchk.coordinates[static_cast<std::size_t>(3 * i + 2)]),
-                                    "",
-                                    0});
-    }
-    current_molecule_.perceive_bonds();
-    uploadCurrentMoleculeToRenderers();
-
-    current_mo_data_ = sbox::basis::MOData{};
-    const std::optional<sbox::basis::MOData> maybe_mo = mo_data_from_fchk(fchk);
-    if (maybe_mo.has_value()) {
-        current_mo_data_ = *maybe_mo;
-        use_cube_fallback_ = !basis_textures_.upload(current_mo_data_);
-        has_mo_data_ = !use_cube_fallback_;
-    } else {
-        has_mo_data_ = false;
-        use_cube_fallback_ = false;
+void App::drawFileLoadProgress() {
+    if (!file_loader_.busy()) {
+        return;
     }
-    has_cube_data_ = false;
-    state_.view_mode = ui::ViewMode::MolecularOrbital;
-    state_.molecule_loaded = current_molecule_.num_atoms() > 0;
-    state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
-    state_.num_mo = static_cast<int>(fchk.mo_energies.size());
-    state_.homo_index = -1;
-    for (int i = 0; i < fchk.occupations.size(); ++i) {
-        if (fchk.occupations(i) > 0.5) {
-            state_.homo_index = i;
+    ImGui::SetNextWindowPos(ImGui::GetMainViewport()->GetCenter(), ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+    if (ImGui::Begin("Loading", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse)) {
+        const std::string filename = std::filesystem::path(file_loader_.path()).filename().string();
+        ImGui::TextUnformatted(filename.c_str());
+        ImGui::ProgressBar(static_cast<float>(file_loader_.progress()), ImVec2(280.0f, 0.0f));
+        if (ImGui::Button("Cancel")) {
+            file_loader_.cancel();
         }
     }
-    state_.selected_mo = state_.homo_index;
-    state_.mol_num_basis = fchk.num_basis;
-    state_.mol_total_energy_h = fchk.total_energy;
-    state_.mol_has_mo_summary = true;
-    if (state_.homo_index >= 0 && state_.homo_index + 1 < fchk.mo_energies.size()) {
-        state_.mol_homo_lumo_gap_ev =
-            (fchk.mo_energies(state_.homo_index + 1) - fchk.mo_energies(state_.homo_index)) * 27.2114;
-    } else {
-        state_.mol_homo_lumo_gap_ev = 0.0;
-    }
-    state_.computation.charge = current_molecule_.charge();
-    state_.computation.multiplicity = current_molecule_.multiplicity();
-    settings_manager_.settings().last_open_directory = std::filesystem::path(path).parent_path().string();
-    settings_manager_.add_recent_file(path);
+    ImGui::End();
 }
 
-void App::loadProjectFile(const std::string& path) {
-    nci_grid_.reset();
-    state_.show_nci = false;
-    state_.nci_plot_rdg.clear();
-    state_.nci_plot_sign_rho.clear();
-    state_.nci_compute_requested = false;
-    nlohmann::json extra_state;
-    current_molecule_ = sbox::io::load_project(path, &extra_state);
-    current_pdb_data_ = sbox::io::PDBData{};
-    current_trajectory_ = sbox::io::Trajectory{};
-    has_trajectory_ = false;
-    uploadCurrentMoleculeToRenderers();
-    current_mo_data_ = sbox::basis::MOData{};
-    has_mo_data_ = false;
-    has_cube_data_ = false;
-    use_cube_fallback_ = false;
-    clear_mo_summary(state_);
-    state_.molecule_loaded = current_molecule_.num_atoms() > 0;
-    state_.view_mode = ui::ViewMode::MolecularOrbital;
-    state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
-    state_.computation.charge = current_molecule_.charge();
-    state_.computation.multiplicity = current_molecule_.multiplicity();
-    settings_manager_.settings().last_open_directory = std::filesystem::path(path).parent_path().string();
-    settings_manager_.add_recent_file(path);
+void App::openFileAsync(const std::string& path, sbox::io::FileKind kind) {
+    file_loader_.start(path, kind);
 }
 
 void App::load_file_by_extension(const std::string& path) {
-    std::string ext = std::filesystem::path(path).extension().string();
-    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char ch) {
-        return static_cast<char>(std::tolower(ch));
-    });
-    if (ext == ".xyz") {
-        loadXYZFile(path);
-    } else if (ext == ".sdf" || ext == ".mol") {
-        loadSDFFile(path);
-    } else if (ext == ".molden") {
-        loadMoldenFile(path);
-    } else if (ext == ".cube") {
-        loadCubeFile(path);
-    } else if (ext == ".fchk" || ext == ".fch") {
-        loadFchkFile(path);
-    } else if (ext == ".pdb" || ext == ".ent") {
-        loadPDBFile(path);
-    } else if (ext == ".sbox") {
-        loadProjectFile(path);
-    } else {
-        throw std::runtime_error("Unsupported file type: " + ext);
-    }
+    sbox::io::LoadedFile file = sbox::io::read_file(path, sbox::io::file_kind_from_path(path));
+    applyLoadedFile(file);
 }
 
 float App::computeMaxDensityEstimate() const {
@@ -2317,6 +2447,10 @@ float App::computeMaxDensityEstimate() const {
             const float max_psi = volume_texture_.max_abs_value();
             return std::max(max_psi * max_psi, 1e-6f);
         }
+        if (!use_cube_fallback_ && has_mo_data_ && bakedOrbitalReady()) {
+            const float max_psi = baked_mo_texture_.max_abs_value();
+            return std::max(max_psi * max_psi, 1e-6f);
+        }
 
         if (has_mo_data_ && current_mo_data_.coefficients.cols() > 0) {
             const int mo_index = state_.selected_mo >= 0 ? state_.selected_mo : find_homo_index();
@@ -2406,8 +2540,10 @@ void App::updateMaxDensityEstimate() {
     density_zeff_ = state_.current_Zeff;
 }
 
-void App::renderViewportToTexture() {
+void App::renderViewportToTexture(bool progressive) {
     const sbox::Settings& settings = settings_manager_.settings();
+    progressive_viewport_ = progressive && settings.progressive_raymarch;
+    raymarch_refining_ = false;
     const bool use_deferred =
         state_.view_mode == ui::ViewMode::MolecularOrbital &&
         settings.use_deferred_rendering &&
@@ -2420,11 +2556,19 @@ void App::renderViewportToTexture() {
     } else {
         renderForwardToTarget(viewport_fbo_, viewport_width_, viewport_height_, false);
     }
+    progressive_viewport_ = false;
     update_render_stats_summary(gpu_timing_, state_);
 }
 
 void App::render_single_frame() {
     window_->pollEvents();
+    // No later frame collects an asynchronous bake here, and total density is drawn only from the
+    // bake, so wait for it before rendering.
+    updateOrbitalBake();
+    if (mo_bake_.valid()) {
+        mo_bake_.wait();
+        updateOrbitalBake();
+    }
     updateMaxDensityEstimate();
     renderViewportToTexture();
 }
@@ -2437,6 +2581,12 @@ void App::render_to_fbo(unsigned int fbo, int w, int h, bool transparent_backgro
     renderViewportToTarget(fbo, w, h, transparent_background);
 }
 
+void App::render_tile_to_fbo(unsigned int fbo, const sbox::render::RenderTile& tile, bool transparent_background) {
+    camera_.setProjectionTile(tile.image_width, tile.image_height, tile.x, tile.y, tile.width, tile.height);
+    renderViewportToTarget(fbo, tile.width, tile.height, transparent_background);
+    camera_.clearProjectionTile();
+}
+
 ui::AppState& App::state() {
     return state_;
 }
@@ -2472,12 +2622,26 @@ bool App::has_mo_data() const {
 void App::set_current_molecule_for_export(const sbox::chem::MolecularSystem& mol) {
     current_molecule_ = mol;
     current_pdb_data_ = sbox::io::PDBData{};
+    ++color_revision_;
+    uploadCurrentMoleculeToRenderers();
+    state_.molecule_loaded = current_molecule_.num_atoms() > 0;
+    state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
+}
+
+void App::showTrajectoryFrame(int index) {
+    if (index < 0 || index >= current_trajectory_.num_frames()) {
+        return;
+    }
+    current_molecule_ = current_trajectory_.frames[static_cast<std::size_t>(index)].geometry;
     uploadCurrentMoleculeToRenderers();
     state_.molecule_loaded = current_molecule_.num_atoms() > 0;
     state_.mol_bound_radius = compute_mol_bound_radius(current_molecule_);
 }
 
 void App::renderViewportToTarget(unsigned int fbo, int width, int height, bool transparent_background) {
+    if (fbo == viewport_fbo_) {
+        redraw_.invalidate();  // the screenshot's frame replaces the one the viewport shows
+    }
     const sbox::Settings& settings = settings_manager_.settings();
     const bool use_deferred =
         state_.view_mode == ui::ViewMode::MolecularOrbital &&
@@ -2522,34 +2686,59 @@ void App::renderForwardToTarget(unsigned int fbo, int width, int height, bool tr
             return;
         }
 
-        active_shader->bind();
-        if (orbital_shader_) {
-            active_shader->setUniform("u_n", state_.current_n);
-            active_shader->setUniform("u_l", state_.current_l);
-            active_shader->setUniform("u_m", state_.selected_m);
-            active_shader->setUniform("u_Zeff", state_.current_Zeff);
-            active_shader->setUniform("u_inv_vp", camera_.inv_view_projection());
-            active_shader->setUniform("u_camera_pos", camera_.camera_position());
-            active_shader->setUniform("u_iso_value", state_.iso_value);
-            active_shader->setUniform("u_render_mode", state_.render_mode);
-            active_shader->setUniform("u_gamma", state_.gamma);
-            active_shader->setUniform("u_volume_steps", settings_manager_.settings().volume_steps);
-            active_shader->setUniform("u_isosurface_steps", settings_manager_.settings().isosurface_steps);
+        if (!orbital_shader_) {
+            active_shader->bind();
+            glBindVertexArray(fullscreen_vao_);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            glBindVertexArray(0);
+        } else {
+            const sbox::Settings& settings = settings_manager_.settings();
+            const sbox::render::ProgressiveSchedule::Frame frame =
+                nextRayMarchFrame(sbox::render::ViewKey()
+                                      .add(state_.current_n)
+                                      .add(state_.current_l)
+                                      .add(state_.selected_m)
+                                      .add(state_.current_Zeff)
+                                      .add(camera_.inv_view_projection())
+                                      .add(camera_.camera_position())
+                                      .add(state_.iso_value)
+                                      .add(state_.render_mode)
+                                      .add(state_.gamma)
+                                      .add(max_density_estimate_)
+                                      .add(settings.volume_steps)
+                                      .add(settings.isosurface_steps)
+                                      .value(),
+                                  width,
+                                  height);
+            if (frame.march) {
+                active_shader->bind();
+                active_shader->setUniform("u_n", state_.current_n);
+                active_shader->setUniform("u_l", state_.current_l);
+                active_shader->setUniform("u_m", state_.selected_m);
+                active_shader->setUniform("u_Zeff", state_.current_Zeff);
+                active_shader->setUniform("u_inv_vp", camera_.inv_view_projection());
+                active_shader->setUniform("u_camera_pos", camera_.camera_position());
+                active_shader->setUniform("u_iso_value", state_.iso_value);
+                active_shader->setUniform("u_render_mode", state_.render_mode);
+                active_shader->setUniform("u_gamma", state_.gamma);
+                active_shader->setUniform("u_volume_steps", scaled_steps(settings.volume_steps, frame.step_scale));
+                active_shader->setUniform("u_isosurface_steps", scaled_steps(settings.isosurface_steps, frame.step_scale));
+
+                const int res_loc = glGetUniformLocation(active_shader->id(), "u_resolution");
+                if (res_loc >= 0) {
+                    glUniform2f(res_loc, static_cast<float>(frame.width), static_cast<float>(frame.height));
+                }
 
-            const int res_loc = glGetUniformLocation(active_shader->id(), "u_resolution");
-            if (res_loc >= 0) {
-                glUniform2f(res_loc, static_cast<float>(width), static_cast<float>(height));
+                const int density_loc = glGetUniformLocation(active_shader->id(), "u_max_density");
+                if (density_loc >= 0) {
+                    glUniform1f(density_loc, max_density_estimate_);
+                }
+                drawRayMarch(*active_shader, frame, width, height);
             }
-
-            const int density_loc = glGetUniformLocation(active_shader->id(), "u_max_density");
-            if (density_loc >= 0) {
-                glUniform1f(density_loc, max_density_estimate_);
+            if (progressive_viewport_) {
+                raymarch_target_.composite(fullscreen_vao_);
             }
         }
-
-        glBindVertexArray(fullscreen_vao_);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
-        glBindVertexArray(0);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         camera_.setViewportSize(static_cast<float>(viewport_width_), static_cast<float>(viewport_height_));
         end_gpu_timed_pass(gpu_timing_, App::GpuTimingState::Pass::Orbitals);
@@ -2568,14 +2757,21 @@ void App::renderForwardToTarget(unsigned int fbo, int width, int height, bool tr
 
     if (mol_renderer_.has_data()) {
         if (current_molecule_.num_atoms() > settings_manager_.settings().lod_threshold_atoms) {
+            sbox::editor::SpatialIndex& index = editor_state_.spatial_index;
+            if (!index.matches(current_molecule_)) {
+                index.build(current_molecule_);
+            }
+            lod_visible_atoms_.clear();
+            index.query_frustum(camera_.projectionMatrix() * camera_.viewMatrix(),
+                                sbox::render::LODRenderer::kCullMargin,
+                                lod_visible_atoms_);
             lod_renderer_.render(camera_.viewMatrix(),
                                  camera_.projectionMatrix(),
                                  camera_.camera_position(),
                                  static_cast<sbox::render::MolRenderMode>(state_.mol_render_mode),
                                  current_molecule_,
-                                 static_cast<sbox::render::ColorMode>(state_.color_mode),
-                                 current_pdb_data_.atoms.empty() ? nullptr : &current_pdb_data_,
-                                 current_charges_for_render(latest_result_));
+                                 lod_visible_atoms_,
+                                 mol_renderer_);
             state_.lod_atoms_rendered = lod_renderer_.atoms_rendered();
             state_.lod_atoms_culled = lod_renderer_.atoms_culled();
             state_.lod_bonds_rendered = lod_renderer_.bonds_rendered();
@@ -2794,8 +2990,15 @@ void App::renderOrbitalPass(int width, int height) {
     if (state_.show_esp_surface && esp_surface_.is_uploaded() && esp_shader_) {
         return;
     }
+    const sbox::render::VolumeTexture* volume = nullptr;
     if (use_cube_fallback_ && has_cube_data_ && cube_shader_) {
         active = cube_shader_.get();
+        volume = &volume_texture_;
+    } else if (has_mo_data_ && bakedOrbitalReady() && cube_shader_) {
+        active = cube_shader_.get();
+        volume = &baked_mo_texture_;
+    } else if (has_mo_data_ && state_.show_total_density) {
+        return;  // the density is only drawn from its bake, which is still running
     } else if (has_mo_data_ && mo_shader_) {
         active = mo_shader_.get();
     }
@@ -2803,6 +3006,32 @@ void App::renderOrbitalPass(int width, int height) {
         return;
     }
 
+    const sbox::Settings& settings = settings_manager_.settings();
+    const int mo_idx = state_.selected_mo >= 0 ? state_.selected_mo : find_homo_index();
+    const sbox::render::ProgressiveSchedule::Frame frame =
+        nextRayMarchFrame(sbox::render::ViewKey()
+                              .add(static_cast<const void*>(active))
+                              .add(static_cast<const void*>(volume))
+                              .add(volume != nullptr ? volume->revision() : 0U)
+                              .add(volume == nullptr ? mo_idx : -1)
+                              .add(mo_data_generation_)
+                              .add(camera_.inv_view_projection())
+                              .add(camera_.camera_position())
+                              .add(state_.render_mode)
+                              .add(state_.iso_value)
+                              .add(state_.gamma)
+                              .add(max_density_estimate_)
+                              .add(state_.mol_bound_radius)
+                              .add(settings.volume_steps)
+                              .add(settings.isosurface_steps)
+                              .value(),
+                          width,
+                          height);
+    if (!frame.march) {
+        raymarch_target_.composite(fullscreen_vao_);
+        return;
+    }
+
     active->bind();
     active->setUniform("u_inv_vp", camera_.inv_view_projection());
     active->setUniform("u_camera_pos", camera_.camera_position());
@@ -2811,24 +3040,34 @@ void App::renderOrbitalPass(int width, int height) {
     active->setUniform("u_gamma", state_.gamma);
     active->setUniform("u_max_density", max_density_estimate_);
     active->setUniform("u_bound_radius", state_.mol_bound_radius);
-    active->setUniform("u_volume_steps", settings_manager_.settings().volume_steps);
-    active->setUniform("u_isosurface_steps", settings_manager_.settings().isosurface_steps);
+    active->setUniform("u_volume_steps", scaled_steps(settings.volume_steps, frame.step_scale));
+    active->setUniform("u_isosurface_steps", scaled_steps(settings.isosurface_steps, frame.step_scale));
     const int res_loc = glGetUniformLocation(active->id(), "u_resolution");
     if (res_loc >= 0) {
-        glUniform2f(res_loc, static_cast<float>(width), static_cast<float>(height));
+        glUniform2f(res_loc, static_cast<float>(frame.width), static_cast<float>(frame.height));
     }
 
-    if (!use_cube_fallback_) {
-        const int mo_idx = state_.selected_mo >= 0 ? state_.selected_mo : find_homo_index();
+    if (volume == nullptr) {
         active->setUniform("u_mo_index", mo_idx);
         active->setUniform("u_num_shells", basis_textures_.num_shells());
         active->setUniform("u_num_basis", basis_textures_.num_basis());
         active->setUniform("u_num_mo", basis_textures_.num_mo());
+        basis_textures_.select_mo(mo_idx);
         basis_textures_.bind(active->id(), 1);
+        if (mo_idx != orbital_bricks_mo_ || state_.mol_bound_radius != orbital_bricks_radius_) {
+            if (!orbital_bricks_.upload(sbox::render::build_orbital_bricks(current_mo_data_, mo_idx, state_.mol_bound_radius))) {
+                orbital_bricks_.clear();
+            }
+            orbital_bricks_mo_ = mo_idx;
+            orbital_bricks_radius_ = state_.mol_bound_radius;
+        }
+        // Outside the brick grid the orbital is not known to vanish, so those samples are never skipped.
+        orbital_bricks_.bind(active->id(), 10, std::numeric_limits<float>::max());
     } else {
-        volume_texture_.bind(active->id(), 5);
-        const Eigen::Vector3f orig = volume_texture_.origin();
-        const Eigen::Matrix3f w2g = volume_texture_.world_to_grid();
+        volume->bind(active->id(), 5);
+        volume->bricks().bind(active->id(), 10, 0.0f);
+        const Eigen::Vector3f orig = volume->origin();
+        const Eigen::Matrix3f w2g = volume->world_to_grid();
         const int origin_loc = glGetUniformLocation(active->id(), "u_grid_origin");
         if (origin_loc >= 0) {
             glUniform3f(origin_loc, orig.x(), orig.y(), orig.z());
@@ -2839,17 +3078,54 @@ void App::renderOrbitalPass(int width, int height) {
         }
         const int dims_loc = glGetUniformLocation(active->id(), "u_grid_dims");
         if (dims_loc >= 0) {
-            glUniform3i(dims_loc, volume_texture_.nx(), volume_texture_.ny(), volume_texture_.nz());
+            glUniform3i(dims_loc, volume->nx(), volume->ny(), volume->nz());
         }
     }
 
+    drawRayMarch(*active, frame, width, height);
+    if (volume == nullptr) {
+        orbital_bricks_.unbind();
+        basis_textures_.unbind();
+    } else {
+        volume->bricks().unbind();
+        volume->unbind();
+    }
+    if (progressive_viewport_) {
+        raymarch_target_.composite(fullscreen_vao_);
+    }
+}
+
+sbox::render::ProgressiveSchedule::Frame App::nextRayMarchFrame(std::uint64_t view_key, int width, int height) {
+    if (!progressive_viewport_) {
+        sbox::render::ProgressiveSchedule::Frame frame;
+        frame.width = width;
+        frame.height = height;
+        return frame;
+    }
+    const double march_ms = raymarch_target_.take_march_ms();
+    if (march_ms >= 0.0) {
+        raymarch_schedule_.report_march_ms(march_ms);
+    }
+    raymarch_schedule_.set_frame_budget_ms(settings_manager_.settings().raymarch_budget_ms);
+    const sbox::render::ProgressiveSchedule::Frame frame = raymarch_schedule_.next(view_key, width, height);
+    raymarch_refining_ = !raymarch_schedule_.converged();
+    return frame;
+}
+
+void App::drawRayMarch(Shader& shader, const sbox::render::ProgressiveSchedule::Frame& frame, int width, int height) {
+    const int jitter_loc = glGetUniformLocation(shader.id(), "u_jitter");
+    if (jitter_loc >= 0) {
+        glUniform2f(jitter_loc, frame.jitter.x(), frame.jitter.y());
+    }
+    shader.setUniform("u_sample_offset", frame.sample_offset);
+    if (progressive_viewport_) {
+        raymarch_target_.begin_march(frame, width, height);
+    }
     glBindVertexArray(fullscreen_vao_);
     glDrawArrays(GL_TRIANGLES, 0, 3);
     glBindVertexArray(0);
-    if (!use_cube_fallback_) {
-        basis_textures_.unbind();
-    } else {
-        volume_texture_.unbind();
+    if (progressive_viewport_) {
+        raymarch_target_.end_march();
     }
 }
 
@@ -2884,13 +3160,13 @@ void App::renderESPPass(int width, int height) {
     if (w2g_loc >= 0) {
         glUniformMatrix3fv(w2g_loc, 1, GL_FALSE, w2g.data());
     }
-    if (latest_result_.has_value() && latest_result_->has_density_cube) {
+    if (latest_result_ && latest_result_->has_density_cube) {
         const int dims_loc = glGetUniformLocation(esp_shader_->id(), "u_grid_dims");
         if (dims_loc >= 0) {
             glUniform3i(dims_loc,
-                        latest_result_->density_cube.nx,
-                        latest_result_->density_cube.ny,
-                        latest_result_->density_cube.nz);
+                        latest_result_->density_cube->nx,
+                        latest_result_->density_cube->ny,
+                        latest_result_->density_cube->nz);
         }
     }
     const int min_loc = glGetUniformLocation(esp_shader_->id(), "u_esp_min");
@@ -2971,8 +3247,8 @@ void App::uploadCurrentMoleculeToRenderers() {
     const auto color_mode = static_cast<sbox::render::ColorMode>(state_.color_mode);
     const sbox::io::PDBData* pdb_ptr = current_pdb_data_.atoms.empty() ? nullptr : &current_pdb_data_;
     const std::vector<double>* charges = current_charges_for_render(latest_result_);
-    mol_renderer_.upload(current_molecule_, color_mode, pdb_ptr, charges);
-    lod_renderer_.rebuild(current_molecule_, color_mode, pdb_ptr, charges);
+    editor_state_.spatial_index.update(current_molecule_);
+    mol_renderer_.update(current_molecule_, color_mode, pdb_ptr, charges, color_revision_);
 }
 
 }  // namespace sbox
@@ -3,6 +3,7 @@
 #include "analysis/nci.h"
 #include "backend/backend_manager.h"
 #include "backend/python_env.h"
+#include "backend/volume_cache.h"
 #include "chem/ligand_library.h"
 #include "core/basis_set.h"
 #include "core/update_checker.h"
@@ -16,17 +17,20 @@
 #include "editor/select_mode.h"
 #include "io/cube_io.h"
 #include "io/fchk_io.h"
+#include "io/file_loader.h"
 #include "io/pdb_io.h"
 #include "io/sdf_io.h"
 #include "io/trajectory_io.h"
 #include "io/xyz_io.h"
 #include "renderer/basis_texture.h"
+#include "renderer/brick_grid.h"
 #include "renderer/camera.h"
 #include "renderer/esp_surface.h"
 #include "renderer/gbuffer.h"
 #include "renderer/lod_renderer.h"
 #include "renderer/mol_renderer.h"
 #include "renderer/post_process.h"
+#include "renderer/progressive_raymarch.h"
 #include "renderer/ssao.h"
 #include "renderer/screenshot.h"
 #include "renderer/shader.h"
@@ -36,6 +40,7 @@
 #include "ui/annotations.h"
 #include "ui/annotation_editor.h"
 #include "ui/app_state.h"
+#include "ui/redraw_scheduler.h"
 #include "ui/about_dialog.h"
 #include "ui/context_menu.h"
 #include "ui/editor_toolbar.h"
@@ -48,6 +53,8 @@
 #include <optional>
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <future>
 #include <string>
 
 struct GLFWwindow;
@@ -62,7 +69,10 @@ public:
         bool initialized = false;
     };
 
-    App();
+    // A headless App renders offscreen only: it has no visible window, ImGui context, editor tools,
+    // compute backend or update check, and leaves the saved settings untouched. The view state the
+    // renderer reads (AppState, camera, loaded file) is still built as for the GUI.
+    explicit App(bool headless = false);
     ~App();
 
     App(const App&) = delete;
@@ -73,6 +83,8 @@ public:
     void render_single_frame();
     void render_to_fbo(unsigned int fbo, int w, int h);
     void render_to_fbo(unsigned int fbo, int w, int h, bool transparent_background);
+    // Renders one tile of a larger image (see save_screenshot_tiled) into fbo.
+    void render_tile_to_fbo(unsigned int fbo, const sbox::render::RenderTile& tile, bool transparent_background = false);
     ui::AppState& state();
     const ui::AppState& state() const;
     Camera& camera();
@@ -91,26 +103,37 @@ private:
     void rebuild_imgui_scale();
     void on_content_scale_change(float x_scale, float y_scale);
     void ensureViewportTarget(int width, int height);
-    void renderViewportToTexture();
+    // `progressive` lets the orbital ray march refine over several frames; only the interactive
+    // viewport asks for it, so screenshots and exports stay exact.
+    void renderViewportToTexture(bool progressive = false);
     void renderForwardToTarget(unsigned int fbo, int width, int height, bool transparent_background = false);
     void renderDeferredToTarget(unsigned int fbo, int width, int height, bool transparent_background = false);
     void renderOrbitalPass(int width, int height);
+    sbox::render::ProgressiveSchedule::Frame nextRayMarchFrame(std::uint64_t view_key, int width, int height);
+    void drawRayMarch(Shader& shader, const sbox::render::ProgressiveSchedule::Frame& frame, int width, int height);
     void renderESPPass(int width, int height);
     void renderNCIPass(int width, int height);
     void renderViewportToTarget(unsigned int fbo, int width, int height, bool transparent_background = false);
     void updateMaxDensityEstimate();
     [[nodiscard]] float computeMaxDensityEstimate() const;
-    void loadMoldenFile(const std::string& path);
-    void loadCubeFile(const std::string& path);
-    void loadXYZFile(const std::string& path);
-    void loadTrajectoryFile(const std::string& path);
-    void loadSDFFile(const std::string& path);
-    void loadPDBFile(const std::string& path);
-    void loadFchkFile(const std::string& path);
-    void loadProjectFile(const std::string& path);
+    // Parses on file_loader_'s worker; the result is swapped in by applyLoadedFile on a later frame.
+    void openFileAsync(const std::string& path, sbox::io::FileKind kind);
+    // Main-thread half of a load: swaps in the parsed data and uploads it to the GPU.
+    void applyLoadedFile(sbox::io::LoadedFile& file);
+    void drawFileLoadProgress();
     void uploadCurrentMoleculeToRenderers();
+    // Loads one frame of current_trajectory_ as the current molecule.
+    void showTrajectoryFrame(int index);
     void apply_settings();
+    // Re-validates the cached Python probe off the main thread; the result lands in pollPythonProbe.
+    void startPythonProbe(const std::string& preferred_path);
+    void pollPythonProbe();
+    // Bakes the selected MO onto a grid on a worker thread and swaps the result in once it is ready.
+    void updateOrbitalBake();
+    [[nodiscard]] int bakeTarget() const;
+    [[nodiscard]] bool bakedOrbitalReady() const;
     void applyMOData(const sbox::basis::MOData& mo_data, const std::string& name_hint);
+    void applyMOData(const sbox::basis::MOData& mo_data, sbox::chem::MolecularSystem molecule);
     void applyBackendResult(const sbox::backend::JobResult& result);
     void loadESPSurface(const sbox::backend::JobResult& result);
     void detect_metal_center();
@@ -119,6 +142,7 @@ private:
     [[nodiscard]] int find_homo_index() const;
     [[nodiscard]] float compute_mol_bound_radius(const sbox::chem::MolecularSystem& mol) const;
 
+    bool headless_ = false;
     std::unique_ptr<Window> window_;
     std::unique_ptr<Shader> gradient_shader_;
     std::unique_ptr<Shader> orbital_shader_;
@@ -135,18 +159,40 @@ private:
     std::unique_ptr<sbox::UpdateChecker> update_checker_;
     sbox::backend::BackendManager backend_;
     sbox::backend::PythonEnvironment python_env_;
+    std::future<sbox::backend::PythonInfo> python_probe_;
+    std::string python_probe_from_;  // python_env_'s interpreter when the probe started
     ui::SetupWizardState wizard_state_;
     sbox::chem::LigandLibrary ligand_library_;
     sbox::analysis::DOrbitalEnergies current_d_orbitals_;
     bool has_d_orbital_analysis_ = false;
     int current_metal_index_ = -1;
     sbox::render::BasisTextures basis_textures_;
+    sbox::render::BrickTexture orbital_bricks_;
+    sbox::render::VolumeTexture baked_mo_texture_;
+    std::future<sbox::io::CubeData> mo_bake_;
+    // {MO index or kTotalDensityBake, cube resolution, mo_data_generation_} of the baked texture and of
+    // the bake in flight.
+    std::array<int, 3> baked_mo_key_{-1, 0, -1};
+    std::array<int, 3> pending_mo_key_{-1, 0, -1};
+    bool baked_mo_valid_ = false;
+    int mo_data_generation_ = 0;
+    int orbital_bricks_mo_ = -1;  // MO and bound radius orbital_bricks_ was built for; -1 when stale
+    float orbital_bricks_radius_ = 0.0f;
     sbox::render::ESPSurface esp_surface_;
     sbox::render::LODRenderer lod_renderer_;
+    std::vector<std::uint32_t> lod_visible_atoms_;  // frustum query result, reused between frames
+    // Bumped whenever current_pdb_data_ or latest_result_ (the charge source) is replaced, so the
+    // renderers re-color even though the PDB data lives at a fixed address.
+    std::uint64_t color_revision_ = 0;
     sbox::render::MolRenderer mol_renderer_;
     sbox::render::VolumeTexture nci_rdg_texture_;
     sbox::render::VolumeTexture nci_sign_texture_;
     sbox::render::PostProcess post_process_;
+    sbox::render::ProgressiveSchedule raymarch_schedule_;
+    sbox::render::ProgressiveTarget raymarch_target_;
+    bool progressive_viewport_ = false;  // set while renderViewportToTexture(true) runs
+    bool raymarch_refining_ = false;     // the last viewport frame's ray march has not converged yet
+    ui::RedrawScheduler redraw_;
     sbox::render::GBuffer gbuffer_;
     sbox::render::SSAO ssao_;
     sbox::render::ShadowMap shadow_map_;
@@ -156,7 +202,9 @@ private:
     sbox::chem::MolecularSystem current_molecule_;
     sbox::io::Trajectory current_trajectory_;
     sbox::io::PDBData current_pdb_data_;
-    std::optional<sbox::backend::JobResult> latest_result_;
+    sbox::backend::JobResultHandle latest_result_;
+    sbox::backend::VolumeCache result_volumes_;  // volumes of latest_result_, generated on first use
+    sbox::io::FileLoader file_loader_;
     std::optional<sbox::analysis::NCIGrid> nci_grid_;
     bool has_trajectory_ = false;
     bool has_mo_data_ = false;
@@ -59,8 +59,8 @@ struct AppState {
         bool gas_done = false;
         bool solvent_done = false;
         bool run_requested = false;
-        sbox::backend::JobResult gas_result;
-        sbox::backend::JobResult solvent_result;
+        sbox::backend::JobResultHandle gas_result;
+        sbox::backend::JobResultHandle solvent_result;
         std::vector<SolventResult> history;
     };
 
@@ -128,6 +128,7 @@ struct AppState {
         bool is_2d = false;
         bool coord1_set = false;
         bool coord2_set = false;
+        int workers = 0;  // 0 = one driver process per hardware thread
         int scan_job_id = -1;
         bool scan_running = false;
         bool scan_complete = false;
@@ -135,6 +136,16 @@ struct AppState {
         int viewed_point = -1;
     };
 
+    struct EnsembleState {
+        int job_id = -1;
+        int frames = 0;  // trajectory frames submitted; 0 once that trajectory has been replaced
+        bool running = false;
+        bool complete = false;
+        std::vector<sbox::backend::JobResult::EnsembleMember> members;
+        std::string error;
+        int show_frame_requested = -1;  // trajectory frame the App should load into the viewport
+    };
+
     struct ReactionPathState {
         struct TrackedCoordinate {
             std::string label;
@@ -156,9 +167,10 @@ struct AppState {
         TrajectoryPlayerState player;
         std::vector<TrackedCoordinate> tracked;
         bool smooth_interpolation = true;
+        bool chain_ts_frequency = false;  // queue the TS frequency job behind the NEB run
         int ts_frequency_job_id = -1;
         bool ts_frequency_running = false;
-        sbox::backend::JobResult ts_frequency_result;
+        sbox::backend::JobResultHandle ts_frequency_result;
     };
 
     int selected_Z = 1;
@@ -175,6 +187,8 @@ struct AppState {
     bool show_complex_builder = false;
     bool show_spectrochemical = false;
     bool show_settings = false;
+    bool show_backend_telemetry = false;
+    int telemetry_window = 0;  // index into the telemetry panel's window choices
     int color_mode = 0;
     float esp_density_iso = 0.005f;
     float esp_color_min = -0.05f;
@@ -190,6 +204,7 @@ struct AppState {
     bool symmetry_elements_dirty = true;
 
     int render_mode = 0;  // 0=volume, 1=isosurface, 2=phase isosurface
+    bool show_total_density = false;  // MO view draws the total electron density instead of selected_mo
     float iso_value = 0.01f;
     float gamma = 0.4f;
     ViewMode view_mode = ViewMode::AtomicOrbital;
@@ -216,6 +231,7 @@ struct AppState {
     TrajectoryPlayerState optimization_player;
     std::vector<GeometricConstraint> constraints;
     PESScanState pes;
+    EnsembleState ensemble;
     ReactionPathState reaction_path;
     ComplexBuilderState complex_builder;
     SolventPanelState solvent;
@@ -0,0 +1,163 @@
+#include "ui/backend_telemetry_panel.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+namespace sbox::ui {
+
+namespace {
+
+using sbox::backend::BackendManager;
+using sbox::backend::JobTelemetry;
+
+struct WindowOption {
+    const char* label;
+    double seconds;
+};
+
+constexpr std::array<WindowOption, 3> kWindows = {{
+    {"Last 10 minutes", 600.0},
+    {"Last hour", 3600.0},
+    {"Whole session", 1.0e12},
+}};
+
+constexpr int kRecentJobRows = 20;
+
+void seconds_cell(double seconds) {
+    if (seconds <= 0.0) {
+        ImGui::TextDisabled("-");
+    } else if (seconds < 1.0) {
+        ImGui::Text("%.0f ms", seconds * 1000.0);
+    } else {
+        ImGui::Text("%.2f s", seconds);
+    }
+}
+
+void draw_stage_table(const BackendManager::TelemetrySummary& summary) {
+    double all_stages = 0.0;
+    for (const auto& stage : summary.stages) {
+        all_stages += stage.total_seconds;
+    }
+    if (!ImGui::BeginTable("TelemetryStages", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+        return;
+    }
+    ImGui::TableSetupColumn("Stage");
+    ImGui::TableSetupColumn("Mean / job");
+    ImGui::TableSetupColumn("Total");
+    ImGui::TableSetupColumn("Share", ImGuiTableColumnFlags_WidthStretch, 2.0f);
+    ImGui::TableHeadersRow();
+    for (const auto& stage : summary.stages) {
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(0);
+        ImGui::TextUnformatted(stage.name.c_str());
+        ImGui::TableSetColumnIndex(1);
+        seconds_cell(stage.mean_seconds);
+        ImGui::TableSetColumnIndex(2);
+        seconds_cell(stage.total_seconds);
+        ImGui::TableSetColumnIndex(3);
+        const float share = all_stages > 0.0 ? static_cast<float>(stage.total_seconds / all_stages) : 0.0f;
+        ImGui::ProgressBar(share, ImVec2(-1.0f, 0.0f));
+    }
+    ImGui::EndTable();
+}
+
+void draw_recent_jobs(const std::vector<JobTelemetry>& history) {
+    constexpr int kColumns = 12;
+    if (!ImGui::BeginTable("TelemetryJobs", kColumns,
+                           ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollX | ImGuiTableFlags_SizingFixedFit)) {
+        return;
+    }
+    for (const char* column : {"Job", "Driver", "Status", "Queue", "Spawn", "Import", "SCF", "Properties", "Parse", "Wall",
+                               "CPU user/sys", "Peak RSS"}) {
+        ImGui::TableSetupColumn(column);
+    }
+    ImGui::TableHeadersRow();
+
+    const std::size_t first = history.size() > static_cast<std::size_t>(kRecentJobRows)
+                                  ? history.size() - static_cast<std::size_t>(kRecentJobRows)
+                                  : 0;
+    for (std::size_t i = history.size(); i-- > first;) {
+        const JobTelemetry& job = history[i];
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(0);
+        ImGui::Text("%d", job.job_id);
+        ImGui::TableSetColumnIndex(1);
+        ImGui::TextUnformatted(job.driver.c_str());
+        ImGui::TableSetColumnIndex(2);
+        ImGui::TextUnformatted(backend::job_status_to_string(job.status));
+        ImGui::TableSetColumnIndex(3);
+        seconds_cell(job.queue_wait_seconds);
+        ImGui::TableSetColumnIndex(4);
+        seconds_cell(job.spawn_seconds);
+        ImGui::TableSetColumnIndex(5);
+        seconds_cell(job.import_seconds);
+        ImGui::TableSetColumnIndex(6);
+        seconds_cell(job.scf_seconds);
+        ImGui::TableSetColumnIndex(7);
+        seconds_cell(job.properties_seconds);
+        ImGui::TableSetColumnIndex(8);
+        seconds_cell(job.parse_seconds);
+        ImGui::TableSetColumnIndex(9);
+        seconds_cell(job.wall_seconds);
+        ImGui::TableSetColumnIndex(10);
+        ImGui::Text("%.1f / %.1f s", job.user_cpu_seconds, job.system_cpu_seconds);
+        ImGui::TableSetColumnIndex(11);
+        if (job.peak_rss_kb > 0) {
+            ImGui::Text("%.0f MB", static_cast<double>(job.peak_rss_kb) / 1024.0);
+        } else {
+            ImGui::TextDisabled("-");
+        }
+    }
+    ImGui::EndTable();
+}
+
+}  // namespace
+
+void draw_backend_telemetry_panel(AppState& state, const BackendManager& backend) {
+    if (!ImGui::Begin("Backend Telemetry", &state.show_backend_telemetry)) {
+        ImGui::End();
+        return;
+    }
+
+    state.telemetry_window = std::clamp(state.telemetry_window, 0, static_cast<int>(kWindows.size()) - 1);
+    const WindowOption& window = kWindows[static_cast<std::size_t>(state.telemetry_window)];
+    ImGui::SetNextItemWidth(180.0f);
+    if (ImGui::BeginCombo("Window", window.label)) {
+        for (int i = 0; i < static_cast<int>(kWindows.size()); ++i) {
+            if (ImGui::Selectable(kWindows[static_cast<std::size_t>(i)].label, i == state.telemetry_window)) {
+                state.telemetry_window = i;
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    const BackendManager::TelemetrySummary summary = backend.telemetry_summary(window.seconds);
+    if (summary.jobs == 0) {
+        ImGui::TextDisabled("No jobs have finished in this window.");
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("Jobs: %d    Throughput: %.2f jobs/min    Mean wall time: %.2f s", summary.jobs, summary.jobs_per_minute,
+                summary.mean_wall_seconds);
+    if (summary.peak_rss_kb > 0) {
+        ImGui::Text("Largest peak RSS: %.0f MB", static_cast<double>(summary.peak_rss_kb) / 1024.0);
+    }
+
+    ImGui::Separator();
+    ImGui::TextUnformatted("Slowest stages");
+    draw_stage_table(summary);
+
+    ImGui::Separator();
+    ImGui::TextUnformatted("Recent jobs");
+    draw_recent_jobs(backend.telemetry());
+
+    ImGui::End();
+}
+
+}  // namespace sbox::ui
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "backend/backend_manager.h"
+#include "ui/app_state.h"
+
+namespace sbox::ui {
+
+void draw_backend_telemetry_panel(AppState& state, const sbox::backend::BackendManager& backend);
+
+}  // namespace sbox::ui
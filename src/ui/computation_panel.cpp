@@ -14,6 +14,7 @@ namespace {
 using sbox::backend::BackendManager;
 using sbox::backend::BasisSetType;
 using sbox::backend::JobResult;
+using sbox::backend::JobResultHandle;
 using sbox::backend::Method;
 
 constexpr std::array<Method, 12> kMethods = {
@@ -194,7 +195,7 @@ void draw_computation_panel(AppState& state, BackendManager& backend) {
         }
     }
 
-    const JobResult* active_result = comp.active_job_id >= 0 ? backend.result(comp.active_job_id) : nullptr;
+    const JobResultHandle active_result = comp.active_job_id >= 0 ? backend.result(comp.active_job_id) : nullptr;
     if (comp.job_completed && active_result != nullptr) {
         ImGui::Separator();
         ImGui::Text("Total Energy: %.10f Hartree", active_result->total_energy);
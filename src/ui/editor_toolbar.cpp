@@ -6,6 +6,7 @@
 #include <imgui.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <string>
 #include <vector>
@@ -69,6 +70,17 @@ EditorState::EditorState()
       measure_mode(std::make_unique<sbox::editor::MeasureMode>()),
       fragment_mode(std::make_unique<sbox::editor::FragmentMode>(&fragment_library)) {
     select_mode->set_context_menu_state(&context_menu);
+    attach_spatial_index();
+}
+
+void EditorState::attach_spatial_index() {
+    const std::array<sbox::editor::EditorMode*, 5> modes = {
+        select_mode.get(), draw_mode.get(), erase_mode.get(), measure_mode.get(), fragment_mode.get()};
+    for (sbox::editor::EditorMode* mode : modes) {
+        if (mode != nullptr) {
+            mode->set_spatial_index(&spatial_index);
+        }
+    }
 }
 
 sbox::editor::EditorMode* EditorState::active_mode() {
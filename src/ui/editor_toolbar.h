@@ -7,6 +7,7 @@
 #include "editor/fragment_mode.h"
 #include "editor/measure_mode.h"
 #include "editor/select_mode.h"
+#include "editor/spatial_index.h"
 #include "ui/context_menu.h"
 
 #include <memory>
@@ -28,9 +29,13 @@ struct EditorState {
 
     sbox::editor::Selection selection;
     sbox::editor::CommandStack commands;
+    // Built alongside the renderer upload of the edited molecule and refit while atoms are dragged.
+    sbox::editor::SpatialIndex spatial_index;
     sbox::editor::FragmentLibrary fragment_library;
     ContextMenuState context_menu;
 
+    // Points every mode at spatial_index; call again after replacing a mode.
+    void attach_spatial_index();
     sbox::editor::EditorMode* active_mode();
     const sbox::editor::EditorMode* active_mode() const;
 };
@@ -0,0 +1,145 @@
+#include "ui/ensemble_panel.h"
+
+#include "backend/job_types.h"
+#include "ui/plot_utils.h"
+
+#include <implot.h>
+#include <imgui.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace sbox::ui {
+
+namespace {
+
+constexpr double kHartreeToKcal = 627.509;
+
+// Relative energies (kcal/mol above the lowest successful member) for every member that succeeded.
+void plot_members(const char* plot_id, const std::vector<sbox::backend::JobResult::EnsembleMember>& members) {
+    double lowest = std::numeric_limits<double>::max();
+    for (const auto& member : members) {
+        if (member.success) {
+            lowest = std::min(lowest, member.energy);
+        }
+    }
+    std::vector<float> xs;
+    std::vector<float> ys;
+    for (const auto& member : members) {
+        if (member.success) {
+            xs.push_back(static_cast<float>(member.index));
+            ys.push_back(static_cast<float>((member.energy - lowest) * kHartreeToKcal));
+        }
+    }
+    if (xs.empty()) {
+        return;
+    }
+    if (ImPlot::BeginPlot(plot_id, ImVec2(-1.0f, 200.0f))) {
+        ImPlot::SetupAxes("Frame", "Relative energy (kcal/mol)");
+        plot_line_styled("Energy", xs.data(), ys.data(), static_cast<int>(xs.size()), ImVec4(0.15f, 0.70f, 0.88f, 1.0f), 2.0f);
+        ImPlot::EndPlot();
+    }
+}
+
+}  // namespace
+
+void draw_ensemble_panel(AppState& state,
+                         sbox::backend::BackendManager& backend,
+                         const sbox::io::Trajectory& trajectory) {
+    if (!ImGui::Begin("Trajectory Single Points")) {
+        ImGui::End();
+        return;
+    }
+
+    AppState::EnsembleState& ensemble = state.ensemble;
+
+    ImGui::Text("Frames: %d", trajectory.num_frames());
+    ImGui::Text("Method: %s", sbox::backend::method_display_name(state.computation.method));
+    if (sbox::backend::method_needs_basis(state.computation.method)) {
+        ImGui::Text("Basis: %s", sbox::backend::basis_display_name(state.computation.basis));
+    } else {
+        ImGui::TextDisabled("Basis: not used for this method");
+    }
+    ImGui::TextDisabled("All frames run in one driver process that reuses its setup between frames.");
+
+    const bool can_run = !trajectory.empty() && !ensemble.running;
+    if (!can_run) {
+        ImGui::BeginDisabled();
+    }
+    const std::string label = "Score " + std::to_string(trajectory.num_frames()) + " Frames";
+    if (ImGui::Button(label.c_str())) {
+        sbox::backend::JobSpec spec;
+        spec.geometry = trajectory.frames.front().geometry;
+        spec.method = state.computation.method;
+        spec.basis = state.computation.basis;
+        spec.charge = state.computation.charge;
+        spec.multiplicity = state.computation.multiplicity;
+        spec.solvent = state.computation.solvent;
+        spec.properties = {
+            sbox::backend::PropertyRequest::MullikenCharges,
+            sbox::backend::PropertyRequest::DipoleMoment,
+        };
+        spec.run_ensemble = true;
+        spec.ensemble.geometries.reserve(trajectory.frames.size());
+        for (const auto& frame : trajectory.frames) {
+            spec.ensemble.geometries.push_back(frame.geometry);
+        }
+        ensemble.job_id = backend.submit(spec);
+        ensemble.frames = trajectory.num_frames();
+        ensemble.running = true;
+        ensemble.complete = false;
+        ensemble.members.clear();
+        ensemble.error.clear();
+    }
+    if (!can_run) {
+        ImGui::EndDisabled();
+    }
+    if (ensemble.running && ensemble.job_id >= 0) {
+        ImGui::SameLine();
+        if (ImGui::Button("Cancel")) {
+            backend.cancel(ensemble.job_id);
+        }
+    }
+
+    if (ensemble.running && ensemble.job_id >= 0) {
+        ImGui::SeparatorText("Progress");
+        const auto progress = backend.get_progress(ensemble.job_id);
+        ImGui::Text("Frame %d / %d", progress.step, progress.total);
+        const float fraction = progress.total > 0 ? static_cast<float>(progress.step) / static_cast<float>(progress.total) : 0.0f;
+        ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f));
+        plot_members("Live Ensemble", progress.ensemble);
+    }
+
+    if (!ensemble.error.empty()) {
+        ImGui::TextColored(ImVec4(0.95f, 0.45f, 0.35f, 1.0f), "%s", ensemble.error.c_str());
+    }
+
+    if (ensemble.complete && !ensemble.members.empty()) {
+        ImGui::SeparatorText("Results");
+        const auto lowest = std::min_element(ensemble.members.begin(), ensemble.members.end(), [](const auto& a, const auto& b) {
+            if (a.success != b.success) {
+                return a.success;
+            }
+            return a.energy < b.energy;
+        });
+        const auto failed = std::count_if(ensemble.members.begin(), ensemble.members.end(), [](const auto& member) {
+            return !member.success;
+        });
+        if (lowest->success) {
+            ImGui::Text("Lowest: frame %d, %.6f Hartree", lowest->index + 1, lowest->energy);
+            if (ImGui::Button("Show Lowest Frame")) {
+                ensemble.show_frame_requested = lowest->index;
+            }
+        }
+        if (failed > 0) {
+            ImGui::TextColored(ImVec4(0.95f, 0.70f, 0.25f, 1.0f), "%d frame(s) failed", static_cast<int>(failed));
+        }
+        plot_members("Ensemble Energies", ensemble.members);
+    }
+
+    ImGui::End();
+}
+
+}  // namespace sbox::ui
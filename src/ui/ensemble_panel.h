@@ -0,0 +1,14 @@
+#pragma once
+
+#include "backend/backend_manager.h"
+#include "io/trajectory_io.h"
+#include "ui/app_state.h"
+
+namespace sbox::ui {
+
+// Scores every frame of the loaded trajectory as one ensemble job and plots energies as they stream in.
+void draw_ensemble_panel(AppState& state,
+                         sbox::backend::BackendManager& backend,
+                         const sbox::io::Trajectory& trajectory);
+
+}  // namespace sbox::ui
@@ -88,7 +88,7 @@ struct ExportDialogState {
     sbox::render::VideoExporter::ExportSettings active_settings;
     ExportKind active_kind = ExportKind::None;
     OffscreenTarget target;
-    std::vector<unsigned char> pixels;
+    sbox::render::FrameReadback readback;
     int frame_index = 0;
     bool exporting = false;
     bool popup_open = false;
@@ -158,18 +158,6 @@ bool ensure_target(OffscreenTarget& target, int width, int height) {
     return true;
 }
 
-void flip_rows(std::vector<unsigned char>& pixels, int width, int height) {
-    const std::size_t row_bytes = static_cast<std::size_t>(width) * 4u;
-    std::vector<unsigned char> temp(row_bytes);
-    for (int y = 0; y < height / 2; ++y) {
-        unsigned char* top = pixels.data() + static_cast<std::size_t>(y) * row_bytes;
-        unsigned char* bottom = pixels.data() + static_cast<std::size_t>(height - 1 - y) * row_bytes;
-        std::copy(top, top + row_bytes, temp.data());
-        std::copy(bottom, bottom + row_bytes, top);
-        std::copy(temp.data(), temp.data() + row_bytes, bottom);
-    }
-}
-
 void fill_settings_for_format(sbox::render::VideoExporter::ExportSettings& settings, int format_index) {
     if (format_index == 1) {
         settings.codec = "prores";
@@ -208,7 +196,7 @@ bool start_export(ExportDialogState& dialog,
     dialog.active_settings = settings;
     dialog.frame_index = 0;
     dialog.exporting = true;
-    dialog.pixels.assign(static_cast<std::size_t>(settings.width) * static_cast<std::size_t>(settings.height) * 4u, 0);
+    dialog.readback.resize(settings.width, settings.height);
     dialog.camera_snapshot.orientation = app.camera().orientation();
     dialog.camera_snapshot.target = app.camera().target();
     dialog.camera_snapshot.distance = app.camera().distance();
@@ -227,6 +215,7 @@ void restore_export_state(ExportDialogState& dialog, sbox::App& app) {
 
 void finish_export(ExportDialogState& dialog, sbox::App& app) {
     restore_export_state(dialog, app);
+    dialog.readback.flush(dialog.exporter);
     dialog.exporter.end();
     dialog.exporting = false;
     dialog.active_kind = ExportKind::None;
@@ -273,13 +262,7 @@ bool process_one_export_frame(ExportDialogState& dialog, sbox::App& app) {
     }
 
     app.render_to_fbo(dialog.target.fbo, settings.width, settings.height, settings.transparent_background);
-    glBindFramebuffer(GL_FRAMEBUFFER, dialog.target.fbo);
-    glPixelStorei(GL_PACK_ALIGNMENT, 1);
-    glReadPixels(0, 0, settings.width, settings.height, GL_RGBA, GL_UNSIGNED_BYTE, dialog.pixels.data());
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    flip_rows(dialog.pixels, settings.width, settings.height);
-
-    if (!dialog.exporter.write_frame(dialog.pixels.data(), settings.width, settings.height)) {
+    if (!dialog.readback.read(dialog.target.fbo, dialog.exporter)) {
         return false;
     }
 
@@ -319,6 +302,10 @@ void draw_format_combo(const char* label, int& index) {
 
 }  // namespace
 
+bool export_in_progress() {
+    return dialog_state().exporting;
+}
+
 void draw_export_dialog(bool& show, sbox::App& app) {
     ExportDialogState& dialog = dialog_state();
     if (show && !dialog.popup_open) {
@@ -500,9 +487,23 @@ void draw_export_dialog(bool& show, sbox::App& app) {
         show = false;
         dialog.popup_open = false;
         destroy_target(dialog.target);
+        dialog.readback.release();
     } else {
         show = true;
     }
 }
 
+void release_export_dialog() {
+    ExportDialogState& dialog = dialog_state();
+    if (dialog.exporting) {
+        // Keep what was rendered: the frames in flight still reach the file before ffmpeg closes.
+        dialog.readback.flush(dialog.exporter);
+        dialog.exporter.end();
+        dialog.exporting = false;
+        dialog.active_kind = ExportKind::None;
+    }
+    destroy_target(dialog.target);
+    dialog.readback.release();
+}
+
 }  // namespace sbox::ui
@@ -7,5 +7,10 @@ class App;
 namespace sbox::ui {
 
 void draw_export_dialog(bool& show, sbox::App& app);
+// True while an export renders one frame per call to draw_export_dialog().
+bool export_in_progress();
+// Ends a running export and frees the dialog's GL objects. Call while the GL context is current:
+// the dialog state is a function-static that would otherwise outlive the context.
+void release_export_dialog();
 
 }  // namespace sbox::ui
@@ -6,7 +6,7 @@
 namespace sbox::ui {
 
 void draw_nci_panel(AppState& state, const sbox::backend::JobResult& result) {
-    if (!result.has_density_cube) {
+    if (!result.has_density_cube && !result.has_mo_data) {
         return;
     }
 
@@ -14,6 +14,7 @@
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <numeric>
 #include <stdexcept>
 #include <string>
@@ -124,7 +125,7 @@ std::vector<AngleChange> largest_angle_changes(const sbox::chem::MolecularSystem
 void sync_frame_to_molecule(AppState::TrajectoryPlayerState& player,
                             const sbox::backend::JobResult& result,
                             sbox::chem::MolecularSystem& mol,
-                            sbox::render::MolRenderer& renderer) {
+                            const std::function<void()>& geometry_changed) {
     if (!result.has_trajectory || result.trajectory_frames.empty()) {
         return;
     }
@@ -134,7 +135,7 @@ void sync_frame_to_molecule(AppState::TrajectoryPlayerState& player,
         return;
     }
     mol = result.trajectory_frames[static_cast<std::size_t>(player.current_frame)];
-    renderer.upload(mol);
+    geometry_changed();
     player.last_applied_frame = player.current_frame;
 }
 
@@ -143,7 +144,7 @@ void sync_frame_to_molecule(AppState::TrajectoryPlayerState& player,
 void draw_optimization_panel(AppState& state,
                              const sbox::backend::JobResult& result,
                              sbox::chem::MolecularSystem& mol,
-                             sbox::render::MolRenderer& renderer) {
+                             const std::function<void()>& geometry_changed) {
     if (result.opt_history.empty() && !state.computation.job_running) {
         return;
     }
@@ -251,7 +252,7 @@ void draw_optimization_panel(AppState& state,
         ImGui::SliderFloat("Speed", &player.playback_speed, 0.1f, 5.0f, "%.1fx");
 
         if (frame_changed || player.last_applied_frame != player.current_frame) {
-            sync_frame_to_molecule(player, result, mol, renderer);
+            sync_frame_to_molecule(player, result, mol, geometry_changed);
         }
 
         ImGui::Separator();
@@ -330,7 +331,7 @@ void draw_optimization_panel(AppState& state,
         ImGui::SameLine();
         if (ImGui::Button("Apply Optimised Geometry")) {
             mol = result.trajectory_frames.back();
-            renderer.upload(mol);
+            geometry_changed();
             player.current_frame = player.total_frames - 1;
             player.last_applied_frame = player.current_frame;
         }
@@ -2,14 +2,17 @@
 
 #include "backend/job_types.h"
 #include "core/molecular_system.h"
-#include "renderer/mol_renderer.h"
 #include "ui/app_state.h"
 
+#include <functional>
+
 namespace sbox::ui {
 
+// Trajectory playback writes frames into `mol` and then calls `geometry_changed` so the caller can
+// bring its renderers and spatial index up to date.
 void draw_optimization_panel(AppState& state,
                              const sbox::backend::JobResult& result,
                              sbox::chem::MolecularSystem& mol,
-                             sbox::render::MolRenderer& renderer);
+                             const std::function<void()>& geometry_changed);
 
 }  // namespace sbox::ui
@@ -49,6 +49,7 @@ ViewportPanelState draw_viewport(AppState& state, unsigned int texture_id) {
                 ImGui::SetNextItemWidth(220.0f);
                 ImGui::SliderInt("Molecular Orbital", &state.selected_mo, 0, state.num_mo - 1);
                 ImGui::Text("%s", mo_label_for_index(state, state.selected_mo, state.homo_index));
+                ImGui::Checkbox("Total Density", &state.show_total_density);
             } else {
                 ImGui::TextUnformatted("No molecular orbitals loaded.");
             }
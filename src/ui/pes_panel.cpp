@@ -247,15 +247,23 @@ void draw_coordinate_editor(const char* label_prefix,
 }
 
 std::string estimate_time_label(const AppState::PESScanState& pes, sbox::backend::Method method) {
-    const int total_points = std::max(1, pes.coord1.steps) * (pes.is_2d ? std::max(1, pes.coord2.steps) : 1);
+    sbox::backend::JobSpec::ScanSpec scan;
+    scan.coord1 = pes.coord1;
+    scan.coord2 = pes.coord2;
+    scan.is_2d = pes.is_2d;
+    scan.workers = pes.workers;
+    const int total_points = scan.total_points();
+    const int workers = scan.resolved_workers();
     const double seconds_per_point =
         sbox::backend::method_is_xtb(method) ? 2.0 : (method == sbox::backend::Method::HF ? 6.0 : 15.0);
-    const double total_seconds = total_points * seconds_per_point;
-    char buffer[128];
+    const double total_seconds = std::ceil(static_cast<double>(total_points) / workers) * seconds_per_point;
+    char buffer[160];
     std::snprintf(buffer,
                   sizeof(buffer),
-                  "~%d single-point optimisations, estimated %.1f minutes.",
+                  "~%d single-point optimisations on %d worker%s, estimated %.1f minutes.",
                   total_points,
+                  workers,
+                  workers == 1 ? "" : "s",
                   total_seconds / 60.0);
     return buffer;
 }
@@ -419,7 +427,7 @@ void draw_pes_panel(AppState& state,
     AppState::PESScanState& pes = state.pes;
 
     if (pes.scan_running && pes.scan_job_id >= 0) {
-        if (const sbox::backend::JobResult* completed = backend.result(pes.scan_job_id)) {
+        if (const sbox::backend::JobResultHandle completed = backend.result(pes.scan_job_id)) {
             pes.result = completed->scan_result;
             pes.scan_running = false;
             pes.scan_complete = completed->has_scan;
@@ -450,6 +458,11 @@ void draw_pes_panel(AppState& state,
     } else {
         ImGui::TextDisabled("Basis: not used for this method");
     }
+    ImGui::SliderInt("Workers", &pes.workers, 0, 64, pes.workers == 0 ? "auto" : "%d");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Scan points are split into chunks that run in parallel driver processes.\n"
+                          "Each chunk walks neighbouring points and warm-starts from the previous one.");
+    }
     ImGui::TextDisabled("%s", estimate_time_label(pes, state.computation.method).c_str());
 
     const bool xtb_scan_unsupported = sbox::backend::method_is_xtb(state.computation.method);
@@ -481,6 +494,7 @@ void draw_pes_panel(AppState& state,
         spec.scan.is_2d = pes.is_2d;
         spec.scan.coord1 = pes.coord1;
         spec.scan.coord2 = pes.coord2;
+        spec.scan.workers = pes.workers;
         pes.scan_job_id = backend.submit(spec);
         pes.scan_running = true;
         pes.scan_complete = false;
@@ -19,6 +19,7 @@
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <limits>
 #include <map>
 #include <numeric>
@@ -212,7 +213,7 @@ sbox::chem::MolecularSystem interpolated_frame(const sbox::chem::MolecularSystem
 
 void apply_neb_view_frame(AppState::ReactionPathState& path,
                           sbox::chem::MolecularSystem& mol,
-                          sbox::render::MolRenderer& renderer) {
+                          const std::function<void()>& geometry_changed) {
     if (path.result.path_geometries.empty()) {
         return;
     }
@@ -227,15 +228,20 @@ void apply_neb_view_frame(AppState::ReactionPathState& path,
 
     const int current = path.player.current_frame;
     const int next = std::min(current + 1, path.player.total_frames - 1);
-    if (path.smooth_interpolation && next != current && interp_t > 0.0f) {
+    const bool interpolating = path.smooth_interpolation && next != current && interp_t > 0.0f;
+    if (!interpolating && path.player.last_applied_frame == current) {
+        return;
+    }
+    if (interpolating) {
         mol = interpolated_frame(path.result.path_geometries[static_cast<std::size_t>(current)],
                                  path.result.path_geometries[static_cast<std::size_t>(next)],
                                  interp_t);
     } else {
         mol = path.result.path_geometries[static_cast<std::size_t>(current)];
     }
-    renderer.upload(mol);
-    path.player.last_applied_frame = current;
+    geometry_changed();
+    // An in-between geometry is replaced by the exact image once playback stops.
+    path.player.last_applied_frame = interpolating ? -1 : current;
 }
 
 void write_xyz_frames(const std::string& path, const std::vector<sbox::chem::MolecularSystem>& frames) {
@@ -305,12 +311,28 @@ void draw_spline_profile(const std::vector<float>& xs, const std::vector<float>&
     plot_line_styled("Spline", sx.data(), sy.data(), static_cast<int>(sx.size()), ImVec4(0.20f, 0.75f, 0.90f, 1.0f), 2.0f);
 }
 
+// Frequency job at a transition-state geometry. When chained behind a NEB run the geometry is a
+// placeholder that BackendManager replaces with the TS image through a GeometryFrom edge.
+sbox::backend::JobSpec make_ts_frequency_spec(const AppState& state, const sbox::chem::MolecularSystem& geometry) {
+    sbox::backend::JobSpec spec;
+    spec.geometry = geometry;
+    spec.method = state.computation.method;
+    spec.basis = state.computation.basis;
+    spec.charge = state.computation.charge;
+    spec.multiplicity = state.computation.multiplicity;
+    spec.properties = {
+        sbox::backend::PropertyRequest::Frequencies,
+        sbox::backend::PropertyRequest::MoldenFile,
+    };
+    return spec;
+}
+
 }  // namespace
 
 void draw_reaction_path_panel(AppState& state,
                               sbox::backend::BackendManager& backend,
                               sbox::chem::MolecularSystem& mol,
-                              sbox::render::MolRenderer& renderer) {
+                              const std::function<void()>& geometry_changed) {
     if (!ImGui::Begin("Reaction Path")) {
         ImGui::End();
         return;
@@ -319,13 +341,13 @@ void draw_reaction_path_panel(AppState& state,
     auto& rp = state.reaction_path;
 
     if (rp.ts_frequency_running && rp.ts_frequency_job_id >= 0) {
-        if (const auto* result = backend.result(rp.ts_frequency_job_id)) {
-            rp.ts_frequency_result = *result;
+        if (auto result = backend.result(rp.ts_frequency_job_id)) {
+            rp.ts_frequency_result = std::move(result);
             rp.ts_frequency_running = false;
         }
     }
     if (rp.neb_running && rp.neb_job_id >= 0) {
-        if (const auto* result = backend.result(rp.neb_job_id)) {
+        if (const auto result = backend.result(rp.neb_job_id)) {
             rp.result = result->neb_result;
             rp.neb_running = false;
             rp.neb_complete = result->has_neb;
@@ -390,6 +412,7 @@ void draw_reaction_path_panel(AppState& state,
     if (!valid_pair || rp.neb_running) {
         ImGui::BeginDisabled();
     }
+    ImGui::Checkbox("Run frequency at TS afterwards", &rp.chain_ts_frequency);
     if (ImGui::Button("Run NEB")) {
         sbox::backend::JobSpec spec;
         spec.run_neb = true;
@@ -401,7 +424,19 @@ void draw_reaction_path_panel(AppState& state,
         spec.neb.product = rp.product;
         spec.neb.num_images = rp.num_images;
         spec.neb.max_neb_steps = rp.max_neb_steps;
-        rp.neb_job_id = backend.submit(spec);
+        if (rp.chain_ts_frequency) {
+            sbox::backend::JobGraph graph;
+            const int neb_node = graph.add(spec);
+            const int freq_node = graph.add(make_ts_frequency_spec(state, rp.reactant));
+            graph.connect(neb_node, freq_node, sbox::backend::JobDependency::Kind::GeometryFrom);
+            const std::vector<int> job_ids = backend.submit_graph(graph);
+            rp.neb_job_id = job_ids[static_cast<std::size_t>(neb_node)];
+            rp.ts_frequency_job_id = job_ids[static_cast<std::size_t>(freq_node)];
+            rp.ts_frequency_running = true;
+            rp.ts_frequency_result.reset();
+        } else {
+            rp.neb_job_id = backend.submit(spec);
+        }
         rp.neb_running = true;
         rp.neb_complete = false;
         rp.result = {};
@@ -414,8 +449,34 @@ void draw_reaction_path_panel(AppState& state,
     if (rp.neb_running) {
         ImGui::SeparatorText("Progress");
         const auto progress = backend.get_progress(rp.neb_job_id);
-        ImGui::Text("Image %d / %d", progress.step, rp.num_images);
-        ImGui::ProgressBar(rp.num_images > 0 ? static_cast<float>(progress.step) / static_cast<float>(rp.num_images) : 0.0f, ImVec2(-1.0f, 0.0f));
+        if (progress.images.empty()) {
+            ImGui::Text("Image %d / %d", progress.step, rp.num_images);
+            ImGui::ProgressBar(rp.num_images > 0 ? static_cast<float>(progress.step) / static_cast<float>(rp.num_images) : 0.0f, ImVec2(-1.0f, 0.0f));
+        } else {
+            const int total = std::max(1, progress.total);
+            ImGui::Text("Iteration %d: %d / %d images converged", progress.iteration, progress.step, progress.total);
+            ImGui::ProgressBar(static_cast<float>(progress.step) / static_cast<float>(total), ImVec2(-1.0f, 0.0f));
+            if (ImGui::BeginTable("NEBImageProgress", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+                ImGui::TableSetupColumn("Image");
+                ImGui::TableSetupColumn("Energy (Ha)");
+                ImGui::TableSetupColumn("Max force (eV/A)");
+                ImGui::TableSetupColumn("SCF");
+                ImGui::TableHeadersRow();
+                for (const auto& image : progress.images) {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%d", image.index);
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%.6f", image.energy);
+                    ImGui::TableSetColumnIndex(2);
+                    const ImVec4 color = image.converged ? ImVec4(0.35f, 0.85f, 0.45f, 1.0f) : ImVec4(0.95f, 0.70f, 0.25f, 1.0f);
+                    ImGui::TextColored(color, "%.4f", image.max_force);
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::TextUnformatted(image.scf_converged ? "converged" : "not converged");
+                }
+                ImGui::EndTable();
+            }
+        }
         if (!progress.message.empty()) {
             ImGui::TextWrapped("%s", progress.message.c_str());
         }
@@ -528,7 +589,7 @@ void draw_reaction_path_panel(AppState& state,
         ImGui::SliderInt("Image", &rp.player.current_frame, 0, std::max(0, rp.player.total_frames - 1));
         ImGui::SliderFloat("Speed##neb", &rp.player.playback_speed, 0.1f, 5.0f, "%.1fx");
         ImGui::Checkbox("Smooth interpolation", &rp.smooth_interpolation);
-        apply_neb_view_frame(rp, mol, renderer);
+        apply_neb_view_frame(rp, mol, geometry_changed);
 
         ImGui::SeparatorText("Transition State Info");
         if (rp.result.ts_index >= 0) {
@@ -542,24 +603,16 @@ void draw_reaction_path_panel(AppState& state,
             if (ImGui::Button("View TS Geometry")) {
                 rp.player.current_frame = rp.result.ts_index;
                 rp.player.last_applied_frame = -1;
-                apply_neb_view_frame(rp, mol, renderer);
+                apply_neb_view_frame(rp, mol, geometry_changed);
             }
             ImGui::SameLine();
             if (!rp.ts_frequency_running) {
                 if (ImGui::Button("Run Frequency at TS")) {
-                    sbox::backend::JobSpec spec;
-                    spec.geometry = rp.result.path_geometries[static_cast<std::size_t>(rp.result.ts_index)];
-                    spec.method = state.computation.method;
-                    spec.basis = state.computation.basis;
-                    spec.charge = state.computation.charge;
-                    spec.multiplicity = state.computation.multiplicity;
-                    spec.properties = {
-                        sbox::backend::PropertyRequest::Frequencies,
-                        sbox::backend::PropertyRequest::MoldenFile,
-                    };
+                    const sbox::backend::JobSpec spec =
+                        make_ts_frequency_spec(state, rp.result.path_geometries[static_cast<std::size_t>(rp.result.ts_index)]);
                     rp.ts_frequency_job_id = backend.submit(spec);
                     rp.ts_frequency_running = true;
-                    rp.ts_frequency_result = {};
+                    rp.ts_frequency_result.reset();
                 }
             } else {
                 ImGui::TextDisabled("Frequency job running...");
@@ -567,10 +620,11 @@ void draw_reaction_path_panel(AppState& state,
             ImGui::SameLine();
             ImGui::TextDisabled("IRC not yet implemented - coming in a future update.");
 
-            if (!rp.ts_frequency_running && rp.ts_frequency_result.has_frequencies && !rp.ts_frequency_result.frequencies_cm1.empty()) {
-                const auto min_it = std::min_element(rp.ts_frequency_result.frequencies_cm1.begin(),
-                                                    rp.ts_frequency_result.frequencies_cm1.end());
-                if (min_it != rp.ts_frequency_result.frequencies_cm1.end() && *min_it < 0.0) {
+            if (!rp.ts_frequency_running && rp.ts_frequency_result && rp.ts_frequency_result->has_frequencies
+                && !rp.ts_frequency_result->frequencies_cm1.empty()) {
+                const auto& frequencies = rp.ts_frequency_result->frequencies_cm1;
+                const auto min_it = std::min_element(frequencies.begin(), frequencies.end());
+                if (min_it != frequencies.end() && *min_it < 0.0) {
                     ImGui::Text("Imaginary frequency: %.1fi cm^-1", std::abs(*min_it));
                 }
             }
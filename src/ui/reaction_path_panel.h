@@ -2,14 +2,17 @@
 
 #include "backend/backend_manager.h"
 #include "core/molecular_system.h"
-#include "renderer/mol_renderer.h"
 #include "ui/app_state.h"
 
+#include <functional>
+
 namespace sbox::ui {
 
+// Path playback writes images into `mol` and then calls `geometry_changed` so the caller can bring
+// its renderers and spatial index up to date.
 void draw_reaction_path_panel(AppState& state,
                               sbox::backend::BackendManager& backend,
                               sbox::chem::MolecularSystem& mol,
-                              sbox::render::MolRenderer& renderer);
+                              const std::function<void()>& geometry_changed);
 
 }  // namespace sbox::ui
@@ -0,0 +1,45 @@
+#include "ui/redraw_scheduler.h"
+
+#include <algorithm>
+
+namespace sbox::ui {
+
+bool RedrawScheduler::update(const FrameActivity& activity, double now) {
+    if (activity.ui_input || activity.scene_input) {
+        last_input_time_ = now;
+        ui_frames_ = kSettleFrames;
+    } else if (ui_frames_ > 0) {
+        --ui_frames_;
+    }
+
+    if (activity.scene_input) {
+        render_frames_ = kSettleFrames;
+    } else if (invalidated_) {
+        render_frames_ = std::max(render_frames_, 1);
+    }
+    invalidated_ = false;
+
+    const bool render = render_frames_ > 0 || activity.animating;
+    if (render_frames_ > 0) {
+        --render_frames_;
+    }
+    animating_ = activity.animating;
+    background_work_ = activity.background_work;
+    text_input_ = activity.text_input;
+    return render;
+}
+
+double RedrawScheduler::wait_timeout(double now) const {
+    if (invalidated_ || animating_ || render_frames_ > 0 || ui_frames_ > 0) {
+        return 0.0;
+    }
+    if (now - last_input_time_ < kRecentInputSeconds) {
+        return kRecentInputWaitSeconds;
+    }
+    if (background_work_ || text_input_) {
+        return kBusyWaitSeconds;
+    }
+    return kIdleWaitSeconds;
+}
+
+}  // namespace sbox::ui
@@ -0,0 +1,44 @@
+#pragma once
+
+namespace sbox::ui {
+
+// Paces the main loop. Every frame reports what happened; the scheduler answers whether the viewport
+// must be rendered again or its last image can be presented as is, and how long the loop may then
+// block waiting for events. Input keeps the loop polling for a few frames so ImGui can settle hover
+// and layout changes; with nothing going on it sleeps until an event or a slow timeout.
+class RedrawScheduler {
+public:
+    struct FrameActivity {
+        bool ui_input = false;         // any input, including pointer motion over panels
+        bool scene_input = false;      // input that can change the scene: buttons, keys, wheel, viewport motion
+        bool animating = false;        // playback or refinement that advances every frame
+        bool background_work = false;  // jobs, loads or bakes whose completion is polled for
+        bool text_input = false;       // a focused text field, whose cursor blinks
+    };
+
+    // Frames kept running after input; widgets apply a click on its release, a frame or two later.
+    static constexpr int kSettleFrames = 3;
+    static constexpr double kIdleWaitSeconds = 0.5;
+    static constexpr double kBusyWaitSeconds = 0.1;
+    // Shortly after input, waits stay short so delayed tooltips and hover effects appear on time.
+    static constexpr double kRecentInputSeconds = 1.0;
+    static constexpr double kRecentInputWaitSeconds = 0.05;
+
+    // Marks the viewport stale from outside the input path: loaded files, job results, bakes, resizes.
+    void invalidate() { invalidated_ = true; }
+    // Records this frame's activity at time `now` (seconds); true when the viewport has to be rendered.
+    bool update(const FrameActivity& activity, double now);
+    // Seconds the next event wait may block; 0 means poll and run the next frame right away.
+    double wait_timeout(double now) const;
+
+private:
+    bool invalidated_ = true;
+    int render_frames_ = 0;
+    int ui_frames_ = 0;
+    bool animating_ = false;
+    bool background_work_ = false;
+    bool text_input_ = false;
+    double last_input_time_ = -1.0e9;
+};
+
+}  // namespace sbox::ui
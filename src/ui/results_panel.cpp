@@ -49,8 +49,8 @@ bool export_existing_file(const std::filesystem::path& source,
 
 void draw_results_panel(const AppState& state,
                         const sbox::backend::JobResult& result,
-                        const sbox::chem::MolecularSystem& mol) {
-    (void)state;
+                        const sbox::chem::MolecularSystem& mol,
+                        sbox::backend::VolumeCache& volumes) {
     if (!result.converged()) {
         return;
     }
@@ -181,7 +181,8 @@ void draw_results_panel(const AppState& state,
     const std::filesystem::path density_cube_path = work_dir / "density.cube";
 
     const bool have_molden = std::filesystem::exists(molden_path);
-    const bool have_cube = std::filesystem::exists(homo_cube_path) || std::filesystem::exists(density_cube_path);
+    const bool have_cube = volumes.can_generate() || result.has_homo_cube || result.has_density_cube
+        || std::filesystem::exists(homo_cube_path) || std::filesystem::exists(density_cube_path);
 
     if (!have_molden) {
         ImGui::BeginDisabled();
@@ -209,10 +210,16 @@ void draw_results_panel(const AppState& state,
     if (ImGui::Button("Export Cube")) {
         const std::string path = save_file_dialog("Export Cube", "cube", "result.cube");
         if (!path.empty()) {
-            if (result.has_homo_cube) {
-                sbox::io::write_cube(path, result.homo_cube);
-            } else if (result.has_density_cube) {
-                sbox::io::write_cube(path, result.density_cube);
+            // The selected orbital if the result has orbitals, else the HOMO, else the density.
+            sbox::backend::VolumeCache::Volume volume = volumes.orbital(state.selected_mo);
+            if (!volume) {
+                volume = volumes.homo();
+            }
+            if (!volume) {
+                volume = volumes.density();
+            }
+            if (volume) {
+                sbox::io::write_cube(path, *volume);
             } else if (std::filesystem::exists(homo_cube_path)) {
                 std::filesystem::copy_file(homo_cube_path, path, std::filesystem::copy_options::overwrite_existing);
             } else if (std::filesystem::exists(density_cube_path)) {
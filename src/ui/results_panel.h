@@ -1,6 +1,7 @@
 #pragma once
 
 #include "backend/job_types.h"
+#include "backend/volume_cache.h"
 #include "core/molecular_system.h"
 #include "ui/app_state.h"
 
@@ -8,6 +9,7 @@ namespace sbox::ui {
 
 void draw_results_panel(const AppState& state,
                         const sbox::backend::JobResult& result,
-                        const sbox::chem::MolecularSystem& mol);
+                        const sbox::chem::MolecularSystem& mol,
+                        sbox::backend::VolumeCache& volumes);
 
 }  // namespace sbox::ui
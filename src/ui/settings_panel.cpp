@@ -161,6 +161,17 @@ void draw_settings_panel(sbox::Settings& settings,
             ImGui::SameLine();
             help_marker("Higher values improve volume quality but cost performance. Default: 192.");
             ImGui::SliderInt("Isosurface Steps", &settings.isosurface_steps, 64, 512);
+            ImGui::Checkbox("Bake Orbitals to Grid", &settings.bake_orbitals);
+            ImGui::SameLine();
+            help_marker("Evaluates the selected orbital once on a grid at the cube resolution and ray-marches that. "
+                        "Turn off to evaluate every basis shell per ray sample (exact, but slow for large basis sets).");
+            ImGui::Checkbox("Progressive Volume Rendering", &settings.progressive_raymarch);
+            ImGui::SameLine();
+            help_marker("Ray-marches orbitals at reduced resolution while the view changes, then refines them over the "
+                        "next frames once it holds still. Screenshots and exports always render at full quality.");
+            if (settings.progressive_raymarch) {
+                ImGui::SliderFloat("Interactive Budget (ms)", &settings.raymarch_budget_ms, 4.0f, 33.0f, "%.0f");
+            }
             ImGui::SliderFloat("Default Iso Value", &settings.default_iso_value, 0.0001f, 0.1f, "%.4f", ImGuiSliderFlags_Logarithmic);
             ImGui::SliderFloat("Default Gamma", &settings.default_gamma, 0.1f, 1.0f, "%.2f");
             ImGui::SliderFloat("Atom Size Scale", &settings.atom_scale, 0.2f, 3.0f, "%.1f");
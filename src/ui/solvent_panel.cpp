@@ -133,15 +133,16 @@ void draw_solvent_panel(AppState& state, sbox::backend::BackendManager& backend)
         draw_progress_block("Solvent", panel.solvent_job_id, backend);
     }
 
-    if (panel.gas_done && panel.solvent_done && panel.gas_result.converged() && panel.solvent_result.converged()) {
-        const double gas_e_h = panel.gas_result.total_energy;
-        const double solv_e_h = panel.solvent_result.total_energy;
+    if (panel.gas_done && panel.solvent_done && panel.gas_result && panel.solvent_result
+        && panel.gas_result->converged() && panel.solvent_result->converged()) {
+        const double gas_e_h = panel.gas_result->total_energy;
+        const double solv_e_h = panel.solvent_result->total_energy;
         const double delta_h = solv_e_h - gas_e_h;
         const double delta_kcal = delta_h * 627.509;
-        const double gas_homo = homo_ev(panel.gas_result);
-        const double solv_homo = homo_ev(panel.solvent_result);
-        const double gas_lumo = lumo_ev(panel.gas_result);
-        const double solv_lumo = lumo_ev(panel.solvent_result);
+        const double gas_homo = homo_ev(*panel.gas_result);
+        const double solv_homo = homo_ev(*panel.solvent_result);
+        const double gas_lumo = lumo_ev(*panel.gas_result);
+        const double solv_lumo = lumo_ev(*panel.solvent_result);
 
         if (ImGui::BeginTable("##solvent_compare", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
             ImGui::TableSetupColumn("Property");
@@ -168,12 +169,12 @@ void draw_solvent_panel(AppState& state, sbox::backend::BackendManager& backend)
             row("Total Energy (Hartree)", gas_e_h, solv_e_h, delta_h, "%.8f");
             row("Total Energy (eV)", energy_ev(gas_e_h), energy_ev(solv_e_h), energy_ev(delta_h), "%.4f");
             row("Solvation Energy (kcal/mol)", 0.0, 0.0, delta_kcal, "%.2f", true, true);
-            row("Dipole Moment (D)", dipole_mag(panel.gas_result), dipole_mag(panel.solvent_result),
-                dipole_mag(panel.solvent_result) - dipole_mag(panel.gas_result), "%.4f");
+            row("Dipole Moment (D)", dipole_mag(*panel.gas_result), dipole_mag(*panel.solvent_result),
+                dipole_mag(*panel.solvent_result) - dipole_mag(*panel.gas_result), "%.4f");
             row("HOMO (eV)", gas_homo, solv_homo, solv_homo - gas_homo, "%.3f");
             row("LUMO (eV)", gas_lumo, solv_lumo, solv_lumo - gas_lumo, "%.3f");
-            row("Gap (eV)", panel.gas_result.homo_lumo_gap_eV(), panel.solvent_result.homo_lumo_gap_eV(),
-                panel.solvent_result.homo_lumo_gap_eV() - panel.gas_result.homo_lumo_gap_eV(), "%.3f");
+            row("Gap (eV)", panel.gas_result->homo_lumo_gap_eV(), panel.solvent_result->homo_lumo_gap_eV(),
+                panel.solvent_result->homo_lumo_gap_eV() - panel.gas_result->homo_lumo_gap_eV(), "%.3f");
             ImGui::EndTable();
         }
 
@@ -182,8 +183,8 @@ void draw_solvent_panel(AppState& state, sbox::backend::BackendManager& backend)
         ImGui::SameLine();
         ImGui::TextDisabled("(%s)", solvation_classification(delta_kcal));
 
-        if (!panel.gas_result.mulliken_charges.empty() &&
-            panel.gas_result.mulliken_charges.size() == panel.solvent_result.mulliken_charges.size()) {
+        if (!panel.gas_result->mulliken_charges.empty() &&
+            panel.gas_result->mulliken_charges.size() == panel.solvent_result->mulliken_charges.size()) {
             ImGui::Separator();
             ImGui::TextUnformatted("Charge Comparison");
             if (ImGui::BeginTable("##charge_compare", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0.0f, 180.0f))) {
@@ -193,9 +194,9 @@ void draw_solvent_panel(AppState& state, sbox::backend::BackendManager& backend)
                 ImGui::TableSetupColumn("Solvent");
                 ImGui::TableSetupColumn("Delta");
                 ImGui::TableHeadersRow();
-                for (std::size_t i = 0; i < panel.gas_result.mulliken_charges.size(); ++i) {
-                    const double gas_q = panel.gas_result.mulliken_charges[i];
-                    const double solv_q = panel.solvent_result.mulliken_charges[i];
+                for (std::size_t i = 0; i < panel.gas_result->mulliken_charges.size(); ++i) {
+                    const double gas_q = panel.gas_result->mulliken_charges[i];
+                    const double solv_q = panel.solvent_result->mulliken_charges[i];
                     const double dq = solv_q - gas_q;
                     ImGui::TableNextRow();
                     if (std::abs(dq) > 0.05) {
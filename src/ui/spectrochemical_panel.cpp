@@ -223,7 +223,7 @@ void draw_spectrochemical_panel(AppState& state,
     bool all_complete = !spec.results.empty();
     for (auto& result : spec.results) {
         if (!result.complete) {
-            const sbox::backend::JobResult* backend_result = backend.result(result.job_id);
+            const sbox::backend::JobResultHandle backend_result = backend.result(result.job_id);
             if (backend_result != nullptr && backend_result->converged() &&
                 backend_result->has_mo_data && backend_result->mo_data.coefficients.cols() > 0) {
                 result.energy = backend_result->total_energy;
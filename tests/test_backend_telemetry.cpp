@@ -0,0 +1,137 @@
+#include "backend/backend_manager.h"
+#include "backend/job_types.h"
+
+#include <gtest/gtest.h>
+#include <json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using sbox::backend::BackendManager;
+using sbox::backend::JobSpec;
+using sbox::backend::JobStatus;
+using sbox::backend::JobTelemetry;
+
+// No Python environment is configured, so every job fails before a driver is spawned.
+void wait_for_jobs(BackendManager& backend, std::size_t count) {
+    std::size_t finished = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (finished < count && std::chrono::steady_clock::now() < deadline) {
+        finished += backend.poll_completed().size();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(finished, count);
+}
+
+}  // namespace
+
+TEST(BackendTelemetryTest, JobThatNeverSpawnedSpendsItsWallTimeQueued) {
+    BackendManager backend;
+    const int job_id = backend.submit(JobSpec{});
+    wait_for_jobs(backend, 1);
+
+    const std::vector<JobTelemetry> history = backend.telemetry();
+    ASSERT_EQ(history.size(), 1U);
+    const JobTelemetry& telemetry = history.front();
+    EXPECT_EQ(telemetry.job_id, job_id);
+    EXPECT_EQ(telemetry.driver, "pyscf_driver");
+    EXPECT_EQ(telemetry.status, JobStatus::Failed);
+    EXPECT_EQ(telemetry.spawned_at, 0.0);
+    EXPECT_GT(telemetry.submitted_at, 0.0);
+    EXPECT_GE(telemetry.finished_at, telemetry.submitted_at);
+    EXPECT_DOUBLE_EQ(telemetry.queue_wait_seconds, telemetry.wall_seconds);
+    EXPECT_EQ(telemetry.peak_rss_kb, 0);
+    EXPECT_EQ(backend.result(job_id)->telemetry.job_id, job_id);
+}
+
+TEST(BackendTelemetryTest, SummaryReportsThroughputAndStages) {
+    BackendManager backend;
+    EXPECT_EQ(backend.telemetry_summary().jobs, 0);
+
+    backend.submit(JobSpec{});
+    backend.submit(JobSpec{});
+    wait_for_jobs(backend, 2);
+
+    const BackendManager::TelemetrySummary summary = backend.telemetry_summary();
+    EXPECT_EQ(summary.jobs, 2);
+    EXPECT_GT(summary.jobs_per_minute, 0.0);
+    ASSERT_FALSE(summary.stages.empty());
+    const auto queue = std::find_if(summary.stages.begin(), summary.stages.end(), [](const auto& stage) {
+        return stage.name == "queue";
+    });
+    ASSERT_NE(queue, summary.stages.end());
+    EXPECT_EQ(queue->jobs, 2);
+    for (std::size_t i = 1; i < summary.stages.size(); ++i) {
+        EXPECT_GE(summary.stages[i - 1].total_seconds, summary.stages[i].total_seconds);
+    }
+}
+
+TEST(BackendTelemetryTest, LogHasOneJsonObjectPerJob) {
+    const std::filesystem::path log_path =
+        std::filesystem::temp_directory_path() / ("sbox_telemetry_test_" + std::to_string(::getpid()) + ".jsonl");
+    std::filesystem::remove(log_path);
+
+    std::set<int> submitted;
+    {
+        BackendManager backend;
+        backend.set_telemetry_log(log_path.string());
+        submitted.insert(backend.submit(JobSpec{}));
+        submitted.insert(backend.submit(JobSpec{}));
+        wait_for_jobs(backend, 2);
+    }
+
+    std::ifstream in(log_path);
+    ASSERT_TRUE(in.good());
+    std::set<int> logged;
+    std::string line;
+    while (std::getline(in, line)) {
+        const nlohmann::json entry = nlohmann::json::parse(line);
+        EXPECT_EQ(entry.at("status"), "failed");
+        EXPECT_TRUE(entry.contains("queue_wait_s"));
+        EXPECT_TRUE(entry.contains("peak_rss_kb"));
+        logged.insert(entry.at("job_id").get<int>());
+    }
+    EXPECT_EQ(logged, submitted);
+    std::filesystem::remove(log_path);
+}
+
+TEST(BackendTelemetryTest, LogRotatesOnceItReachesItsCap) {
+    const std::filesystem::path log_path =
+        std::filesystem::temp_directory_path() / ("sbox_telemetry_rotate_" + std::to_string(::getpid()) + ".jsonl");
+    const std::filesystem::path rotated_path = log_path.string() + ".1";
+    std::filesystem::remove(log_path);
+    std::filesystem::remove(rotated_path);
+
+    {
+        BackendManager backend;
+        // Any one entry exceeds the cap, so every entry after the first starts a fresh log.
+        backend.set_telemetry_log(log_path.string(), 1);
+        for (int i = 0; i < 3; ++i) {
+            backend.submit(JobSpec{});
+            wait_for_jobs(backend, 1);
+        }
+    }
+
+    auto line_count = [](const std::filesystem::path& path) {
+        std::ifstream in(path);
+        int lines = 0;
+        std::string line;
+        while (std::getline(in, line)) {
+            ++lines;
+        }
+        return lines;
+    };
+    EXPECT_EQ(line_count(log_path), 1);
+    EXPECT_EQ(line_count(rotated_path), 1);
+    std::filesystem::remove(log_path);
+    std::filesystem::remove(rotated_path);
+}
@@ -0,0 +1,138 @@
+#include "batch_compute.h"
+
+#include <gtest/gtest.h>
+#include <json.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using nlohmann::json;
+
+std::vector<json> read_lines(const std::string& text) {
+    std::vector<json> records;
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line)) {
+        records.push_back(json::parse(line));
+    }
+    return records;
+}
+
+std::string write_water(const std::string& name) {
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / (name + "_" + std::to_string(::getpid()) + ".xyz");
+    std::ofstream out(path);
+    out << "3\nwater\nO 0.0 0.0 0.117\nH 0.0 0.757 -0.469\nH 0.0 -0.757 -0.469\n";
+    return path.string();
+}
+
+}  // namespace
+
+TEST(BatchComputeTest, RecordOfConvergedJobCarriesResults) {
+    sbox::ComputeRequest request;
+    request.input_file = "water.xyz";
+    request.method = sbox::backend::Method::GFN2_XTB;
+    request.optimize = true;
+
+    sbox::backend::JobResult result;
+    result.job_id = 7;
+    result.status = sbox::backend::JobStatus::Converged;
+    result.total_energy = -5.07;
+    result.dipole_moment = Eigen::Vector3d(0.0, 0.0, 2.0);
+    result.mulliken_charges = {-0.6, 0.3, 0.3};
+    result.has_optimized_geometry = true;
+    result.optimization_converged = true;
+    result.optimized_geometry.add_atom({8, Eigen::Vector3d(0.0, 0.0, 0.1), "", 0});
+    result.telemetry.wall_seconds = 1.5;
+    result.telemetry.scf_seconds = 0.75;
+
+    const json record = sbox::compute_result_record(3, request, result);
+    EXPECT_EQ(record["index"], 3);
+    EXPECT_EQ(record["input"], "water.xyz");
+    EXPECT_EQ(record["method"], "gfn2-xtb");
+    EXPECT_TRUE(record["basis"].is_null());
+    EXPECT_EQ(record["status"], "converged");
+    EXPECT_DOUBLE_EQ(record["energy"].get<double>(), -5.07);
+    EXPECT_DOUBLE_EQ(record["dipole_norm"].get<double>(), 2.0);
+    EXPECT_EQ(record["mulliken_charges"].size(), 3u);
+    EXPECT_FALSE(record.contains("lowdin_charges"));
+    EXPECT_TRUE(record["optimization_converged"].get<bool>());
+    ASSERT_EQ(record["geometry"].size(), 1u);
+    EXPECT_EQ(record["geometry"][0][0], "O");
+    EXPECT_DOUBLE_EQ(record["timings"]["scf_s"].get<double>(), 0.75);
+    EXPECT_DOUBLE_EQ(record["timings"]["wall_s"].get<double>(), 1.5);
+}
+
+TEST(BatchComputeTest, RecordOfFailedJobHasNoResults) {
+    sbox::ComputeRequest request;
+    request.input_file = "water.xyz";
+    sbox::backend::JobResult result;
+    result.status = sbox::backend::JobStatus::Failed;
+    result.error_message = "SCF did not converge";
+    result.total_energy = -1.0;
+
+    const json record = sbox::compute_result_record(0, request, result);
+    EXPECT_EQ(record["status"], "failed");
+    EXPECT_EQ(record["error"], "SCF did not converge");
+    EXPECT_EQ(record["basis"], "sto-3g");
+    EXPECT_FALSE(record.contains("energy"));
+    EXPECT_TRUE(record.contains("timings"));
+}
+
+TEST(BatchComputeTest, JobSpecRequestsTheReportedProperties) {
+    using sbox::backend::PropertyRequest;
+    const std::string water = write_water("sbox_batch_spec");
+    sbox::ComputeRequest request;
+    request.input_file = water;
+
+    const auto has = [](const sbox::backend::JobSpec& spec, PropertyRequest property) {
+        return std::find(spec.properties.begin(), spec.properties.end(), property) != spec.properties.end();
+    };
+    const sbox::backend::JobSpec single_point = sbox::compute_job_spec(request);
+    EXPECT_EQ(single_point.geometry.num_atoms(), 3);
+    EXPECT_TRUE(has(single_point, PropertyRequest::MullikenCharges));
+    EXPECT_TRUE(has(single_point, PropertyRequest::LowdinCharges));
+    EXPECT_TRUE(has(single_point, PropertyRequest::DipoleMoment));
+    EXPECT_FALSE(has(single_point, PropertyRequest::Optimization));
+
+    request.optimize = true;
+    const sbox::backend::JobSpec optimization = sbox::compute_job_spec(request);
+    EXPECT_TRUE(optimization.optimize_geometry);
+    EXPECT_TRUE(has(optimization, PropertyRequest::Optimization));
+    std::filesystem::remove(water);
+}
+
+// No Python environment is configured, so every submitted job fails before a driver is spawned.
+TEST(BatchComputeTest, EveryRequestGetsOneRecord) {
+    const std::string water = write_water("sbox_batch_compute");
+    std::vector<sbox::ComputeRequest> requests(5);
+    for (sbox::ComputeRequest& request : requests) {
+        request.input_file = water;
+    }
+    requests[2].input_file = water + ".missing.xyz";
+
+    sbox::backend::BackendManager backend;
+    std::ostringstream out;
+    const int failures = sbox::run_compute_batch(requests, backend, 2, out);
+    EXPECT_EQ(failures, 5);
+
+    const std::vector<json> records = read_lines(out.str());
+    ASSERT_EQ(records.size(), requests.size());
+    std::set<int> indices;
+    for (const json& record : records) {
+        indices.insert(record["index"].get<int>());
+        EXPECT_EQ(record["status"], "failed");
+        EXPECT_TRUE(record.contains("error"));
+        EXPECT_EQ(record.contains("job_id"), record["index"] != 2);
+    }
+    EXPECT_EQ(indices, (std::set<int>{0, 1, 2, 3, 4}));
+    std::filesystem::remove(water);
+}
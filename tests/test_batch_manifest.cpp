@@ -0,0 +1,129 @@
+#include "batch_manifest.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(BatchManifestTest, ParsesJsonArrayWithDefaults) {
+    sbox::RenderRequest defaults;
+    defaults.width = 640;
+    defaults.height = 480;
+    defaults.render_mode = "isosurface";
+
+    const std::vector<sbox::RenderRequest> requests = sbox::parse_render_manifest(
+        R"([{"input": "water.molden", "output": "a.png", "orbital": "lumo", "yaw": 30},
+            {"output": "b.png", "orbital": 3, "resolution": "256x128", "zoom": 2.0, "render_mode": "phase"},
+            {"input": "benzene.xyz", "output": "c.jpg", "iso": 0.05, "pitch": -15}])",
+        defaults);
+
+    ASSERT_EQ(requests.size(), 3u);
+    EXPECT_EQ(requests[0].input_file, "water.molden");
+    EXPECT_EQ(requests[0].orbital, -2);
+    EXPECT_FLOAT_EQ(requests[0].yaw_deg, 30.0f);
+    EXPECT_EQ(requests[0].width, 640);
+    EXPECT_EQ(requests[0].render_mode, "isosurface");
+
+    EXPECT_EQ(requests[1].input_file, "water.molden");
+    EXPECT_EQ(requests[1].orbital, 3);
+    EXPECT_EQ(requests[1].width, 256);
+    EXPECT_EQ(requests[1].height, 128);
+    EXPECT_FLOAT_EQ(requests[1].zoom, 2.0f);
+    EXPECT_FLOAT_EQ(requests[1].yaw_deg, 0.0f);
+    EXPECT_EQ(requests[1].render_mode, "phase");
+
+    EXPECT_EQ(requests[2].input_file, "benzene.xyz");
+    EXPECT_EQ(requests[2].orbital, -1);
+    EXPECT_FLOAT_EQ(requests[2].iso_value, 0.05f);
+    EXPECT_FLOAT_EQ(requests[2].pitch_deg, -15.0f);
+}
+
+TEST(BatchManifestTest, ParsesJsonLinesAndSkipsBlankLines) {
+    const std::vector<sbox::RenderRequest> requests = sbox::parse_render_manifest(
+        "{\"input\": \"a.xyz\", \"output\": \"a.png\"}\n\n  \n{\"output\": \"a_side.png\", \"yaw\": 90}\n",
+        sbox::RenderRequest{});
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_EQ(requests[1].input_file, "a.xyz");
+    EXPECT_EQ(requests[1].output_path, "a_side.png");
+    EXPECT_TRUE(sbox::parse_render_manifest("  \n", sbox::RenderRequest{}).empty());
+}
+
+TEST(BatchManifestTest, RejectsMalformedEntries) {
+    const sbox::RenderRequest defaults;
+    EXPECT_THROW(sbox::parse_render_manifest("[{\"input\": \"a.xyz\"", defaults), std::runtime_error);
+    EXPECT_THROW(sbox::parse_render_manifest("{\"input\": \"a.xyz\"}", defaults), std::runtime_error);
+    EXPECT_THROW(sbox::parse_render_manifest("{\"output\": \"a.png\"}", defaults), std::runtime_error);
+    EXPECT_THROW(sbox::parse_render_manifest("[{\"input\": \"a\", \"output\": \"b\", \"orbital\": \"homo-1\"}]", defaults),
+                 std::runtime_error);
+    EXPECT_THROW(sbox::parse_render_manifest("[{\"input\": \"a\", \"output\": \"b\", \"resolution\": \"big\"}]", defaults),
+                 std::runtime_error);
+    EXPECT_THROW(sbox::parse_render_manifest("[{\"input\": \"a\", \"output\": \"b\", \"zoom\": 0}]", defaults),
+                 std::runtime_error);
+    EXPECT_THROW(sbox::parse_render_manifest("[3]", defaults), std::runtime_error);
+}
+
+TEST(BatchManifestTest, RequestFromCliCopiesScreenshotOptions) {
+    sbox::CLIOptions options;
+    options.input_file = "mol.molden";
+    options.screenshot_path = "out.png";
+    options.screenshot_width = 800;
+    options.screenshot_height = 600;
+    options.orbital = 4;
+    options.render_mode = "volume";
+    options.iso_value = 0.02f;
+    const sbox::RenderRequest request = sbox::render_request_from_cli(options);
+    EXPECT_EQ(request.input_file, "mol.molden");
+    EXPECT_EQ(request.output_path, "out.png");
+    EXPECT_EQ(request.width, 800);
+    EXPECT_EQ(request.height, 600);
+    EXPECT_EQ(request.orbital, 4);
+    EXPECT_EQ(request.render_mode, "volume");
+    EXPECT_FLOAT_EQ(request.iso_value, 0.02f);
+    EXPECT_FLOAT_EQ(request.zoom, 1.0f);
+}
+
+TEST(BatchManifestTest, ParsesComputeManifestWithPathsAndObjects) {
+    sbox::ComputeRequest defaults;
+    defaults.method = sbox::backend::Method::GFN2_XTB;
+    defaults.optimize = true;
+
+    const std::vector<sbox::ComputeRequest> requests = sbox::parse_compute_manifest(
+        "\"water.xyz\"\n"
+        "{\"input\": \"ion.sdf\", \"method\": \"B3LYP\", \"basis\": \"def2-svp\", \"charge\": -1, \"optimize\": false}\n"
+        "{\"input\": \"radical.xyz\", \"multiplicity\": 2}\n",
+        defaults);
+
+    ASSERT_EQ(requests.size(), 3u);
+    EXPECT_EQ(requests[0].input_file, "water.xyz");
+    EXPECT_EQ(requests[0].method, sbox::backend::Method::GFN2_XTB);
+    EXPECT_TRUE(requests[0].optimize);
+
+    EXPECT_EQ(requests[1].method, sbox::backend::Method::DFT_B3LYP);
+    EXPECT_EQ(requests[1].basis, sbox::backend::BasisSetType::def2_SVP);
+    EXPECT_EQ(requests[1].charge, -1);
+    EXPECT_FALSE(requests[1].optimize);
+
+    EXPECT_EQ(requests[2].multiplicity, 2);
+    EXPECT_EQ(requests[2].charge, 0);
+}
+
+TEST(BatchManifestTest, RejectsUnknownComputeSettings) {
+    const sbox::ComputeRequest defaults;
+    EXPECT_THROW(sbox::parse_compute_manifest("[{\"input\": \"a.xyz\", \"method\": \"dft\"}]", defaults), std::runtime_error);
+    EXPECT_THROW(sbox::parse_compute_manifest("[{\"input\": \"a.xyz\", \"basis\": \"6-31+g\"}]", defaults), std::runtime_error);
+    EXPECT_THROW(sbox::parse_compute_manifest("[{\"input\": \"a.xyz\", \"multiplicity\": 0}]", defaults), std::runtime_error);
+    EXPECT_THROW(sbox::parse_compute_manifest("[{\"method\": \"hf\"}]", defaults), std::runtime_error);
+    EXPECT_THROW(sbox::parse_compute_manifest("[4]", defaults), std::runtime_error);
+
+    sbox::CLIOptions options;
+    options.method = "PBE0";
+    options.basis = "cc-pVDZ";
+    options.optimize = true;
+    const sbox::ComputeRequest request = sbox::compute_request_from_cli(options);
+    EXPECT_EQ(request.method, sbox::backend::Method::DFT_PBE0);
+    EXPECT_EQ(request.basis, sbox::backend::BasisSetType::cc_pVDZ);
+    EXPECT_TRUE(request.optimize);
+    options.method = "hartree-fock";
+    EXPECT_THROW(sbox::compute_request_from_cli(options), std::runtime_error);
+}
@@ -0,0 +1,126 @@
+#include "core/basis_set.h"
+#include "core/gaussian_eval.h"
+#include "renderer/brick_grid.h"
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Core>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+sbox::basis::MOData make_diffuse_mo() {
+    sbox::basis::MOData mo_data;
+    mo_data.basis.spherical = true;
+    mo_data.atom_positions = {Eigen::Vector3d(0.0, 0.0, -1.4), Eigen::Vector3d(0.0, 0.0, 1.4)};
+
+    sbox::basis::BasisShell s;
+    s.atom_index = 0;
+    s.angular_momentum = 0;
+    s.primitives = {{3.42525091, 0.15432897}, {0.62391373, 0.53532814}, {0.16885540, 0.44463454}};
+    mo_data.basis.shells.push_back(s);
+
+    sbox::basis::BasisShell p;
+    p.atom_index = 1;
+    p.angular_momentum = 1;
+    p.primitives = {{0.8, 0.7}, {0.05, 0.3}};
+    mo_data.basis.shells.push_back(p);
+
+    sbox::basis::BasisShell d;
+    d.atom_index = 1;
+    d.angular_momentum = 2;
+    d.primitives = {{0.4, 1.0}};
+    mo_data.basis.shells.push_back(d);
+
+    sbox::basis::BasisShell f;
+    f.atom_index = 0;
+    f.angular_momentum = 3;
+    f.primitives = {{0.3, 0.8}};
+    mo_data.basis.shells.push_back(f);
+
+    const int num_basis = mo_data.basis.num_basis_functions();
+    mo_data.coefficients = Eigen::MatrixXd(num_basis, 2);
+    for (int mu = 0; mu < num_basis; ++mu) {
+        mo_data.coefficients(mu, 0) = 0.3 * std::cos(1.7 * mu);
+        mo_data.coefficients(mu, 1) = mu == 0 ? 1.0 : 0.0;
+    }
+    mo_data.energies = Eigen::VectorXd::Zero(2);
+    mo_data.occupations = Eigen::VectorXd::Zero(2);
+    mo_data.total_energy = 0.0;
+    return mo_data;
+}
+
+}  // namespace
+
+TEST(BrickGridTest, VolumeBricksCoverTheFilteringApron) {
+    const int n = 20;
+    std::vector<float> data(static_cast<std::size_t>(n * n * n), 0.0f);
+    data[static_cast<std::size_t>((8 * n + 3) * n + 3)] = -2.0f;  // voxel (8, 3, 3), z fastest
+
+    const sbox::render::BrickGrid grid =
+        sbox::render::build_volume_bricks(data.data(), n, n, n, Eigen::Vector3f::Zero(), Eigen::Matrix3f::Identity());
+
+    ASSERT_EQ(grid.dims, Eigen::Vector3i(3, 3, 3));
+    EXPECT_FLOAT_EQ(grid.at(1, 0, 0), 2.0f);
+    EXPECT_FLOAT_EQ(grid.at(0, 0, 0), 2.0f);  // voxel 8 is in brick 0's apron
+    EXPECT_FLOAT_EQ(grid.at(2, 0, 0), 0.0f);
+    EXPECT_FLOAT_EQ(grid.at(1, 1, 0), 0.0f);
+    EXPECT_FLOAT_EQ(grid.bound_at(Eigen::Vector3f(9.5f, 2.0f, 2.0f), -1.0f), 2.0f);
+    EXPECT_FLOAT_EQ(grid.bound_at(Eigen::Vector3f(-0.5f, 2.0f, 2.0f), -1.0f), -1.0f);
+}
+
+TEST(BrickGridTest, VolumeBricksFollowTheGridTransform) {
+    const int n = 16;
+    std::vector<float> data(static_cast<std::size_t>(n * n * n), 0.0f);
+    data[static_cast<std::size_t>((12 * n + 12) * n + 12)] = 1.0f;
+
+    const Eigen::Vector3f origin(-4.0f, -4.0f, -4.0f);
+    const Eigen::Matrix3f world_to_grid = Eigen::Matrix3f::Identity() * 2.0f;  // 0.5 bohr spacing
+    const sbox::render::BrickGrid grid = sbox::render::build_volume_bricks(data.data(), n, n, n, origin, world_to_grid);
+
+    ASSERT_EQ(grid.dims, Eigen::Vector3i(2, 2, 2));
+    EXPECT_FLOAT_EQ(grid.bound_at(Eigen::Vector3f(2.0f, 2.0f, 2.0f), 0.0f), 1.0f);
+    EXPECT_FLOAT_EQ(grid.bound_at(Eigen::Vector3f(-2.0f, -2.0f, -2.0f), 0.0f), 0.0f);
+}
+
+TEST(BrickGridTest, OrbitalBricksBoundTheOrbitalEverywhere) {
+    const sbox::basis::MOData mo_data = make_diffuse_mo();
+    const float radius = 8.0f;
+    const sbox::render::BrickGrid grid = sbox::render::build_orbital_bricks(mo_data, 0, radius, 16);
+    ASSERT_EQ(grid.dims, Eigen::Vector3i(16, 16, 16));
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-radius, radius);
+    for (int i = 0; i < 20000; ++i) {
+        const Eigen::Vector3d point(coord(rng), coord(rng), coord(rng));
+        const double psi = sbox::basis::evaluate_mo_at_point(mo_data, 0, point);
+        ASSERT_GE(grid.bound_at(point.cast<float>(), 0.0f), std::abs(psi)) << point.transpose();
+    }
+}
+
+TEST(BrickGridTest, OrbitalBricksAreTightFarFromCompactShells) {
+    const sbox::basis::MOData mo_data = make_diffuse_mo();
+    const sbox::render::BrickGrid grid = sbox::render::build_orbital_bricks(mo_data, 1, 12.0f, 24);
+
+    // MO 1 is only the compact s shell on atom 0; the corner bricks are far outside its reach.
+    EXPECT_LT(grid.at(0, 0, 0), 1e-6f);
+    EXPECT_GT(grid.bound_at(Eigen::Vector3f(0.0f, 0.0f, -1.4f), 0.0f), 0.5f);
+
+    std::size_t empty_bricks = 0;
+    for (const float bound : grid.max_abs) {
+        if (bound * bound < 1e-6f) {
+            ++empty_bricks;
+        }
+    }
+    EXPECT_GT(empty_bricks, grid.max_abs.size() * 9 / 10);
+}
+
+TEST(BrickGridTest, InvalidInputsGiveAnEmptyGrid) {
+    const sbox::basis::MOData mo_data = make_diffuse_mo();
+    EXPECT_TRUE(sbox::render::build_orbital_bricks(mo_data, 5, 8.0f).empty());
+    EXPECT_TRUE(sbox::render::build_orbital_bricks(mo_data, 0, 0.0f).empty());
+    EXPECT_TRUE(sbox::render::build_volume_bricks(nullptr, 4, 4, 4, Eigen::Vector3f::Zero(), Eigen::Matrix3f::Identity()).empty());
+}
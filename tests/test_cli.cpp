@@ -52,6 +52,39 @@ TEST(CLI, ScreenshotAndResolution) {
     EXPECT_EQ(options.screenshot_height, 1080);
 }
 
+TEST(CLI, RenderBatchManifest) {
+    std::vector<std::string> args = {"schrodingers_sandbox", "--render-batch", "views.jsonl", "--resolution", "512x512"};
+    std::vector<char*> argv = make_argv(args);
+    const sbox::CLIOptions options = sbox::parse_cli(static_cast<int>(argv.size()), argv.data());
+    EXPECT_EQ(options.render_manifest, "views.jsonl");
+    EXPECT_TRUE(options.input_file.empty());
+    EXPECT_EQ(options.screenshot_width, 512);
+}
+
+TEST(CLI, ComputeBatchOptions) {
+    std::vector<std::string> args = {"schrodingers_sandbox", "--compute", "a.xyz", "b.sdf", "--jobs", "4",
+                                     "--method", "b3lyp", "--output", "results.jsonl", "c.pdb"};
+    std::vector<char*> argv = make_argv(args);
+    const sbox::CLIOptions options = sbox::parse_cli(static_cast<int>(argv.size()), argv.data());
+    EXPECT_TRUE(options.compute);
+    EXPECT_EQ(options.input_file, "a.xyz");
+    EXPECT_EQ(options.input_files, (std::vector<std::string>{"a.xyz", "b.sdf", "c.pdb"}));
+    EXPECT_EQ(options.max_parallel_jobs, 4);
+    EXPECT_EQ(options.method, "b3lyp");
+    EXPECT_EQ(options.output_file, "results.jsonl");
+    EXPECT_FALSE(options.append_output);
+    EXPECT_TRUE(options.compute_manifest.empty());
+}
+
+TEST(CLI, AppendToOutput) {
+    std::vector<std::string> args = {"schrodingers_sandbox", "--compute", "a.xyz", "--output", "results.jsonl", "--append"};
+    std::vector<char*> argv = make_argv(args);
+    const sbox::CLIOptions options = sbox::parse_cli(static_cast<int>(argv.size()), argv.data());
+    EXPECT_EQ(options.output_file, "results.jsonl");
+    EXPECT_TRUE(options.append_output);
+    EXPECT_EQ(options.input_files, (std::vector<std::string>{"a.xyz"}));
+}
+
 TEST(CLI, OrbitalHomo) {
     std::vector<std::string> args = {"schrodingers_sandbox", "--orbital", "homo"};
     std::vector<char*> argv = make_argv(args);
@@ -0,0 +1,114 @@
+#include "backend/backend_manager.h"
+#include "backend/job_types.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using sbox::backend::read_ensemble_stream;
+
+class EnsembleStreamTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = std::filesystem::temp_directory_path() /
+                ("sbox_ensemble_stream_test_" + std::to_string(::getpid()) + ".jsonl");
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override { std::filesystem::remove(path_); }
+
+    void write(const std::string& contents) const {
+        std::ofstream out(path_, std::ios::binary);
+        out << contents;
+    }
+
+    std::filesystem::path path_;
+};
+
+}  // namespace
+
+TEST_F(EnsembleStreamTest, ParsesEveryField) {
+    write(R"({"index": 2, "success": true, "energy": -1.125, "dipole_moment": [0.1, 0.2, 0.3],)"
+          R"( "mulliken_charges": [0.25, -0.25], "wall_time": 1.5})"
+          "\n"
+          R"({"index": 0, "success": false, "error": "SCF did not converge"})"
+          "\n");
+
+    const auto members = read_ensemble_stream(path_);
+    ASSERT_EQ(members.size(), 2u);
+
+    EXPECT_EQ(members[0].index, 2);
+    EXPECT_TRUE(members[0].success);
+    EXPECT_DOUBLE_EQ(members[0].energy, -1.125);
+    EXPECT_DOUBLE_EQ(members[0].dipole_moment.y(), 0.2);
+    EXPECT_EQ(members[0].mulliken_charges, (std::vector<double>{0.25, -0.25}));
+    EXPECT_DOUBLE_EQ(members[0].wall_time_seconds, 1.5);
+    EXPECT_TRUE(members[0].error.empty());
+
+    EXPECT_EQ(members[1].index, 0);
+    EXPECT_FALSE(members[1].success);
+    EXPECT_TRUE(members[1].mulliken_charges.empty());
+    EXPECT_EQ(members[1].error, "SCF did not converge");
+}
+
+TEST_F(EnsembleStreamTest, KeepsCompletionOrder) {
+    write("{\"index\": 3, \"success\": true, \"energy\": -3.0}\n"
+          "{\"index\": 1, \"success\": true, \"energy\": -1.0}\n"
+          "{\"index\": 2, \"success\": true, \"energy\": -2.0}\n");
+
+    const auto members = read_ensemble_stream(path_);
+    ASSERT_EQ(members.size(), 3u);
+    EXPECT_EQ(members[0].index, 3);
+    EXPECT_EQ(members[1].index, 1);
+    EXPECT_EQ(members[2].index, 2);
+}
+
+TEST_F(EnsembleStreamTest, SkipsBlankMalformedAndPartialLines) {
+    write("{\"index\": 0, \"success\": true, \"energy\": -1.0}\n"
+          "\n"
+          "[1, 2, 3]\n"
+          "not json\n"
+          "{\"index\": 1, \"success\": true, \"energy\": -1.5}\n"
+          "{\"index\": 2, \"succ");
+
+    const auto members = read_ensemble_stream(path_);
+    ASSERT_EQ(members.size(), 2u);
+    EXPECT_EQ(members[0].index, 0);
+    EXPECT_EQ(members[1].index, 1);
+}
+
+TEST_F(EnsembleStreamTest, MissingFileIsEmpty) {
+    EXPECT_TRUE(read_ensemble_stream(path_).empty());
+}
+
+// No Python environment is configured, so the job fails before a driver is spawned.
+TEST(EnsembleJobTest, IsAttributedToTheEnsembleDriver) {
+    sbox::backend::BackendManager backend;
+    sbox::backend::JobSpec spec;
+    spec.run_ensemble = true;
+    spec.ensemble.geometries.resize(3);
+    const int job_id = backend.submit(spec);
+
+    std::size_t finished = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (finished == 0 && std::chrono::steady_clock::now() < deadline) {
+        finished += backend.poll_completed().size();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(finished, 1U);
+
+    const sbox::backend::JobResultHandle result = backend.result(job_id);
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->status, sbox::backend::JobStatus::Failed);
+    EXPECT_EQ(result->telemetry.driver, "ensemble_driver");
+    EXPECT_FALSE(result->has_ensemble);
+    EXPECT_TRUE(backend.get_progress(job_id).ensemble.empty());
+}
@@ -0,0 +1,195 @@
+#include "io/cube_io.h"
+#include "io/file_loader.h"
+
+#include <Eigen/Core>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using sbox::io::FileKind;
+using sbox::io::FileLoader;
+using sbox::io::LoadedFile;
+
+std::filesystem::path temp_path(const std::string& name) {
+    return std::filesystem::temp_directory_path() / ("sbox_loader_" + std::to_string(::getpid()) + "_" + name);
+}
+
+std::filesystem::path write_water_xyz() {
+    const std::filesystem::path path = temp_path("water.xyz");
+    std::ofstream out(path);
+    out << "3\nwater\n"
+        << "O 0.000 0.000 0.117\n"
+        << "H 0.000 0.757 -0.467\n"
+        << "H 0.000 -0.757 -0.467\n";
+    return path;
+}
+
+// 60^3 values: large enough for several progress reports from the cube reader.
+std::filesystem::path write_large_cube() {
+    sbox::io::CubeData cube;
+    cube.comment1 = "loader test";
+    cube.comment2 = "progress";
+    cube.atom_Z = {1, 1};
+    cube.atom_pos = {Eigen::Vector3d(0.0, 0.0, -0.35), Eigen::Vector3d(0.0, 0.0, 0.35)};
+    cube.origin = Eigen::Vector3d(-2.0, -2.0, -2.0);
+    cube.step_x = Eigen::Vector3d(0.1, 0.0, 0.0);
+    cube.step_y = Eigen::Vector3d(0.0, 0.1, 0.0);
+    cube.step_z = Eigen::Vector3d(0.0, 0.0, 0.1);
+    cube.nx = 60;
+    cube.ny = 60;
+    cube.nz = 60;
+    cube.data.assign(60 * 60 * 60, 0.25f);
+    const std::filesystem::path path = temp_path("large.cube");
+    sbox::io::write_cube(path.string(), cube);
+    return path;
+}
+
+// Enough atoms for several progress reports from the line-based readers.
+constexpr int kLargeAtomCount = 20000;
+
+std::filesystem::path write_large_xyz() {
+    const std::filesystem::path path = temp_path("large.xyz");
+    std::ofstream out(path);
+    out << kLargeAtomCount << "\nlarge\n";
+    for (int i = 0; i < kLargeAtomCount; ++i) {
+        out << "C " << (i % 100) * 3.0 << ' ' << (i / 100) * 3.0 << " 0.0\n";
+    }
+    return path;
+}
+
+std::filesystem::path write_large_pdb() {
+    const std::filesystem::path path = temp_path("large.pdb");
+    std::ofstream out(path);
+    char line[96];
+    for (int i = 0; i < kLargeAtomCount; ++i) {
+        std::snprintf(line, sizeof(line), "ATOM  %5d  CA  ALA A%4d    %8.3f%8.3f%8.3f  1.00  0.00           C\n",
+                      i % 100000, i % 10000, (i % 100) * 3.0, (i / 100) * 3.0, 0.0);
+        out << line;
+    }
+    return path;
+}
+
+std::optional<LoadedFile> wait_for_load(FileLoader& loader) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (std::optional<LoadedFile> file = loader.take()) {
+            return file;
+        }
+        if (!loader.busy() && loader.path().empty()) {
+            return std::nullopt;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+TEST(FileLoaderTest, KindFollowsExtension) {
+    EXPECT_EQ(sbox::io::file_kind_from_path("/tmp/a.XYZ"), FileKind::XYZ);
+    EXPECT_EQ(sbox::io::file_kind_from_path("a.mol"), FileKind::SDF);
+    EXPECT_EQ(sbox::io::file_kind_from_path("a.fch"), FileKind::Fchk);
+    EXPECT_EQ(sbox::io::file_kind_from_path("a.ent"), FileKind::PDB);
+    EXPECT_THROW(sbox::io::file_kind_from_path("a.docx"), std::runtime_error);
+}
+
+TEST(FileLoaderTest, CubeReadReportsMonotonicProgressAndPerceivesBonds) {
+    const std::filesystem::path path = write_large_cube();
+    std::vector<double> reported;
+    const LoadedFile file = sbox::io::read_file(path.string(), FileKind::Cube, [&reported](double fraction) {
+        reported.push_back(fraction);
+        return true;
+    });
+    std::filesystem::remove(path);
+
+    ASSERT_GE(reported.size(), 3U);
+    for (std::size_t i = 1; i < reported.size(); ++i) {
+        EXPECT_GE(reported[i], reported[i - 1]);
+    }
+    EXPECT_DOUBLE_EQ(reported.back(), 1.0);
+    EXPECT_EQ(file.cube.data.size(), 60U * 60U * 60U);
+    EXPECT_EQ(file.molecule.num_atoms(), 2);
+    EXPECT_EQ(file.molecule.bonds().size(), 1U);
+}
+
+TEST(FileLoaderTest, ProgressCallbackCancelsTheRead) {
+    const std::filesystem::path path = write_large_cube();
+    int calls = 0;
+    EXPECT_THROW(sbox::io::read_file(path.string(), FileKind::Cube, [&calls](double) { return ++calls < 2; }),
+                 sbox::io::ReadCancelled);
+    std::filesystem::remove(path);
+}
+
+TEST(FileLoaderTest, LineBasedReadersCancelInsideTheParseLoop) {
+    for (const auto& [path, kind] : {std::pair{write_large_xyz(), FileKind::XYZ}, std::pair{write_large_pdb(), FileKind::PDB}}) {
+        // The first report is read_file's own 0.0; the next one has to come from inside the parser.
+        std::vector<double> reported;
+        EXPECT_THROW(sbox::io::read_file(path.string(), kind, [&reported](double fraction) {
+                         reported.push_back(fraction);
+                         return reported.size() < 2;
+                     }),
+                     sbox::io::ReadCancelled);
+        std::filesystem::remove(path);
+        ASSERT_EQ(reported.size(), 2U);
+        EXPECT_GT(reported[1], 0.0);
+        EXPECT_LT(reported[1], 0.8);
+    }
+}
+
+TEST(FileLoaderTest, LoadsOnWorkerAndHandsTheFileOverOnce) {
+    const std::filesystem::path path = write_water_xyz();
+    FileLoader loader;
+    loader.start(path.string(), FileKind::XYZ);
+    const std::optional<LoadedFile> file = wait_for_load(loader);
+    std::filesystem::remove(path);
+
+    ASSERT_TRUE(file.has_value());
+    EXPECT_EQ(file->kind, FileKind::XYZ);
+    EXPECT_EQ(file->path, path.string());
+    EXPECT_EQ(file->molecule.num_atoms(), 3);
+    EXPECT_FALSE(loader.take().has_value());
+    EXPECT_FALSE(loader.busy());
+}
+
+TEST(FileLoaderTest, ParseErrorIsRethrownOnTake) {
+    FileLoader loader;
+    loader.start(temp_path("missing.xyz").string(), FileKind::XYZ);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (loader.busy() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_THROW(loader.take(), std::runtime_error);
+}
+
+TEST(FileLoaderTest, CancelledLoadYieldsNothing) {
+    const std::filesystem::path path = write_large_cube();
+    FileLoader loader;
+    loader.start(path.string(), FileKind::Cube);
+    loader.cancel();
+    EXPECT_FALSE(loader.busy());
+    EXPECT_TRUE(loader.path().empty());
+    EXPECT_FALSE(loader.take().has_value());
+
+    // A newer load replaces one still in flight.
+    const std::filesystem::path xyz = write_water_xyz();
+    loader.start(path.string(), FileKind::Cube);
+    loader.start(xyz.string(), FileKind::XYZ);
+    const std::optional<LoadedFile> file = wait_for_load(loader);
+    ASSERT_TRUE(file.has_value());
+    EXPECT_EQ(file->kind, FileKind::XYZ);
+    std::filesystem::remove(path);
+    std::filesystem::remove(xyz);
+}
@@ -0,0 +1,85 @@
+#include "renderer/frame_writer_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using sbox::render::FrameWriterQueue;
+
+// One-row frames whose every byte is the frame number.
+std::vector<unsigned char> numbered_frame(int number, std::size_t size) {
+    return std::vector<unsigned char>(size, static_cast<unsigned char>(number));
+}
+
+}  // namespace
+
+TEST(FrameWriterQueueTest, WritesFramesInPushOrderAndDrainsOnFinish) {
+    std::mutex mutex;
+    std::vector<int> written;
+    FrameWriterQueue queue;
+    queue.start([&](const std::vector<unsigned char>& frame) {
+        // A slow writer keeps frames waiting, so finish() has a full queue to drain.
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard<std::mutex> lock(mutex);
+        written.push_back(frame.front());
+        return true;
+    });
+
+    constexpr int kFrames = 40;
+    for (int i = 0; i < kFrames; ++i) {
+        const std::vector<unsigned char> frame = numbered_frame(i, 16);
+        ASSERT_TRUE(queue.push(frame.data(), frame.size(), 1));
+    }
+    EXPECT_TRUE(queue.finish());
+
+    ASSERT_EQ(written.size(), static_cast<std::size_t>(kFrames));
+    for (int i = 0; i < kFrames; ++i) {
+        EXPECT_EQ(written[static_cast<std::size_t>(i)], i);
+    }
+    EXPECT_EQ(queue.frames_written(), kFrames);
+    const std::vector<unsigned char> late = numbered_frame(kFrames, 16);
+    EXPECT_FALSE(queue.push(late.data(), late.size(), 1));
+}
+
+TEST(FrameWriterQueueTest, FlipsBottomUpFrames) {
+    std::vector<unsigned char> received;
+    FrameWriterQueue queue;
+    queue.start([&](const std::vector<unsigned char>& frame) {
+        received = frame;
+        return true;
+    });
+    const std::vector<unsigned char> bottom_up = {0, 0, 1, 1, 2, 2};
+    ASSERT_TRUE(queue.push(bottom_up.data(), 2, 3, true));
+    ASSERT_TRUE(queue.finish());
+    EXPECT_EQ(received, (std::vector<unsigned char>{2, 2, 1, 1, 0, 0}));
+}
+
+TEST(FrameWriterQueueTest, FailedWriteStopsTheQueueWithoutHanging) {
+    int attempts = 0;
+    FrameWriterQueue queue;
+    queue.start([&](const std::vector<unsigned char>&) {
+        ++attempts;
+        return attempts < 3;
+    });
+
+    bool rejected = false;
+    for (int i = 0; i < 100 && !rejected; ++i) {
+        const std::vector<unsigned char> frame = numbered_frame(i, 8);
+        rejected = !queue.push(frame.data(), frame.size(), 1);
+        if (!rejected) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    EXPECT_TRUE(rejected);
+    EXPECT_FALSE(queue.finish());
+    EXPECT_TRUE(queue.failed());
+    EXPECT_EQ(queue.frames_written(), 2);
+    // Frames queued behind the failure are dropped, not written.
+    EXPECT_EQ(attempts, 3);
+}
@@ -128,3 +128,53 @@ TEST(GaussianEvalTest, BasisEvaluationSupportsSphericalDAndF) {
     EXPECT_NEAR(basis_values(0), 1.0, 1e-12);
     EXPECT_NEAR(basis_values(5), 1.0, 1e-12);
 }
+
+TEST(GaussianEvalTest, DensityMatrixContractionMatchesOccupiedOrbitalSum) {
+    sbox::basis::MOData mo_data;
+    mo_data.basis.spherical = true;
+    mo_data.atom_positions = {Eigen::Vector3d(0.0, 0.0, -1.0), Eigen::Vector3d(0.3, 0.0, 1.2)};
+    for (int atom = 0; atom < 2; ++atom) {
+        sbox::basis::BasisShell s;
+        s.atom_index = atom;
+        s.angular_momentum = 0;
+        s.primitives = {{1.2, 0.6}, {0.3, 0.5}};
+        mo_data.basis.shells.push_back(s);
+        sbox::basis::BasisShell d;
+        d.atom_index = atom;
+        d.angular_momentum = 2;
+        d.primitives = {{0.7, 1.0}};
+        mo_data.basis.shells.push_back(d);
+    }
+    const int num_basis = mo_data.basis.num_basis_functions();
+    mo_data.coefficients = Eigen::MatrixXd(num_basis, 4);
+    for (int mu = 0; mu < num_basis; ++mu) {
+        for (int i = 0; i < 4; ++i) {
+            mo_data.coefficients(mu, i) = std::sin(0.7 * mu + 1.3 * i);
+        }
+    }
+    mo_data.occupations = Eigen::Vector4d(2.0, 2.0, 1.0, 0.0);
+
+    const Eigen::MatrixXd density = sbox::basis::density_matrix(mo_data);
+    ASSERT_EQ(density.rows(), num_basis);
+    EXPECT_TRUE(density.isApprox(density.transpose()));
+
+    std::vector<double> values;
+    std::vector<int> active;
+    for (const Eigen::Vector3d& point : {Eigen::Vector3d(0.2, -0.4, 0.1), Eigen::Vector3d(1.0, 0.5, 1.5)}) {
+        Eigen::VectorXd basis_values;
+        sbox::basis::evaluate_basis_at_point(mo_data, point, basis_values);
+        values.assign(basis_values.data(), basis_values.data() + basis_values.size());
+        double expected = 0.0;
+        for (int i = 0; i < 3; ++i) {
+            const double psi = sbox::basis::evaluate_mo_at_point(mo_data, i, point);
+            expected += mo_data.occupations(i) * psi * psi;
+        }
+        EXPECT_NEAR(sbox::basis::contract_density(density, values, active), expected, 1e-10);
+    }
+
+    // Screened-out functions carry no pairs.
+    values.assign(static_cast<std::size_t>(num_basis), 0.0);
+    values[2] = 0.5;
+    EXPECT_NEAR(sbox::basis::contract_density(density, values, active), 0.25 * density(2, 2), 1e-14);
+    EXPECT_EQ(active.size(), 1U);
+}
@@ -117,10 +117,77 @@ TEST(GpuCrossvalTest, BasisPackingMatchesExpectedCpuData) {
     EXPECT_FLOAT_EQ(prim_data[5], 0.53532814f);
 
     const auto& mo_coeff = textures.mo_coeff_data();
-    ASSERT_EQ(mo_coeff.size(), 8U);
+    ASSERT_EQ(mo_coeff.size(), 4U);
     const float inv_sqrt2 = static_cast<float>(1.0 / std::sqrt(2.0));
     EXPECT_NEAR(mo_coeff[0], inv_sqrt2, 1e-6f);
     EXPECT_NEAR(mo_coeff[1], inv_sqrt2, 1e-6f);
-    EXPECT_NEAR(mo_coeff[4], inv_sqrt2, 1e-6f);
-    EXPECT_NEAR(mo_coeff[1 + 4], -inv_sqrt2, 1e-6f);
+    EXPECT_NEAR(mo_coeff[2], inv_sqrt2, 1e-6f);
+    EXPECT_NEAR(mo_coeff[3], -inv_sqrt2, 1e-6f);
+}
+
+TEST(GpuCrossvalTest, PackingHasNoFixedShellOrOrbitalCap) {
+    sbox::basis::MOData mo_data = make_h2_sto3g();
+    const int num_atoms = 700;
+    mo_data.atom_positions.clear();
+    mo_data.basis.shells.clear();
+    for (int atom = 0; atom < num_atoms; ++atom) {
+        mo_data.atom_positions.push_back(Eigen::Vector3d(1.4 * atom, 0.0, 0.0));
+        sbox::basis::BasisShell s;
+        s.atom_index = atom;
+        s.angular_momentum = 0;
+        s.primitives = {{3.42525091, 0.15432897}, {0.62391373, 0.53532814}, {0.16885540, 0.44463454}};
+        mo_data.basis.shells.push_back(s);
+        sbox::basis::BasisShell p = s;
+        p.angular_momentum = 1;
+        mo_data.basis.shells.push_back(p);
+    }
+    const int num_basis = mo_data.basis.num_basis_functions();
+    mo_data.coefficients = Eigen::MatrixXd::Identity(num_basis, num_basis);
+
+    sbox::render::BasisTextures textures;
+    ASSERT_TRUE(textures.pack(mo_data));
+    EXPECT_EQ(textures.num_shells(), 2 * num_atoms);
+    EXPECT_EQ(textures.num_basis(), 4 * num_atoms);
+    EXPECT_EQ(textures.num_mo(), 4 * num_atoms);
+    EXPECT_EQ(textures.num_primitives(), 6 * num_atoms);
+
+    ASSERT_TRUE(textures.select_mo(2500));
+    EXPECT_EQ(textures.selected_mo(), 2500);
+    EXPECT_FALSE(textures.select_mo(4 * num_atoms));
+    EXPECT_EQ(textures.selected_mo(), 2500);
+}
+
+TEST(GpuCrossvalTest, SelectedColumnUsesHalfPrecisionOnlyWhenAccurate) {
+    sbox::basis::MOData mo_data = make_h2_sto3g();
+    sbox::render::BasisTextures textures;
+    ASSERT_TRUE(textures.pack(mo_data));
+    EXPECT_EQ(textures.selected_mo(), -1);
+    ASSERT_TRUE(textures.select_mo(1));
+    EXPECT_TRUE(textures.mo_is_half_precision());
+
+    // Past the half-float range the column has to stay in 32-bit floats.
+    mo_data.coefficients(0, 0) = 1.0e5;
+    ASSERT_TRUE(textures.pack(mo_data));
+    ASSERT_TRUE(textures.select_mo(0));
+    EXPECT_FALSE(textures.mo_is_half_precision());
+    ASSERT_TRUE(textures.select_mo(1));
+    EXPECT_TRUE(textures.mo_is_half_precision());
+}
+
+TEST(GpuCrossvalTest, HalfConversionRoundsToNearest) {
+    using sbox::render::float_to_half;
+    using sbox::render::half_to_float;
+
+    EXPECT_EQ(float_to_half(1.0f), 0x3c00);
+    EXPECT_EQ(float_to_half(-2.0f), 0xc000);
+    EXPECT_EQ(float_to_half(65504.0f), 0x7bff);
+    EXPECT_EQ(float_to_half(1.0e6f), 0x7c00);
+    EXPECT_EQ(float_to_half(std::ldexp(1.0f, -24)), 0x0001);
+    EXPECT_EQ(float_to_half(std::ldexp(1.0f, -26)), 0x0000);
+    EXPECT_EQ(float_to_half(1.0f + std::ldexp(1.0f, -11)), 0x3c00);  // tie rounds to even
+    EXPECT_EQ(float_to_half(1.0f + 3.0f * std::ldexp(1.0f, -11)), 0x3c02);
+
+    for (const float value : {0.70710678f, -0.0123f, 3.0e-6f, 1234.5f}) {
+        EXPECT_NEAR(half_to_float(float_to_half(value)), value, std::abs(value) * 1e-3f + 6.0e-8f) << value;
+    }
 }
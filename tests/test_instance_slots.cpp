@@ -0,0 +1,207 @@
+#include "renderer/instance_slots.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+using sbox::render::InstanceSlots;
+
+void fill(InstanceSlots& slots, int slot, float value) {
+    float* data = slots.slot(slot);
+    for (std::size_t i = 0; i < slots.floats_per_slot(); ++i) {
+        data[i] = value;
+    }
+    slots.mark_dirty(slot);
+}
+
+// Items are single floats; an item's slot holds it when the slot's float equals the item.
+struct SlotList {
+    InstanceSlots slots{1};
+    std::vector<int> item_slots;
+    std::vector<float> items;
+
+    explicit SlotList(const std::vector<float>& initial) {
+        for (const float item : initial) {
+            item_slots.push_back(slots.take());
+            fill(slots, item_slots.back(), item);
+        }
+        items = initial;
+        slots.clear_dirty();
+    }
+
+    // Applies the edit to `edited` and returns the new-list indices that were written.
+    std::vector<std::size_t> edit(const std::vector<float>& edited) {
+        const InstanceSlots::SameItem same = [&](std::size_t old_index, std::size_t new_index) {
+            return slots.slot(item_slots[old_index])[0] == edited[new_index];
+        };
+        const InstanceSlots::Edit found = InstanceSlots::find_edit(item_slots.size(), edited.size(), same);
+        std::vector<std::size_t> stale;
+        slots.apply_edit(found, item_slots, same, stale);
+        for (const std::size_t index : stale) {
+            fill(slots, item_slots[index], edited[index]);
+        }
+        items = edited;
+        return stale;
+    }
+
+    bool holds_items() const {
+        if (item_slots.size() != items.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            if (slots.slot(item_slots[i])[0] != items[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+std::vector<std::size_t> run_firsts(const std::vector<InstanceSlots::Run>& runs) {
+    std::vector<std::size_t> firsts;
+    for (const InstanceSlots::Run& run : runs) {
+        firsts.push_back(run.first);
+    }
+    return firsts;
+}
+
+}  // namespace
+
+TEST(InstanceSlotsTest, TakeAppendsZeroedSlots) {
+    InstanceSlots slots(3);
+    EXPECT_EQ(slots.take(), 0);
+    EXPECT_EQ(slots.take(), 1);
+    EXPECT_EQ(slots.slot_count(), 2);
+    EXPECT_EQ(slots.data().size(), 6u);
+    for (const float value : slots.data()) {
+        EXPECT_EQ(value, 0.0f);
+    }
+}
+
+TEST(InstanceSlotsTest, ReleasedSlotsAreZeroedAndReusedLastFirst) {
+    InstanceSlots slots(2);
+    for (int i = 0; i < 4; ++i) {
+        fill(slots, slots.take(), static_cast<float>(i + 1));
+    }
+    slots.release(1);
+    slots.release(3);
+    EXPECT_EQ(slots.free_count(), 2u);
+    EXPECT_EQ(slots.slot(1)[0], 0.0f);
+    EXPECT_EQ(slots.slot(3)[1], 0.0f);
+    EXPECT_EQ(slots.slot(2)[0], 3.0f);
+
+    EXPECT_EQ(slots.take(), 3);
+    EXPECT_EQ(slots.take(), 1);
+    EXPECT_EQ(slots.take(), 4);
+    EXPECT_EQ(slots.free_count(), 0u);
+    EXPECT_EQ(slots.slot_count(), 5);
+}
+
+TEST(InstanceSlotsTest, DirtySlotsBecomeSortedRunsOnce) {
+    InstanceSlots slots(1);
+    for (int i = 0; i < 10; ++i) {
+        slots.take();
+    }
+    slots.clear_dirty();
+    slots.mark_dirty(7);
+    slots.mark_dirty(2);
+    slots.mark_dirty(3);
+    slots.mark_dirty(2);
+    slots.release(8);
+
+    const std::vector<InstanceSlots::Run> runs = slots.take_dirty_runs(0);
+    ASSERT_EQ(runs.size(), 2u);
+    EXPECT_EQ(runs[0].first, 2u);
+    EXPECT_EQ(runs[0].count, 2u);
+    EXPECT_EQ(runs[1].first, 7u);
+    EXPECT_EQ(runs[1].count, 2u);
+    EXPECT_TRUE(slots.take_dirty_runs(0).empty());
+}
+
+TEST(InstanceSlotsTest, RunsWithinTheMergeGapAreJoined) {
+    InstanceSlots slots(4);
+    for (int i = 0; i < 40; ++i) {
+        slots.take();
+    }
+    slots.clear_dirty();
+    for (const int slot : {0, 3, 5, 30}) {
+        slots.mark_dirty(slot);
+    }
+    const std::vector<InstanceSlots::Run> runs = slots.take_dirty_runs(2);
+    EXPECT_EQ(run_firsts(runs), (std::vector<std::size_t>{0, 30}));
+    EXPECT_EQ(runs[0].count, 6u);
+    EXPECT_EQ(runs[1].count, 1u);
+}
+
+TEST(InstanceSlotsTest, ClearDropsFreeAndDirtySlots) {
+    InstanceSlots slots(2);
+    slots.take();
+    slots.take();
+    slots.release(0);
+    slots.clear();
+    EXPECT_EQ(slots.slot_count(), 0);
+    EXPECT_EQ(slots.free_count(), 0u);
+    EXPECT_TRUE(slots.take_dirty_runs(16).empty());
+    EXPECT_EQ(slots.take(), 0);
+}
+
+TEST(InstanceSlotsTest, FindEditSpansTheChangedRun) {
+    const std::vector<float> old_items{1, 2, 3, 4, 5};
+    const std::vector<float> new_items{1, 2, 7, 8, 9, 5};
+    const InstanceSlots::Edit edit = InstanceSlots::find_edit(
+        old_items.size(), new_items.size(), [&](std::size_t a, std::size_t b) { return old_items[a] == new_items[b]; });
+    EXPECT_EQ(edit.prefix, 2u);
+    EXPECT_EQ(edit.old_run, 2u);
+    EXPECT_EQ(edit.new_run, 3u);
+}
+
+TEST(InstanceSlotsTest, MidStructureInsertTakesOneSlot) {
+    SlotList list({1, 2, 3, 4, 5, 6});
+    const std::vector<int> before = list.item_slots;
+
+    EXPECT_EQ(list.edit({1, 2, 3, 9, 4, 5, 6}), (std::vector<std::size_t>{3}));
+    EXPECT_TRUE(list.holds_items());
+    EXPECT_EQ(list.item_slots[3], 6);
+    EXPECT_EQ(list.item_slots[2], before[2]);
+    EXPECT_EQ(list.item_slots[4], before[3]);
+    EXPECT_EQ(run_firsts(list.slots.take_dirty_runs(0)), (std::vector<std::size_t>{6}));
+}
+
+TEST(InstanceSlotsTest, RemovalReleasesOnlyTheRemovedSlot) {
+    SlotList list({1, 2, 3, 4, 5, 6});
+    const std::vector<int> before = list.item_slots;
+
+    EXPECT_TRUE(list.edit({1, 2, 3, 5, 6}).empty());
+    EXPECT_TRUE(list.holds_items());
+    EXPECT_EQ(list.slots.free_count(), 1u);
+    EXPECT_EQ(list.slots.slot(before[3])[0], 0.0f);
+    EXPECT_EQ(list.item_slots[3], before[4]);
+    EXPECT_EQ(run_firsts(list.slots.take_dirty_runs(0)), (std::vector<std::size_t>{3}));
+}
+
+TEST(InstanceSlotsTest, MoveOnlyEditRewritesInPlace) {
+    SlotList list({1, 2, 3, 4, 5, 6});
+    const std::vector<int> before = list.item_slots;
+
+    EXPECT_EQ(list.edit({1, 2, 7, 4, 8, 6}), (std::vector<std::size_t>{2, 4}));
+    EXPECT_TRUE(list.holds_items());
+    EXPECT_EQ(list.item_slots, before);
+    EXPECT_EQ(list.slots.slot_count(), 6);
+    EXPECT_EQ(list.slots.free_count(), 0u);
+
+    EXPECT_TRUE(list.edit({1, 2, 7, 4, 8, 6}).empty());
+}
+
+TEST(InstanceSlotsTest, InsertReusesAFreedSlot) {
+    SlotList list({1, 2, 3, 4, 5, 6});
+    const int removed_slot = list.item_slots[1];
+    list.edit({1, 3, 4, 5, 6});
+
+    EXPECT_EQ(list.edit({1, 3, 4, 5, 6, 7}), (std::vector<std::size_t>{5}));
+    EXPECT_TRUE(list.holds_items());
+    EXPECT_EQ(list.item_slots[5], removed_slot);
+    EXPECT_EQ(list.slots.slot_count(), 6);
+    EXPECT_EQ(list.slots.free_count(), 0u);
+}
@@ -0,0 +1,143 @@
+#include "backend/backend_manager.h"
+#include "backend/job_types.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using sbox::backend::BackendManager;
+using sbox::backend::JobDependency;
+using sbox::backend::JobGraph;
+using sbox::backend::JobSpec;
+using sbox::backend::JobStatus;
+using sbox::backend::PythonEnvironment;
+using sbox::backend::PythonInfo;
+
+// No Python environment is configured, so every root job fails straight away without spawning a driver.
+std::map<int, JobStatus> wait_for_jobs(BackendManager& backend, const std::vector<int>& job_ids) {
+    std::map<int, JobStatus> statuses;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (statuses.size() < job_ids.size() && std::chrono::steady_clock::now() < deadline) {
+        for (int job_id : backend.poll_completed()) {
+            statuses[job_id] = backend.status(job_id);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return statuses;
+}
+
+}  // namespace
+
+TEST(JobGraphTest, RejectsCycles) {
+    BackendManager backend;
+    JobGraph graph;
+    const int a = graph.add(JobSpec{});
+    const int b = graph.add(JobSpec{});
+    graph.connect(a, b, JobDependency::Kind::GeometryFrom);
+    graph.connect(b, a, JobDependency::Kind::OrbitalsFrom);
+    EXPECT_THROW(backend.submit_graph(graph), std::runtime_error);
+}
+
+TEST(JobGraphTest, RejectsEdgesToMissingNodes) {
+    BackendManager backend;
+    JobGraph graph;
+    const int a = graph.add(JobSpec{});
+    graph.connect(a, 3, JobDependency::Kind::After);
+    EXPECT_THROW(backend.submit_graph(graph), std::runtime_error);
+}
+
+TEST(JobGraphTest, RejectsUnknownUpstreamJob) {
+    BackendManager backend;
+    JobSpec spec;
+    spec.dependencies.push_back({12345, JobDependency::Kind::After});
+    EXPECT_THROW(backend.submit(spec), std::runtime_error);
+}
+
+TEST(JobGraphTest, BadNodeLeavesNothingQueued) {
+    BackendManager backend;
+    JobGraph graph;
+    const int first = graph.add(JobSpec{});
+    JobSpec orphan;
+    orphan.dependencies.push_back({12345, JobDependency::Kind::After});
+    const int second = graph.add(orphan);
+    graph.connect(first, second, JobDependency::Kind::GeometryFrom);
+    EXPECT_THROW(backend.submit_graph(graph), std::runtime_error);
+    EXPECT_FALSE(backend.has_running_jobs());
+}
+
+TEST(JobGraphTest, FailureSkipsOnlyDependentNodes) {
+    BackendManager backend;
+    JobGraph graph;
+    const int optimize = graph.add(JobSpec{});
+    const int frequencies = graph.add(JobSpec{});
+    const int cubes = graph.add(JobSpec{});
+    const int independent = graph.add(JobSpec{});
+    graph.connect(optimize, frequencies, JobDependency::Kind::GeometryFrom);
+    graph.connect(optimize, cubes, JobDependency::Kind::OrbitalsFrom);
+    graph.connect(frequencies, cubes, JobDependency::Kind::After);
+
+    const std::vector<int> job_ids = backend.submit_graph(graph);
+    ASSERT_EQ(job_ids.size(), 4U);
+    const std::map<int, JobStatus> statuses = wait_for_jobs(backend, job_ids);
+    ASSERT_EQ(statuses.size(), 4U);
+
+    EXPECT_EQ(statuses.at(job_ids[static_cast<std::size_t>(optimize)]), JobStatus::Failed);
+    EXPECT_EQ(statuses.at(job_ids[static_cast<std::size_t>(independent)]), JobStatus::Failed);
+    EXPECT_EQ(statuses.at(job_ids[static_cast<std::size_t>(frequencies)]), JobStatus::Cancelled);
+    EXPECT_EQ(statuses.at(job_ids[static_cast<std::size_t>(cubes)]), JobStatus::Cancelled);
+    EXPECT_NE(backend.result(job_ids[static_cast<std::size_t>(cubes)])->error_message.find("upstream"), std::string::npos);
+}
+
+TEST(JobGraphTest, DependencyOnCompletedJobResolvesImmediately) {
+    BackendManager backend;
+    const int first = backend.submit(JobSpec{});
+    ASSERT_EQ(wait_for_jobs(backend, {first}).size(), 1U);
+
+    JobSpec follow_up;
+    follow_up.dependencies.push_back({first, JobDependency::Kind::OrbitalsFrom});
+    const int second = backend.submit(follow_up);
+    const std::map<int, JobStatus> statuses = wait_for_jobs(backend, {second});
+    ASSERT_EQ(statuses.size(), 1U);
+    EXPECT_EQ(statuses.at(second), JobStatus::Cancelled);
+}
+
+TEST(JobGraphTest, FailedSpawnRemovesTheWorkDirectory) {
+    PythonInfo info;
+    info.python_path = (std::filesystem::temp_directory_path() / "sbox_missing_python" / "python3").string();
+    info.valid = true;
+    PythonEnvironment env;
+    env.set_info(info);
+    BackendManager backend;
+    backend.init(env);
+
+    const int job_id = backend.submit(JobSpec{});
+    const std::string work_dir = backend.work_dir(job_id);
+    ASSERT_FALSE(work_dir.empty());
+    ASSERT_EQ(wait_for_jobs(backend, {job_id}).size(), 1U);
+
+    EXPECT_EQ(backend.status(job_id), JobStatus::Failed);
+    EXPECT_NE(backend.result(job_id)->error_message.find("Failed to start backend driver"), std::string::npos);
+    EXPECT_TRUE(backend.result(job_id)->work_dir.empty());
+    EXPECT_FALSE(std::filesystem::exists(work_dir));
+}
+
+TEST(JobGraphTest, SkippedJobRemovesTheWorkDirectory) {
+    BackendManager backend;
+    const int first = backend.submit(JobSpec{});
+    JobSpec follow_up;
+    follow_up.dependencies.push_back({first, JobDependency::Kind::GeometryFrom});
+    const int second = backend.submit(follow_up);
+    const std::string work_dir = backend.work_dir(second);
+    ASSERT_FALSE(work_dir.empty());
+    ASSERT_EQ(wait_for_jobs(backend, {first, second}).size(), 2U);
+
+    EXPECT_EQ(backend.status(second), JobStatus::Cancelled);
+    EXPECT_FALSE(std::filesystem::exists(work_dir));
+}
@@ -129,3 +129,30 @@ TEST(MolecularSystemTest, CenterMovesCenterOfMassToOrigin) {
     EXPECT_NEAR(centered.y(), 0.0, 1e-12);
     EXPECT_NEAR(centered.z(), 0.0, 1e-12);
 }
+
+TEST(MolecularSystemTest, BondsByAtomListsEveryBondUnderBothAtoms) {
+    sbox::chem::MolecularSystem system;
+    for (int i = 0; i < 4; ++i) {
+        system.add_atom({6, Eigen::Vector3d(static_cast<double>(i), 0.0, 0.0), "C"});
+    }
+    system.add_bond(0, 1, sbox::chem::BondOrder::Single);
+    system.add_bond(1, 2, sbox::chem::BondOrder::Single);
+    system.add_bond(1, 3, sbox::chem::BondOrder::Single);
+
+    sbox::chem::BondsByAtom bonds_by_atom;
+    EXPECT_FALSE(bonds_by_atom.built());
+    bonds_by_atom.build(system);
+    ASSERT_EQ(bonds_by_atom.offsets, (std::vector<std::uint32_t>{0, 1, 4, 5, 6}));
+    std::vector<std::uint32_t> of_atom_1(bonds_by_atom.bonds.begin() + 1, bonds_by_atom.bonds.begin() + 4);
+    std::sort(of_atom_1.begin(), of_atom_1.end());
+    EXPECT_EQ(of_atom_1, (std::vector<std::uint32_t>{0, 1, 2}));
+    EXPECT_TRUE(bonds_by_atom.matches(system));
+
+    system.atom(3).position.x() = 7.0;
+    EXPECT_TRUE(bonds_by_atom.matches(system));
+
+    // Same counts, different topology.
+    system.remove_bond(2);
+    system.add_bond(2, 3, sbox::chem::BondOrder::Single);
+    EXPECT_FALSE(bonds_by_atom.matches(system));
+}
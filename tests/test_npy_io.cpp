@@ -0,0 +1,128 @@
+#include "io/npy_io.h"
+
+#include <Eigen/Core>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::filesystem::path npy_path(const std::string& name) {
+    return std::filesystem::temp_directory_path() / ("schrodingerssandbox_" + name + ".npy");
+}
+
+// Writes a version 1.0 header the way numpy.save does for Fortran-contiguous arrays.
+void write_fortran_matrix(const std::filesystem::path& path, const std::vector<double>& column_major, int rows, int cols) {
+    std::string header = "{'descr': '<f8', 'fortran_order': True, 'shape': (" + std::to_string(rows) + ", "
+        + std::to_string(cols) + "), }";
+    header.append((64 - (10 + header.size() + 1) % 64) % 64, ' ');
+    header.push_back('\n');
+
+    std::ofstream out(path, std::ios::binary);
+    out.write("\x93NUMPY\x01\x00", 8);
+    const std::uint16_t len = static_cast<std::uint16_t>(header.size());
+    out.put(static_cast<char>(len & 0xFF));
+    out.put(static_cast<char>(len >> 8));
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(reinterpret_cast<const char*>(column_major.data()),
+              static_cast<std::streamsize>(column_major.size() * sizeof(double)));
+}
+
+}  // namespace
+
+TEST(NpyIoTest, VectorRoundTrip) {
+    const std::vector<double> values = {-0.5, 0.25, 3.0, 1.0e-9};
+    const std::filesystem::path path = npy_path("vector");
+    sbox::io::write_npy(path.string(), values.data(), {values.size()});
+
+    const Eigen::VectorXd vec = sbox::io::read_npy_vector(path.string());
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(vec.size(), 4);
+    for (int i = 0; i < vec.size(); ++i) {
+        EXPECT_DOUBLE_EQ(vec(i), values[static_cast<std::size_t>(i)]);
+    }
+}
+
+TEST(NpyIoTest, RowMajorMatrixIsTransposedIntoEigenLayout) {
+    const std::vector<double> row_major = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    const std::filesystem::path path = npy_path("row_major");
+    sbox::io::write_npy(path.string(), row_major.data(), {2, 3});
+
+    const Eigen::MatrixXd mat = sbox::io::read_npy_matrix(path.string());
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(mat.rows(), 2);
+    ASSERT_EQ(mat.cols(), 3);
+    EXPECT_DOUBLE_EQ(mat(0, 2), 3.0);
+    EXPECT_DOUBLE_EQ(mat(1, 0), 4.0);
+    EXPECT_DOUBLE_EQ(mat(1, 2), 6.0);
+}
+
+TEST(NpyIoTest, FortranOrderMatrixCopiesDirectly) {
+    const std::vector<double> column_major = {1.0, 4.0, 2.0, 5.0, 3.0, 6.0};
+    const std::filesystem::path path = npy_path("fortran");
+    write_fortran_matrix(path, column_major, 2, 3);
+
+    const Eigen::MatrixXd mat = sbox::io::read_npy_matrix(path.string());
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(mat.rows(), 2);
+    ASSERT_EQ(mat.cols(), 3);
+    EXPECT_DOUBLE_EQ(mat(0, 1), 2.0);
+    EXPECT_DOUBLE_EQ(mat(1, 1), 5.0);
+    EXPECT_DOUBLE_EQ(mat(1, 2), 6.0);
+}
+
+TEST(NpyIoTest, VolumeKeepsShapeAndFloatPayload) {
+    std::vector<float> volume(2 * 3 * 4);
+    for (std::size_t i = 0; i < volume.size(); ++i) {
+        volume[i] = static_cast<float>(i) * 0.5f;
+    }
+    const std::filesystem::path path = npy_path("volume");
+    sbox::io::write_npy(path.string(), volume.data(), {2, 3, 4});
+
+    std::vector<std::size_t> shape;
+    const std::vector<float> loaded = sbox::io::read_npy_floats(path.string(), &shape);
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(shape.size(), 3U);
+    EXPECT_EQ(shape[0], 2U);
+    EXPECT_EQ(shape[1], 3U);
+    EXPECT_EQ(shape[2], 4U);
+    ASSERT_EQ(loaded.size(), volume.size());
+    EXPECT_FLOAT_EQ(loaded.back(), volume.back());
+}
+
+TEST(NpyIoTest, DoublePayloadNarrowsToFloat) {
+    const std::vector<double> values = {0.125, -2.5};
+    const std::filesystem::path path = npy_path("narrow");
+    sbox::io::write_npy(path.string(), values.data(), {values.size()});
+
+    const std::vector<float> loaded = sbox::io::read_npy_floats(path.string());
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(loaded.size(), 2U);
+    EXPECT_FLOAT_EQ(loaded[0], 0.125f);
+    EXPECT_FLOAT_EQ(loaded[1], -2.5f);
+}
+
+TEST(NpyIoTest, RejectsNonNpyFile) {
+    const std::filesystem::path path = npy_path("garbage");
+    {
+        std::ofstream out(path);
+        out << "this is not a numpy file at all";
+    }
+    EXPECT_THROW(sbox::io::NpyFile file(path.string()), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST(NpyIoTest, ThrowsOnMissingFile) {
+    EXPECT_THROW(sbox::io::read_npy_vector("/definitely/not/here.npy"), std::runtime_error);
+}
@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -52,6 +53,30 @@ TEST(PdbIoTest, ReadsMinimalPeptideAndGroupsResidues) {
     EXPECT_EQ(data.chains[0].id, "A");
 }
 
+TEST(PdbIoTest, BuildsPerAtomChainAndResidueLookups) {
+    const std::filesystem::path path = temp_pdb_path("schrodingerssandbox_test_lookups.pdb");
+    write_text_file(path,
+                    "ATOM      1  N   ALA A   1       1.000   2.000   3.000  1.00  0.00           N\n"
+                    "ATOM      2  CA  ALA A   1       2.000   2.000   3.000  1.00  0.00           C\n"
+                    "ATOM      3  N   GLY A   2       4.000   2.000   3.000  1.00  0.00           N\n"
+                    "ATOM      4  N   ALA B   1       8.000   2.000   3.000  1.00  0.00           N\n"
+                    "ATOM      5  CA  ALA B   1       9.000   2.000   3.000  1.00  0.00           C\n"
+                    "END\n");
+
+    const sbox::io::PDBData data = sbox::io::read_pdb(path.string());
+    std::filesystem::remove(path);
+
+    ASSERT_TRUE(data.has_atom_lookups());
+    EXPECT_EQ(data.atom_chain_index, (std::vector<int>{0, 0, 0, 1, 1}));
+    EXPECT_EQ(data.atom_residue_index, (std::vector<int>{0, 0, 1, 2, 2}));
+    EXPECT_EQ(data.residue_names, (std::vector<std::string>{"ALA", "GLY"}));
+    EXPECT_EQ(data.atom_residue_name_id, (std::vector<int>{0, 0, 1, 0, 0}));
+
+    sbox::io::PDBData hand_built;
+    hand_built.atoms = data.atoms;
+    EXPECT_FALSE(hand_built.has_atom_lookups());
+}
+
 TEST(PdbIoTest, ToMolecularSystemPerceivesBondsWithoutConect) {
     const std::filesystem::path path = temp_pdb_path("schrodingerssandbox_test_peptide_bonds.pdb");
     write_text_file(path, minimal_peptide_pdb());
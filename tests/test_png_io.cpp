@@ -0,0 +1,166 @@
+#include "io/png_io.h"
+
+#include <gtest/gtest.h>
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::uint32_t read_u32(const unsigned char* data) {
+    return (static_cast<std::uint32_t>(data[0]) << 24) | (static_cast<std::uint32_t>(data[1]) << 16) |
+           (static_cast<std::uint32_t>(data[2]) << 8) | static_cast<std::uint32_t>(data[3]);
+}
+
+int paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Minimal decoder for the 8-bit RGBA files PngStreamWriter produces; checks chunk CRCs on the way.
+std::vector<unsigned char> decode_rgba_png(const std::string& path, int& width, int& height) {
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<unsigned char> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_GE(file.size(), 8u);
+    std::vector<unsigned char> zlib_stream;
+    std::size_t pos = 8;
+    while (pos + 12 <= file.size()) {
+        const std::uint32_t length = read_u32(&file[pos]);
+        const std::string type(file.begin() + static_cast<std::ptrdiff_t>(pos + 4), file.begin() + static_cast<std::ptrdiff_t>(pos + 8));
+        const unsigned char* data = &file[pos + 8];
+        EXPECT_EQ(crc32(0L, &file[pos + 4], length + 4), read_u32(data + length)) << type;
+        if (type == "IHDR") {
+            width = static_cast<int>(read_u32(data));
+            height = static_cast<int>(read_u32(data + 4));
+            EXPECT_EQ(data[8], 8);
+            EXPECT_EQ(data[9], 6);
+        } else if (type == "IDAT") {
+            zlib_stream.insert(zlib_stream.end(), data, data + length);
+        }
+        pos += 12 + length;
+    }
+
+    const std::size_t row_bytes = static_cast<std::size_t>(width) * 4u;
+    std::vector<unsigned char> filtered(static_cast<std::size_t>(height) * (row_bytes + 1));
+    uLongf filtered_size = static_cast<uLongf>(filtered.size());
+    EXPECT_EQ(uncompress(filtered.data(), &filtered_size, zlib_stream.data(), static_cast<uLong>(zlib_stream.size())), Z_OK);
+    EXPECT_EQ(filtered_size, filtered.size());
+
+    std::vector<unsigned char> pixels(static_cast<std::size_t>(height) * row_bytes);
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* in_row = filtered.data() + static_cast<std::size_t>(y) * (row_bytes + 1);
+        unsigned char* row = pixels.data() + static_cast<std::size_t>(y) * row_bytes;
+        const unsigned char* prev = y > 0 ? row - row_bytes : nullptr;
+        for (std::size_t i = 0; i < row_bytes; ++i) {
+            const int left = i >= 4 ? row[i - 4] : 0;
+            const int up = prev != nullptr ? prev[i] : 0;
+            const int up_left = prev != nullptr && i >= 4 ? prev[i - 4] : 0;
+            int predictor = 0;
+            switch (in_row[0]) {
+            case 1: predictor = left; break;
+            case 2: predictor = up; break;
+            case 3: predictor = (left + up) / 2; break;
+            case 4: predictor = paeth(left, up, up_left); break;
+            default: break;
+            }
+            row[i] = static_cast<unsigned char>(in_row[1 + i] + predictor);
+        }
+    }
+    return pixels;
+}
+
+// Smooth gradients with noise on top, so every filter type wins somewhere.
+std::vector<unsigned char> make_image(int width, int height) {
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<int> noise(0, 7);
+    std::vector<unsigned char> pixels(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4u);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned char* p = pixels.data() + (static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x)) * 4u;
+            p[0] = static_cast<unsigned char>(x * 255 / width);
+            p[1] = static_cast<unsigned char>(y * 255 / height);
+            p[2] = static_cast<unsigned char>((x * y) % 251 + noise(rng));
+            p[3] = static_cast<unsigned char>(x < width / 2 ? 255 : 128);
+        }
+    }
+    return pixels;
+}
+
+std::string temp_png(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+}  // namespace
+
+TEST(PngIoTest, StreamedBandsDecodeToTheSourceImage) {
+    const int width = 173;
+    const int height = 301;
+    const std::vector<unsigned char> image = make_image(width, height);
+    const std::string path = temp_png("sbox_png_stream_test.png");
+
+    sbox::io::PngStreamWriter writer;
+    writer.open(path, width, height, 4);
+    const std::size_t row_bytes = static_cast<std::size_t>(width) * 4u;
+    int row = 0;
+    for (const int band : {1, 150, 7, 143}) {
+        writer.write_rows(image.data() + static_cast<std::size_t>(row) * row_bytes, band);
+        row += band;
+    }
+    EXPECT_EQ(writer.rows_written(), height);
+    writer.finish();
+
+    int decoded_width = 0;
+    int decoded_height = 0;
+    const std::vector<unsigned char> decoded = decode_rgba_png(path, decoded_width, decoded_height);
+    EXPECT_EQ(decoded_width, width);
+    EXPECT_EQ(decoded_height, height);
+    EXPECT_TRUE(decoded == image);
+    std::filesystem::remove(path);
+}
+
+TEST(PngIoTest, ThreadCountDoesNotChangeThePixels) {
+    const int width = 64;
+    const int height = 256;
+    const std::vector<unsigned char> image = make_image(width, height);
+    for (const int threads : {1, 3, 8}) {
+        const std::string path = temp_png("sbox_png_threads_test.png");
+        sbox::io::PngStreamWriter writer;
+        writer.open(path, width, height, threads);
+        writer.write_rows(image.data(), height);
+        writer.finish();
+
+        int decoded_width = 0;
+        int decoded_height = 0;
+        EXPECT_TRUE(decode_rgba_png(path, decoded_width, decoded_height) == image) << threads;
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(PngIoTest, RejectsWrongRowCounts) {
+    const std::string path = temp_png("sbox_png_rows_test.png");
+    const std::vector<unsigned char> image = make_image(8, 4);
+
+    sbox::io::PngStreamWriter writer;
+    writer.open(path, 8, 4);
+    EXPECT_THROW(writer.write_rows(image.data(), 5), std::runtime_error);
+    writer.write_rows(image.data(), 3);
+    EXPECT_THROW(writer.finish(), std::runtime_error);
+
+    EXPECT_THROW(writer.open(path, 0, 4), std::runtime_error);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,112 @@
+#include "renderer/progressive_raymarch.h"
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Core>
+
+#include <cmath>
+
+namespace {
+
+using Frame = sbox::render::ProgressiveSchedule::Frame;
+
+}  // namespace
+
+TEST(ProgressiveRaymarchTest, FirstFrameIsExact) {
+    sbox::render::ProgressiveSchedule schedule;
+    const Frame frame = schedule.next(1, 800, 600);
+    EXPECT_TRUE(frame.march);
+    EXPECT_FALSE(frame.interactive);
+    EXPECT_EQ(frame.width, 800);
+    EXPECT_EQ(frame.height, 600);
+    EXPECT_FLOAT_EQ(frame.step_scale, 1.0f);
+    EXPECT_FLOAT_EQ(frame.blend, 1.0f);
+    EXPECT_TRUE(frame.jitter.isZero());
+    EXPECT_FLOAT_EQ(frame.sample_offset, 0.0f);
+}
+
+TEST(ProgressiveRaymarchTest, StillViewAccumulatesUntilConverged) {
+    sbox::render::ProgressiveSchedule schedule;
+    schedule.set_converged_frames(6);
+    schedule.next(7, 320, 240);
+    for (int n = 1; n < 6; ++n) {
+        EXPECT_FALSE(schedule.converged());
+        const Frame frame = schedule.next(7, 320, 240);
+        ASSERT_TRUE(frame.march);
+        EXPECT_FALSE(frame.interactive);
+        EXPECT_EQ(frame.width, 320);
+        EXPECT_FLOAT_EQ(frame.step_scale, 1.0f);
+        // Frame n is weighted 1/(n+1), so the history stays an unweighted mean.
+        EXPECT_FLOAT_EQ(frame.blend, 1.0f / static_cast<float>(n + 1));
+        EXPECT_LE(std::abs(frame.jitter.x()), 1.0f / 320.0f);
+        EXPECT_LE(std::abs(frame.jitter.y()), 1.0f / 240.0f);
+        EXPECT_GE(frame.sample_offset, -0.5f);
+        EXPECT_LT(frame.sample_offset, 0.5f);
+    }
+    EXPECT_TRUE(schedule.converged());
+    EXPECT_EQ(schedule.accumulated_frames(), 6);
+    EXPECT_FALSE(schedule.next(7, 320, 240).march);
+    EXPECT_FALSE(schedule.next(7, 320, 240).march);
+}
+
+TEST(ProgressiveRaymarchTest, ViewChangesMarchCoarseFramesAndRestart) {
+    sbox::render::ProgressiveSchedule schedule;
+    schedule.set_converged_frames(4);
+    for (int i = 0; i < 4; ++i) {
+        schedule.next(1, 1000, 500);
+    }
+    ASSERT_TRUE(schedule.converged());
+
+    const Frame moving = schedule.next(2, 1000, 500);
+    EXPECT_TRUE(moving.march);
+    EXPECT_TRUE(moving.interactive);
+    EXPECT_LT(moving.width, 1000);
+    EXPECT_LT(moving.height, 500);
+    EXPECT_LT(moving.step_scale, 1.0f);
+    EXPECT_FLOAT_EQ(moving.blend, 1.0f);
+    EXPECT_FALSE(schedule.converged());
+
+    // Once the key holds, the first settled frame replaces the coarse one at full resolution.
+    const Frame settled = schedule.next(2, 1000, 500);
+    EXPECT_FALSE(settled.interactive);
+    EXPECT_EQ(settled.width, 1000);
+    EXPECT_FLOAT_EQ(settled.blend, 1.0f);
+    EXPECT_TRUE(settled.jitter.isZero());
+
+    EXPECT_TRUE(schedule.next(2, 1200, 500).interactive);
+    schedule.invalidate();
+    EXPECT_FALSE(schedule.next(2, 1200, 500).interactive);
+}
+
+TEST(ProgressiveRaymarchTest, InteractiveScaleFollowsTheBudget) {
+    sbox::render::ProgressiveSchedule schedule;
+    schedule.set_frame_budget_ms(10.0f);
+    const float start = schedule.interactive_scale();
+
+    schedule.report_march_ms(40.0);
+    const float slower = schedule.interactive_scale();
+    EXPECT_LT(slower, start);
+    for (int i = 0; i < 20; ++i) {
+        schedule.report_march_ms(1000.0);
+    }
+    EXPECT_FLOAT_EQ(schedule.interactive_scale(), sbox::render::ProgressiveSchedule::kMinInteractiveScale);
+
+    for (int i = 0; i < 40; ++i) {
+        schedule.report_march_ms(0.5);
+    }
+    EXPECT_FLOAT_EQ(schedule.interactive_scale(), 1.0f);
+    schedule.report_march_ms(-1.0);
+    EXPECT_FLOAT_EQ(schedule.interactive_scale(), 1.0f);
+}
+
+TEST(ProgressiveRaymarchTest, ViewKeySeesEveryInput) {
+    const Eigen::Matrix4f inv_vp = Eigen::Matrix4f::Identity();
+    const std::uint64_t base = sbox::render::ViewKey().add(inv_vp).add(0.01f).add(2).value();
+    EXPECT_EQ(sbox::render::ViewKey().add(inv_vp).add(0.01f).add(2).value(), base);
+
+    Eigen::Matrix4f moved = inv_vp;
+    moved(0, 3) = 1e-4f;
+    EXPECT_NE(sbox::render::ViewKey().add(moved).add(0.01f).add(2).value(), base);
+    EXPECT_NE(sbox::render::ViewKey().add(inv_vp).add(0.02f).add(2).value(), base);
+    EXPECT_NE(sbox::render::ViewKey().add(inv_vp).add(0.01f).add(3).value(), base);
+}
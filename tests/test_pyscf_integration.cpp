@@ -81,7 +81,7 @@ const sbox::backend::JobResult& wait_for_job(sbox::backend::BackendManager& back
         const std::vector<int> completed = backend.poll_completed();
         for (int completed_id : completed) {
             if (completed_id == job_id) {
-                const sbox::backend::JobResult* result = backend.result(job_id);
+                const sbox::backend::JobResultHandle result = backend.result(job_id);
                 EXPECT_NE(result, nullptr);
                 return *result;
             }
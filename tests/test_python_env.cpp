@@ -4,6 +4,36 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+
+std::filesystem::path scratch_dir(const std::string& name) {
+    const auto dir = std::filesystem::temp_directory_path() / ("sbox_python_env_" + name + "_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+sbox::backend::PythonInfo fake_info(const std::filesystem::path& dir) {
+    std::filesystem::create_directories(dir / "site-packages");
+    std::ofstream(dir / "python3") << "#!/bin/sh\n";
+    sbox::backend::PythonInfo info;
+    info.python_path = (dir / "python3").string();
+    info.version = "Python 3.11.0";
+    info.valid = true;
+    info.has_tblite = true;
+    info.tblite_version = "0.3.0";
+    info.site_packages = {(dir / "site-packages").string()};
+    return info;
+}
+
+}  // namespace
+
 TEST(PythonEnvTest, RunCaptureSucceedsForEcho) {
     std::string out;
     const int status = sbox::backend::PythonEnvironment::run_capture("echo hello", out);
@@ -32,3 +62,85 @@ TEST(PythonEnvTest, CheckPackagesDoesNotCrash) {
     env.check_packages();
     EXPECT_TRUE(env.info().valid);
 }
+
+TEST(PythonEnvTest, RunCaptureKillsCommandsThatOutliveTheTimeout) {
+    std::string out;
+    const auto start = std::chrono::steady_clock::now();
+    const int status = sbox::backend::PythonEnvironment::run_capture("echo started; sleep 30", out, 0.5);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(status, -1);
+    EXPECT_LT(elapsed, 10.0);
+    EXPECT_NE(out.find("started"), std::string::npos);
+}
+
+TEST(PythonEnvTest, ProbeCacheRoundTrips) {
+    const auto dir = scratch_dir("roundtrip");
+    const std::string cache_path = (dir / "cache" / "python_env_cache.json").string();
+
+    sbox::backend::PythonEnvironment writer;
+    writer.set_info(fake_info(dir));
+    writer.save_cache(cache_path);
+
+    sbox::backend::PythonEnvironment reader;
+    ASSERT_TRUE(reader.load_cache(cache_path));
+    EXPECT_TRUE(reader.info().valid);
+    EXPECT_EQ(reader.info().python_path, writer.info().python_path);
+    EXPECT_TRUE(reader.info().has_tblite);
+    EXPECT_EQ(reader.info().tblite_version, "0.3.0");
+    EXPECT_FALSE(reader.info().has_pyscf);
+
+    sbox::backend::PythonEnvironment by_path;
+    EXPECT_TRUE(by_path.load_cache(cache_path, writer.info().python_path));
+    EXPECT_FALSE(by_path.load_cache(cache_path, (dir / "other-python").string()));
+    std::filesystem::remove_all(dir);
+}
+
+TEST(PythonEnvTest, ProbeCacheIsInvalidatedBySitePackagesChanges) {
+    const auto dir = scratch_dir("invalidate");
+    const std::string cache_path = (dir / "python_env_cache.json").string();
+
+    sbox::backend::PythonEnvironment writer;
+    writer.set_info(fake_info(dir));
+    writer.save_cache(cache_path);
+
+    const auto site = dir / "site-packages";
+    std::filesystem::last_write_time(site, std::filesystem::last_write_time(site) + std::chrono::seconds(5));
+
+    sbox::backend::PythonEnvironment reader;
+    EXPECT_FALSE(reader.load_cache(cache_path));
+    EXPECT_FALSE(reader.info().valid);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(PythonEnvTest, PackageThatKillsTheInterpreterOnlyMarksItselfMissing) {
+    const std::filesystem::path dir = scratch_dir("broken_package");
+    std::filesystem::create_directories(dir / "geometric");
+    std::filesystem::create_directories(dir / "tblite");
+    std::ofstream(dir / "geometric" / "__init__.py") << "import os\nos._exit(3)\n";
+    std::ofstream(dir / "tblite" / "__init__.py") << "__version__ = \"0.0-probe-test\"\n";
+
+    const char* previous = std::getenv("PYTHONPATH");
+    const std::string saved = previous != nullptr ? previous : "";
+    ::setenv("PYTHONPATH", dir.c_str(), 1);
+    sbox::backend::PythonEnvironment env;
+    env.detect();
+    if (previous != nullptr) {
+        ::setenv("PYTHONPATH", saved.c_str(), 1);
+    } else {
+        ::unsetenv("PYTHONPATH");
+    }
+
+    ASSERT_TRUE(env.info().valid);
+    EXPECT_FALSE(env.info().has_geometric);
+    EXPECT_TRUE(env.info().has_tblite);
+    EXPECT_EQ(env.info().tblite_version, "0.0-probe-test");
+    EXPECT_FALSE(env.info().site_packages.empty());
+    std::filesystem::remove_all(dir);
+}
+
+TEST(PythonEnvTest, CheckPackagesListsSitePackages) {
+    sbox::backend::PythonEnvironment env;
+    env.detect();
+    ASSERT_TRUE(env.info().valid);
+    EXPECT_FALSE(env.info().site_packages.empty());
+}
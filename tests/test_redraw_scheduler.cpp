@@ -0,0 +1,112 @@
+#include "ui/redraw_scheduler.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using Activity = sbox::ui::RedrawScheduler::FrameActivity;
+using sbox::ui::RedrawScheduler;
+
+// Runs idle frames until the scheduler stops asking for more, returning how many rendered the viewport.
+int settle(RedrawScheduler& scheduler, double& now) {
+    int rendered = 0;
+    for (int i = 0; i < 20 && scheduler.wait_timeout(now) == 0.0; ++i) {
+        rendered += scheduler.update(Activity{}, now) ? 1 : 0;
+        now += 0.016;
+    }
+    return rendered;
+}
+
+}  // namespace
+
+TEST(RedrawSchedulerTest, RendersOnceAtStartThenSleeps) {
+    RedrawScheduler scheduler;
+    double now = 100.0;
+    EXPECT_EQ(scheduler.wait_timeout(now), 0.0);
+    EXPECT_TRUE(scheduler.update(Activity{}, now));
+    EXPECT_EQ(settle(scheduler, now), 0);
+    EXPECT_DOUBLE_EQ(scheduler.wait_timeout(now), RedrawScheduler::kIdleWaitSeconds);
+    EXPECT_FALSE(scheduler.update(Activity{}, now + 1.0));
+}
+
+TEST(RedrawSchedulerTest, PanelHoverOnlyRedrawsTheUi) {
+    RedrawScheduler scheduler;
+    double now = 0.0;
+    scheduler.update(Activity{}, now);
+    settle(scheduler, now);
+
+    Activity hover;
+    hover.ui_input = true;
+    now += 5.0;
+    EXPECT_FALSE(scheduler.update(hover, now));
+    EXPECT_EQ(scheduler.wait_timeout(now), 0.0);
+    EXPECT_EQ(settle(scheduler, now), 0);
+    EXPECT_DOUBLE_EQ(scheduler.wait_timeout(now), RedrawScheduler::kRecentInputWaitSeconds);
+    EXPECT_DOUBLE_EQ(scheduler.wait_timeout(now + 2.0), RedrawScheduler::kIdleWaitSeconds);
+}
+
+TEST(RedrawSchedulerTest, SceneInputRendersThroughTheSettleFrames) {
+    RedrawScheduler scheduler;
+    double now = 0.0;
+    scheduler.update(Activity{}, now);
+    settle(scheduler, now);
+
+    Activity click;
+    click.scene_input = true;
+    EXPECT_TRUE(scheduler.update(click, now));
+    EXPECT_EQ(settle(scheduler, now), RedrawScheduler::kSettleFrames - 1);
+}
+
+TEST(RedrawSchedulerTest, InvalidationAndAnimationRender) {
+    RedrawScheduler scheduler;
+    double now = 0.0;
+    scheduler.update(Activity{}, now);
+    settle(scheduler, now);
+
+    scheduler.invalidate();
+    EXPECT_EQ(scheduler.wait_timeout(now), 0.0);
+    EXPECT_TRUE(scheduler.update(Activity{}, now));
+    EXPECT_FALSE(scheduler.update(Activity{}, now));
+
+    Activity playing;
+    playing.animating = true;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(scheduler.update(playing, now));
+        EXPECT_EQ(scheduler.wait_timeout(now), 0.0);
+    }
+    EXPECT_FALSE(scheduler.update(Activity{}, now));
+}
+
+TEST(RedrawSchedulerTest, BackgroundWorkWakesPeriodically) {
+    RedrawScheduler scheduler;
+    double now = 0.0;
+    scheduler.update(Activity{}, now);
+    settle(scheduler, now);
+
+    Activity job;
+    job.background_work = true;
+    EXPECT_FALSE(scheduler.update(job, now));
+    EXPECT_DOUBLE_EQ(scheduler.wait_timeout(now), RedrawScheduler::kBusyWaitSeconds);
+}
+
+TEST(RedrawSchedulerTest, ExportRunsEveryFrameThenRendersTheRestoredScene) {
+    RedrawScheduler scheduler;
+    double now = 0.0;
+    scheduler.update(Activity{}, now);
+    settle(scheduler, now);
+
+    // An export reports itself as animating; each frame it renders must not wait on events.
+    Activity exporting;
+    exporting.animating = true;
+    for (int i = 0; i < 30; ++i) {
+        scheduler.update(exporting, now);
+        EXPECT_EQ(scheduler.wait_timeout(now), 0.0);
+        now += 0.016;
+    }
+
+    // Finishing restores the camera and molecule, which invalidates the viewport once.
+    scheduler.invalidate();
+    EXPECT_TRUE(scheduler.update(Activity{}, now));
+    EXPECT_EQ(settle(scheduler, now), 0);
+    EXPECT_DOUBLE_EQ(scheduler.wait_timeout(now), RedrawScheduler::kIdleWaitSeconds);
+}
@@ -63,6 +63,9 @@ TEST(Settings, RoundTripSerialization) {
     settings.window_maximized = true;
     settings.volume_steps = 321;
     settings.isosurface_steps = 654;
+    settings.bake_orbitals = false;
+    settings.progressive_raymarch = false;
+    settings.raymarch_budget_ms = 20.0f;
     settings.default_iso_value = 0.25f;
     settings.default_gamma = 0.8f;
     settings.mol_render_mode = 2;
@@ -103,6 +106,9 @@ TEST(Settings, RoundTripSerialization) {
     EXPECT_EQ(loaded.window_maximized, settings.window_maximized);
     EXPECT_EQ(loaded.volume_steps, settings.volume_steps);
     EXPECT_EQ(loaded.isosurface_steps, settings.isosurface_steps);
+    EXPECT_EQ(loaded.bake_orbitals, settings.bake_orbitals);
+    EXPECT_EQ(loaded.progressive_raymarch, settings.progressive_raymarch);
+    EXPECT_FLOAT_EQ(loaded.raymarch_budget_ms, settings.raymarch_budget_ms);
     EXPECT_FLOAT_EQ(loaded.default_iso_value, settings.default_iso_value);
     EXPECT_FLOAT_EQ(loaded.default_gamma, settings.default_gamma);
     EXPECT_EQ(loaded.mol_render_mode, settings.mol_render_mode);
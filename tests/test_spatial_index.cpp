@@ -0,0 +1,233 @@
+#include "editor/picking.h"
+#include "editor/spatial_index.h"
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Random atoms in a box, each bonded to its successor when they are close.
+sbox::chem::MolecularSystem make_random_molecule(int num_atoms, float box, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coord(-box, box);
+    const int elements[] = {1, 6, 7, 8, 16, 26};
+    sbox::chem::MolecularSystem mol;
+    for (int i = 0; i < num_atoms; ++i) {
+        mol.add_atom({elements[i % 6], Eigen::Vector3d(coord(rng), coord(rng), coord(rng)), "", 0});
+    }
+    for (int i = 0; i + 1 < num_atoms; ++i) {
+        if (mol.distance(i, i + 1) < box) {
+            mol.add_bond(i, i + 1, sbox::chem::BondOrder::Single);
+        }
+    }
+    return mol;
+}
+
+sbox::editor::Ray random_ray(std::mt19937& rng, float box) {
+    std::uniform_real_distribution<float> coord(-box, box);
+    sbox::editor::Ray ray;
+    ray.origin = Eigen::Vector3f(coord(rng), coord(rng), 3.0f * box);
+    const Eigen::Vector3f target(coord(rng), coord(rng), coord(rng));
+    ray.direction = (target - ray.origin).normalized();
+    return ray;
+}
+
+Eigen::Matrix4f look_down_minus_z(float eye_z, float fovy_rad, float z_near, float z_far) {
+    const float f = 1.0f / std::tan(fovy_rad * 0.5f);
+    Eigen::Matrix4f proj = Eigen::Matrix4f::Zero();
+    proj(0, 0) = f;
+    proj(1, 1) = f;
+    proj(2, 2) = (z_far + z_near) / (z_near - z_far);
+    proj(2, 3) = (2.0f * z_far * z_near) / (z_near - z_far);
+    proj(3, 2) = -1.0f;
+    Eigen::Matrix4f view = Eigen::Matrix4f::Identity();
+    view(2, 3) = -eye_z;
+    return proj * view;
+}
+
+void expect_same_hit(const sbox::editor::PickResult& linear, const sbox::editor::PickResult& indexed) {
+    ASSERT_EQ(linear.type, indexed.type);
+    EXPECT_EQ(linear.index, indexed.index);
+    EXPECT_FLOAT_EQ(linear.distance, indexed.distance);
+}
+
+}  // namespace
+
+TEST(SpatialIndexTest, PicksMatchLinearScans) {
+    const sbox::chem::MolecularSystem mol = make_random_molecule(3000, 40.0f, 11);
+    sbox::editor::SpatialIndex index;
+    index.build(mol);
+    ASSERT_TRUE(index.matches(mol));
+
+    std::mt19937 rng(5);
+    int atom_hits = 0;
+    int bond_hits = 0;
+    for (int i = 0; i < 500; ++i) {
+        const sbox::editor::Ray ray = random_ray(rng, 40.0f);
+        const sbox::editor::PickResult atom_linear = sbox::editor::pick_atom(ray, mol, 1.2f);
+        expect_same_hit(atom_linear, sbox::editor::pick_atom(ray, mol, 1.2f, &index));
+        const sbox::editor::PickResult bond_linear = sbox::editor::pick_bond(ray, mol);
+        expect_same_hit(bond_linear, sbox::editor::pick_bond(ray, mol, 0.3f, &index));
+        atom_hits += atom_linear.type == sbox::editor::PickResult::Type::Atom ? 1 : 0;
+        bond_hits += bond_linear.type == sbox::editor::PickResult::Type::Bond ? 1 : 0;
+    }
+    EXPECT_GT(atom_hits, 50);
+    EXPECT_GT(bond_hits, 50);
+}
+
+TEST(SpatialIndexTest, RefitFollowsMovedAtoms) {
+    sbox::chem::MolecularSystem mol = make_random_molecule(500, 20.0f, 3);
+    sbox::editor::SpatialIndex index;
+    index.build(mol);
+
+    mol.atom(42).position = Eigen::Vector3d(200.0, 0.0, 0.0);
+    sbox::editor::Ray ray;
+    ray.origin = Eigen::Vector3f(200.0f, 0.0f, 50.0f);
+    ray.direction = Eigen::Vector3f(0.0f, 0.0f, -1.0f);
+    EXPECT_EQ(index.pick_atom(ray, mol).type, sbox::editor::PickResult::Type::None);
+
+    index.refit(mol);
+    const sbox::editor::PickResult hit = index.pick_atom(ray, mol);
+    ASSERT_EQ(hit.type, sbox::editor::PickResult::Type::Atom);
+    EXPECT_EQ(hit.index, 42);
+
+    mol.add_atom({6, Eigen::Vector3d(0.0, 0.0, 0.0), "", 0});
+    EXPECT_FALSE(index.matches(mol));
+    index.refit(mol);
+    EXPECT_TRUE(index.matches(mol));
+}
+
+TEST(SpatialIndexTest, PartialRefitMatchesFullRebuild) {
+    sbox::chem::MolecularSystem mol = make_random_molecule(2000, 30.0f, 17);
+    sbox::editor::SpatialIndex index;
+    index.build(mol);
+
+    const std::vector<int> moved = {0, 7, 8, 1234, 1999};
+    for (int atom_index : moved) {
+        mol.atom(atom_index).position += Eigen::Vector3d(45.0, -20.0, 10.0);
+    }
+    index.refit_atoms(mol, moved);
+
+    std::mt19937 rng(23);
+    for (int i = 0; i < 300; ++i) {
+        const sbox::editor::Ray ray = random_ray(rng, 60.0f);
+        expect_same_hit(sbox::editor::pick_atom(ray, mol), index.pick_atom(ray, mol));
+        expect_same_hit(sbox::editor::pick_bond(ray, mol), index.pick_bond(ray, mol));
+    }
+    for (int atom_index : moved) {
+        std::vector<int> found;
+        index.query_sphere(mol.atom(atom_index).position.cast<float>(), 1.0e-3f, found);
+        EXPECT_NE(std::find(found.begin(), found.end(), atom_index), found.end());
+    }
+}
+
+TEST(SpatialIndexTest, UpdateFollowsPlaybackAndTopologyChanges) {
+    sbox::chem::MolecularSystem mol = make_random_molecule(400, 20.0f, 29);
+    sbox::editor::SpatialIndex index;
+    index.build(mol);
+
+    // A playback frame replaces the positions without changing any count.
+    sbox::chem::MolecularSystem frame = mol;
+    frame.atom(10).position = Eigen::Vector3d(0.0, 150.0, 0.0);
+    index.update(frame);
+    sbox::editor::Ray ray;
+    ray.origin = Eigen::Vector3f(0.0f, 150.0f, 50.0f);
+    ray.direction = Eigen::Vector3f(0.0f, 0.0f, -1.0f);
+    const sbox::editor::PickResult hit = index.pick_atom(ray, frame);
+    ASSERT_EQ(hit.type, sbox::editor::PickResult::Type::Atom);
+    EXPECT_EQ(hit.index, 10);
+
+    // Replacing a bond keeps the counts, so only the topology check notices it. The new bond reaches
+    // the far atom, where no bond box was before.
+    ASSERT_GT(frame.num_bonds(), 0);
+    const int from = frame.bond(0).atom_i == 10 ? frame.bond(0).atom_j : frame.bond(0).atom_i;
+    frame.remove_bond(0);
+    frame.add_bond(from, 10, sbox::chem::BondOrder::Single);
+    ASSERT_TRUE(index.matches(frame));
+    index.update(frame);
+    const Eigen::Vector3f midpoint = 0.5f * (frame.atom(from).position + frame.atom(10).position).cast<float>();
+    ray.origin = midpoint + Eigen::Vector3f(0.0f, 0.0f, 50.0f);
+    expect_same_hit(sbox::editor::pick_bond(ray, frame), index.pick_bond(ray, frame));
+    EXPECT_EQ(index.pick_bond(ray, frame).type, sbox::editor::PickResult::Type::Bond);
+}
+
+TEST(SpatialIndexTest, SphereQueryMatchesBruteForce) {
+    const sbox::chem::MolecularSystem mol = make_random_molecule(2000, 30.0f, 17);
+    sbox::editor::SpatialIndex index;
+    index.build(mol);
+
+    const Eigen::Vector3f center(4.0f, -3.0f, 2.0f);
+    std::vector<int> found;
+    index.query_sphere(center, 9.0f, found);
+    std::sort(found.begin(), found.end());
+
+    std::vector<int> expected;
+    for (int i = 0; i < mol.num_atoms(); ++i) {
+        if ((mol.atom(i).position.cast<float>() - center).norm() <= 9.0f) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(found, expected);
+}
+
+TEST(SpatialIndexTest, FrustumAndScreenRectQueriesMatchProjection) {
+    const sbox::chem::MolecularSystem mol = make_random_molecule(4000, 60.0f, 23);
+    sbox::editor::SpatialIndex index;
+    index.build(mol);
+    const Eigen::Matrix4f vp = look_down_minus_z(80.0f, 0.6f, 1.0f, 200.0f);
+
+    std::vector<std::uint32_t> visible;
+    index.query_frustum(vp, 0.0f, visible);
+    std::vector<int> in_rect;
+    index.query_screen_rect(vp, Eigen::Vector2f(-0.5f, 0.1f), Eigen::Vector2f(0.2f, 0.7f), in_rect);
+    std::sort(visible.begin(), visible.end());
+    std::sort(in_rect.begin(), in_rect.end());
+
+    std::vector<std::uint32_t> expected_visible;
+    std::vector<int> expected_rect;
+    for (int i = 0; i < mol.num_atoms(); ++i) {
+        const Eigen::Vector3f p = mol.atom(i).position.cast<float>();
+        const Eigen::Vector4f clip = vp * Eigen::Vector4f(p.x(), p.y(), p.z(), 1.0f);
+        if (clip.w() <= 0.0f) {
+            continue;
+        }
+        const Eigen::Vector3f ndc = clip.head<3>() / clip.w();
+        if (ndc.cwiseAbs().maxCoeff() <= 1.0f) {
+            expected_visible.push_back(static_cast<std::uint32_t>(i));
+        }
+        if (ndc.x() >= -0.5f && ndc.x() <= 0.2f && ndc.y() >= 0.1f && ndc.y() <= 0.7f && ndc.z() >= -1.0f) {
+            expected_rect.push_back(i);
+        }
+    }
+    EXPECT_GT(expected_visible.size(), 100u);
+    EXPECT_LT(expected_visible.size(), static_cast<std::size_t>(mol.num_atoms()));
+    EXPECT_FALSE(expected_rect.empty());
+    EXPECT_EQ(visible, expected_visible);
+    EXPECT_EQ(in_rect, expected_rect);
+
+    std::vector<std::uint32_t> with_margin;
+    index.query_frustum(vp, 5.0f, with_margin);
+    EXPECT_GT(with_margin.size(), visible.size());
+}
+
+TEST(SpatialIndexTest, EmptyIndexFindsNothing) {
+    const sbox::chem::MolecularSystem mol;
+    sbox::editor::SpatialIndex index;
+    index.build(mol);
+    sbox::editor::Ray ray;
+    ray.origin = Eigen::Vector3f::Zero();
+    ray.direction = Eigen::Vector3f::UnitZ();
+    EXPECT_EQ(index.pick_atom(ray, mol).type, sbox::editor::PickResult::Type::None);
+    EXPECT_EQ(index.pick_bond(ray, mol).type, sbox::editor::PickResult::Type::None);
+    std::vector<int> found;
+    index.query_sphere(Eigen::Vector3f::Zero(), 10.0f, found);
+    EXPECT_TRUE(found.empty());
+}
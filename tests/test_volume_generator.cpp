@@ -0,0 +1,186 @@
+#include "analysis/volume_generator.h"
+#include "backend/volume_cache.h"
+#include "core/gaussian_eval.h"
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Core>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+// H2 in a minimal basis: one s shell per atom, bonding and antibonding orbitals.
+sbox::basis::MOData make_h2() {
+    sbox::basis::MOData mo_data;
+    mo_data.atomic_numbers = {1, 1};
+    mo_data.atom_positions = {Eigen::Vector3d(0.0, 0.0, -0.7), Eigen::Vector3d(0.0, 0.0, 0.7)};
+    for (int atom = 0; atom < 2; ++atom) {
+        sbox::basis::BasisShell shell;
+        shell.atom_index = atom;
+        shell.angular_momentum = 0;
+        shell.primitives = {{3.42525091, 0.15432897}, {0.62391373, 0.53532814}, {0.16885540, 0.44463454}};
+        mo_data.basis.shells.push_back(shell);
+    }
+    mo_data.coefficients.resize(2, 2);
+    mo_data.coefficients << 0.55, 1.2, 0.55, -1.2;
+    mo_data.energies = Eigen::Vector2d(-0.58, 0.67);
+    mo_data.occupations = Eigen::Vector2d(2.0, 0.0);
+    mo_data.total_energy = -1.117;
+    return mo_data;
+}
+
+Eigen::Vector3d grid_point(const sbox::io::CubeData& cube, int ix, int iy, int iz) {
+    return cube.origin + cube.step_x * ix + cube.step_y * iy + cube.step_z * iz;
+}
+
+}  // namespace
+
+TEST(VolumeGeneratorTest, GridFitsMoleculeWithCubicVoxels) {
+    const std::vector<Eigen::Vector3d> atoms = {Eigen::Vector3d(-3.0, 0.0, 0.0), Eigen::Vector3d(3.0, 0.5, 0.0)};
+    const sbox::analysis::VolumeGrid grid = sbox::analysis::fit_volume_grid(atoms, 60, 4.0);
+
+    EXPECT_EQ(grid.nx, 60);
+    EXPECT_LT(grid.ny, grid.nx);
+    EXPECT_LT(grid.nz, grid.nx);
+    EXPECT_NEAR(grid.spacing, 14.0 / 59.0, 1e-12);
+    for (const Eigen::Vector3d& atom : atoms) {
+        const Eigen::Vector3d far_corner =
+            grid.origin + grid.spacing * Eigen::Vector3d(grid.nx - 1, grid.ny - 1, grid.nz - 1);
+        EXPECT_TRUE(((atom.array() - 4.0) >= grid.origin.array() - 1e-9).all());
+        EXPECT_TRUE(((atom.array() + 4.0) <= far_corner.array() + 1e-9).all());
+    }
+}
+
+TEST(VolumeGeneratorTest, OrbitalVolumeMatchesPointEvaluation) {
+    const sbox::basis::MOData mo_data = make_h2();
+    const sbox::analysis::VolumeGrid grid = sbox::analysis::fit_volume_grid(mo_data.atom_positions, 24);
+    const sbox::io::CubeData cube = sbox::analysis::evaluate_orbital_volume(mo_data, 1, grid, 3);
+
+    ASSERT_EQ(cube.data.size(), static_cast<std::size_t>(cube.nx) * cube.ny * cube.nz);
+    EXPECT_EQ(cube.atom_Z, mo_data.atomic_numbers);
+    for (const auto& [ix, iy, iz] : {std::tuple{0, 0, 0}, std::tuple{11, 12, 10}, std::tuple{cube.nx - 1, 5, cube.nz / 2}}) {
+        const double expected = sbox::basis::evaluate_mo_at_point(mo_data, 1, grid_point(cube, ix, iy, iz));
+        EXPECT_NEAR(cube.at(ix, iy, iz), expected, 1e-6);
+    }
+}
+
+TEST(VolumeGeneratorTest, RejectsCoefficientsThatDoNotMatchTheBasis) {
+    sbox::basis::MOData mo_data = make_h2();
+    mo_data.coefficients.conservativeResize(1, 2);
+    const sbox::analysis::VolumeGrid grid = sbox::analysis::fit_volume_grid(mo_data.atom_positions, 8);
+    EXPECT_THROW(sbox::analysis::evaluate_orbital_volume(mo_data, 0, grid, 1), std::runtime_error);
+    EXPECT_THROW(sbox::analysis::evaluate_density_volume(mo_data, grid, 1), std::runtime_error);
+}
+
+TEST(VolumeGeneratorTest, DensityIsOccupationWeightedAndThreadCountIndependent) {
+    const sbox::basis::MOData mo_data = make_h2();
+    const sbox::analysis::VolumeGrid grid = sbox::analysis::fit_volume_grid(mo_data.atom_positions, 20);
+    const sbox::io::CubeData serial = sbox::analysis::evaluate_density_volume(mo_data, grid, 1);
+    const sbox::io::CubeData parallel = sbox::analysis::evaluate_density_volume(mo_data, grid, 4);
+
+    ASSERT_EQ(serial.data, parallel.data);
+    const Eigen::Vector3d point = grid_point(serial, 9, 9, 9);
+    const double psi = sbox::basis::evaluate_mo_at_point(mo_data, 0, point);
+    EXPECT_NEAR(serial.at(9, 9, 9), 2.0 * psi * psi, 1e-6);
+}
+
+TEST(VolumeGeneratorTest, ScreeningOnlyDropsNegligibleValues) {
+    const sbox::basis::MOData mo_data = make_h2();
+    const std::vector<double> radii2 = sbox::basis::shell_screening_radii2(mo_data.basis, 1.0e-10);
+    std::vector<double> screened;
+    Eigen::VectorXd full;
+    for (const Eigen::Vector3d& point : {Eigen::Vector3d(0.3, 0.1, 0.2), Eigen::Vector3d(0.0, 0.0, 12.0),
+                                         Eigen::Vector3d(30.0, 0.0, 0.0)}) {
+        sbox::basis::evaluate_basis_screened(mo_data, radii2, point, screened);
+        sbox::basis::evaluate_basis_at_point(mo_data, point, full);
+        ASSERT_EQ(screened.size(), static_cast<std::size_t>(full.size()));
+        for (std::size_t i = 0; i < screened.size(); ++i) {
+            EXPECT_NEAR(screened[i], full(static_cast<Eigen::Index>(i)), 1e-10);
+        }
+    }
+}
+
+TEST(VolumeCacheTest, GeneratesLazilyAndCachesPerResolution) {
+    auto result = std::make_shared<sbox::backend::JobResult>();
+    result->status = sbox::backend::JobStatus::Converged;
+    result->mo_data = make_h2();
+    result->has_mo_data = true;
+
+    sbox::backend::VolumeCache volumes;
+    volumes.set_resolution(16);
+    volumes.reset(result);
+    ASSERT_TRUE(volumes.can_generate());
+
+    const sbox::backend::VolumeCache::Volume homo = volumes.homo();
+    ASSERT_NE(homo, nullptr);
+    EXPECT_EQ(homo->nz, 16);  // the bond axis is the longest side
+    EXPECT_EQ(volumes.homo(), homo);
+    EXPECT_EQ(volumes.orbital(0), homo);
+    EXPECT_EQ(volumes.orbital(5), nullptr);
+
+    volumes.set_resolution(24);
+    const sbox::backend::VolumeCache::Volume finer = volumes.homo();
+    ASSERT_NE(finer, nullptr);
+    EXPECT_EQ(finer->nz, 24);
+}
+
+TEST(VolumeCacheTest, ConcurrentRequestsAndResetsAreSafe) {
+    auto result = std::make_shared<sbox::backend::JobResult>();
+    result->mo_data = make_h2();
+    result->has_mo_data = true;
+
+    sbox::backend::VolumeCache volumes;
+    volumes.set_resolution(12);
+    volumes.reset(result);
+    std::vector<std::thread> readers;
+    std::vector<sbox::backend::VolumeCache::Volume> found(4);
+    for (std::size_t i = 0; i < found.size(); ++i) {
+        readers.emplace_back([&volumes, &found, i]() {
+            for (int round = 0; round < 5; ++round) {
+                found[i] = volumes.homo();
+                (void)volumes.has_density();
+            }
+        });
+    }
+    std::thread resetter([&volumes, &result]() {
+        for (int round = 0; round < 5; ++round) {
+            volumes.reset(result);
+        }
+    });
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    resetter.join();
+
+    for (const sbox::backend::VolumeCache::Volume& volume : found) {
+        ASSERT_NE(volume, nullptr);
+        EXPECT_EQ(volume->nz, 12);
+    }
+    const sbox::backend::VolumeCache::Volume cached = volumes.homo();
+    EXPECT_EQ(volumes.homo(), cached);
+}
+
+TEST(VolumeCacheTest, PrefersDriverDensityCube) {
+    auto result = std::make_shared<sbox::backend::JobResult>();
+    result->mo_data = make_h2();
+    result->has_mo_data = true;
+    auto driver_cube = std::make_shared<sbox::io::CubeData>();
+    driver_cube->nx = driver_cube->ny = driver_cube->nz = 3;
+    driver_cube->data.assign(27, 1.0f);
+    result->density_cube = driver_cube;
+    result->has_density_cube = true;
+
+    sbox::backend::VolumeCache volumes;
+    volumes.reset(result);
+    EXPECT_EQ(volumes.density(), result->density_cube);
+
+    sbox::backend::VolumeCache empty;
+    EXPECT_FALSE(empty.has_density());
+    EXPECT_EQ(empty.density(), nullptr);
+}